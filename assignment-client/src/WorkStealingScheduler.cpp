@@ -0,0 +1,185 @@
+//
+//  WorkStealingScheduler.cpp
+//  assignment-client/src
+//
+//  Created on 2019-11-04.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingScheduler.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+// how long a thread that ran out of things to do keeps polling before it parks
+static const std::chrono::microseconds MAX_SPIN_TIME { 100 };
+static const int SPIN_CHECK_INTERVAL = 64;
+
+// returns true if condition() became true while spinning, false if the caller should park
+template <typename F>
+static bool spinUntil(F condition) {
+    auto spinStart = p_high_resolution_clock::now();
+    for (int i = 1; ; ++i) {
+        if (condition()) {
+            return true;
+        }
+        if (i % SPIN_CHECK_INTERVAL == 0) {
+            if (p_high_resolution_clock::now() - spinStart > MAX_SPIN_TIME) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+WorkStealingScheduler::WorkStealingScheduler(int maxThreads) :
+    _threads(new WorkerState[std::max(0, maxThreads)]),
+    _maxThreads(std::max(0, maxThreads))
+{
+}
+
+void WorkStealingScheduler::setNumThreads(int numThreads) {
+    assert(_numWorking == 0);
+    assert(numThreads <= _maxThreads);
+
+    numThreads = std::min(std::max(0, numThreads), _maxThreads);
+    // a worker that comes back starts from clean counters
+    for (int i = _numThreads; i < numThreads; ++i) {
+        _threads[i].stats = ThreadStats();
+        _threads[i].parks.store(0);
+    }
+    _numThreads = numThreads;
+}
+
+void WorkStealingScheduler::runFrame(std::vector<uint64_t>& jobCosts) {
+    int numThreads = getNumThreads();
+    int numJobs = (int)jobCosts.size();
+    assert(numThreads > 0 || numJobs == 0);
+    if (numThreads == 0) {
+        return;
+    }
+
+    auto frameStart = Clock::now();
+
+    // largest first, so that the long jobs are not the ones left running at the end of the frame
+    _order.resize(numJobs);
+    std::iota(_order.begin(), _order.end(), 0);
+    std::stable_sort(_order.begin(), _order.end(), [&](int a, int b) {
+        return jobCosts[a] > jobCosts[b];
+    });
+
+    // deal them round-robin, so each deque also runs largest first
+    _slots.resize(numJobs);
+    uint32_t slot = 0;
+    for (int thread = 0; thread < numThreads; ++thread) {
+        uint32_t head = slot;
+        for (int i = thread; i < numJobs; i += numThreads) {
+            _slots[slot++] = _order[i];
+        }
+        _threads[thread].range.store(packRange(head, slot), std::memory_order_relaxed);
+    }
+
+    _jobCosts = &jobCosts;
+    _numWorking.store(numThreads, std::memory_order_relaxed);
+
+    // start the frame, the bump publishes all of the above to the workers
+    _frame.fetch_add(1);
+    if (_numParkedWorkers.load() > 0) {
+        // taking the lock makes sure a worker that is about to park has either seen the new frame or is waiting
+        { Lock lock(_mutex); }
+        _workerCondition.notify_all();
+    }
+
+    // wait for the workers to be done with it
+    auto isDone = [&] { return _numWorking.load() == 0; };
+    if (!spinUntil(isDone)) {
+        Lock lock(_mutex);
+        _poolParked.store(true);
+        _poolCondition.wait(lock, isDone);
+        _poolParked.store(false);
+    }
+
+    _jobCosts = nullptr;
+
+    uint64_t frameNsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frameStart).count();
+    for (int i = 0; i < numThreads; ++i) {
+        _threads[i].stats.frameNsecs += frameNsecs;
+    }
+}
+
+uint32_t WorkStealingScheduler::waitForFrame(int threadIndex, uint32_t lastFrame) {
+    uint32_t frame;
+    auto hasStarted = [&] {
+        frame = _frame.load();
+        return frame != lastFrame;
+    };
+
+    if (spinUntil(hasStarted)) {
+        return frame;
+    }
+
+    ++_threads[threadIndex].parks;
+
+    Lock lock(_mutex);
+    ++_numParkedWorkers;
+    _workerCondition.wait(lock, hasStarted);
+    --_numParkedWorkers;
+
+    return frame;
+}
+
+void WorkStealingScheduler::finishFrame() {
+    if (_numWorking.fetch_sub(1) == 1 && _poolParked.load()) {
+        // see runFrame, the pool thread is either waiting or will see there is nothing left
+        { Lock lock(_mutex); }
+        _poolCondition.notify_one();
+    }
+}
+
+bool WorkStealingScheduler::popOwn(WorkerState& worker, int& job) {
+    uint64_t range = worker.range.load(std::memory_order_relaxed);
+    while (rangeHead(range) < rangeTail(range)) {
+        uint32_t head = rangeHead(range);
+        if (worker.range.compare_exchange_weak(range, packRange(head + 1, rangeTail(range)),
+                                               std::memory_order_relaxed)) {
+            job = _slots[head];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingScheduler::steal(int threadIndex, int& job) {
+    int numThreads = getNumThreads();
+    for (int i = 1; i < numThreads; ++i) {
+        auto& victim = _threads[(threadIndex + i) % numThreads];
+
+        uint64_t range = victim.range.load(std::memory_order_relaxed);
+        while (rangeHead(range) < rangeTail(range)) {
+            uint32_t tail = rangeTail(range) - 1;
+            if (victim.range.compare_exchange_weak(range, packRange(rangeHead(range), tail),
+                                                   std::memory_order_relaxed)) {
+                job = _slots[tail];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<WorkStealingScheduler::ThreadStats> WorkStealingScheduler::sampleThreadStats() {
+    std::vector<ThreadStats> stats;
+    stats.reserve(_numThreads);
+    for (int i = 0; i < _numThreads; ++i) {
+        auto& thread = _threads[i];
+        stats.push_back(thread.stats);
+        stats.back().parks = thread.parks.exchange(0);
+        thread.stats = ThreadStats();
+    }
+    return stats;
+}
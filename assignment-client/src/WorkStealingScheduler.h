@@ -0,0 +1,142 @@
+//
+//  WorkStealingScheduler.h
+//  assignment-client/src
+//
+//  Created on 2019-11-04.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WorkStealingScheduler_h
+#define hifi_WorkStealingScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+// Hands out the jobs of a frame to a fixed set of worker threads.
+//
+// The pool thread calls runFrame() with the expected cost of every job (e.g. what it took last frame). Jobs are sorted
+// largest first and dealt round-robin onto one deque per worker; each worker takes the largest job left on its own
+// deque and, once that is empty, steals the smallest job left on someone else's.
+// Workers spin for a little while between frames before parking, so back-to-back frames (e.g. processing packets and
+// then mixing) do not pay for a condition variable handoff.
+//
+// runFrame() and setNumThreads() must only be called from a single (pool) thread. The state of every worker the pool
+// can grow to is allocated up front, so that resizing never moves it out from under a worker that is waiting.
+class WorkStealingScheduler {
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+    using ConditionVariable = std::condition_variable;
+    using Clock = p_high_resolution_clock;
+
+public:
+    struct ThreadStats {
+        uint64_t busyNsecs { 0 };
+        uint64_t frameNsecs { 0 }; // wall time of the frames this worker was part of
+        uint64_t jobs { 0 };
+        uint64_t steals { 0 };
+        uint64_t parks { 0 };
+
+        float utilization() const { return frameNsecs > 0 ? (float)busyNsecs / (float)frameNsecs : 0.0f; }
+    };
+
+    explicit WorkStealingScheduler(int maxThreads);
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    // must not be called while a frame is running, numThreads is clamped to maxThreads
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return _numThreads; }
+    int getMaxThreads() const { return _maxThreads; }
+
+    // pool thread: runs every job of the frame and returns once all workers are done with it
+    // jobCosts holds the expected cost of each job on the way in and their measured cost (in nanoseconds) on the way out
+    void runFrame(std::vector<uint64_t>& jobCosts);
+
+    // worker thread: returns the frame to run once one newer than lastFrame has started
+    uint32_t waitForFrame(int threadIndex, uint32_t lastFrame);
+
+    // worker thread: calls job(jobIndex) for each job this worker gets, its own first and then stolen ones
+    template <typename F>
+    void runJobs(int threadIndex, F job);
+
+    // worker thread: signals it is done with the frame, nothing of the frame may be touched afterwards
+    void finishFrame();
+
+    // the frame counter, for a worker that starts between frames
+    uint32_t getFrame() const { return _frame.load(std::memory_order_acquire); }
+
+    // returns the per-worker counters accumulated since the last call and resets them
+    std::vector<ThreadStats> sampleThreadStats();
+
+private:
+    // jobs left on a worker's deque, [head, tail) packed in a single word so that the owner (taking from the head)
+    // and thieves (taking from the tail) settle on the last job with one compare-and-swap
+    struct alignas(64) WorkerState {
+        std::atomic<uint64_t> range { 0 };
+
+        // only touched by the owning worker during a frame, and by the pool thread between frames
+        ThreadStats stats;
+
+        // counted while waiting for a frame, so it can race with sampling
+        std::atomic<uint64_t> parks { 0 };
+    };
+
+    static uint64_t packRange(uint32_t head, uint32_t tail) { return ((uint64_t)head << 32) | tail; }
+    static uint32_t rangeHead(uint64_t range) { return (uint32_t)(range >> 32); }
+    static uint32_t rangeTail(uint64_t range) { return (uint32_t)range; }
+
+    bool popOwn(WorkerState& worker, int& job);
+    bool steal(int threadIndex, int& job);
+
+    // sized for maxThreads once, only the first _numThreads are in use
+    std::unique_ptr<WorkerState[]> _threads;
+    const int _maxThreads;
+    int _numThreads { 0 }; // changed between frames only, the frame counter publishes it to the workers
+
+    // frame state, written by the pool thread before the frame counter is bumped
+    std::vector<int> _order; // job indices, largest first
+    std::vector<int> _slots; // job indices, each worker's deque is a contiguous range of this
+    std::vector<uint64_t>* _jobCosts { nullptr };
+
+    std::atomic<uint32_t> _frame { 0 };
+    std::atomic<int> _numWorking { 0 };
+
+    // parking
+    Mutex _mutex;
+    ConditionVariable _workerCondition;
+    ConditionVariable _poolCondition;
+    std::atomic<int> _numParkedWorkers { 0 };
+    std::atomic<bool> _poolParked { false };
+};
+
+template <typename F>
+void WorkStealingScheduler::runJobs(int threadIndex, F job) {
+    auto& worker = _threads[threadIndex];
+    auto& costs = *_jobCosts;
+
+    int jobIndex;
+    bool stolen = false;
+    while (popOwn(worker, jobIndex) || (stolen = steal(threadIndex, jobIndex))) {
+        auto start = Clock::now();
+        job(jobIndex);
+        auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+        // every job runs exactly once, so its slot is only written by the worker that ran it
+        costs[jobIndex] = (uint64_t)cost;
+        worker.stats.busyNsecs += (uint64_t)cost;
+        ++worker.stats.jobs;
+        if (stolen) {
+            ++worker.stats.steals;
+        }
+    }
+}
+
+#endif // hifi_WorkStealingScheduler_h
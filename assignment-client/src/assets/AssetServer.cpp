@@ -36,7 +36,6 @@
 #include <image/TextureProcessing.h>
 
 #include "AssetServerLogging.h"
-#include "BakeAssetTask.h"
 #include "SendAssetTask.h"
 #include "UploadAssetTask.h"
 
@@ -55,9 +54,6 @@ static const QString BAKED_MODEL_SIMPLE_NAME = "asset.fbx";
 static const QString BAKED_TEXTURE_SIMPLE_NAME = "texture.ktx";
 static const QString BAKED_SCRIPT_SIMPLE_NAME = "asset.js";
 
-static const ModelBakeVersion CURRENT_MODEL_BAKE_VERSION = (ModelBakeVersion)((BakeVersion)ModelBakeVersion::COUNT - 1);
-static const TextureBakeVersion CURRENT_TEXTURE_BAKE_VERSION = (TextureBakeVersion)((BakeVersion)TextureBakeVersion::COUNT - 1);
-static const ScriptBakeVersion CURRENT_SCRIPT_BAKE_VERSION = (ScriptBakeVersion)((BakeVersion)ScriptBakeVersion::COUNT - 1);
 
 BakedAssetType assetTypeForExtension(const QString& extension) {
     auto extensionLower = extension.toLower();
@@ -113,20 +109,10 @@ QString getBakeMapping(const AssetUtils::AssetHash& hash, const QString& relativ
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
-void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath) {
+void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                            OvenWorkerPool::Priority priority) {
     qDebug() << "Starting bake for: " << assetPath << assetHash;
-    auto it = _pendingBakes.find(assetHash);
-    if (it == _pendingBakes.end()) {
-        auto task = std::make_shared<BakeAssetTask>(assetHash, assetPath, filePath);
-        task->setAutoDelete(false);
-        _pendingBakes[assetHash] = task;
-
-        connect(task.get(), &BakeAssetTask::bakeComplete, this, &AssetServer::handleCompletedBake);
-        connect(task.get(), &BakeAssetTask::bakeFailed, this, &AssetServer::handleFailedBake);
-        connect(task.get(), &BakeAssetTask::bakeAborted, this, &AssetServer::handleAbortedBake);
-
-        _bakingTaskPool.start(task.get());
-    } else {
+    if (!_ovenWorkerPool.queueBake(assetHash, assetPath, filePath, priority)) {
         qDebug() << "Already in queue";
     }
 }
@@ -136,9 +122,8 @@ QString AssetServer::getPathToAssetHash(const AssetUtils::AssetHash& assetHash)
 }
 
 std::pair<AssetUtils::BakingStatus, QString> AssetServer::getAssetStatus(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
-    auto it = _pendingBakes.find(hash);
-    if (it != _pendingBakes.end()) {
-        return { (*it)->isBaking() ? AssetUtils::Baking : AssetUtils::Pending, "" };
+    if (_ovenWorkerPool.isPending(hash)) {
+        return { _ovenWorkerPool.isBaking(hash) ? AssetUtils::Baking : AssetUtils::Pending, "" };
     }
 
     if (path.startsWith(AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER)) {
@@ -166,8 +151,8 @@ std::pair<AssetUtils::BakingStatus, QString> AssetServer::getAssetStatus(const A
         bakedPath = meta.redirectTarget;
     }
 
-    auto jt = _fileMappings.find(bakedPath);
-    if (jt != _fileMappings.end()) {
+    auto jt = _mappingStore.find(bakedPath);
+    if (jt != _mappingStore.end()) {
         if (jt->second == hash) {
             return { AssetUtils::NotBaked, "" };
         } else {
@@ -181,18 +166,19 @@ std::pair<AssetUtils::BakingStatus, QString> AssetServer::getAssetStatus(const A
 }
 
 void AssetServer::bakeAssets() {
-    auto it = _fileMappings.cbegin();
-    for (; it != _fileMappings.cend(); ++it) {
+    auto it = _mappingStore.begin();
+    for (; it != _mappingStore.end(); ++it) {
         auto path = it->first;
         auto hash = it->second;
-        maybeBake(path, hash);
+        maybeBake(path, hash, OvenWorkerPool::BACKGROUND);
     }
 }
 
-void AssetServer::maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
+void AssetServer::maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash,
+                            OvenWorkerPool::Priority priority) {
     if (needsToBeBaked(path, hash)) {
         qDebug() << "Queuing bake of: " << path;
-        bakeAsset(hash, path, getPathToAssetHash(hash));
+        bakeAsset(hash, path, getPathToAssetHash(hash), priority);
     }
 }
 
@@ -212,7 +198,7 @@ void AssetServer::createEmptyMetaFile(const AssetUtils::AssetHash& hash) {
 bool AssetServer::hasMetaFile(const AssetUtils::AssetHash& hash) {
     QString metaFilePath = AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER + hash + "/meta.json";
 
-    return _fileMappings.find(metaFilePath) != _fileMappings.end();
+    return _mappingStore.find(metaFilePath) != _mappingStore.end();
 }
 
 bool AssetServer::needsToBeBaked(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& assetHash) {
@@ -236,8 +222,8 @@ bool AssetServer::needsToBeBaked(const AssetUtils::AssetPath& path, const AssetU
         bakedPath = meta.redirectTarget;
     }
 
-    auto mappingIt = _fileMappings.find(bakedPath);
-    bool bakedMappingExists = mappingIt != _fileMappings.end();
+    auto mappingIt = _mappingStore.find(bakedPath);
+    bool bakedMappingExists = mappingIt != _mappingStore.end();
 
     // If the path is mapped to the original file's hash, baking has been disabled for this
     // asset
@@ -294,7 +280,6 @@ void updateConsumedCores() {
 AssetServer::AssetServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
     _transferTaskPool(this),
-    _bakingTaskPool(this),
     _filesizeLimit(AssetUtils::MAX_UPLOAD_SIZE)
 {
     BAKEABLE_TEXTURE_EXTENSIONS = image::getSupportedFormats();
@@ -304,7 +289,10 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     // so the ideal is greater than the number of cores on the system.
     static const int TASK_POOL_THREAD_COUNT = 50;
     _transferTaskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
-    _bakingTaskPool.setMaxThreadCount(1);
+
+    connect(&_ovenWorkerPool, &OvenWorkerPool::bakeComplete, this, &AssetServer::handleCompletedBake);
+    connect(&_ovenWorkerPool, &OvenWorkerPool::bakeFailed, this, &AssetServer::handleFailedBake);
+    connect(&_ovenWorkerPool, &OvenWorkerPool::bakeAborted, this, &AssetServer::handleAbortedBake);
 
     // Queue all requests until the Asset Server is fully setup
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
@@ -330,22 +318,11 @@ void AssetServer::aboutToFinish() {
     // remove pending transfer tasks
     _transferTaskPool.clear();
 
-    // abort each of our still running bake tasks, remove pending bakes that were never put on the thread pool
-    auto it = _pendingBakes.begin();
-    while (it != _pendingBakes.end()) {
-        auto pendingRunnable =  _bakingTaskPool.tryTake(it->get());
-
-        if (pendingRunnable) {
-            it = _pendingBakes.erase(it);
-        } else {
-            qDebug() << "Aborting bake for" << it.key();
-            it.value()->abort();
-            ++it;
-        }
-    }
+    // drop the queued bakes and abort the ones the oven workers are on
+    _ovenWorkerPool.abortAll();
 
     // make sure all bakers are finished or aborted
-    while (_pendingBakes.size() > 0) {
+    while (_ovenWorkerPool.getNumPending() > 0) {
         QCoreApplication::processEvents();
     }
 }
@@ -392,6 +369,17 @@ void AssetServer::completeSetup() {
                     " (" << maxBandwidth << "bits/s)";
     }
 
+    // get the number of oven processes to keep around for baking
+    static const QString OVEN_WORKERS_OPTION = "oven_workers";
+    auto ovenWorkers = assetServerObject[OVEN_WORKERS_OPTION].toInt(OvenWorkerPool::DEFAULT_NUM_WORKERS);
+    _ovenWorkerPool.setNumWorkers(ovenWorkers);
+    qCInfo(asset_server) << "Baking with" << _ovenWorkerPool.getStats().numWorkers << "oven workers";
+
+    // and how long one of them may take over a single bake
+    static const QString OVEN_JOB_TIMEOUT_OPTION = "oven_job_timeout";
+    auto ovenJobTimeout = assetServerObject[OVEN_JOB_TIMEOUT_OPTION].toInt(OvenWorkerPool::DEFAULT_JOB_TIMEOUT_SECS);
+    _ovenWorkerPool.setJobTimeout(ovenJobTimeout);
+
     // get the path to the asset folder from the domain server settings
     static const QString ASSETS_PATH_OPTION = "assets_path";
     auto assetsJSONValue = assetServerObject[ASSETS_PATH_OPTION];
@@ -436,7 +424,7 @@ void AssetServer::completeSetup() {
 
         qCInfo(asset_server) << "There are" << hashedFiles.size() << "asset files in the asset directory.";
 
-        if (_fileMappings.size() > 0) {
+        if (_mappingStore.size() > 0) {
             cleanupUnmappedFiles();
             cleanupBakedFilesForDeletedAssets();
         }
@@ -527,15 +515,9 @@ void AssetServer::cleanupUnmappedFiles() {
     for (const auto& fileInfo : files) {
         auto filename = fileInfo.fileName();
         if (hashFileRegex.exactMatch(filename)) {
-            bool matched { false };
-            for (auto& pair : _fileMappings) {
-                if (pair.second == filename) {
-                    matched = true;
-                    break;
-                }
-            }
-            if (!matched) {
+            if (!_mappingStore.isHashMapped(filename)) {
                 // remove the unmapped file
+                _hotAssetCache.remove(filename);
                 QFile removeableFile { fileInfo.absoluteFilePath() };
 
                 if (removeableFile.remove()) {
@@ -555,27 +537,21 @@ void AssetServer::cleanupBakedFilesForDeletedAssets() {
 
     std::set<AssetUtils::AssetHash> bakedHashes;
 
-    for (const auto& it : _fileMappings) {
-        // check if this is a mapping to baked content
-        if (it.first.startsWith(AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER)) {
-            // extract the hash from the baked mapping
-            AssetUtils::AssetHash hash = it.first.mid(AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER.length(),
-                                                      AssetUtils::SHA256_HASH_HEX_LENGTH);
+    // the mappings to baked content
+    auto bakedMappings = _mappingStore.getFolder(AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER);
+    for (auto it = bakedMappings.first; it != bakedMappings.second; ++it) {
+        // extract the hash from the baked mapping
+        AssetUtils::AssetHash hash = it->first.mid(AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER.length(),
+                                                   AssetUtils::SHA256_HASH_HEX_LENGTH);
 
-            // add the hash to our set of hashes for which we have baked content
-            bakedHashes.insert(hash);
-        }
+        // add the hash to our set of hashes for which we have baked content
+        bakedHashes.insert(hash);
     }
 
     // enumerate the hashes for which we have baked content
     for (const auto& hash : bakedHashes) {
         // check if we have a mapping that points to this hash
-        auto matchingMapping = std::find_if(std::begin(_fileMappings), std::end(_fileMappings),
-                                            [&hash](const std::pair<AssetUtils::AssetPath, AssetUtils::AssetHash> mappingPair) {
-            return mappingPair.second == hash;
-        });
-
-        if (matchingMapping == std::end(_fileMappings)) {
+        if (!_mappingStore.isHashMapped(hash)) {
             // we didn't find a mapping for this hash, remove any baked content we still have for it
             removeBakedPathsForDeletedAsset(hash);
         }
@@ -634,8 +610,8 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
     QUrl url { assetPath };
     assetPath = url.path();
 
-    auto it = _fileMappings.find(assetPath);
-    if (it != _fileMappings.end()) {
+    auto it = _mappingStore.find(assetPath);
+    if (it != _mappingStore.end()) {
 
         // check if we should re-direct to a baked asset
         auto originalAssetHash = it->second;
@@ -643,6 +619,9 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
         quint8 wasRedirected = false;
         bool bakingDisabled = false;
 
+        // someone is waiting on this asset, bake it ahead of the others if it's still queued
+        _ovenWorkerPool.prioritize(originalAssetHash, OvenWorkerPool::REQUESTED);
+
         bool loaded;
         AssetMeta meta;
         std::tie(loaded, meta) = readMetaFile(originalAssetHash);
@@ -655,8 +634,8 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
             bakedAssetPath = meta.redirectTarget;
         }
 
-        auto bakedIt = _fileMappings.find(bakedAssetPath);
-        if (bakedIt != _fileMappings.end()) {
+        auto bakedIt = _mappingStore.find(bakedAssetPath);
+        if (bakedIt != _mappingStore.end()) {
             if (bakedIt->second != originalAssetHash) {
                 qDebug() << "Did find baked version for: " << originalAssetHash << assetPath;
                 // we found a baked version of the requested asset to serve, redirect to that
@@ -692,7 +671,7 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
 
                 writeMetaFile(originalAssetHash, needsBakingMeta);
                 if (!bakingDisabled) {
-                    maybeBake(assetPath, originalAssetHash);
+                    maybeBake(assetPath, originalAssetHash, OvenWorkerPool::REQUESTED);
                 }
             }
         }
@@ -704,11 +683,11 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
 void AssetServer::handleGetAllMappingOperation(NLPacketList& replyPacket) {
     replyPacket.writePrimitive(AssetUtils::AssetServerError::NoError);
 
-    uint32_t count = (uint32_t)_fileMappings.size();
+    uint32_t count = (uint32_t)_mappingStore.size();
 
     replyPacket.writePrimitive(count);
 
-    for (auto it = _fileMappings.cbegin(); it != _fileMappings.cend(); ++ it) {
+    for (auto it = _mappingStore.begin(); it != _mappingStore.end(); ++ it) {
         auto mapping = it->first;
         auto hash = it->second;
         replyPacket.writeString(mapping);
@@ -867,7 +846,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _hotAssetCache);
     _transferTaskPool.start(task);
 }
 
@@ -881,7 +860,7 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     if (canWriteToAssetServer) {
         qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << message->getSourceID();
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit);
+        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit, _hotAssetCache);
         _transferTaskPool.start(task);
     } else {
         // this is a node the domain told us is not allowed to rez entities
@@ -957,6 +936,43 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
+    auto hotAssetStats = _hotAssetCache.getStats();
+    quint64 now = usecTimestampNow();
+    float statsInterval = (float)(now - _lastStatsTime) / (float)USECS_PER_SECOND;
+    // the hit rate over this stats interval
+    uint64_t hits = hotAssetStats.hits - _lastStatsHotAssetHits;
+    uint64_t lookups = hits + hotAssetStats.misses - _lastStatsHotAssetMisses;
+
+    QJsonObject hotAssetCacheStats;
+    hotAssetCacheStats["1. Hit Rate (%)"] = lookups > 0 ? 100.0 * (double)hits / (double)lookups : 0.0;
+    hotAssetCacheStats["2. Mapped Assets"] = (int)hotAssetStats.numEntries;
+    hotAssetCacheStats["3. Resident (MB)"] = (double)hotAssetStats.residentBytes / (1024.0 * 1024.0);
+    hotAssetCacheStats["4. Served (MB/s)"] = statsInterval > 0.0f ?
+        (double)(hotAssetStats.bytesServed - _lastStatsBytesServed) / (1024.0 * 1024.0) / statsInterval : 0.0;
+    serverStats["Hot Asset Cache"] = hotAssetCacheStats;
+    _lastStatsBytesServed = hotAssetStats.bytesServed;
+    _lastStatsHotAssetHits = hotAssetStats.hits;
+    _lastStatsHotAssetMisses = hotAssetStats.misses;
+
+    auto bakingStats = _ovenWorkerPool.getStats();
+    QJsonObject ovenStats;
+    ovenStats["1. Queued"] = bakingStats.numQueued;
+    ovenStats["2. Baking"] = bakingStats.numBaking;
+    ovenStats["3. Workers"] = bakingStats.numWorkers;
+    ovenStats["4. Baked (/min)"] = statsInterval > 0.0f ?
+        60.0 * (double)(bakingStats.numCompleted - _lastStatsBakesCompleted) / statsInterval : 0.0;
+    ovenStats["5. Baked"] = (double)bakingStats.numCompleted;
+    ovenStats["6. Failed"] = (double)bakingStats.numFailed;
+    ovenStats["7. Worker Crashes"] = (double)bakingStats.numWorkerCrashes;
+    uint64_t textureLookups = bakingStats.numTextureCacheHits + bakingStats.numTextureCacheMisses;
+    ovenStats["8. Textures Deduplicated (%)"] = textureLookups > 0 ?
+        100.0 * (double)bakingStats.numTextureCacheHits / (double)textureLookups : 0.0;
+    ovenStats["9. Texture Processing Saved (s)"] = (double)bakingStats.textureCacheSavedUsecs / USECS_PER_SECOND;
+    serverStats["Baking"] = ovenStats;
+    _lastStatsBakesCompleted = bakingStats.numCompleted;
+
+    _lastStatsTime = now;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -964,93 +980,13 @@ void AssetServer::sendStatsPacket() {
 static const QString MAP_FILE_NAME = "map.json";
 
 bool AssetServer::loadMappingsFromFile() {
-
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.exists()) {
-        if (mapFile.open(QIODevice::ReadOnly)) {
-            QJsonParseError error;
-
-            auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
-
-            if (error.error == QJsonParseError::NoError) {
-                if (!jsonDocument.isObject()) {
-                    qCWarning(asset_server) << "Failed to read mapping file, root value in" << mapFilePath << "is not an object";
-                    return false;
-                }
-
-                //_fileMappings = jsonDocument.object().toVariantHash();
-                auto root = jsonDocument.object();
-                for (auto it = root.begin(); it != root.end(); ++it) {
-                    auto key = it.key();
-                    auto value = it.value();
-
-                    if (!value.isString()) {
-                        qCWarning(asset_server) << "Skipping" << key << ":" << value << "because it is not a string";
-                        continue;
-                    }
-
-                    if (!AssetUtils::isValidFilePath(key)) {
-                        qCWarning(asset_server) << "Will not keep mapping for" << key << "since it is not a valid path.";
-                        continue;
-                    }
-
-                    if (!AssetUtils::isValidHash(value.toString())) {
-                        qCWarning(asset_server) << "Will not keep mapping for" << key << "since it does not have a valid hash.";
-                        continue;
-                    }
-
-
-                    qDebug() << "Added " << key << value.toString();
-                    _fileMappings[key] = value.toString();
-                }
-
-                qCInfo(asset_server) << "Loaded" << _fileMappings.size() << "mappings from map file at" << mapFilePath;
-                return true;
-            }
-        }
-
-        qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
-        return false;
-    } else {
-        qCInfo(asset_server) << "No existing mappings loaded from file since no file was found at" << mapFilePath;
-    }
-
-    return true;
-}
-
-bool AssetServer::writeMappingsToFile() {
     auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
 
-    QSaveFile mapFile { mapFilePath };
-    if (mapFile.open(QIODevice::WriteOnly)) {
-        QJsonObject root;
-
-        for (auto it : _fileMappings) {
-            root[it.first] = it.second;
-        }
-
-        QJsonDocument jsonDocument { root };
-
-        if (mapFile.write(jsonDocument.toJson()) != -1) {
-            if (mapFile.commit()) {
-                qCDebug(asset_server) << "Wrote JSON mappings to file at" << mapFilePath;
-                return true;
-            } else {
-                qCWarning(asset_server) << "Failed to commit JSON mappings to file at" << mapFilePath;
-            }
-        } else {
-            qCWarning(asset_server) << "Failed to write JSON mappings to file at" << mapFilePath;
-        }
-    } else {
-        qCWarning(asset_server) << "Failed to open map file at" << mapFilePath;
-    }
-
-    return false;
+    return _mappingStore.load(mapFilePath);
 }
 
-bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash) {
+bool AssetServer::addSetMapping(AssetMappingStore::Transaction& transaction, AssetUtils::AssetPath path,
+                                const AssetUtils::AssetHash& hash) {
     path = path.trimmed();
 
     if (!AssetUtils::isValidFilePath(path)) {
@@ -1063,27 +999,24 @@ bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash h
         return false;
     }
 
-    // remember what the old mapping was in case persistence fails
-    auto it = _fileMappings.find(path);
-    auto oldMapping = it != _fileMappings.end() ? it->second : "";
+    transaction.set(path, hash);
+    return true;
+}
+
+bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash) {
+    path = path.trimmed();
 
-    // update the in memory QHash
-    _fileMappings[path] = hash;
+    AssetMappingStore::Transaction transaction;
+    if (!addSetMapping(transaction, path, hash)) {
+        return false;
+    }
 
-    // attempt to write to file
-    if (writeMappingsToFile()) {
-        // persistence succeeded, we are good to go
+    // attempt to persist the mapping, the store only changes if it succeeds
+    if (_mappingStore.commit(transaction)) {
         qCDebug(asset_server) << "Set mapping:" << path << "=>" << hash;
         maybeBake(path, hash);
         return true;
     } else {
-        // failed to persist this mapping to file - put back the old one in our in-memory representation
-        if (oldMapping.isEmpty()) {
-            _fileMappings.erase(_fileMappings.find(path));
-        } else {
-            _fileMappings[path] = oldMapping;
-        }
-
         qCWarning(asset_server) << "Failed to persist mapping:" << path << "=>" << hash;
 
         return false;
@@ -1107,88 +1040,83 @@ void AssetServer::removeBakedPathsForDeletedAsset(AssetUtils::AssetHash hash) {
 }
 
 bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
-    // take a copy of the current mappings in case persistence of these deletes fails
-    auto oldMappings = _fileMappings;
+    AssetMappingStore::Transaction transaction;
+
+    QSet<AssetUtils::AssetHash> hashesToCheckForDeletion;
 
-    QSet<QString> hashesToCheckForDeletion;
+    // enumerate the paths to delete and remove them all in one transaction
+    addDeleteMappings(transaction, paths, hashesToCheckForDeletion);
 
-    // enumerate the paths to delete and remove them all
+    // attempt to persist the deletes, the store only changes if it succeeds
+    if (_mappingStore.commit(transaction)) {
+        // persistence succeeded we are good to go
+        deleteUnmappedFiles(hashesToCheckForDeletion);
+        return true;
+    } else {
+        qCWarning(asset_server) << "Failed to persist deleted mappings";
+
+        return false;
+    }
+}
+
+void AssetServer::addDeleteMappings(AssetMappingStore::Transaction& transaction, const AssetUtils::AssetPathList& paths,
+                                    QSet<AssetUtils::AssetHash>& hashes) {
     for (const auto& rawPath : paths) {
         auto path = rawPath.trimmed();
 
         // figure out if this path will delete a file or folder
         if (pathIsFolder(path)) {
-            // enumerate the in memory file mappings and remove anything that matches
-            auto it = _fileMappings.begin();
-            auto sizeBefore = _fileMappings.size();
+            // remove everything the store has below the folder
+            auto folder = _mappingStore.getFolder(path);
+            auto sizeBefore = transaction.size();
 
-            while (it != _fileMappings.end()) {
-                if (it->first.startsWith(path)) {
-                    // add this hash to the list we need to check for asset removal from the server
-                    hashesToCheckForDeletion << it->second;
+            for (auto it = folder.first; it != folder.second; ++it) {
+                // add this hash to the list we need to check for asset removal from the server
+                hashes << it->second;
 
-                    it = _fileMappings.erase(it);
-                } else {
-                    ++it;
-                }
+                transaction.remove(it->first);
             }
 
-            auto sizeNow = _fileMappings.size();
-            if (sizeBefore != sizeNow) {
-                qCDebug(asset_server) << "Deleted" << sizeBefore - sizeNow << "mappings in folder: " << path;
+            if (transaction.size() != sizeBefore) {
+                qCDebug(asset_server) << "Deleting" << transaction.size() - sizeBefore << "mappings in folder: " << path;
             } else {
                 qCDebug(asset_server) << "Did not find any mappings to delete in folder:" << path;
             }
 
         } else {
-            auto it = _fileMappings.find(path);
-            if (it != _fileMappings.end()) {
+            auto it = _mappingStore.find(path);
+            if (it != _mappingStore.end()) {
                 // add this hash to the list we need to check for asset removal from server
-                hashesToCheckForDeletion << it->second;
+                hashes << it->second;
+
+                qCDebug(asset_server) << "Deleting a mapping:" << path << "=>" << it->second;
 
-                qCDebug(asset_server) << "Deleted a mapping:" << path << "=>" << it->second;
-                
-                _fileMappings.erase(it);
+                transaction.remove(path);
             } else {
                 qCDebug(asset_server) << "Unable to delete a mapping that was not found:" << path;
             }
         }
     }
+}
 
-    // deleted the old mappings, attempt to persist to file
-    if (writeMappingsToFile()) {
-        // persistence succeeded we are good to go
-
-        // TODO iterate through hashesToCheckForDeletion instead
-        for (auto& pair : _fileMappings) {
-            auto it = hashesToCheckForDeletion.find(pair.second);
-            if (it != hashesToCheckForDeletion.end()) {
-                hashesToCheckForDeletion.erase(it);
-            }
+void AssetServer::deleteUnmappedFiles(const QSet<AssetUtils::AssetHash>& hashes) {
+    // the hashes no path maps to anymore are unmapped - we will delete those asset files
+    for (auto& hash : hashes) {
+        if (_mappingStore.isHashMapped(hash)) {
+            continue;
         }
 
-        // we now have a set of hashes that are unmapped - we will delete those asset files
-        for (auto& hash : hashesToCheckForDeletion) {
-            // remove the unmapped file
-            QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+        // remove the unmapped file
+        _hotAssetCache.remove(hash);
+        QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
 
-            if (removeableFile.remove()) {
-                qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
+        if (removeableFile.remove()) {
+            qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
 
-                removeBakedPathsForDeletedAsset(hash);
-            } else {
-                qCDebug(asset_server) << "\tAttempt to delete unmapped file" << hash << "failed";
-            }
+            removeBakedPathsForDeletedAsset(hash);
+        } else {
+            qCDebug(asset_server) << "\tAttempt to delete unmapped file" << hash << "failed";
         }
-
-        return true;
-    } else {
-        qCWarning(asset_server) << "Failed to persist deleted mappings, rolling back";
-
-        // we didn't delete the previous mapping, put it back in our in-memory representation
-        _fileMappings = oldMappings;
-
-        return false;
     }
 }
 
@@ -1203,6 +1131,8 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
         return false;
     }
 
+    AssetMappingStore::Transaction transaction;
+
     // figure out if this rename is for a file or folder
     if (pathIsFolder(oldPath)) {
         if (!pathIsFolder(newPath)) {
@@ -1212,35 +1142,25 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
             return false;
         }
 
-        // take a copy of the old mappings
-        auto oldMappings = _fileMappings;
-
-        // iterate the current mappings and adjust any that matches the renamed folder
-        auto it = oldMappings.begin();
-
-        while (it != oldMappings.end()) {
-            auto& oldKey = it->first;
-            if (oldKey.startsWith(oldPath)) {
-                auto newKey = oldKey;
-                newKey.replace(0, oldPath.size(), newPath);
-
-                // remove the old version from the in memory file mappings
-                _fileMappings.erase(_fileMappings.find(oldKey));
-                _fileMappings[newKey] = it->second;
-            }
+        // remove every mapping below the renamed folder, then add them back below the new one, so that renaming into
+        // a sub folder of the old one doesn't remove what it just added
+        auto folder = _mappingStore.getFolder(oldPath);
+        for (auto it = folder.first; it != folder.second; ++it) {
+            transaction.remove(it->first);
+        }
+        for (auto it = folder.first; it != folder.second; ++it) {
+            auto newKey = it->first;
+            newKey.replace(0, oldPath.size(), newPath);
 
-            ++it;
+            transaction.set(newKey, it->second);
         }
 
-        if (writeMappingsToFile()) {
+        if (_mappingStore.commit(transaction)) {
             // persisted the changed mappings, return success
             qCDebug(asset_server) << "Renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return true;
         } else {
-            // couldn't persist the renamed paths, rollback and return failure
-            _fileMappings = oldMappings;
-
             qCWarning(asset_server) << "Failed to persist renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return false;
@@ -1253,40 +1173,24 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
             return false;
         }
 
-        // take the old hash to remove the old mapping
-        auto it = _fileMappings.find(oldPath);
-        auto oldSourceMapping = it->second;
-        _fileMappings.erase(it);
-
-        // in case we're overwriting, keep the current destination mapping for potential rollback
-        auto oldDestinationIt = _fileMappings.find(newPath);
-
-        if (!oldSourceMapping.isEmpty()) {
-            _fileMappings[newPath] = oldSourceMapping;
-
-            if (writeMappingsToFile()) {
-                // persisted the renamed mapping, return success
-                qCDebug(asset_server) << "Renamed mapping:" << oldPath << "=>" << newPath;
-
-                return true;
-            } else {
-                // we couldn't persist the renamed mapping, rollback and return failure
-                _fileMappings[oldPath] = oldSourceMapping;
+        auto it = _mappingStore.find(oldPath);
+        if (it == _mappingStore.end()) {
+            // failed to find a mapping that was to be renamed, return failure
+            return false;
+        }
 
-                if (oldDestinationIt != _fileMappings.end()) {
-                    // put back the overwritten mapping for the destination path
-                    _fileMappings[newPath] = oldDestinationIt->second;
-                } else {
-                    // clear the new mapping
-                    _fileMappings.erase(_fileMappings.find(newPath));
-                }
+        // move the old hash over to the new path, overwriting whatever it mapped to
+        transaction.remove(oldPath);
+        transaction.set(newPath, it->second);
 
-                qCDebug(asset_server) << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
+        if (_mappingStore.commit(transaction)) {
+            // persisted the renamed mapping, return success
+            qCDebug(asset_server) << "Renamed mapping:" << oldPath << "=>" << newPath;
 
-                return false;
-            }
+            return true;
         } else {
-            // failed to find a mapping that was to be renamed, return failure
+            qCDebug(asset_server) << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
+
             return false;
         }
     }
@@ -1308,15 +1212,16 @@ void AssetServer::handleFailedBake(QString originalAssetHash, QString assetPath,
     meta.bakeVersion = currentTypeVersion;
 
     writeMetaFile(originalAssetHash, meta);
-
-    _pendingBakes.remove(originalAssetHash);
 }
 
 void AssetServer::handleCompletedBake(QString originalAssetHash, QString originalAssetPath,
                                       QString bakedTempOutputDir) {
-    auto reportCompletion = [this, originalAssetPath, originalAssetHash](bool errorCompletingBake,
-                                                                         QString errorReason,
-                                                                         QString redirectTarget) {
+    // the baked files and the meta file are mapped in one transaction, so a bake is mapped whole or not at all
+    AssetMappingStore::Transaction transaction;
+
+    auto reportCompletion = [this, originalAssetPath, originalAssetHash, &transaction](bool errorCompletingBake,
+                                                                                       QString errorReason,
+                                                                                       QString redirectTarget) {
         auto type = assetTypeForFilename(originalAssetPath);
         auto currentTypeVersion = currentBakeVersionForAssetType(type);
 
@@ -1328,11 +1233,14 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
         if (errorCompletingBake) {
             qWarning() << "Could not complete bake for" << originalAssetHash;
             meta.lastBakeErrors = errorReason;
-        }
 
-        writeMetaFile(originalAssetHash, meta);
+            // none of the baked files are mapped
+            transaction = AssetMappingStore::Transaction();
+        }
 
-        _pendingBakes.remove(originalAssetHash);
+        if (!writeMetaFile(originalAssetHash, meta, transaction) || !_mappingStore.commit(transaction)) {
+            qCWarning(asset_server) << "Failed to persist the mappings of the bake of" << originalAssetHash;
+        }
     };
 
     bool errorCompletingBake { false };
@@ -1439,7 +1347,7 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
         }
 
         // add a mapping (under the hidden baked folder) for this file resulting from the bake
-        if (!setMapping(bakeMapping, bakedFileHash)) {
+        if (!addSetMapping(transaction, bakeMapping, bakedFileHash)) {
             qDebug() << "Failed to set mapping";
             // stop handling this bake, couldn't add a mapping for this bake file
             errorCompletingBake = true;
@@ -1464,8 +1372,7 @@ void AssetServer::handleCompletedBake(QString originalAssetHash, QString origina
 void AssetServer::handleAbortedBake(QString originalAssetHash, QString assetPath) {
     qDebug() << "Aborted bake:" << originalAssetHash;
 
-    // for an aborted bake we don't do anything but remove the BakeAssetTask from our pending bakes
-    _pendingBakes.remove(originalAssetHash);
+    // for an aborted bake we don't do anything, the oven worker pool has already dropped it from its pending bakes
 }
 
 static const QString BAKE_VERSION_KEY = "bake_version";
@@ -1476,8 +1383,8 @@ static const QString REDIRECT_TARGET_KEY = "redirect_target";
 std::pair<bool, AssetMeta> AssetServer::readMetaFile(AssetUtils::AssetHash hash) {
     auto metaFilePath = AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER + hash + "/" + "meta.json";
 
-    auto it = _fileMappings.find(metaFilePath);
-    if (it == _fileMappings.end()) {
+    auto it = _mappingStore.find(metaFilePath);
+    if (it == _mappingStore.end()) {
         return { false, {} };
     }
 
@@ -1521,6 +1428,21 @@ std::pair<bool, AssetMeta> AssetServer::readMetaFile(AssetUtils::AssetHash hash)
 }
 
 bool AssetServer::writeMetaFile(AssetUtils::AssetHash originalAssetHash, const AssetMeta& meta) {
+    AssetMappingStore::Transaction transaction;
+    if (!writeMetaFile(originalAssetHash, meta, transaction)) {
+        return false;
+    }
+
+    // attempt to persist the mapping, the store only changes if it succeeds
+    if (!_mappingStore.commit(transaction)) {
+        qCWarning(asset_server) << "Failed to persist the meta file mapping for" << originalAssetHash;
+        return false;
+    }
+    return true;
+}
+
+bool AssetServer::writeMetaFile(AssetUtils::AssetHash originalAssetHash, const AssetMeta& meta,
+                                AssetMappingStore::Transaction& transaction) {
     // construct the JSON that will be in the meta file
     QJsonObject metaFileObject;
 
@@ -1547,22 +1469,32 @@ bool AssetServer::writeMetaFile(AssetUtils::AssetHash originalAssetHash, const A
         // add a mapping to the meta file so it doesn't get deleted because it is unmapped
         auto metaFileMapping = AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER + originalAssetHash + "/" + "meta.json";
 
-        return setMapping(metaFileMapping, metaFileHash);
+        return addSetMapping(transaction, metaFileMapping, metaFileHash);
     } else {
         return false;
     }
 }
 
 bool AssetServer::setBakingEnabled(const AssetUtils::AssetPathList& paths, bool enabled) {
+    // the mappings of all the paths change in one transaction
+    AssetMappingStore::Transaction transaction;
+    QSet<AssetUtils::AssetHash> hashesToCheckForDeletion;
+    QSet<AssetUtils::AssetHash> changedHashes;
+    std::vector<std::pair<AssetUtils::AssetPath, AssetUtils::AssetHash>> assetsToBake;
+
     for (const auto& path : paths) {
-        auto it = _fileMappings.find(path);
-        if (it != _fileMappings.end()) {
+        auto it = _mappingStore.find(path);
+        if (it != _mappingStore.end()) {
             auto type = assetTypeForFilename(path);
             if (type == BakedAssetType::Undefined) {
                 continue;
             }
 
             auto hash = it->second;
+            if (changedHashes.contains(hash)) {
+                // another of the paths maps to the same asset
+                continue;
+            }
 
             bool loaded;
             AssetMeta meta;
@@ -1574,20 +1506,33 @@ bool AssetServer::setBakingEnabled(const AssetUtils::AssetPathList& paths, bool
                 bakedMapping = meta.redirectTarget;
             }
 
-            auto it = _fileMappings.find(bakedMapping);
-            bool currentlyDisabled = (it != _fileMappings.end() && it->second == hash);
+            auto it = _mappingStore.find(bakedMapping);
+            bool currentlyDisabled = (it != _mappingStore.end() && it->second == hash);
 
             if (enabled && currentlyDisabled) {
-                QStringList bakedMappings{ bakedMapping };
-                deleteMappings(bakedMappings);
-                maybeBake(path, hash);
+                addDeleteMappings(transaction, { bakedMapping }, hashesToCheckForDeletion);
+                assetsToBake.push_back({ path, hash });
+                changedHashes << hash;
                 qDebug() << "Enabled baking for" << path;
             } else if (!enabled && !currentlyDisabled) {
-                removeBakedPathsForDeletedAsset(hash);
-                setMapping(bakedMapping, hash);
+                addDeleteMappings(transaction, { AssetUtils::HIDDEN_BAKED_CONTENT_FOLDER + hash + "/" },
+                                  hashesToCheckForDeletion);
+                addSetMapping(transaction, bakedMapping, hash);
+                changedHashes << hash;
                 qDebug() << "Disabled baking for" << path;
             }
         }
     }
+
+    // attempt to persist the changes, the store only changes if it succeeds
+    if (!_mappingStore.commit(transaction)) {
+        qCWarning(asset_server) << "Failed to persist baking changes";
+        return false;
+    }
+
+    deleteUnmappedFiles(hashesToCheckForDeletion);
+    for (const auto& asset : assetsToBake) {
+        maybeBake(asset.first, asset.second);
+    }
     return true;
 }
@@ -13,20 +13,22 @@
 #define hifi_AssetServer_h
 
 #include <QtCore/QDir>
+#include <QtCore/QSet>
 #include <QtCore/QThreadPool>
 #include <QRunnable>
 
+#include <BakeVersions.h>
+#include <SharedUtil.h>
 #include <ThreadedAssignment.h>
 
+#include "AssetMappingStore.h"
 #include "AssetUtils.h"
+#include "HotAssetCache.h"
+#include "OvenWorkerPool.h"
 #include "ReceivedMessage.h"
 
 #include "RegisteredMetaTypes.h"
 
-using BakeVersion = int;
-static const BakeVersion INITIAL_BAKE_VERSION = 0;
-static const BakeVersion NEEDS_BAKING_BAKE_VERSION = -1;
-
 enum class BakedAssetType : int {
     Model = 0,
     Texture,
@@ -36,31 +38,6 @@ enum class BakedAssetType : int {
     Undefined
 };
 
-// ATTENTION! Do not remove baking versions, and do not reorder them. If you add
-// a new value, it will immediately become the "current" version.
-enum class ModelBakeVersion : BakeVersion {
-    Initial = INITIAL_BAKE_VERSION,
-    MetaTextureJson,
-
-    COUNT
-};
-
-// ATTENTION! See above.
-enum class TextureBakeVersion : BakeVersion {
-    Initial = INITIAL_BAKE_VERSION,
-    MetaTextureJson,
-
-    COUNT
-};
-
-// ATTENTION! See above.
-enum class ScriptBakeVersion : BakeVersion {
-    Initial = INITIAL_BAKE_VERSION,
-    FixEmptyScripts,
-
-    COUNT
-};
-
 struct AssetMeta {
     BakeVersion bakeVersion { INITIAL_BAKE_VERSION };
     bool failedLastBake { false };
@@ -68,7 +45,6 @@ struct AssetMeta {
     QString redirectTarget;
 };
 
-class BakeAssetTask;
 
 class AssetServer : public ThreadedAssignment {
     Q_OBJECT
@@ -106,14 +82,23 @@ private:
 
     // Mapping file operations must be called from main assignment thread only
     bool loadMappingsFromFile();
-    bool writeMappingsToFile();
 
     /// Set the mapping for path to hash
     bool setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash);
 
+    /// Add setting the mapping for path to hash to `transaction`. Returns `false` if the path or hash is invalid.
+    bool addSetMapping(AssetMappingStore::Transaction& transaction, AssetUtils::AssetPath path, const AssetUtils::AssetHash& hash);
+
     /// Delete mapping `path`. Returns `true` if deletion of mappings succeeds, else `false`.
     bool deleteMappings(const AssetUtils::AssetPathList& paths);
 
+    /// Add deleting mappings `paths` to `transaction`, and the hashes they map to to `hashes`
+    void addDeleteMappings(AssetMappingStore::Transaction& transaction, const AssetUtils::AssetPathList& paths,
+                           QSet<AssetUtils::AssetHash>& hashes);
+
+    /// Delete the files of `hashes` that no path maps to anymore, once the deletion of their mappings is committed
+    void deleteUnmappedFiles(const QSet<AssetUtils::AssetHash>& hashes);
+
     /// Rename mapping from `oldPath` to `newPath`. Returns true if successful
     bool renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::AssetPath newPath);
 
@@ -130,11 +115,13 @@ private:
     std::pair<AssetUtils::BakingStatus, QString> getAssetStatus(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
 
     void bakeAssets();
-    void maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
+    void maybeBake(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash,
+                   OvenWorkerPool::Priority priority = OvenWorkerPool::NORMAL);
     void createEmptyMetaFile(const AssetUtils::AssetHash& hash);
     bool hasMetaFile(const AssetUtils::AssetHash& hash);
     bool needsToBeBaked(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& assetHash);
-    void bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath);
+    void bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath, const QString& filePath,
+                   OvenWorkerPool::Priority priority);
 
     /// Move baked content for asset to baked directory and update baked status
     void handleCompletedBake(QString originalAssetHash, QString assetPath, QString bakedTempOutputDir);
@@ -144,20 +131,30 @@ private:
     /// Create meta file to describe baked content for original asset
     std::pair<bool, AssetMeta> readMetaFile(AssetUtils::AssetHash hash);
     bool writeMetaFile(AssetUtils::AssetHash originalAssetHash, const AssetMeta& meta = AssetMeta());
+    /// Create the meta file, and add its mapping to `transaction`
+    bool writeMetaFile(AssetUtils::AssetHash originalAssetHash, const AssetMeta& meta, AssetMappingStore::Transaction& transaction);
 
     /// Remove baked paths when the original asset is deleteds
     void removeBakedPathsForDeletedAsset(AssetUtils::AssetHash originalAssetHash);
 
-    AssetUtils::Mappings _fileMappings;
+    AssetMappingStore _mappingStore;
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
+    /// Mappings of the files of the assets we sent lately, outliving the tasks that send from them
+    HotAssetCache _hotAssetCache;
+    quint64 _lastStatsTime { usecTimestampNow() };
+    uint64_t _lastStatsBytesServed { 0 };
+    uint64_t _lastStatsHotAssetHits { 0 };
+    uint64_t _lastStatsHotAssetMisses { 0 };
+
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
-    QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
-    QThreadPool _bakingTaskPool;
+    /// Persistent oven processes baking the assets that need it
+    OvenWorkerPool _ovenWorkerPool;
+    uint64_t _lastStatsBakesCompleted { 0 };
 
     QMutex _queuedRequestsMutex;
     bool _isQueueingRequests { true };
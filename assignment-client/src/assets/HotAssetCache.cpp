@@ -0,0 +1,92 @@
+//
+//  HotAssetCache.cpp
+//  assignment-client/src/assets
+//
+//  Created on 2019-11-29.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HotAssetCache.h"
+
+#include "AssetServerLogging.h"
+
+HotAssetCache::MappedAssetPointer HotAssetCache::get(const AssetUtils::AssetHash& hash, const QString& filePath) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(hash);
+        if (it != _entries.end()) {
+            ++_hits;
+            _lru.splice(_lru.begin(), _lru, it->lruPosition);
+            return it->asset;
+        }
+        ++_misses;
+    }
+
+    // map it without holding up the hits of the other tasks
+    MappedAssetPointer asset = map(filePath);
+    if (!asset || asset->getSize() > _budget) {
+        return asset;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        // another task mapped it first
+        return it->asset;
+    }
+    _lru.push_front(hash);
+    _entries.insert(hash, { asset, _lru.begin() });
+    _residentBytes += asset->getSize();
+    evict();
+    return asset;
+}
+
+void HotAssetCache::remove(const AssetUtils::AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        _residentBytes -= it->asset->getSize();
+        _lru.erase(it->lruPosition);
+        _entries.erase(it);
+    }
+}
+
+HotAssetCache::Stats HotAssetCache::getStats() const {
+    Stats stats;
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.numEntries = _entries.size();
+    stats.residentBytes = _residentBytes;
+    stats.bytesServed = _bytesServed;
+    return stats;
+}
+
+HotAssetCache::MappedAssetPointer HotAssetCache::map(const QString& filePath) {
+    std::unique_ptr<QFile> file { new QFile(filePath) };
+    if (!file->open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    qint64 size = file->size();
+    const uchar* data = nullptr;
+    if (size > 0) {
+        data = file->map(0, size);
+        if (!data) {
+            qCWarning(asset_server) << "Failed to map" << filePath << ":" << file->errorString();
+            return nullptr;
+        }
+    }
+    return std::make_shared<MappedAsset>(std::move(file), data, size);
+}
+
+void HotAssetCache::evict() {
+    while (_residentBytes > _budget) {
+        auto it = _entries.find(_lru.back());
+        _residentBytes -= it->asset->getSize();
+        _entries.erase(it);
+        _lru.pop_back();
+    }
+}
@@ -0,0 +1,92 @@
+//
+//  HotAssetCache.h
+//  assignment-client/src/assets
+//
+//  Created on 2019-11-29.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HotAssetCache_h
+#define hifi_HotAssetCache_h
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+#include <AssetUtils.h>
+
+// The asset files the asset server sent lately, memory mapped, so that serving them again is a copy from the mapping
+// into the reply packets instead of an open, a seek and a read. Assets never change once uploaded, they're named by
+// the hash of their content, so a mapping stays good until the file is deleted.
+//
+// The mappings are reference counted: one that's evicted, least recently used first once the resident bytes go over
+// the budget, stays mapped until the last task sending from it is done with it.
+class HotAssetCache {
+public:
+    class MappedAsset {
+    public:
+        MappedAsset(std::unique_ptr<QFile> file, const uchar* data, qint64 size) :
+            _file(std::move(file)), _data(data), _size(size) {}
+
+        const uchar* getData() const { return _data; }
+        qint64 getSize() const { return _size; }
+
+    private:
+        std::unique_ptr<QFile> _file; // unmaps when closed
+        const uchar* _data;
+        qint64 _size;
+    };
+    using MappedAssetPointer = std::shared_ptr<const MappedAsset>;
+
+    struct Stats {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        size_t numEntries { 0 };
+        qint64 residentBytes { 0 };
+        uint64_t bytesServed { 0 };
+    };
+
+    static const qint64 DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+    HotAssetCache(qint64 budget = DEFAULT_BUDGET) : _budget(budget) {}
+
+    // returns the mapping of the file at filePath for the asset, or nullptr if it can't be opened; files bigger than
+    // the budget are mapped for the caller alone
+    MappedAssetPointer get(const AssetUtils::AssetHash& hash, const QString& filePath);
+
+    // to call before the file of the asset is deleted
+    void remove(const AssetUtils::AssetHash& hash);
+
+    void assetServed(qint64 numBytes) { _bytesServed += numBytes; }
+
+    Stats getStats() const;
+
+private:
+    static MappedAssetPointer map(const QString& filePath);
+    void evict(); // with the mutex locked
+
+    struct Entry {
+        MappedAssetPointer asset;
+        std::list<AssetUtils::AssetHash>::iterator lruPosition;
+    };
+
+    const qint64 _budget;
+
+    mutable std::mutex _mutex;
+    QHash<AssetUtils::AssetHash, Entry> _entries;
+    std::list<AssetUtils::AssetHash> _lru; // most recently used first
+    qint64 _residentBytes { 0 };
+    uint64_t _hits { 0 };
+    uint64_t _misses { 0 };
+
+    std::atomic<uint64_t> _bytesServed { 0 };
+};
+
+#endif // hifi_HotAssetCache_h
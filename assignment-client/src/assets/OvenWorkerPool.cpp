@@ -0,0 +1,324 @@
+//
+//  OvenWorkerPool.cpp
+//  assignment-client/src/assets
+//
+//  Created on 2019-11-30.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OvenWorkerPool.h"
+
+#include <algorithm>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <PathUtils.h>
+
+#include "AssetServerLogging.h"
+
+static const int OVEN_STATUS_CODE_SUCCESS { 0 };
+static const int OVEN_STATUS_CODE_FAIL { 1 };
+static const int OVEN_STATUS_CODE_ABORT { 2 };
+
+static const QString OVEN_WORKER_PARAMETER = "--worker";
+static const QByteArray OVEN_JOB_RESULT_PREFIX = "OVEN_JOB_RESULT ";
+static const QString OVEN_ERROR_FILENAME = "errors.txt";
+
+static const int WORKER_EXIT_TIMEOUT_MSECS = 1000;
+static const int MSECS_PER_SEC = 1000;
+
+static void deleteOutputDir(const QString& outputDir) {
+    if (!outputDir.isEmpty()) {
+        PathUtils::deleteMyTemporaryDir(QDir(outputDir).dirName());
+    }
+}
+
+OvenWorkerPool::OvenWorkerPool(QObject* parent) :
+    QObject(parent),
+    _workers(DEFAULT_NUM_WORKERS)
+{
+}
+
+OvenWorkerPool::~OvenWorkerPool() {
+    for (auto& worker : _workers) {
+        if (worker.process) {
+            worker.process->disconnect(this);
+
+            // with its input closed the worker quits once it's done with what it has
+            worker.process->closeWriteChannel();
+            if (!worker.process->waitForFinished(WORKER_EXIT_TIMEOUT_MSECS)) {
+                worker.process->kill();
+                worker.process->waitForFinished();
+            }
+        }
+    }
+}
+
+void OvenWorkerPool::setNumWorkers(int numWorkers) {
+    for (const auto& worker : _workers) {
+        if (worker.process) {
+            qCWarning(asset_server) << "Cannot change the number of oven workers while they are running";
+            return;
+        }
+    }
+    _workers.clear();
+    _workers.resize(std::max(numWorkers, 1));
+}
+
+void OvenWorkerPool::setJobTimeout(int timeoutSecs) {
+    _jobTimeoutSecs = std::max(timeoutSecs, 1);
+}
+
+bool OvenWorkerPool::queueBake(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath,
+                               const QString& filePath, Priority priority) {
+    if (_jobs.contains(assetHash)) {
+        prioritize(assetHash, priority);
+        return false;
+    }
+
+    Job job;
+    job.hash = assetHash;
+    job.path = assetPath;
+    job.filePath = filePath;
+    job.queueKey = { -priority, _nextSequenceNumber++ };
+    _queue[job.queueKey] = assetHash;
+    _jobs.insert(assetHash, job);
+
+    dispatch();
+    return true;
+}
+
+void OvenWorkerPool::prioritize(const AssetUtils::AssetHash& assetHash, Priority priority) {
+    auto it = _jobs.find(assetHash);
+    if (it == _jobs.end() || it->isBaking || -it->queueKey.first >= priority) {
+        return;
+    }
+
+    // keep its place among the bakes of its new priority that were queued after it
+    _queue.erase(it->queueKey);
+    it->queueKey.first = -priority;
+    _queue[it->queueKey] = assetHash;
+}
+
+bool OvenWorkerPool::isBaking(const AssetUtils::AssetHash& assetHash) const {
+    auto it = _jobs.find(assetHash);
+    return it != _jobs.end() && it->isBaking;
+}
+
+void OvenWorkerPool::abortAll() {
+    // empty the queue first, nothing should go out to a worker from the handlers
+    auto queue = std::move(_queue);
+    _queue.clear();
+    for (const auto& entry : queue) {
+        auto job = _jobs.take(entry.second);
+        emit bakeAborted(job.hash, job.path);
+    }
+
+    for (auto& worker : _workers) {
+        if (!worker.currentJob.isEmpty()) {
+            qCDebug(asset_server) << "Terminating oven worker baking" << worker.currentJob;
+            _jobs[worker.currentJob].wasAborted = true;
+            worker.process->terminate();
+        }
+    }
+}
+
+OvenWorkerPool::Stats OvenWorkerPool::getStats() const {
+    Stats stats;
+    stats.numWorkers = (int)_workers.size();
+    stats.numQueued = (int)_queue.size();
+    for (const auto& worker : _workers) {
+        if (!worker.currentJob.isEmpty()) {
+            ++stats.numBaking;
+        }
+    }
+    stats.numCompleted = _numCompleted;
+    stats.numFailed = _numFailed;
+    stats.numWorkerCrashes = _numWorkerCrashes;
+    stats.numTextureCacheHits = _numTextureCacheHits;
+    stats.numTextureCacheMisses = _numTextureCacheMisses;
+    stats.textureCacheSavedUsecs = _textureCacheSavedUsecs;
+    return stats;
+}
+
+void OvenWorkerPool::dispatch() {
+    for (size_t index = 0; index < _workers.size(); ++index) {
+        while (_workers[index].currentJob.isEmpty() && !_queue.empty()) {
+            auto next = _queue.begin();
+            auto assetHash = next->second;
+            _queue.erase(next);
+
+            // the worker bakes into a temporary directory of ours, which we move the results out of afterwards
+            auto outputDir = PathUtils::generateTemporaryDir();
+            if (outputDir.isEmpty()) {
+                failJob(_jobs.take(assetHash), "Could not create temporary working directory");
+                continue;
+            }
+            _jobs[assetHash].outputDir = outputDir;
+
+            if (!_workers[index].process && !startWorker(index)) {
+                failJob(_jobs.take(assetHash), "Oven process failed to start");
+                continue;
+            }
+
+            auto& job = _jobs[assetHash];
+            QJsonObject message {
+                { "hash", job.hash },
+                { "input", job.filePath },
+                { "name", job.path.split("/").last() },
+                { "output", job.outputDir },
+                { "type", job.path.mid(job.path.lastIndexOf('.') + 1) }
+            };
+
+            qCDebug(asset_server) << "Sending bake of" << job.path << "to oven worker" << index;
+            _workers[index].process->write(QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n");
+            _workers[index].currentJob = assetHash;
+            job.isBaking = true;
+
+            auto& jobTimer = _workers[index].jobTimer;
+            if (!jobTimer) {
+                jobTimer.reset(new QTimer());
+                jobTimer->setSingleShot(true);
+                connect(jobTimer.get(), &QTimer::timeout, this, [this, index] {
+                    handleJobTimeout(index);
+                });
+            }
+            jobTimer->start(_jobTimeoutSecs * MSECS_PER_SEC);
+        }
+    }
+}
+
+bool OvenWorkerPool::startWorker(size_t index) {
+    auto base = QFileInfo(QCoreApplication::applicationFilePath()).absoluteDir();
+    QString path = base.absolutePath() + "/oven";
+
+    std::unique_ptr<QProcess> process { new QProcess() };
+    process->setStandardErrorFile(QProcess::nullDevice());
+
+    connect(process.get(), &QProcess::readyReadStandardOutput, this, [this, index] {
+        handleWorkerOutput(index);
+    });
+    connect(process.get(), static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            this, [this, index](int exitCode, QProcess::ExitStatus exitStatus) {
+        handleWorkerFinished(index, exitCode, exitStatus);
+    });
+
+    process->start(path, { OVEN_WORKER_PARAMETER });
+    if (!process->waitForStarted()) {
+        qCWarning(asset_server) << "Failed to start oven worker" << path << ":" << process->errorString();
+        return false;
+    }
+
+    qCDebug(asset_server) << "Started oven worker" << index;
+    _workers[index].process = std::move(process);
+    return true;
+}
+
+void OvenWorkerPool::handleWorkerOutput(size_t index) {
+    auto& worker = _workers[index];
+    while (worker.process && worker.process->canReadLine()) {
+        auto line = worker.process->readLine().trimmed();
+
+        // the rest is the worker's log
+        if (!line.startsWith(OVEN_JOB_RESULT_PREFIX)) {
+            continue;
+        }
+
+        // asset hash, status code, then the baked texture cache stats of the job
+        auto fields = line.mid(OVEN_JOB_RESULT_PREFIX.size()).split(' ');
+        if (fields.size() < 2 || fields[0] != worker.currentJob) {
+            qCWarning(asset_server) << "Unexpected result from oven worker" << index << ":" << line;
+            continue;
+        }
+        if (fields.size() >= 5) {
+            _numTextureCacheHits += fields[2].toULongLong();
+            _numTextureCacheMisses += fields[3].toULongLong();
+            _textureCacheSavedUsecs += fields[4].toULongLong();
+        }
+
+        finishJob(index, fields[1].toInt());
+    }
+}
+
+void OvenWorkerPool::handleWorkerFinished(size_t index, int exitCode, QProcess::ExitStatus exitStatus) {
+    auto& worker = _workers[index];
+    worker.process.release()->deleteLater();
+    if (worker.jobTimer) {
+        worker.jobTimer->stop();
+    }
+
+    if (!worker.currentJob.isEmpty()) {
+        auto job = _jobs.take(worker.currentJob);
+        worker.currentJob.clear();
+
+        if (job.wasAborted) {
+            deleteOutputDir(job.outputDir);
+            emit bakeAborted(job.hash, job.path);
+        } else if (job.timedOut) {
+            failJob(job, QString("Bake did not finish within %1 seconds").arg(_jobTimeoutSecs));
+        } else {
+            qCWarning(asset_server) << "Oven worker" << index << "exited while baking" << job.path << ":"
+                << exitCode << exitStatus;
+            ++_numWorkerCrashes;
+            failJob(job, "Fatal error occurred while baking");
+        }
+    }
+
+    // whatever is still queued goes to a new worker
+    dispatch();
+}
+
+void OvenWorkerPool::handleJobTimeout(size_t index) {
+    auto& worker = _workers[index];
+    if (worker.currentJob.isEmpty() || !worker.process) {
+        return;
+    }
+
+    // the job is failed once the worker has exited, in handleWorkerFinished
+    auto& job = _jobs[worker.currentJob];
+    qCWarning(asset_server) << "Killing oven worker" << index << "after baking" << job.path << "for"
+        << _jobTimeoutSecs << "seconds";
+    job.timedOut = true;
+    worker.process->kill();
+}
+
+void OvenWorkerPool::finishJob(size_t index, int statusCode) {
+    auto& worker = _workers[index];
+    worker.jobTimer->stop();
+    auto job = _jobs.take(worker.currentJob);
+    worker.currentJob.clear();
+
+    if (statusCode == OVEN_STATUS_CODE_SUCCESS) {
+        ++_numCompleted;
+        emit bakeComplete(job.hash, job.path, job.outputDir);
+    } else if (statusCode == OVEN_STATUS_CODE_ABORT) {
+        deleteOutputDir(job.outputDir);
+        emit bakeAborted(job.hash, job.path);
+    } else {
+        QString errors;
+        QFile errorFile { QDir(job.outputDir).absoluteFilePath(OVEN_ERROR_FILENAME) };
+        if (errorFile.open(QIODevice::ReadOnly)) {
+            errors = errorFile.readAll();
+            errorFile.close();
+        } else {
+            errors = "Unknown error occurred while baking";
+        }
+        failJob(job, errors);
+    }
+
+    dispatch();
+}
+
+void OvenWorkerPool::failJob(const Job& job, const QString& errors) {
+    deleteOutputDir(job.outputDir);
+
+    ++_numFailed;
+    emit bakeFailed(job.hash, job.path, errors);
+}
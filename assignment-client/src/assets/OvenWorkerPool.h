@@ -0,0 +1,130 @@
+//
+//  OvenWorkerPool.h
+//  assignment-client/src/assets
+//
+//  Created on 2019-11-30.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OvenWorkerPool_h
+#define hifi_OvenWorkerPool_h
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QProcess>
+#include <QtCore/QTimer>
+
+#include <AssetUtils.h>
+
+// Bakes assets with a fixed number of long running oven processes (started with --worker), feeding each of them one
+// job at a time over its stdin. A worker that crashes fails the bake it was on and is started again for the next one,
+// so a bad asset still can't take the asset server down with it, and one that hangs is killed once its bake has run for
+// the job timeout. Queued bakes go out highest priority first, and in
+// the order they were queued within a priority.
+class OvenWorkerPool : public QObject {
+    Q_OBJECT
+public:
+    enum Priority : int {
+        BACKGROUND = 0, // re-bakes of the assets we already had when starting up
+        NORMAL, // assets that were just mapped
+        REQUESTED // assets a client asked for while their bake was pending
+    };
+
+    struct Stats {
+        int numWorkers { 0 };
+        int numQueued { 0 };
+        int numBaking { 0 };
+        uint64_t numCompleted { 0 };
+        uint64_t numFailed { 0 };
+        uint64_t numWorkerCrashes { 0 };
+
+        // textures the workers found already baked in their baked texture cache, and the processing time it saved
+        uint64_t numTextureCacheHits { 0 };
+        uint64_t numTextureCacheMisses { 0 };
+        uint64_t textureCacheSavedUsecs { 0 };
+    };
+
+    static const int DEFAULT_NUM_WORKERS = 2;
+    static const int DEFAULT_JOB_TIMEOUT_SECS = 30 * 60;
+
+    OvenWorkerPool(QObject* parent = nullptr);
+    ~OvenWorkerPool();
+
+    // only takes effect while no worker is running
+    void setNumWorkers(int numWorkers);
+
+    // applies to the bakes sent out after the call
+    void setJobTimeout(int timeoutSecs);
+
+    // returns false if the asset is already queued or baking
+    bool queueBake(const AssetUtils::AssetHash& assetHash, const AssetUtils::AssetPath& assetPath,
+                   const QString& filePath, Priority priority = NORMAL);
+
+    // moves a queued bake up to priority, if it was queued lower
+    void prioritize(const AssetUtils::AssetHash& assetHash, Priority priority);
+
+    bool isPending(const AssetUtils::AssetHash& assetHash) const { return _jobs.contains(assetHash); }
+    bool isBaking(const AssetUtils::AssetHash& assetHash) const;
+    int getNumPending() const { return _jobs.size(); }
+
+    // drops the queued bakes and terminates the workers on the others, bakeAborted is emitted for each
+    void abortAll();
+
+    Stats getStats() const;
+
+signals:
+    void bakeComplete(QString assetHash, QString assetPath, QString tempOutputDir);
+    void bakeFailed(QString assetHash, QString assetPath, QString errors);
+    void bakeAborted(QString assetHash, QString assetPath);
+
+private:
+    // sorts by descending priority, then by the order the bakes were queued in
+    using QueueKey = std::pair<int, uint64_t>;
+
+    struct Job {
+        AssetUtils::AssetHash hash;
+        AssetUtils::AssetPath path;
+        QString filePath;
+        QueueKey queueKey;
+        QString outputDir;
+        bool isBaking { false };
+        bool wasAborted { false };
+        bool timedOut { false };
+    };
+
+    struct Worker {
+        std::unique_ptr<QProcess> process;
+        AssetUtils::AssetHash currentJob;
+        std::unique_ptr<QTimer> jobTimer;
+    };
+
+    void dispatch();
+    bool startWorker(size_t index);
+    void handleWorkerOutput(size_t index);
+    void handleWorkerFinished(size_t index, int exitCode, QProcess::ExitStatus exitStatus);
+    void handleJobTimeout(size_t index);
+    void finishJob(size_t index, int statusCode);
+    void failJob(const Job& job, const QString& errors);
+
+    std::vector<Worker> _workers;
+    QHash<AssetUtils::AssetHash, Job> _jobs; // queued and baking
+    std::map<QueueKey, AssetUtils::AssetHash> _queue;
+    uint64_t _nextSequenceNumber { 0 };
+    int _jobTimeoutSecs { DEFAULT_JOB_TIMEOUT_SECS };
+
+    uint64_t _numCompleted { 0 };
+    uint64_t _numFailed { 0 };
+    uint64_t _numWorkerCrashes { 0 };
+    uint64_t _numTextureCacheHits { 0 };
+    uint64_t _numTextureCacheMisses { 0 };
+    uint64_t _textureCacheSavedUsecs { 0 };
+};
+
+#endif // hifi_OvenWorkerPool_h
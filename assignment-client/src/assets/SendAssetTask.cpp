@@ -13,8 +13,6 @@
 
 #include <cmath>
 
-#include <QFile>
-
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
@@ -26,11 +24,13 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             HotAssetCache& hotAssetCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _hotAssetCache(hotAssetCache)
 {
     
 }
@@ -64,17 +64,19 @@ void SendAssetTask::run() {
         replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
 
-        if (file.open(QIODevice::ReadOnly)) {
+        // the file of a hot asset is already mapped, we send from the mapping of whoever asked for it first
+        auto mappedAsset = _hotAssetCache.get(hexHash, filePath);
+
+        if (mappedAsset) {
+            qint64 fileSize = mappedAsset->getSize();
 
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(fileSize);
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (fileSize < byteRange.fromInclusive || fileSize < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,29 +84,16 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
-
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
-
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
-
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
+                // a positive range starts that far into the file, a negative one that far back from its end
+                qint64 start = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : fileSize + byteRange.fromInclusive;
 
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
-                }
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+                replyPacketList->write((const char*)mappedAsset->getData() + start, size);
+                _hotAssetCache.assetServed(size);
 
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
             qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
             replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
@@ -19,13 +19,15 @@
 
 #include "AssetUtils.h"
 #include "AssetServer.h"
+#include "HotAssetCache.h"
 #include "Node.h"
 
 class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  HotAssetCache& hotAssetCache);
 
     void run() override;
 
@@ -33,6 +35,7 @@ private:
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    HotAssetCache& _hotAssetCache;
 };
 
 #endif
@@ -21,11 +21,12 @@
 #include "ClientServerUtils.h"
 
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir, uint64_t filesizeLimit) :
+                                 const QDir& resourcesDir, uint64_t filesizeLimit, HotAssetCache& hotAssetCache) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
     _resourcesDir(resourcesDir),
-    _filesizeLimit(filesizeLimit)
+    _filesizeLimit(filesizeLimit),
+    _hotAssetCache(hotAssetCache)
 {
     
 }
@@ -81,6 +82,11 @@ void UploadAssetTask::run() {
             } else {
                 qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
                 file.close();
+
+                // drop the mapping of the bad contents, and write a new file rather than truncating the one
+                // that sends still in flight have mapped
+                _hotAssetCache.remove(QString(hexHash));
+                file.remove();
             }
         }
 
@@ -282,6 +282,18 @@ void AudioMixer::sendStatsPacket() {
 
     statsObject["threads"] = _slavePool.numThreads();
 
+    // how much of the parallel part of each frame every slave spent working
+    QJsonArray threadStats;
+    for (auto& stats : _slavePool.sampleThreadStats()) {
+        QJsonObject thread;
+        thread["utilization"] = QString::number(stats.utilization() * 100.0f, 'f', 2);
+        thread["jobs_per_frame"] = (float)stats.jobs / (float)_numStatFrames;
+        thread["steals_per_frame"] = (float)stats.steals / (float)_numStatFrames;
+        thread["parks"] = (qint64)stats.parks;
+        threadStats.push_back(thread);
+    }
+    statsObject["thread_utilization"] = threadStats;
+
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
     statsObject["throttling_ratio"] = _throttlingRatio;
 
@@ -338,12 +350,21 @@ void AudioMixer::sendStatsPacket() {
     mixStats["3_active_to_skippped"] = (int)(_stats.activeToSkipped / (float)_numStatFrames);
     mixStats["3_active_to_inactive"] = (int)(_stats.activeToInactive / (float)_numStatFrames);
 
+    mixStats["4_exact_source_mixes"] = (int)(_stats.exactSourceMixes / (float)_numStatFrames);
+    mixStats["4_approximate_source_mixes"] = (int)(_stats.approximateSourceMixes / (float)_numStatFrames);
+    mixStats["4_far_field_cell_mixes"] = (int)(_stats.farFieldCellMixes / (float)_numStatFrames);
+    mixStats["4_far_field_renders"] = (int)(_stats.farFieldRenders / (float)_numStatFrames);
+
+    mixStats["5_packet_buffers_pooled"] = (int)(_stats.packetBuffersPooled / (float)_numStatFrames);
+    mixStats["5_packet_buffers_allocated"] = (int)(_stats.packetBuffersAllocated / (float)_numStatFrames);
+
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
 
     statsObject["mix_stats"] = mixStats;
 
-    _numStatFrames = _numSilentPackets = 0;
+    _numStatFrames = 0;
+    _numSilentPackets = 0;
     _stats.reset();
 
     // add stats for each listerner
@@ -461,6 +482,12 @@ void AudioMixer::start() {
         nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
             // mix across slave threads
             auto mixTimer = _mixTiming.timer();
+
+            // sum the far field cells once for all listeners, the slaves don't use them while throttling
+            if (_workerSharedData.farField.isEnabled() && numToRetain == -1) {
+                _workerSharedData.farField.prepareFrame(cbegin, cend);
+            }
+
             _slavePool.mix(cbegin, cend, frame, numToRetain);
         });
 
@@ -588,6 +615,22 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
         }
 
         qCDebug(audio) << "Throttle Start:" << _throttleStartTarget << "Throttle Backoff:" << _throttleBackoffTarget;
+
+        const QString FAR_FIELD_MIXING_KEY = "far_field_mixing";
+        const QString FAR_FIELD_EXACT_SOURCES_KEY = "far_field_exact_sources";
+        const QString FAR_FIELD_CELL_SIZE_KEY = "far_field_cell_size";
+
+        auto& farField = _workerSharedData.farField;
+        farField.setEnabled(audioThreadingGroupObject[FAR_FIELD_MIXING_KEY].toBool(false));
+        farField.setNumExactSources(audioThreadingGroupObject[FAR_FIELD_EXACT_SOURCES_KEY]
+                                        .toInt(AudioMixerFarField::DEFAULT_NUM_EXACT_SOURCES));
+        farField.setCellSize(audioThreadingGroupObject[FAR_FIELD_CELL_SIZE_KEY]
+                                 .toDouble(AudioMixerFarField::DEFAULT_CELL_SIZE));
+
+        if (farField.isEnabled()) {
+            qCDebug(audio) << "Far field mixing enabled - exact sources:" << farField.getNumExactSources()
+                << "cell size:" << farField.getCellSize();
+        }
     }
 
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
@@ -100,7 +100,7 @@ private:
     float _trailingMixRatio { 0.0f };
     float _throttlingRatio { 0.0f };
 
-    int _numSilentPackets { 0 };
+    std::atomic<int> _numSilentPackets { 0 }; // counted by whichever thread handles the packet
 
     int _numStatFrames { 0 };
     AudioMixerStats _stats;
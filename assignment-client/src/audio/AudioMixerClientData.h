@@ -19,6 +19,7 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioFOA.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
@@ -89,6 +90,10 @@ public:
 
     AudioLimiter audioLimiter;
 
+    // decodes the far field cells mixed for this listener (see AudioMixerFarField)
+    AudioFOA farFieldRenderer;
+    bool farFieldRendered { false };
+
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
     void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
@@ -121,6 +126,10 @@ public:
         bool ignoredByListener { false };
         bool ignoringListener { false };
 
+        // far field state, see AudioMixerFarField
+        int farFieldCell { -1 };
+        bool isMixedApproximately { false };
+
         MixableStream(NodeIDStreamID nodeIDStreamID, PositionalAudioStream* positionalStream) :
             nodeStreamID(nodeIDStreamID), hrtf(new AudioHRTF), positionalStream(positionalStream) {};
         MixableStream(QUuid nodeID, Node::LocalID localNodeID, StreamID streamID, PositionalAudioStream* positionalStream) :
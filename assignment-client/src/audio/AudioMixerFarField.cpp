@@ -0,0 +1,96 @@
+//
+//  AudioMixerFarField.cpp
+//  assignment-client/src/audio
+//
+//  Created on 2019-11-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerFarField.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "AudioMixerClientData.h"
+
+const float AudioMixerFarField::DEFAULT_CELL_SIZE = 8.0f; // meters
+
+// the listener applies distance attenuation per cell, but the off-axis attenuation of each talker depends on where
+// the listener is - use the middle of its range (0.2 to 1.0) for every talker in a cell
+static const float FAR_FIELD_OFF_AXIS_COEFFICIENT = 0.6f;
+
+static uint64_t cellKey(const glm::vec3& position, float cellSize) {
+    // 21 bits per axis covers +/- 8M meters with the smallest cell size
+    const uint64_t AXIS_MASK = (1 << 21) - 1;
+    auto cell = glm::ivec3(glm::floor(position / cellSize));
+    return (((uint64_t)cell.x & AXIS_MASK) << 42) | (((uint64_t)cell.y & AXIS_MASK) << 21) | ((uint64_t)cell.z & AXIS_MASK);
+}
+
+void AudioMixerFarField::prepareFrame(ConstIter begin, ConstIter end) {
+    _numCells = 0;
+    _cellIndices.clear();
+    _streamCells.clear();
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        auto nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        for (auto& stream : nodeData->getAudioStreams()) {
+            // injectors and stereo streams are rare and have their own gain rules, they are always mixed exactly
+            if (stream->getType() == PositionalAudioStream::Microphone && !stream->isStereo() &&
+                stream->lastPopSucceeded() && stream->getLastPopOutputLoudness() != 0.0f) {
+                addStream(*stream);
+            }
+        }
+    });
+
+    for (int i = 0; i < _numCells; ++i) {
+        _cells[i].centroid /= (float)_cells[i].numSources;
+    }
+}
+
+void AudioMixerFarField::addStream(const PositionalAudioStream& stream) {
+    auto key = cellKey(stream.getPosition(), _cellSize);
+    auto it = _cellIndices.find(key);
+
+    int index;
+    if (it != _cellIndices.end()) {
+        index = it->second;
+    } else {
+        index = _numCells++;
+        if (index == (int)_cells.size()) {
+            _cells.emplace_back();
+        }
+        _cellIndices.emplace(key, index);
+
+        auto& cell = _cells[index];
+        cell.centroid = glm::vec3(0.0f);
+        cell.numSources = 0;
+        memset(cell.samples, 0, sizeof(cell.samples));
+    }
+
+    auto& cell = _cells[index];
+    cell.centroid += stream.getPosition();
+    ++cell.numSources;
+
+    static const float SAMPLE_SCALE = FAR_FIELD_OFF_AXIS_COEFFICIENT / 32768.0f;
+
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    AudioRingBuffer::ConstIterator streamPopOutput = stream.getLastPopOutput();
+    streamPopOutput.readSamples(samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+        cell.samples[i] += samples[i] * SAMPLE_SCALE;
+    }
+
+    _streamCells.emplace(&stream, index);
+}
+
+int AudioMixerFarField::cellForStream(const PositionalAudioStream* stream) const {
+    auto it = _streamCells.find(stream);
+    return it != _streamCells.end() ? it->second : -1;
+}
@@ -0,0 +1,77 @@
+//
+//  AudioMixerFarField.h
+//  assignment-client/src/audio
+//
+//  Created on 2019-11-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerFarField_h
+#define hifi_AudioMixerFarField_h
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <NodeList.h>
+
+class PositionalAudioStream;
+
+// Approximate mixing of distant talkers.
+// Once per frame the audible mono avatar streams are binned into a grid of cells, and every cell is summed into one
+// bus that all listeners share. A listener encodes the cells that are far enough away into its own first-order
+// ambisonic field and decodes that with a single AudioFOA render, instead of one AudioHRTF render per talker.
+class AudioMixerFarField {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    static const float DEFAULT_CELL_SIZE;
+    static const int DEFAULT_NUM_EXACT_SOURCES = 16;
+
+    struct Cell {
+        glm::vec3 centroid;
+        int numSources { 0 };
+        float samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    };
+
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    // the closest sources of each listener are always mixed exactly
+    void setNumExactSources(int numExactSources) { _numExactSources = std::max(numExactSources, 0); }
+    int getNumExactSources() const { return _numExactSources; }
+
+    void setCellSize(float cellSize) { _cellSize = std::max(cellSize, 1.0f); }
+    float getCellSize() const { return _cellSize; }
+
+    // bins and sums the streams for this frame, must be called before the mix and not concurrently with it
+    void prepareFrame(ConstIter begin, ConstIter end);
+
+    int getNumCells() const { return _numCells; }
+    const Cell& getCell(int index) const { return _cells[index]; }
+
+    // returns the cell the stream was summed into this frame, or -1 if it has to be mixed exactly
+    int cellForStream(const PositionalAudioStream* stream) const;
+
+private:
+    void addStream(const PositionalAudioStream& stream);
+
+    bool _enabled { false };
+    int _numExactSources { DEFAULT_NUM_EXACT_SOURCES };
+    float _cellSize { DEFAULT_CELL_SIZE };
+
+    // cells are re-used from frame to frame, only the first _numCells are valid
+    std::vector<Cell> _cells;
+    int _numCells { 0 };
+
+    std::unordered_map<uint64_t, int> _cellIndices;
+    std::unordered_map<const PositionalAudioStream*, int> _streamCells;
+};
+
+#endif // hifi_AudioMixerFarField_h
@@ -12,11 +12,13 @@
 #include "AudioMixerSlave.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
+#include <AudioKernels.h>
 #include <LogHandler.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
@@ -41,6 +43,36 @@ using AudioStreamVector = AudioMixerClientData::AudioStreamVector;
 using MixableStream = AudioMixerClientData::MixableStream;
 using MixableStreamsVector = AudioMixerClientData::MixableStreamsVector;
 
+static const int HRTF_DATASET_INDEX = 1;
+
+// far field cell states, per listener
+enum FarFieldCellState : uint8_t {
+    FAR_FIELD_CELL_CANDIDATE,
+    FAR_FIELD_CELL_EXACT,
+    FAR_FIELD_CELL_MIXED
+};
+
+// the far field goes through AudioFOA as 16-bit samples at a fixed scale, its rotation and overlap-save state carry
+// over between frames so the scale and render gain can't change with the content of the frame
+// a cell sums many sources, leave room for the field to go this far above a single full-scale source
+static const float FAR_FIELD_HEADROOM = 4.0f;
+static const float FAR_FIELD_INPUT_SCALE = AudioConstants::MAX_SAMPLE_VALUE / FAR_FIELD_HEADROOM;
+static const float FAR_FIELD_RENDER_GAIN = 32768.0f / FAR_FIELD_INPUT_SCALE;
+
+// beyond this fraction of the headroom, peaks are bent smoothly towards full scale instead of wrapping or clipping
+static const float FAR_FIELD_SOFT_CLIP_KNEE = 0.75f;
+
+static float softClipFarField(float sample) {
+    float magnitude = fabsf(sample);
+    if (magnitude <= FAR_FIELD_SOFT_CLIP_KNEE) {
+        return sample;
+    }
+    // continuous with a slope of one at the knee, and never reaches full scale
+    float excess = (magnitude - FAR_FIELD_SOFT_CLIP_KNEE) / (1.0f - FAR_FIELD_SOFT_CLIP_KNEE);
+    float clipped = FAR_FIELD_SOFT_CLIP_KNEE + (1.0f - FAR_FIELD_SOFT_CLIP_KNEE) * excess / (1.0f + excess);
+    return copysignf(clipped, sample);
+}
+
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
 void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
@@ -52,6 +84,8 @@ void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData&
 inline float approximateGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd);
 inline float computeGain(float masterAvatarGain, float masterInjectorGain, const AvatarAudioStream& listeningNodeStream,
         const PositionalAudioStream& streamToAdd, const glm::vec3& relativePosition, float distance);
+inline float applyDistanceAttenuation(float gain, const glm::vec3& listenerPosition, const glm::vec3& sourcePosition,
+        float distance);
 inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
 
@@ -101,17 +135,17 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
 
         // send audio packet
         if (mixHasAudio || data->shouldFlushEncoder()) {
-            QByteArray encodedBuffer;
             if (mixHasAudio) {
-                // encode the audio
-                QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                data->encode(decodedBuffer, encodedBuffer);
+                // encode the audio, straight from the mix buffer
+                auto decodedBuffer = QByteArray::fromRawData(reinterpret_cast<char*>(_bufferSamples),
+                                                             AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+                data->encode(decodedBuffer, _encodedBuffer);
             } else {
                 // time to flush (resets shouldFlush until the next encode)
-                data->encodeFrameOfZeros(encodedBuffer);
+                data->encodeFrameOfZeros(_encodedBuffer);
             }
 
-            sendMixPacket(node, *data, encodedBuffer);
+            sendMixPacket(node, *data, _encodedBuffer);
         } else {
             ++stats.sumListenersSilent;
             sendSilentPacket(node, *data);
@@ -369,6 +403,11 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         return false;
     });
 
+    bool isMixingFarField = !isThrottling && _sharedData.farField.isEnabled();
+    if (isMixingFarField) {
+        prepareFarFieldCells(*listenerData, *listenerAudioStream, isSoloing);
+    }
+
     // Process active streams
     erase_if(streams.active, [&](MixableStream& stream) {
         if (shouldBeRemoved(stream, _sharedData)) {
@@ -387,8 +426,10 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 return true;
             }
 
-            addStream(stream, *listenerAudioStream, listenerData->getMasterAvatarGain(), listenerData->getMasterInjectorGain(),
-                      isSoloing);
+            if (!isMixingFarField || !mixFarFieldStream(stream)) {
+                addStream(stream, *listenerAudioStream, listenerData->getMasterAvatarGain(),
+                          listenerData->getMasterInjectorGain(), isSoloing);
+            }
 
             if (shouldBeInactive(stream)) {
                 // To reduce artifacts we still call render to flush the HRTF for every silent
@@ -403,6 +444,10 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         return false;
     });
 
+    if (isMixingFarField) {
+        mixFarFieldCells(*listenerData, *listenerAudioStream);
+    }
+
     if (isThrottling) {
         // since we're throttling, we need to partition the mixable into throttled and unthrottled streams
         int numToRetain = min(_numToRetain, (int)streams.active.size()); // Make sure we don't overflow
@@ -475,13 +520,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     // check for silent audio before limiting
     // limiting uses a dither and can only guarantee abs(sample) <= 1
-    bool hasAudio = false;
-    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-        if (_mixSamples[i] != 0.0f) {
-            hasAudio = true;
-            break;
-        }
-    }
+    bool hasAudio = hasNonZeroSamples(_mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
     // use the per listener AudioLimiter to render the mixed data
     listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
@@ -489,12 +528,154 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     return hasAudio;
 }
 
+void AudioMixerSlave::prepareFarFieldCells(AudioMixerClientData& listenerData,
+                                           const AvatarAudioStream& listenerAudioStream,
+                                           bool isSoloing) {
+    auto& farField = _sharedData.farField;
+    auto& streams = listenerData.getStreams();
+    int numCells = farField.getNumCells();
+
+    _farFieldCellStates.assign(numCells, FAR_FIELD_CELL_CANDIDATE);
+    _farFieldCellMembers.assign(numCells, 0);
+    _farFieldCandidates.clear();
+
+    // a cell is heard as a whole, so it can only be used if this listener would hear every one of its sources as is
+    // new ignores are only applied while the active streams are processed, keep everything exact on those frames
+    bool canApproximate = !isSoloing &&
+        listenerData.getNewIgnoredNodeIDs().empty() && listenerData.getNewUnignoredNodeIDs().empty() &&
+        listenerData.getNewIgnoringNodeIDs().empty() && listenerData.getNewUnignoringNodeIDs().empty();
+
+    for (auto& stream : streams.skipped) {
+        int cell = farField.cellForStream(stream.positionalStream);
+        if (cell >= 0) {
+            _farFieldCellStates[cell] = FAR_FIELD_CELL_EXACT;
+        }
+    }
+
+    glm::vec3 listenerPosition = listenerAudioStream.getPosition();
+    for (auto& stream : streams.active) {
+        stream.farFieldCell = canApproximate ? farField.cellForStream(stream.positionalStream) : -1;
+        if (stream.farFieldCell < 0) {
+            continue;
+        }
+
+        ++_farFieldCellMembers[stream.farFieldCell];
+
+        // sources in the listener's neighbourhood or with a personal gain set by the listener stay exact
+        float distance = glm::distance(stream.positionalStream->getPosition(), listenerPosition);
+        if (distance < farField.getCellSize() || stream.hrtf->getGainAdjustment() != 1.0f) {
+            _farFieldCellStates[stream.farFieldCell] = FAR_FIELD_CELL_EXACT;
+        } else {
+            _farFieldCandidates.emplace_back(distance, stream.farFieldCell);
+        }
+    }
+
+    // the closest sources always get their own HRTF
+    int numExactSources = std::min(farField.getNumExactSources(), (int)_farFieldCandidates.size());
+    if (numExactSources > 0) {
+        std::nth_element(_farFieldCandidates.begin(), _farFieldCandidates.begin() + (numExactSources - 1),
+                         _farFieldCandidates.end());
+        for (int i = 0; i < numExactSources; ++i) {
+            _farFieldCellStates[_farFieldCandidates[i].second] = FAR_FIELD_CELL_EXACT;
+        }
+    }
+
+    for (int cell = 0; cell < numCells; ++cell) {
+        if (_farFieldCellStates[cell] == FAR_FIELD_CELL_CANDIDATE &&
+            _farFieldCellMembers[cell] == farField.getCell(cell).numSources) {
+            _farFieldCellStates[cell] = FAR_FIELD_CELL_MIXED;
+        } else {
+            _farFieldCellStates[cell] = FAR_FIELD_CELL_EXACT;
+        }
+    }
+}
+
+bool AudioMixerSlave::mixFarFieldStream(AudioMixerClientData::MixableStream& mixableStream) {
+    if (mixableStream.farFieldCell < 0 || _farFieldCellStates[mixableStream.farFieldCell] != FAR_FIELD_CELL_MIXED) {
+        mixableStream.isMixedApproximately = false;
+        return false;
+    }
+
+    if (!mixableStream.isMixedApproximately) {
+        // same as throttling, drop the tail of the last exact block so it doesn't replay when the source comes back
+        resetHRTFState(mixableStream);
+        mixableStream.isMixedApproximately = true;
+    }
+
+    ++stats.approximateSourceMixes;
+    return true;
+}
+
+void AudioMixerSlave::mixFarFieldCells(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerAudioStream) {
+    auto& farField = _sharedData.farField;
+
+    memset(_farFieldMix, 0, sizeof(_farFieldMix));
+
+    glm::vec3 listenerPosition = listenerAudioStream.getPosition();
+    int numCellsMixed = 0;
+
+    for (int cellIndex = 0; cellIndex < farField.getNumCells(); ++cellIndex) {
+        if (_farFieldCellStates[cellIndex] != FAR_FIELD_CELL_MIXED) {
+            continue;
+        }
+
+        auto& cell = farField.getCell(cellIndex);
+        glm::vec3 relativePosition = cell.centroid - listenerPosition;
+        float distance = glm::max(glm::length(relativePosition), EPSILON);
+        float gain = applyDistanceAttenuation(listenerData.getMasterAvatarGain(), listenerPosition, cell.centroid,
+                                              distance);
+        if (gain == 0.0f) {
+            continue;
+        }
+
+        // encode the cell as a point source in world space, from Y-up to the Z-up ambisonic convention
+        glm::vec3 direction = relativePosition / distance;
+        float gainX = -direction.z * gain;
+        float gainY = -direction.x * gain;
+        float gainZ = direction.y * gain;
+
+        // ambiX channel order (W, Y, Z, X)
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+            float sample = cell.samples[i];
+            _farFieldMix[4 * i + 0] += sample * gain;
+            _farFieldMix[4 * i + 1] += sample * gainY;
+            _farFieldMix[4 * i + 2] += sample * gainZ;
+            _farFieldMix[4 * i + 3] += sample * gainX;
+        }
+
+        ++numCellsMixed;
+    }
+
+    stats.farFieldCellMixes += numCellsMixed;
+
+    // once the cells go away, render one more silent block to flush the tail of the last one
+    if (numCellsMixed == 0 && !listenerData.farFieldRendered) {
+        return;
+    }
+    listenerData.farFieldRendered = numCellsMixed > 0;
+
+    // AudioFOA takes 16-bit input, the render gain undoes the fixed input scale
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC; ++i) {
+        float sample = softClipFarField(_farFieldMix[i] / FAR_FIELD_HEADROOM);
+        _farFieldSamples[i] = (int16_t)lrintf(sample * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    // the field is in world space, rotate it into the listener's frame
+    glm::quat relativeOrientation = glm::inverse(listenerAudioStream.getOrientation());
+    listenerData.farFieldRenderer.render(_farFieldSamples, _mixSamples, HRTF_DATASET_INDEX,
+                                         relativeOrientation.w, -relativeOrientation.z, -relativeOrientation.x,
+                                         relativeOrientation.y, FAR_FIELD_RENDER_GAIN,
+                                         AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    ++stats.farFieldRenders;
+}
+
 void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStream,
                                 AvatarAudioStream& listeningNodeStream,
                                 float masterAvatarGain,
                                 float masterInjectorGain,
                                 bool isSoloing) {
     ++stats.totalMixes;
+    ++stats.exactSourceMixes;
 
     auto streamToAdd = mixableStream.positionalStream;
 
@@ -510,8 +691,6 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
                                                    relativePosition, distance));
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
 
-    const int HRTF_DATASET_INDEX = 1;
-
     if (!streamToAdd->lastPopSucceeded()) {
         bool forceSilentBlock = true;
 
@@ -758,14 +937,19 @@ float computeGain(float masterAvatarGain,
         gain *= masterAvatarGain;
     }
 
+    return applyDistanceAttenuation(gain, listeningNodeStream.getPosition(), streamToAdd.getPosition(), distance);
+}
+
+float applyDistanceAttenuation(float gain, const glm::vec3& listenerPosition, const glm::vec3& sourcePosition,
+                               float distance) {
     auto& audioZones = AudioMixer::getAudioZones();
     auto& zoneSettings = AudioMixer::getZoneSettings();
 
     // find distance attenuation coefficient
     float attenuationPerDoublingInDistance = AudioMixer::getAttenuationPerDoublingInDistance();
     for (const auto& settings : zoneSettings) {
-        if (audioZones[settings.source].area.contains(streamToAdd.getPosition()) &&
-            audioZones[settings.listener].area.contains(listeningNodeStream.getPosition())) {
+        if (audioZones[settings.source].area.contains(sourcePosition) &&
+            audioZones[settings.listener].area.contains(listenerPosition)) {
             attenuationPerDoublingInDistance = settings.coefficient;
             break;
         }
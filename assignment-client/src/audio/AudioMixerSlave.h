@@ -23,6 +23,7 @@
 #include <PositionalAudioStream.h>
 
 #include "AudioMixerClientData.h"
+#include "AudioMixerFarField.h"
 #include "AudioMixerStats.h"
 
 class AvatarAudioStream;
@@ -36,6 +37,7 @@ public:
         AudioMixerClientData::ConcurrentAddedStreams addedStreams;
         std::vector<Node::LocalID> removedNodes;
         std::vector<NodeIDStreamID> removedStreams;
+        AudioMixerFarField farField;
     };
 
     AudioMixerSlave(SharedData& sharedData) : _sharedData(sharedData) {};
@@ -68,10 +70,27 @@ private:
 
     void addStreams(Node& listener, AudioMixerClientData& listenerData);
 
+    // decide which cells of the far field can replace the exact mix of their sources for this listener
+    void prepareFarFieldCells(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerAudioStream,
+                              bool isSoloing);
+    // returns true if the stream is part of a far field cell mixed for this listener
+    bool mixFarFieldStream(AudioMixerClientData::MixableStream& mixableStream);
+    void mixFarFieldCells(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerAudioStream);
+
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // encoded mix, kept from one listener to the next so that the codecs can re-use its storage
+    QByteArray _encodedBuffer;
+
+    // far field buffers and per cell state for the listener being mixed
+    float _farFieldMix[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    int16_t _farFieldSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    std::vector<uint8_t> _farFieldCellStates;
+    std::vector<int> _farFieldCellMembers;
+    std::vector<std::pair<float, int>> _farFieldCandidates;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
@@ -14,60 +14,50 @@
 #include <assert.h>
 #include <algorithm>
 
+#include <udt/PacketBufferPool.h>
+
 void AudioMixerSlaveThread::run() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto& bufferPool = udt::PacketBufferPool::getInstance();
+    auto& scheduler = _pool._scheduler;
+
     while (true) {
-        wait();
+        _frame = scheduler.waitForFrame(_index, _frame);
 
-        // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
+        if (_pool._configure) {
+            _pool._configure(*this);
         }
+        _function = _pool._function;
 
-        bool stopping = _stop;
-        notify(stopping);
-        if (stopping) {
-            return;
-        }
-    }
-}
+        // build this frame's packets in recycled buffers, and queue up everything this slave sends during the frame,
+        // it is written out in batches when we're done
+        bufferPool.beginThreadPooling();
+        nodeList->beginSendBatch();
 
-void AudioMixerSlaveThread::wait() {
-    {
-        Lock lock(_pool._mutex);
-        _pool._slaveCondition.wait(lock, [&] {
-            assert(_pool._numStarted <= _pool._numThreads);
-            return _pool._numStarted != _pool._numThreads;
+        // run over our share of the nodes, and whatever we can steal from the other slaves
+        scheduler.runJobs(_index, [&](int job) {
+            (this->*_function)(_pool._nodes[job]);
         });
-        ++_pool._numStarted;
-    }
 
-    if (_pool._configure) {
-        _pool._configure(*this);
-    }
-    _function = _pool._function;
-}
+        nodeList->flushSendBatch();
+        bufferPool.endThreadPooling();
 
-void AudioMixerSlaveThread::notify(bool stopping) {
-    {
-        Lock lock(_pool._mutex);
-        assert(_pool._numFinished < _pool._numThreads);
-        ++_pool._numFinished;
+        auto bufferStats = udt::PacketBufferPool::sampleThreadStats();
+        stats.packetBuffersPooled += (int)bufferStats.pooled;
+        stats.packetBuffersAllocated += (int)bufferStats.allocated;
+
+        bool stopping = _stop;
+        scheduler.finishFrame();
         if (stopping) {
-            ++_pool._numStopped;
+            return;
         }
     }
-    _pool._poolCondition.notify_one();
-}
-
-bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
 }
 
 void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
     _function = &AudioMixerSlave::processPackets;
     _configure = [](AudioMixerSlave& slave) {};
-    run(begin, end);
+    run(begin, end, _processPacketsCosts);
 }
 
 void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, int numToRetain) {
@@ -76,35 +66,31 @@ void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame
         slave.configureMix(_begin, _end, frame, numToRetain);
     };
 
-    run(begin, end);
+    run(begin, end, _mixCosts);
 }
 
-void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
+void AudioMixerSlavePool::run(ConstIter begin, ConstIter end, NodeCosts& nodeCosts) {
     _begin = begin;
     _end = end;
 
-    // fill the queue
+    // one job per node, expected to cost what it did last frame
+    _nodes.clear();
+    _jobCosts.clear();
     std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.push(node);
+        auto cost = nodeCosts.find(node->getLocalID());
+        _nodes.push_back(node);
+        _jobCosts.push_back(cost != nodeCosts.end() ? cost->second : 0);
     });
 
-    {
-        Lock lock(_mutex);
-
-        // run
-        _numStarted = _numFinished = 0;
-        _slaveCondition.notify_all();
-
-        // wait
-        _poolCondition.wait(lock, [&] {
-            assert(_numFinished <= _numThreads);
-            return _numFinished == _numThreads;
-        });
+    _scheduler.runFrame(_jobCosts);
 
-        assert(_numStarted == _numThreads);
+    // remember what they cost this time, which also forgets the nodes that went away
+    nodeCosts.clear();
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        nodeCosts[_nodes[i]->getLocalID()] = _jobCosts[i];
     }
 
-    assert(_queue.empty());
+    _nodes.clear();
 }
 
 void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> functor) {
@@ -126,17 +112,20 @@ void AudioMixerSlavePool::queueStats(QJsonObject& stats) {
 }
 #endif // DEBUG_EVENT_QUEUE
 
+int AudioMixerSlavePool::getMaxThreads() {
+    int maxThreads = QThread::idealThreadCount();
+    if (maxThreads == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int MAX_THREADS_IF_UNKNOWN = 4;
+        maxThreads = MAX_THREADS_IF_UNKNOWN;
+    }
+    return maxThreads;
+}
+
 void AudioMixerSlavePool::setNumThreads(int numThreads) {
     // clamp to allowed size
     {
-        int maxThreads = QThread::idealThreadCount();
-        if (maxThreads == -1) {
-            // idealThreadCount returns -1 if cores cannot be detected
-            static const int MAX_THREADS_IF_UNKNOWN = 4;
-            maxThreads = MAX_THREADS_IF_UNKNOWN;
-        }
-
-        int clampedThreads = std::min(std::max(1, numThreads), maxThreads);
+        int clampedThreads = std::min(std::max(1, numThreads), _scheduler.getMaxThreads());
         if (clampedThreads != numThreads) {
             qWarning("%s: clamped to %d (was %d)", __FUNCTION__, clampedThreads, numThreads);
             numThreads = clampedThreads;
@@ -151,12 +140,12 @@ void AudioMixerSlavePool::resize(int numThreads) {
 
     qDebug("%s: set %d threads (was %d)", __FUNCTION__, numThreads, _numThreads);
 
-    Lock lock(_mutex);
-
     if (numThreads > _numThreads) {
+        _scheduler.setNumThreads(numThreads);
+
         // start new slaves
-        for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this, _workerSharedData);
+        for (int i = _numThreads; i < numThreads; ++i) {
+            auto slave = new AudioMixerSlaveThread(*this, _workerSharedData, i, _scheduler.getFrame());
             slave->start();
             _slaves.emplace_back(slave);
         }
@@ -170,16 +159,10 @@ void AudioMixerSlavePool::resize(int numThreads) {
             ++slave;
         }
 
-        // ...cycle them until they do stop...
-        _numStopped = 0;
-        while (_numStopped != (_numThreads - numThreads)) {
-            _numStarted = _numFinished = _numStopped;
-            _slaveCondition.notify_all();
-            _poolCondition.wait(lock, [&] {
-                assert(_numFinished <= _numThreads);
-                return _numFinished == _numThreads;
-            });
-        }
+        // ...run an empty frame so that they do stop...
+        _configure = nullptr;
+        _jobCosts.clear();
+        _scheduler.runFrame(_jobCosts);
 
         // ...wait for threads to finish...
         slave = extraBegin;
@@ -192,8 +175,9 @@ void AudioMixerSlavePool::resize(int numThreads) {
 
         // ...and erase them
         _slaves.erase(extraBegin, _slaves.end());
+        _scheduler.setNumThreads(numThreads);
     }
 
-    _numThreads = _numStarted = _numFinished = numThreads;
+    _numThreads = numThreads;
     assert(_numThreads == (int)_slaves.size());
 }
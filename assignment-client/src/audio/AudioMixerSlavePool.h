@@ -12,14 +12,13 @@
 #ifndef hifi_AudioMixerSlavePool_h
 #define hifi_AudioMixerSlavePool_h
 
-#include <condition_variable>
-#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <QThread>
 #include <shared/QtHelpers.h>
-#include <TBBHelpers.h>
 
+#include "../WorkStealingScheduler.h"
 #include "AudioMixerSlave.h"
 
 class AudioMixerSlavePool;
@@ -27,40 +26,35 @@ class AudioMixerSlavePool;
 class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     Q_OBJECT
     using ConstIter = NodeList::const_iterator;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
 
 public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool, AudioMixerSlave::SharedData& sharedData)
-        : AudioMixerSlave(sharedData), _pool(pool) {}
+    AudioMixerSlaveThread(AudioMixerSlavePool& pool, AudioMixerSlave::SharedData& sharedData, int index, uint32_t frame)
+        : AudioMixerSlave(sharedData), _pool(pool), _index(index), _frame(frame) {}
 
     void run() override final;
 
 private:
     friend class AudioMixerSlavePool;
 
-    void wait();
-    void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
-
     AudioMixerSlavePool& _pool;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
+    const int _index;
+    uint32_t _frame; // last scheduler frame this slave ran
     bool _stop { false };
 };
 
 // Slave pool for audio mixers
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-    using ConditionVariable = std::condition_variable;
+    // what each node cost (in nanoseconds) the last time a job ran over it, used to schedule the next one largest first
+    using NodeCosts = std::unordered_map<Node::LocalID, uint64_t>;
 
 public:
     using ConstIter = NodeList::const_iterator;
+    using ThreadStats = WorkStealingScheduler::ThreadStats;
 
     AudioMixerSlavePool(AudioMixerSlave::SharedData& sharedData, int numThreads = QThread::idealThreadCount())
-        : _workerSharedData(sharedData) { setNumThreads(numThreads); }
+        : _scheduler(getMaxThreads()), _workerSharedData(sharedData) { setNumThreads(numThreads); }
     ~AudioMixerSlavePool() { resize(0); }
 
     // process packets on slave threads
@@ -79,32 +73,35 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    // returns how busy each slave was since the last call
+    std::vector<ThreadStats> sampleThreadStats() { return _scheduler.sampleThreadStats(); }
+
 private:
-    void run(ConstIter begin, ConstIter end);
+    friend class AudioMixerSlaveThread;
+
+    // the most threads the pool will run, one per core
+    static int getMaxThreads();
+
+    void run(ConstIter begin, ConstIter end, NodeCosts& nodeCosts);
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
-    friend void AudioMixerSlaveThread::wait();
-    friend void AudioMixerSlaveThread::notify(bool stopping);
-    friend bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node);
-
     // synchronization state
-    Mutex _mutex;
-    ConditionVariable _slaveCondition;
-    ConditionVariable _poolCondition;
-    void (AudioMixerSlave::*_function)(const SharedNodePointer& node);
+    WorkStealingScheduler _scheduler;
+    void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     std::function<void(AudioMixerSlave&)> _configure;
     int _numThreads { 0 };
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
-    int _numStopped { 0 }; // guarded by _mutex
 
     // frame state
-    Queue _queue;
+    std::vector<SharedNodePointer> _nodes;
+    std::vector<uint64_t> _jobCosts;
     ConstIter _begin;
     ConstIter _end;
 
+    NodeCosts _processPacketsCosts;
+    NodeCosts _mixCosts;
+
     AudioMixerSlave::SharedData& _workerSharedData;
 };
 
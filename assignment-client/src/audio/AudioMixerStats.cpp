@@ -25,6 +25,14 @@ void AudioMixerStats::reset() {
     manualStereoMixes = 0;
     manualEchoMixes = 0;
 
+    exactSourceMixes = 0;
+    approximateSourceMixes = 0;
+    farFieldCellMixes = 0;
+    farFieldRenders = 0;
+
+    packetBuffersPooled = 0;
+    packetBuffersAllocated = 0;
+
     skippedToActive = 0;
     skippedToInactive = 0;
     inactiveToSkipped = 0;
@@ -55,6 +63,14 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
 
+    exactSourceMixes += otherStats.exactSourceMixes;
+    approximateSourceMixes += otherStats.approximateSourceMixes;
+    farFieldCellMixes += otherStats.farFieldCellMixes;
+    farFieldRenders += otherStats.farFieldRenders;
+
+    packetBuffersPooled += otherStats.packetBuffersPooled;
+    packetBuffersAllocated += otherStats.packetBuffersAllocated;
+
     skippedToActive += otherStats.skippedToActive;
     skippedToInactive += otherStats.skippedToInactive;
     inactiveToSkipped += otherStats.inactiveToSkipped;
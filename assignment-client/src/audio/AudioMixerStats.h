@@ -30,6 +30,16 @@ struct AudioMixerStats {
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    // sources mixed with their own HRTF vs. summed into a far field cell
+    int exactSourceMixes { 0 };
+    int approximateSourceMixes { 0 };
+    int farFieldCellMixes { 0 };
+    int farFieldRenders { 0 };
+
+    // packet buffers the slaves drew from the packet buffer pool vs. allocated on the heap
+    int packetBuffersPooled { 0 };
+    int packetBuffersAllocated { 0 };
+
     int skippedToActive { 0 };
     int skippedToInactive { 0 };
     int inactiveToSkipped { 0 };
@@ -19,6 +19,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QTimer>
@@ -322,6 +323,8 @@ void AvatarMixer::start() {
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
+                // where everyone is this frame, for the slaves to find each listener's neighbours
+                _slaveSharedData.avatarIndex.build(cbegin, cend);
                 _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
@@ -753,6 +756,18 @@ void AvatarMixer::sendStatsPacket() {
 
     statsObject["broadcast_loop_rate"] = _loopRate.rate();
     statsObject["threads"] = _slavePool.numThreads();
+
+    // how much of the parallel part of each frame every slave spent working
+    QJsonArray threadStats;
+    for (auto& stats : _slavePool.sampleThreadStats()) {
+        QJsonObject thread;
+        thread["utilization"] = QString::number(stats.utilization() * 100.0f, 'f', 2);
+        thread["jobs_per_frame"] = (float)stats.jobs / (float)_numTightLoopFrames;
+        thread["steals_per_frame"] = (float)stats.steals / (float)_numTightLoopFrames;
+        thread["parks"] = (qint64)stats.parks;
+        threadStats.push_back(thread);
+    }
+    statsObject["thread_utilization"] = threadStats;
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
     statsObject["throttling_ratio"] = _throttlingRatio;
 
@@ -838,6 +853,13 @@ void AvatarMixer::sendStatsPacket() {
     slavesAggregatObject["sent_5_averageTraitsBytes"] = TIGHT_LOOP_STAT(aggregateStats.numTraitsBytesSent);
     slavesAggregatObject["sent_6_averageIdentityBytes"] = TIGHT_LOOP_STAT(aggregateStats.numIdentityBytesSent);
     slavesAggregatObject["sent_7_averageHeroAvatars"] = TIGHT_LOOP_STAT(aggregateStats.numHeroesIncluded);
+    slavesAggregatObject["sent_8_sharedEncodes"] = TIGHT_LOOP_STAT(aggregateStats.numSharedEncodes);
+    slavesAggregatObject["sent_9_sharedEncodesSent"] = TIGHT_LOOP_STAT(aggregateStats.numSharedEncodesSent);
+    slavesAggregatObject["sent_10_ownEncodes"] = TIGHT_LOOP_STAT(aggregateStats.numOwnEncodes);
+    float averageCandidatesExamined = averageNodes ? aggregateStats.numCandidatesExamined / averageNodes : 0.0f;
+    slavesAggregatObject["sent_11_averageCandidatesExamined"] = TIGHT_LOOP_STAT(averageCandidatesExamined);
+    slavesAggregatObject["sent_12_packetBuffersPooled"] = TIGHT_LOOP_STAT(aggregateStats.numPacketBuffersPooled);
+    slavesAggregatObject["sent_13_packetBuffersAllocated"] = TIGHT_LOOP_STAT(aggregateStats.numPacketBuffersAllocated);
 
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
@@ -46,6 +46,14 @@ void AvatarMixerClientData::setLastOtherAvatarEncodeTime(NLPacket::LocalID other
     }
 }
 
+uint32_t AvatarMixerClientData::getLastOtherAvatarEncodeVersion(NLPacket::LocalID otherAvatar) const {
+    const auto itr = _lastOtherAvatarEncodeVersions.find(otherAvatar);
+    if (itr != _lastOtherAvatarEncodeVersions.end()) {
+        return itr->second;
+    }
+    return 0;
+}
+
 void AvatarMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
     if (!_packetQueue.node) {
         _packetQueue.node = node;
@@ -497,6 +505,7 @@ AvatarMixerClientData::TraitsCheckTimestamp AvatarMixerClientData::getLastOtherA
 void AvatarMixerClientData::cleanupKilledNode(const QUuid&, Node::LocalID nodeLocalID) {
     removeLastBroadcastSequenceNumber(nodeLocalID);
     removeLastBroadcastTime(nodeLocalID);
+    _lastOtherAvatarEncodeVersions.erase(nodeLocalID);
     _lastSentTraitsTimestamps.erase(nodeLocalID);
     _perNodeSentTraitVersions.erase(nodeLocalID);
     _perNodeAckedTraitVersions.erase(nodeLocalID);
@@ -23,6 +23,7 @@
 
 #include "MixerAvatar.h"
 #include <AssociatedTraitValues.h>
+#include <AvatarEncodeCache.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
@@ -75,6 +76,7 @@ public:
     void resetNumAvatarsSentLastFrame() { _numAvatarsSentLastFrame = 0; }
     void incrementNumAvatarsSentLastFrame() { ++_numAvatarsSentLastFrame; }
     int getNumAvatarsSentLastFrame() const { return _numAvatarsSentLastFrame; }
+    int getNumAvatarDataBytesSentLastFrame() const { return _numAvatarDataBytesSentLastFrame; }
 
     void recordNumOtherAvatarStarves(int numAvatarsHeldBack) { _otherAvatarStarves.updateAverage((float) numAvatarsHeldBack); }
     float getAvgNumOtherAvatarStarvesPerSecond() const { return _otherAvatarStarves.getAverageSampleValuePerSecond(); }
@@ -89,6 +91,7 @@ public:
     void resetNumFramesSinceFRDAdjustment() { _numFramesSinceAdjustment = 0; }
 
     void recordSentAvatarData(int numDataBytes, int numTraitsBytes = 0) {
+        _numAvatarDataBytesSentLastFrame = numDataBytes;
         _avgOtherAvatarDataRate.updateAverage(numDataBytes);
         _avgOtherAvatarTraitsRate.updateAverage(numTraitsBytes);
     }
@@ -104,6 +107,7 @@ public:
     bool isRadiusIgnoring(const QUuid& other) const;
     void addToRadiusIgnoringSet(const QUuid& other);
     void removeFromRadiusIgnoringSet(const QUuid& other);
+    const std::vector<QUuid>& getRadiusIgnoredOthers() const { return _radiusIgnoredOthers; }
     void ignoreOther(SharedNodePointer self, SharedNodePointer other);
     void ignoreOther(const Node* self, const Node* other);
 
@@ -128,6 +132,14 @@ public:
 
     QVector<JointData>& getLastOtherAvatarSentJoints(NLPacket::LocalID otherAvatar) { return _lastOtherAvatarSentJoints[otherAvatar]; }
 
+    // which of the other avatar's shared encodes this node is in sync with, 0 if none
+    uint32_t getLastOtherAvatarEncodeVersion(NLPacket::LocalID otherAvatar) const;
+    void setLastOtherAvatarEncodeVersion(NLPacket::LocalID otherAvatar, uint32_t version)
+        { _lastOtherAvatarEncodeVersions[otherAvatar] = version; }
+
+    // this avatar's data, encoded once per frame for all of the nodes it is sent to
+    AvatarEncodeCache& getEncodeCache() const { return _encodeCache; }
+
     void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
     int processPackets(const SlaveSharedData& slaveSharedData); // returns number of packets processed
 
@@ -174,12 +186,16 @@ private:
     // sending to "this" node
     std::unordered_map<NLPacket::LocalID, uint64_t> _lastOtherAvatarEncodeTime;
     std::unordered_map<NLPacket::LocalID, QVector<JointData>> _lastOtherAvatarSentJoints;
+    std::unordered_map<NLPacket::LocalID, uint32_t> _lastOtherAvatarEncodeVersions;
+
+    mutable AvatarEncodeCache _encodeCache;
 
     uint64_t _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ true };
     bool _avatarSkeletonModelUrlMustChange{ false };
 
     int _numAvatarsSentLastFrame = 0;
+    int _numAvatarDataBytesSentLastFrame = 0;
     int _numFramesSinceAdjustment = 0;
 
     SimpleMovingAverage _otherAvatarStarves;
@@ -58,6 +58,11 @@ void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
     _stats.reset();
 }
 
+void AvatarMixerSlave::recordPacketBuffers(const udt::PacketBufferPool::ThreadStats& bufferStats) {
+    _stats.numPacketBuffersPooled += (int)bufferStats.pooled;
+    _stats.numPacketBuffersAllocated += (int)bufferStats.allocated;
+}
+
 
 void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
     auto start = usecTimestampNow();
@@ -330,11 +335,15 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
     const AvatarData& avatar = destinationNodeData->getAvatar();
     glm::vec3 destinationPosition = avatar.getClientGlobalPosition();
 
+    // identifies this frame to the shared avatar encodes
+    uint64_t frame = (uint64_t)_lastFrameTimestamp.time_since_epoch().count();
+
     // reset the internal state for correct random number distribution
     distribution.reset();
 
     // Estimate number to sort on number sent last frame (with min. of 20).
-    const int numToSendEst = std::max(int(destinationNodeData->getNumAvatarsSentLastFrame() * 2.5f), 20);
+    const int numSentLastFrame = destinationNodeData->getNumAvatarsSentLastFrame();
+    const int numToSendEst = std::max(int(numSentLastFrame * 2.5f), 20);
 
     // reset the number of sent avatars
     destinationNodeData->resetNumAvatarsSentLastFrame();
@@ -386,14 +395,19 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
     avatarPriorityQueues[kNonhero].reserve(_end - _begin);
 
-    for (auto listedNode = _begin; listedNode != _end; ++listedNode) {
-        Node* otherNodeRaw = (*listedNode).data();
+    // number of avatars pushed in the queues
+    int numCandidates = 0;
+    int numExamined = 0;
+
+    auto considerAvatar = [&](const Node* otherNodeRaw) {
         if (otherNodeRaw->getType() != NodeType::Agent
             || !otherNodeRaw->getLinkedData()
             || otherNodeRaw == destinationNode) {
-            continue;
+            return;
         }
 
+        ++numExamined;
+
         auto sourceAvatarNode = otherNodeRaw;
 
         bool sendAvatar = true;  // We will consider this source avatar for sending.
@@ -470,6 +484,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
             avatarPriorityQueues[avatarNodeData->getHasPriority() ? kHero : kNonhero].push(
                 SortableAvatar(avatarNodeData, sourceAvatarNode, lastEncodeTime));
+            ++numCandidates;
         }
         
         // If Node A's PAL WAS open but is no longer open, AND
@@ -489,10 +504,72 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             nodeList->sendPacket(std::move(packet), *destinationNode);
             destinationNodeData->cleanupKilledNode(sourceAvatarNode->getUUID(), sourceAvatarNode->getLocalID());
         }
+    };
+
+    const auto& avatarIndex = _sharedData->avatarIndex;
+
+    // Walk every node when the PAL is or was open, it needs to know about everyone, or when there are so few avatars
+    // that we would end up examining most of them anyway.
+    if (PALIsOpen || PALWasOpen || avatarIndex.size() <= numToSendEst * 2) {
+        for (auto listedNode = _begin; listedNode != _end; ++listedNode) {
+            considerAvatar((*listedNode).data());
+        }
+    } else {
+        if ((int)_examinedMarks.size() < avatarIndex.size()) {
+            _examinedMarks.resize(avatarIndex.size(), 0);
+        }
+        if (++_examinedMark == 0) {
+            std::fill(_examinedMarks.begin(), _examinedMarks.end(), 0);
+            _examinedMark = 1;
+        }
+        auto examine = [&](int entry) {
+            if (_examinedMarks[entry] != _examinedMark) {
+                _examinedMarks[entry] = _examinedMark;
+                considerAvatar(avatarIndex.getEntry(entry).node);
+            }
+        };
+
+        // heroes have their own share of the budget, wherever they are
+        for (int entry : avatarIndex.getHeroes()) {
+            examine(entry);
+        }
+
+        // avatars in our radius ignoring set are re-examined every frame so we let them go as soon as they leave the bubble,
+        // examining them can remove them from the set so walk a copy
+        auto radiusIgnoredOthers = destinationNodeData->getRadiusIgnoredOthers();
+        for (const auto& other : radiusIgnoredOthers) {
+            int entry = avatarIndex.find(other);
+            if (entry >= 0) {
+                examine(entry);
+            }
+        }
 
-        destinationNodeData->setPrevRequestsDomainListData(PALIsOpen);
+        // then the closest avatars, one ring of cells at a time, until there are enough candidates to use up both the
+        // estimated send count and the bandwidth budget, sized with what an avatar cost us last frame
+        const int MAX_RINGS = 8;
+        int bytesPerAvatarEstimate = std::max(numSentLastFrame > 0 ?
+            destinationNodeData->getNumAvatarDataBytesSentLastFrame() / numSentLastFrame : 0,
+            (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE);
+        int maxRing = std::min(avatarIndex.getMaxRing(destinationPosition), MAX_RINGS);
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            avatarIndex.forEachInRing(destinationPosition, ring, examine);
+            if (numCandidates >= numToSendEst && numCandidates * bytesPerAvatarEstimate >= maxAvatarBytesPerFrame) {
+                break;
+            }
+        }
+
+        // and one batch of the farther avatars, each gets its turn every NUM_FAR_BATCHES frames,
+        // which its age in the priority sort makes up for
+        int farBatch = (int)((avatarIndex.getBuildNumber() + destinationNode->getLocalID()) %
+                             AvatarSpatialIndex::NUM_FAR_BATCHES);
+        for (int entry : avatarIndex.getFarBatch(farBatch)) {
+            examine(entry);
+        }
     }
 
+    _stats.numCandidatesExamined += numExamined;
+    destinationNodeData->setPrevRequestsDomainListData(PALIsOpen);
+
     // loop through our sorted avatars and allocate our bandwidth to them accordingly
 
     int remainingAvatars = (int)avatarPriorityQueues[kHero].size() + (int)avatarPriorityQueues[kNonhero].size();
@@ -564,31 +641,85 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
             QVector<JointData>& lastSentJointsForOther = destinationNodeData->getLastOtherAvatarSentJoints(sourceNode->getLocalID());
 
-            const bool distanceAdjust = true;
-            const bool dropFaceTracking = false;
-            AvatarDataPacket::SendStatus sendStatus;
-            sendStatus.sendUUID = true;
-
-            do {
+            bool sentSharedEncode = false;
+            if (detail == AvatarData::SendAllData || detail == AvatarData::CullSmallData) {
+                // in view avatars are encoded once per frame and distance level, and that encode is sent to everyone
+                // in sync with it, the random full update only applies if we're the first to ask for it this frame
                 auto startSerialize = chrono::high_resolution_clock::now();
-                QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
-                    &lastSentJointsForOther, avatarSpaceAvailable);
+                bool encoded = false;
+                const auto& sharedEncode = sourceNodeData->getEncodeCache().get(*sourceAvatar, frame, destinationPosition,
+                                                                                 detail == AvatarData::SendAllData, &encoded);
                 auto endSerialize = chrono::high_resolution_clock::now();
                 _stats.toByteArrayElapsedTime +=
                     (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
+                if (encoded) {
+                    _stats.numSharedEncodes++;
+                }
+
+                auto encodeVersion = destinationNodeData->getLastOtherAvatarEncodeVersion(sourceNode->getLocalID());
+                const QByteArray& bytes = sharedEncode.bytes;
+                if (sharedEncode.appliesTo(encodeVersion) && bytes.size() <= avatarPacketCapacity) {
+                    if (bytes.size() > avatarSpaceAvailable) {
+                        nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                        ++numPacketsSent;
+                        avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                        avatarSpaceAvailable = avatarPacketCapacity;
+                    }
 
-                avatarPacket->write(bytes);
-                avatarSpaceAvailable -= bytes.size();
-                numAvatarDataBytes += bytes.size();
-                if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
-                    // Weren't able to fit everything.
-                    nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
-                    ++numPacketsSent;
-                    avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
-                    avatarSpaceAvailable = avatarPacketCapacity;
+                    avatarPacket->write(bytes);
+                    avatarSpaceAvailable -= bytes.size();
+                    numAvatarDataBytes += bytes.size();
+                    if (avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
+                        nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                        ++numPacketsSent;
+                        avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                        avatarSpaceAvailable = avatarPacketCapacity;
+                    }
+
+                    lastSentJointsForOther = sharedEncode.sentJoints;
+                    destinationNodeData->setLastOtherAvatarEncodeVersion(sourceNode->getLocalID(), sharedEncode.version);
+                    _stats.numSharedEncodesSent++;
+                    sentSharedEncode = true;
                 }
-            } while (!sendStatus);
+            }
+
+            if (!sentSharedEncode) {
+                // encode for this node only, which takes it out of sync with the shared encodes
+                const bool distanceAdjust = true;
+                const bool dropFaceTracking = false;
+                AvatarDataPacket::SendStatus sendStatus;
+                sendStatus.sendUUID = true;
+
+                if (detail == AvatarData::SendAllData || detail == AvatarData::CullSmallData) {
+                    destinationNodeData->setLastOtherAvatarEncodeVersion(sourceNode->getLocalID(), 0);
+                    _stats.numOwnEncodes++;
+                }
+
+                do {
+                    // encode straight into the packet's payload
+                    auto startSerialize = chrono::high_resolution_clock::now();
+                    auto payloadSize = avatarPacket->getPayloadSize();
+                    auto destinationBuffer = reinterpret_cast<unsigned char*>(avatarPacket->getPayload() + payloadSize);
+                    int numBytes = sourceAvatar->toBuffer(destinationBuffer, avatarSpaceAvailable, detail,
+                        lastEncodeForOther, lastSentJointsForOther, sendStatus, dropFaceTracking, distanceAdjust,
+                        destinationPosition, &lastSentJointsForOther);
+                    auto endSerialize = chrono::high_resolution_clock::now();
+                    _stats.toByteArrayElapsedTime +=
+                        (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
+
+                    avatarPacket->setPayloadSize(payloadSize + numBytes);
+                    avatarPacket->seek(payloadSize + numBytes);
+                    avatarSpaceAvailable -= numBytes;
+                    numAvatarDataBytes += numBytes;
+                    if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
+                        // Weren't able to fit everything.
+                        nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                        ++numPacketsSent;
+                        avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                        avatarSpaceAvailable = avatarPacketCapacity;
+                    }
+                } while (!sendStatus);
+            }
 
             if (detail != AvatarData::NoData) {
                 _stats.numOthersIncluded++;
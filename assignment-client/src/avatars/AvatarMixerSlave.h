@@ -13,6 +13,9 @@
 #define hifi_AvatarMixerSlave_h
 
 #include <NodeList.h>
+#include <udt/PacketBufferPool.h>
+
+#include "AvatarSpatialIndex.h"
 
 class AvatarMixerClientData;
 
@@ -33,6 +36,12 @@ public:
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
     int numHeroesIncluded { 0 };
+    int numSharedEncodes { 0 };
+    int numSharedEncodesSent { 0 };
+    int numOwnEncodes { 0 };
+    int numCandidatesExamined { 0 };
+    int numPacketBuffersPooled { 0 };
+    int numPacketBuffersAllocated { 0 };
 
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
@@ -59,6 +68,12 @@ public:
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
         numHeroesIncluded = 0;
+        numSharedEncodes = 0;
+        numSharedEncodesSent = 0;
+        numOwnEncodes = 0;
+        numCandidatesExamined = 0;
+        numPacketBuffersPooled = 0;
+        numPacketBuffersAllocated = 0;
 
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
@@ -83,6 +98,12 @@ public:
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
         numHeroesIncluded += rhs.numHeroesIncluded;
+        numSharedEncodes += rhs.numSharedEncodes;
+        numSharedEncodesSent += rhs.numSharedEncodesSent;
+        numOwnEncodes += rhs.numOwnEncodes;
+        numCandidatesExamined += rhs.numCandidatesExamined;
+        numPacketBuffersPooled += rhs.numPacketBuffersPooled;
+        numPacketBuffersAllocated += rhs.numPacketBuffersAllocated;
 
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
@@ -100,6 +121,7 @@ struct SlaveSharedData {
     QStringList skeletonURLWhitelist;
     QUrl skeletonReplacementURL;
     EntityTreePointer entityTree;
+    AvatarSpatialIndex avatarIndex;
 };
 
 class AvatarMixerSlave {
@@ -118,6 +140,9 @@ public:
 
     void harvestStats(AvatarMixerSlaveStats& stats);
 
+    // adds the packet buffers this slave's thread used since the last call to its stats
+    void recordPacketBuffers(const udt::PacketBufferPool::ThreadStats& bufferStats);
+
 private:
     int sendIdentityPacket(NLPacketList& packet, const AvatarMixerClientData* nodeData, const Node& destinationNode);
     int sendReplicatedIdentityPacket(const Node& agentNode, const AvatarMixerClientData* nodeData, const Node& destinationNode);
@@ -143,6 +168,10 @@ private:
     float _throttlingRatio { 0.0f };
     float _avatarHeroFraction { 0.4f };
 
+    // marks the avatar index entries already examined for the current listener
+    std::vector<uint32_t> _examinedMarks;
+    uint32_t _examinedMark { 0 };
+
     AvatarMixerSlaveStats _stats;
     SlaveSharedData* _sharedData;
 };
@@ -12,16 +12,15 @@
 #ifndef hifi_AvatarMixerSlavePool_h
 #define hifi_AvatarMixerSlavePool_h
 
-#include <condition_variable>
-#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <QThread>
 
-#include <TBBHelpers.h>
 #include <NodeList.h>
 #include <shared/QtHelpers.h>
 
+#include "../WorkStealingScheduler.h"
 #include "AvatarMixerSlave.h"
 
 
@@ -30,40 +29,35 @@ class AvatarMixerSlavePool;
 class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
     Q_OBJECT
     using ConstIter = NodeList::const_iterator;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
 
 public:
-    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, SlaveSharedData* slaveSharedData) :
-        AvatarMixerSlave(slaveSharedData), _pool(pool) {};
+    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, SlaveSharedData* slaveSharedData, int index, uint32_t frame) :
+        AvatarMixerSlave(slaveSharedData), _pool(pool), _index(index), _frame(frame) {};
 
     void run() override final;
 
 private:
     friend class AvatarMixerSlavePool;
 
-    void wait();
-    void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
-
     AvatarMixerSlavePool& _pool;
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
+    const int _index;
+    uint32_t _frame; // last scheduler frame this slave ran
     bool _stop { false };
 };
 
 // Slave pool for avatar mixers
 //   AvatarMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AvatarMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-    using ConditionVariable = std::condition_variable;
+    // what each node cost (in nanoseconds) the last time a job ran over it, used to schedule the next one largest first
+    using NodeCosts = std::unordered_map<Node::LocalID, uint64_t>;
 
 public:
     using ConstIter = NodeList::const_iterator;
+    using ThreadStats = WorkStealingScheduler::ThreadStats;
 
     AvatarMixerSlavePool(SlaveSharedData* slaveSharedData, int numThreads = QThread::idealThreadCount()) :
-        _slaveSharedData(slaveSharedData) { setNumThreads(numThreads); }
+        _scheduler(getMaxThreads()), _slaveSharedData(slaveSharedData) { setNumThreads(numThreads); }
     ~AvatarMixerSlavePool() { resize(0); }
 
     // Jobs the slave pool can do...
@@ -81,39 +75,41 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() const { return _numThreads; }
 
+    // returns how busy each slave was since the last call
+    std::vector<ThreadStats> sampleThreadStats() { return _scheduler.sampleThreadStats(); }
+
     void setPriorityReservedFraction(float fraction) { _priorityReservedFraction = fraction; }
     float getPriorityReservedFraction() const { return  _priorityReservedFraction; }
 
 private:
-    void run(ConstIter begin, ConstIter end);
+    friend class AvatarMixerSlaveThread;
+
+    // the most threads the pool will run, one per core
+    static int getMaxThreads();
+
+    void run(ConstIter begin, ConstIter end, NodeCosts& nodeCosts);
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AvatarMixerSlaveThread>> _slaves;
 
-    friend void AvatarMixerSlaveThread::wait();
-    friend void AvatarMixerSlaveThread::notify(bool stopping);
-    friend bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node);
-
     // synchronization state
-    Mutex _mutex;
-    ConditionVariable _slaveCondition;
-    ConditionVariable _poolCondition;
-    void (AvatarMixerSlave::*_function)(const SharedNodePointer& node);
+    WorkStealingScheduler _scheduler;
+    void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     std::function<void(AvatarMixerSlave&)> _configure;
 
     // Set from Domain Settings:
     float _priorityReservedFraction { 0.4f };
     int _numThreads { 0 };
 
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
-    int _numStopped { 0 }; // guarded by _mutex
-
     // frame state
-    Queue _queue;
+    std::vector<SharedNodePointer> _nodes;
+    std::vector<uint64_t> _jobCosts;
     ConstIter _begin;
     ConstIter _end;
 
+    NodeCosts _processIncomingPacketsCosts;
+    NodeCosts _broadcastAvatarDataCosts;
+
     SlaveSharedData* _slaveSharedData;
 };
 
@@ -0,0 +1,107 @@
+//
+//  AvatarSpatialIndex.cpp
+//  assignment-client/src/avatars
+//
+//  Created on 2019-11-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarSpatialIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <AvatarData.h>
+
+#include "AvatarMixerClientData.h"
+
+// one cell per highest distance level, the listener's own cell and its neighbours hold every full detail avatar
+const float AvatarSpatialIndex::CELL_SIZE = AVATAR_DISTANCE_LEVEL_1;
+
+void AvatarSpatialIndex::build(ConstIter begin, ConstIter end) {
+    ++_buildNumber;
+
+    _entries.clear();
+    _cells.clear();
+    _entriesByID.clear();
+    _heroes.clear();
+    for (auto& batch : _farBatches) {
+        batch.clear();
+    }
+
+    struct CellEntry {
+        CellKey key;
+        Entry entry;
+    };
+    std::vector<CellEntry> cellEntries;
+    cellEntries.reserve(end - begin);
+
+    _minX = _minZ = std::numeric_limits<int>::max();
+    _maxX = _maxZ = std::numeric_limits<int>::min();
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        if (node->getType() != NodeType::Agent || !node->getLinkedData()) {
+            return;
+        }
+
+        auto nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+        glm::vec3 position = nodeData->getPosition();
+        int x = cellCoordinate(position.x);
+        int z = cellCoordinate(position.z);
+        _minX = std::min(_minX, x);
+        _maxX = std::max(_maxX, x);
+        _minZ = std::min(_minZ, z);
+        _maxZ = std::max(_maxZ, z);
+
+        cellEntries.push_back({ cellKey(x, z), { node.data(), position } });
+    });
+
+    if (cellEntries.empty()) {
+        _minX = _minZ = 0;
+        _maxX = _maxZ = -1;
+        return;
+    }
+
+    std::sort(cellEntries.begin(), cellEntries.end(), [](const CellEntry& a, const CellEntry& b) {
+        return a.key < b.key;
+    });
+
+    _entries.reserve(cellEntries.size());
+    for (int i = 0; i < (int)cellEntries.size(); ++i) {
+        const auto& cellEntry = cellEntries[i];
+        const Node* node = cellEntry.entry.node;
+
+        if (i == 0 || cellEntries[i - 1].key != cellEntry.key) {
+            _cells[cellEntry.key] = { i, i + 1 };
+        } else {
+            _cells[cellEntry.key].second = i + 1;
+        }
+
+        _entries.push_back(cellEntry.entry);
+        _entriesByID[node->getUUID()] = i;
+        _farBatches[node->getLocalID() % NUM_FAR_BATCHES].push_back(i);
+
+        auto nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+        if (nodeData->getConstAvatarData()->getHasPriority()) {
+            _heroes.push_back(i);
+        }
+    }
+}
+
+int AvatarSpatialIndex::find(const QUuid& nodeID) const {
+    auto entry = _entriesByID.find(nodeID);
+    return entry != _entriesByID.end() ? entry->second : -1;
+}
+
+int AvatarSpatialIndex::getMaxRing(const glm::vec3& position) const {
+    if (_entries.empty()) {
+        return -1;
+    }
+
+    int x = cellCoordinate(position.x);
+    int z = cellCoordinate(position.z);
+    return std::max(std::max(std::abs(x - _minX), std::abs(x - _maxX)), std::max(std::abs(z - _minZ), std::abs(z - _maxZ)));
+}
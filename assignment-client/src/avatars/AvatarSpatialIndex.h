@@ -0,0 +1,123 @@
+//
+//  AvatarSpatialIndex.h
+//  assignment-client/src/avatars
+//
+//  Created on 2019-11-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSpatialIndex_h
+#define hifi_AvatarSpatialIndex_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <NodeList.h>
+#include <UUIDHasher.h>
+
+// Grid of the agents' avatars, rebuilt once per frame, so that a listener can look at the avatars around it
+// ring by ring instead of at every node.
+//   Cells are square in the horizontal plane and unbounded vertically. Avatars are also split into NUM_FAR_BATCHES
+//   batches by local ID, for listeners to go over the ones that are too far to be found ring by ring a batch at a time.
+//   The index is built by the mixer thread and only read by the slaves during the broadcast.
+class AvatarSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    struct Entry {
+        const Node* node;
+        glm::vec3 position;
+    };
+
+    static const float CELL_SIZE;
+    static const int NUM_FAR_BATCHES = 16;
+
+    void build(ConstIter begin, ConstIter end);
+
+    int size() const { return (int)_entries.size(); }
+    const Entry& getEntry(int index) const { return _entries[index]; }
+
+    // bumped by every build, to rotate through the far batches
+    uint32_t getBuildNumber() const { return _buildNumber; }
+
+    // returns the index of the entry for that node, -1 if it isn't in the index
+    int find(const QUuid& nodeID) const;
+
+    // entries of avatars with hero priority
+    const std::vector<int>& getHeroes() const { return _heroes; }
+
+    // entries with a node local ID equal to batch modulo NUM_FAR_BATCHES
+    const std::vector<int>& getFarBatch(int batch) const { return _farBatches[batch]; }
+
+    // the last ring around position that has cells with avatars in it
+    int getMaxRing(const glm::vec3& position) const;
+
+    // calls visit(entryIndex) for the entries in the cells that are ring cells away from position's cell, 0 being its own
+    template <typename F>
+    void forEachInRing(const glm::vec3& position, int ring, F visit) const;
+
+private:
+    using CellKey = uint64_t;
+
+    static int cellCoordinate(float position) { return (int)floorf(position / CELL_SIZE); }
+    static CellKey cellKey(int x, int z) { return ((CellKey)(uint32_t)x << 32) | (uint32_t)z; }
+
+    template <typename F>
+    void forEachInCell(int x, int z, F& visit) const;
+
+    std::vector<Entry> _entries; // sorted by cell
+    std::unordered_map<CellKey, std::pair<int, int>> _cells; // [first, last) entries of each non-empty cell
+    std::unordered_map<QUuid, int> _entriesByID;
+    std::vector<int> _heroes;
+    std::vector<int> _farBatches[NUM_FAR_BATCHES];
+
+    // bounds of the non-empty cells
+    int _minX { 0 };
+    int _maxX { -1 };
+    int _minZ { 0 };
+    int _maxZ { -1 };
+
+    uint32_t _buildNumber { 0 };
+};
+
+template <typename F>
+void AvatarSpatialIndex::forEachInCell(int x, int z, F& visit) const {
+    if (x < _minX || x > _maxX || z < _minZ || z > _maxZ) {
+        return;
+    }
+
+    auto cell = _cells.find(cellKey(x, z));
+    if (cell != _cells.end()) {
+        for (int i = cell->second.first; i < cell->second.second; ++i) {
+            visit(i);
+        }
+    }
+}
+
+template <typename F>
+void AvatarSpatialIndex::forEachInRing(const glm::vec3& position, int ring, F visit) const {
+    int x = cellCoordinate(position.x);
+    int z = cellCoordinate(position.z);
+
+    if (ring == 0) {
+        forEachInCell(x, z, visit);
+        return;
+    }
+
+    // top and bottom rows, then the columns in between
+    for (int dx = -ring; dx <= ring; ++dx) {
+        forEachInCell(x + dx, z - ring, visit);
+        forEachInCell(x + dx, z + ring, visit);
+    }
+    for (int dz = -ring + 1; dz <= ring - 1; ++dz) {
+        forEachInCell(x - ring, z + dz, visit);
+        forEachInCell(x + ring, z + dz, visit);
+    }
+}
+
+#endif // hifi_AvatarSpatialIndex_h
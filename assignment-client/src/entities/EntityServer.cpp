@@ -60,6 +60,7 @@ EntityServer::EntityServer(ReceivedMessage& message) :
         PacketType::ChallengeOwnershipReply },
         this,
         "handleEntityPacket");
+    packetReceiver.registerListener(PacketType::EntityDataAck, this, "handleEntityDataAckPacket");
 
     connect(&_dynamicDomainVerificationTimer, &QTimer::timeout, this, &EntityServer::startDynamicDomainVerification);
     _dynamicDomainVerificationTimer.setSingleShot(true);
@@ -89,6 +90,13 @@ void EntityServer::handleEntityPacket(QSharedPointer<ReceivedMessage> message, S
     }
 }
 
+void EntityServer::handleEntityDataAckPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto nodeData = dynamic_cast<EntityNodeData*>(senderNode->getLinkedData());
+    if (nodeData) {
+        nodeData->parseEntityDataAckPacket(*message);
+    }
+}
+
 std::unique_ptr<OctreeQueryNode> EntityServer::createOctreeQueryNode() {
     return std::unique_ptr<OctreeQueryNode> { new EntityNodeData() };
 }
@@ -97,6 +105,14 @@ OctreePointer EntityServer::createTree() {
     EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
+
+    // drop the shared encodes from the thread making the change, before any send thread can see the new state
+    connect(tree.get(), &EntityTree::editingEntityPointer, this, [this](const EntityItemPointer& entity) {
+        _encodeCache.invalidate(entity->getID());
+    }, Qt::DirectConnection);
+    connect(tree.get(), &EntityTree::deletingEntityPointer, this, [this](EntityItem* entity) {
+        _encodeCache.invalidate(entity->getID());
+    }, Qt::DirectConnection);
     if (!_entitySimulation) {
         SimpleEntitySimulationPointer simpleSimulation { new SimpleEntitySimulation() };
         simpleSimulation->setEntityTree(tree);
@@ -112,6 +128,10 @@ OctreePointer EntityServer::createTree() {
 }
 
 OctreeServer::UniqueSendThread EntityServer::newSendThread(const SharedNodePointer& node) {
+    // forgotten again in trackViewerGone once the node is killed
+    if (_traversalPool) {
+        _traversalPool->addAgent(node->getUUID());
+    }
     return std::unique_ptr<EntityTreeSendThread>(new EntityTreeSendThread(this, node));
 }
 
@@ -346,6 +366,16 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
         tree->setEntityScriptSourceWhitelist("");
     }
     
+    bool wantTraversalPool = false;
+    readOptionBool(QString("traversalPool"), settingsSectionObject, wantTraversalPool);
+    qDebug("traversalPool=%s", debug::valueOf(wantTraversalPool));
+    if (wantTraversalPool && !_traversalPool) {
+        _traversalPool.reset(new EntityTraversalPool());
+    }
+
+    readOptionBool(QString("kinematicDeltas"), settingsSectionObject, _wantKinematicDeltas);
+    qDebug("kinematicDeltas=%s", debug::valueOf(_wantKinematicDeltas));
+
     auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
     
     QString filterURL;
@@ -382,6 +412,16 @@ void EntityServer::nodeKilled(SharedNodePointer node) {
     OctreeServer::nodeKilled(node);
 }
 
+void EntityServer::trackKinematicUpdate(bool isDelta, int numBytes) {
+    if (isDelta) {
+        _kinematicDeltasSent++;
+        _kinematicDeltaBytes += numBytes;
+    } else {
+        _kinematicFullUpdatesSent++;
+        _kinematicFullUpdateBytes += numBytes;
+    }
+}
+
 // FIXME - this stats tracking is somewhat temporary to debug the Whiteboard issues. It's not a bad
 // set of stats to have, but we'd probably want a different data structure if we keep it very long.
 // Since this version uses a single shared QMap for all senders, there could be some lock contention 
@@ -397,6 +437,10 @@ void EntityServer::trackViewerGone(const QUuid& sessionID) {
         _viewerSendingStats.remove(sessionID);
     }
 
+    if (_traversalPool) {
+        _traversalPool->forgetAgent(sessionID);
+    }
+
     if (_entitySimulation) {
         _tree->withReadLock([&] {
             _entitySimulation->clearOwnership(sessionID);
@@ -414,6 +458,68 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    auto encodeStats = _encodeCache.getStats();
+    uint64_t encodeLookups = encodeStats.hits + encodeStats.misses;
+    float encodeHitRate = encodeLookups > 0 ? (float)encodeStats.hits / (float)encodeLookups : 0.0f;
+    statsString += "<b>Entity Server Encode Cache Statistics</b>\r\n";
+    statsString += QString("         Hits... %1 (%2%)\r\n")
+        .arg(locale.toString((qulonglong)encodeStats.hits)).arg(encodeHitRate * 100.0f, 0, 'f', 1);
+    statsString += QString("       Misses... %1\r\n").arg(locale.toString((qulonglong)encodeStats.misses));
+    statsString += QString("      Too big... %1\r\n").arg(locale.toString((qulonglong)encodeStats.tooBig));
+    statsString += QString("Invalidations... %1\r\n").arg(locale.toString((qulonglong)encodeStats.invalidations));
+    statsString += QString("      Entries... %1\r\n").arg(locale.toString((qulonglong)encodeStats.numEntries));
+    statsString += QString("        Bytes... %1\r\n").arg(locale.toString((qulonglong)encodeStats.numBytes));
+    statsString += "\r\n\r\n";
+
+    if (_wantKinematicDeltas) {
+        uint64_t deltas = _kinematicDeltasSent;
+        uint64_t fullUpdates = _kinematicFullUpdatesSent;
+        statsString += "<b>Entity Server Kinematic Delta Statistics</b>\r\n";
+        statsString += QString("      Deltas sent... %1 (%2 bytes)\r\n")
+            .arg(locale.toString((qulonglong)deltas)).arg(locale.toString((qulonglong)_kinematicDeltaBytes));
+        statsString += QString("Full updates sent... %1 (%2 bytes)\r\n")
+            .arg(locale.toString((qulonglong)fullUpdates)).arg(locale.toString((qulonglong)_kinematicFullUpdateBytes));
+        statsString += "\r\n\r\n";
+    }
+
+    if (_traversalPool) {
+        auto traversalStats = _traversalPool->getStats();
+        statsString += "<b>Entity Server Traversal Pool Statistics</b>\r\n";
+        statsString += QString("           Threads... %1\r\n").arg(traversalStats.numThreads);
+        statsString += QString("            Slices... %1\r\n").arg(locale.toString((qulonglong)traversalStats.slices));
+        statsString += QString("    Avg Queue Time... %1 usecs\r\n").arg(traversalStats.averageQueueTime, 0, 'f', 1);
+        statsString += QString("    Avg Slice Time... %1 usecs\r\n").arg(traversalStats.averageSliceTime, 0, 'f', 1);
+        statsString += QString(" Shared Traversals... %1\r\n")
+            .arg(locale.toString((qulonglong)traversalStats.sharedTraversals));
+        statsString += QString("Adopted Traversals... %1\r\n")
+            .arg(locale.toString((qulonglong)traversalStats.adoptedTraversals));
+        statsString += "\r\n";
+
+        statsString += "----- Viewer Node ID -----------------    Avg Slice Time    Last Traversal Time    Traversals\r\n";
+        for (const auto& agentStats : _traversalPool->getAgentStats()) {
+            statsString += agentStats.agentID.toString() + "    ";
+            statsString += QString("%1 usecs").arg(agentStats.averageSliceTime, 8, 'f', 1);
+            statsString += QString("    %1 usecs").arg(locale.toString((qulonglong)agentStats.lastTraversalTime).rightJustified(13, ' '));
+            statsString += QString("    %1\r\n").arg(locale.toString((qulonglong)agentStats.traversals).rightJustified(10, ' '));
+        }
+        statsString += "\r\n\r\n";
+    }
+
+    auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+    auto filterStats = entityEditFilters ? entityEditFilters->getFilterStats() : QVector<EntityEditFilters::FilterStats>();
+    if (!filterStats.isEmpty()) {
+        statsString += "<b>Entity Server Edit Filter Statistics</b>\r\n";
+        statsString += "----- Zone ID --------------------------    Type      Evaluations     Rejections      Avg Time\r\n";
+        for (const auto& stats : filterStats) {
+            statsString += stats.zoneID.isInvalidID() ? QString("global").leftJustified(38, ' ') : stats.zoneID.toString();
+            statsString += stats.isNative ? "    rules " : "    script";
+            statsString += QString("    %1").arg(locale.toString((qulonglong)stats.evaluations).rightJustified(11, ' '));
+            statsString += QString("    %1").arg(locale.toString((qulonglong)stats.rejections).rightJustified(11, ' '));
+            statsString += QString("    %1 usecs\r\n").arg(stats.averageTime, 8, 'f', 1);
+        }
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -458,6 +564,56 @@ QString EntityServer::serverSubclassStats() {
     return statsString;
 }
 
+void EntityServer::addServerSubclassStats(QJsonObject& statsObject) {
+    auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+    if (entityEditFilters) {
+        QJsonObject filtersObject;
+        for (const auto& filterStats : entityEditFilters->getFilterStats()) {
+            QJsonObject filterObject;
+            filterObject["native"] = filterStats.isNative;
+            filterObject["evaluations"] = (double)filterStats.evaluations;
+            filterObject["rejections"] = (double)filterStats.rejections;
+            filterObject["avgTime"] = filterStats.averageTime;
+            filtersObject[filterStats.zoneID.isInvalidID() ? "global" : filterStats.zoneID.toString()] = filterObject;
+        }
+        statsObject["6. editFilters"] = filtersObject;
+    }
+
+    if (_wantKinematicDeltas) {
+        QJsonObject kinematicDeltasObject;
+        kinematicDeltasObject["1. deltas"] = (double)_kinematicDeltasSent;
+        kinematicDeltasObject["2. deltaBytes"] = (double)_kinematicDeltaBytes;
+        kinematicDeltasObject["3. fullUpdates"] = (double)_kinematicFullUpdatesSent;
+        kinematicDeltasObject["4. fullUpdateBytes"] = (double)_kinematicFullUpdateBytes;
+        statsObject["7. kinematicDeltas"] = kinematicDeltasObject;
+    }
+
+    if (!_traversalPool) {
+        return;
+    }
+
+    auto traversalStats = _traversalPool->getStats();
+    QJsonObject traversalObject;
+    traversalObject["1. threads"] = traversalStats.numThreads;
+    traversalObject["2. slices"] = (double)traversalStats.slices;
+    traversalObject["3. avgQueueTime"] = traversalStats.averageQueueTime;
+    traversalObject["4. avgSliceTime"] = traversalStats.averageSliceTime;
+    traversalObject["5. sharedTraversals"] = (double)traversalStats.sharedTraversals;
+    traversalObject["6. adoptedTraversals"] = (double)traversalStats.adoptedTraversals;
+
+    QJsonObject agentsObject;
+    for (const auto& agentStats : _traversalPool->getAgentStats()) {
+        QJsonObject agentObject;
+        agentObject["avgSliceTime"] = agentStats.averageSliceTime;
+        agentObject["lastTraversalTime"] = (double)agentStats.lastTraversalTime;
+        agentObject["traversals"] = (double)agentStats.traversals;
+        agentsObject[agentStats.agentID.toString()] = agentObject;
+    }
+    traversalObject["7. agents"] = agentsObject;
+
+    statsObject["5. traversalPool"] = traversalObject;
+}
+
 void EntityServer::domainSettingsRequestFailed() {
     auto nodeList = DependencyManager::get<NodeList>();
     qCDebug(entities) << "The EntityServer couldn't get the Domain Settings. Starting dynamic domain verification with default values...";
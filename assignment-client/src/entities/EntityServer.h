@@ -14,13 +14,16 @@
 
 #include "../octree/OctreeServer.h"
 
+#include <atomic>
 #include <memory>
 
+#include <EntityEncodeCache.h>
 #include <EntityItem.h>
 #include <EntityTree.h>
 #include <SimpleEntitySimulation.h>
 
 #include "EntityServerConsts.h"
+#include "EntityTraversalPool.h"
 
 /// Handles assignments of type EntityServer - sending entities to various clients.
 
@@ -53,12 +56,20 @@ public:
     virtual void entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) override;
     virtual void readAdditionalConfiguration(const QJsonObject& settingsSectionObject) override;
     virtual QString serverSubclassStats() override;
+    virtual void addServerSubclassStats(QJsonObject& statsObject) override;
 
     virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& sessionID) override;
     virtual void trackViewerGone(const QUuid& sessionID) override;
 
     virtual void aboutToFinish() override;
 
+    EntityEncodeCache& getEncodeCache() { return _encodeCache; }
+    EntityTraversalPool* getTraversalPool() const { return _traversalPool.get(); }
+
+    bool wantKinematicDeltas() const { return _wantKinematicDeltas; }
+    // called by the send threads for each update of a moving entity, sent as a delta or in full
+    void trackKinematicUpdate(bool isDelta, int numBytes);
+
 public slots:
     virtual void nodeAdded(SharedNodePointer node) override;
     virtual void nodeKilled(SharedNodePointer node) override;
@@ -71,12 +82,25 @@ protected:
 
 private slots:
     void handleEntityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleEntityDataAckPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void domainSettingsRequestFailed();
 
 private:
     SimpleEntitySimulationPointer _entitySimulation;
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
 
+    // encodes of the entities shared by all the send threads
+    EntityEncodeCache _encodeCache;
+
+    // runs the traversals of all the send threads when enabled in the domain settings, they run their own otherwise
+    std::unique_ptr<EntityTraversalPool> _traversalPool;
+
+    bool _wantKinematicDeltas { false };
+    std::atomic<uint64_t> _kinematicDeltasSent { 0 };
+    std::atomic<uint64_t> _kinematicDeltaBytes { 0 };
+    std::atomic<uint64_t> _kinematicFullUpdatesSent { 0 };
+    std::atomic<uint64_t> _kinematicFullUpdateBytes { 0 };
+
     QReadWriteLock _viewerSendingStatsLock;
     QMap<QUuid, QMap<QUuid, ViewerSendingStats>> _viewerSendingStats;
 
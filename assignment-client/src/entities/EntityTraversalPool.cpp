@@ -0,0 +1,179 @@
+//
+//  EntityTraversalPool.cpp
+//  assignment-client/src/entities
+//
+//  Created on 2019-11-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTraversalPool.h"
+
+#include <QtCore/QDebug>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+// a shared traversal is adopted as the completed traversal of the agent, whose next (Repeat) traversal catches up on
+// everything that changed since it started, so we only keep them for as long as that catching up stays cheap
+static const uint64_t MAX_SHARED_TRAVERSAL_AGE = USECS_PER_SECOND;
+static const size_t MAX_SHARED_TRAVERSALS = 16;
+
+EntityTraversalPool::EntityTraversalPool(int numThreads) {
+    if (numThreads < 1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int NUM_THREADS_IF_UNKNOWN = 4;
+        numThreads = NUM_THREADS_IF_UNKNOWN;
+    }
+    qDebug("%s: starting %d threads", __FUNCTION__, numThreads);
+
+    for (int i = 0; i < numThreads; ++i) {
+        _threads.emplace_back([this] { work(); });
+    }
+}
+
+EntityTraversalPool::~EntityTraversalPool() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void EntityTraversalPool::run(const QUuid& agentID, const std::function<void()>& slice) {
+    Task task;
+    task.slice = &slice;
+    task.queuedAt = usecTimestampNow();
+
+    Lock lock(_mutex);
+    _queue.push_back(&task);
+    _workCondition.notify_one();
+
+    task.done.wait(lock, [&] { return task.isDone; });
+
+    auto it = _agents.find(agentID);
+    if (it != _agents.end()) {
+        auto& agent = it->second;
+        agent.currentTraversalTime += task.sliceTime;
+        agent.sliceTime.updateAverage((float)task.sliceTime);
+    }
+}
+
+void EntityTraversalPool::work() {
+    Lock lock(_mutex);
+    while (true) {
+        _workCondition.wait(lock, [this] { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+            // stopping, once the queue is drained
+            return;
+        }
+
+        Task* task = _queue.front();
+        _queue.pop_front();
+        uint64_t start = usecTimestampNow();
+        _queueTime.updateAverage((float)(start - task->queuedAt));
+        lock.unlock();
+
+        (*task->slice)();
+
+        uint64_t sliceTime = usecTimestampNow() - start;
+        lock.lock();
+        _sliceTime.updateAverage((float)sliceTime);
+        ++_slices;
+
+        // the task lives on the stack of the send thread, which may return as soon as we let go of the lock
+        task->sliceTime = sliceTime;
+        task->isDone = true;
+        task->done.notify_one();
+    }
+}
+
+void EntityTraversalPool::traversalCompleted(const QUuid& agentID, bool adopted) {
+    Lock lock(_mutex);
+    if (adopted) {
+        ++_numAdoptedTraversals;
+    }
+
+    auto it = _agents.find(agentID);
+    if (it != _agents.end()) {
+        auto& agent = it->second;
+        agent.lastTraversalTime = agent.currentTraversalTime;
+        agent.currentTraversalTime = 0;
+        ++agent.traversals;
+    }
+}
+
+void EntityTraversalPool::addAgent(const QUuid& agentID) {
+    Lock lock(_mutex);
+    _agents[agentID];
+}
+
+void EntityTraversalPool::forgetAgent(const QUuid& agentID) {
+    Lock lock(_mutex);
+    _agents.erase(agentID);
+}
+
+void EntityTraversalPool::shareTraversal(SharedTraversalPointer traversal) {
+    Lock lock(_sharedMutex);
+    _sharedTraversals.push_back(std::move(traversal));
+    if (_sharedTraversals.size() > MAX_SHARED_TRAVERSALS) {
+        _sharedTraversals.pop_front();
+    }
+    ++_numSharedTraversals;
+}
+
+EntityTraversalPool::SharedTraversalPointer EntityTraversalPool::findSharedTraversal(const DiffTraversal::View& view) const {
+    uint64_t oldestStartTime = usecTimestampNow() - MAX_SHARED_TRAVERSAL_AGE;
+
+    Lock lock(_sharedMutex);
+    // newest first
+    for (auto it = _sharedTraversals.rbegin(); it != _sharedTraversals.rend(); ++it) {
+        const auto& traversal = *it;
+        if (traversal->view.startTime < oldestStartTime) {
+            break;
+        }
+        if (traversal->view.usesViewFrustums() == view.usesViewFrustums() && traversal->view.isVerySimilar(view)) {
+            return traversal;
+        }
+    }
+    return SharedTraversalPointer();
+}
+
+EntityTraversalPool::Stats EntityTraversalPool::getStats() const {
+    Stats stats;
+    stats.numThreads = getNumThreads();
+    {
+        Lock lock(_mutex);
+        stats.slices = _slices;
+        stats.averageQueueTime = _queueTime.getAverage();
+        stats.averageSliceTime = _sliceTime.getAverage();
+        stats.adoptedTraversals = _numAdoptedTraversals;
+    }
+    {
+        Lock lock(_sharedMutex);
+        stats.sharedTraversals = _numSharedTraversals;
+    }
+    return stats;
+}
+
+std::vector<EntityTraversalPool::AgentStats> EntityTraversalPool::getAgentStats() const {
+    std::vector<AgentStats> agentStats;
+
+    Lock lock(_mutex);
+    agentStats.reserve(_agents.size());
+    for (const auto& it : _agents) {
+        AgentStats stats;
+        stats.agentID = it.first;
+        stats.averageSliceTime = it.second.sliceTime.getAverage();
+        stats.lastTraversalTime = it.second.lastTraversalTime;
+        stats.traversals = it.second.traversals;
+        agentStats.push_back(stats);
+    }
+    return agentStats;
+}
@@ -0,0 +1,129 @@
+//
+//  EntityTraversalPool.h
+//  assignment-client/src/entities
+//
+//  Created on 2019-11-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTraversalPool_h
+#define hifi_EntityTraversalPool_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QThread>
+#include <QtCore/QUuid>
+
+#include <DiffTraversal.h>
+#include <SimpleMovingAverage.h>
+#include <UUIDHasher.h>
+
+// Runs the tree traversals of all the entity server's send threads on a fixed set of worker threads.
+//
+// A send thread hands the slice of its traversal to run() and sleeps until a worker has run it, so no matter how many
+// agents are connected at most getNumThreads() of them walk the tree (and hold its read lock) at a time. Slices run in
+// the order they were handed in, and each one is bounded by the traversal's time budget and resumes from the waypoint
+// stack the previous one left behind, so the agents take turns round-robin.
+//
+// The pool also keeps the results of recently completed First traversals: an agent starting out with a view very
+// similar to one of them takes that result instead of walking the whole tree itself.
+class EntityTraversalPool {
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+public:
+    // what a First traversal found, with the view (and start time) it ran with
+    struct SharedTraversal {
+        DiffTraversal::View view;
+        std::vector<std::pair<EntityItemWeakPointer, float>> entities; // and their priority
+    };
+    using SharedTraversalPointer = std::shared_ptr<const SharedTraversal>;
+
+    struct Stats {
+        int numThreads { 0 };
+        uint64_t slices { 0 };
+        float averageQueueTime { 0.0f }; // usecs from a slice being handed in to a worker starting it
+        float averageSliceTime { 0.0f }; // usecs
+        uint64_t sharedTraversals { 0 };
+        uint64_t adoptedTraversals { 0 };
+    };
+
+    struct AgentStats {
+        QUuid agentID;
+        float averageSliceTime { 0.0f }; // usecs
+        uint64_t lastTraversalTime { 0 }; // usecs spent in slices over the last completed traversal
+        uint64_t traversals { 0 };
+    };
+
+    explicit EntityTraversalPool(int numThreads = QThread::idealThreadCount());
+    ~EntityTraversalPool();
+
+    int getNumThreads() const { return (int)_threads.size(); }
+
+    // runs slice on one of the workers, and returns once it has run
+    void run(const QUuid& agentID, const std::function<void()>& slice);
+
+    // the agent's current traversal completed, adopted says it took a shared one instead of running its own
+    void traversalCompleted(const QUuid& agentID, bool adopted = false);
+
+    // the per agent stats are only kept between these, slices of a send thread still winding down after its agent was
+    // forgotten don't bring it back
+    void addAgent(const QUuid& agentID);
+    void forgetAgent(const QUuid& agentID);
+
+    void shareTraversal(SharedTraversalPointer traversal);
+    // returns a recent traversal whose view is very similar to view, if any
+    SharedTraversalPointer findSharedTraversal(const DiffTraversal::View& view) const;
+
+    Stats getStats() const;
+    std::vector<AgentStats> getAgentStats() const;
+
+private:
+    struct Task {
+        const std::function<void()>* slice;
+        uint64_t queuedAt;
+        uint64_t sliceTime { 0 };
+        std::condition_variable done;
+        bool isDone { false };
+    };
+
+    struct Agent {
+        SimpleMovingAverage sliceTime { 100 };
+        uint64_t currentTraversalTime { 0 };
+        uint64_t lastTraversalTime { 0 };
+        uint64_t traversals { 0 };
+    };
+
+    void work();
+
+    std::vector<std::thread> _threads;
+
+    // the queue and the timing stats, guarded by _mutex
+    mutable Mutex _mutex;
+    std::condition_variable _workCondition;
+    std::deque<Task*> _queue;
+    bool _stop { false };
+
+    SimpleMovingAverage _queueTime { 1000 };
+    SimpleMovingAverage _sliceTime { 1000 };
+    uint64_t _slices { 0 };
+    uint64_t _numAdoptedTraversals { 0 };
+    std::unordered_map<QUuid, Agent> _agents;
+
+    // the most recent shared traversals, oldest first, guarded by _sharedMutex
+    mutable Mutex _sharedMutex;
+    std::deque<SharedTraversalPointer> _sharedTraversals;
+    uint64_t _numSharedTraversals { 0 };
+};
+
+#endif // hifi_EntityTraversalPool_h
@@ -11,11 +11,22 @@
 
 #include "EntityTreeSendThread.h"
 
+#include <algorithm>
+
 #include <EntityNodeData.h>
 #include <EntityTypes.h>
 #include <OctreeUtils.h>
 
 #include "EntityServer.h"
+#include "EntityTraversalPool.h"
+
+// the agent acks a few times a second, so a kinematic baseline is a few hundred milliseconds old once it's acked; we
+// rebase on a new full update when it gets older than this, which also heals the deltas of an agent that lost the
+// baseline, and retry the full update at most this often until the agent acks it
+static const quint64 KINEMATIC_REBASE_AGE = 2 * USECS_PER_SECOND;
+static const quint64 KINEMATIC_REBASE_INTERVAL = USECS_PER_SECOND;
+// we forget the full updates of the oldest packets past this many sent without an ack
+static const size_t MAX_UNACKED_PACKETS = 1024;
 
 EntityTreeSendThread::EntityTreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) :
     OctreeSendThread(myServer, node)
@@ -33,6 +44,11 @@ void EntityTreeSendThread::resetState() {
 
     _knownState.clear();
     _traversal.reset();
+
+    _kinematicBaselines.clear();
+    _sectionFullUpdates.clear();
+    _packetFullUpdates.clear();
+    _unackedFullUpdates.clear();
 }
 
 void EntityTreeSendThread::preDistributionProcessing() {
@@ -99,8 +115,7 @@ void EntityTreeSendThread::preDistributionProcessing() {
     }
 }
 
-bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
-            bool viewFrustumChanged, bool isFullScene) {
+void EntityTreeSendThread::updateTraversal(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene) {
     if (viewFrustumChanged || _traversal.finished()) {
         EntityTreeElementPointer root = std::dynamic_pointer_cast<EntityTreeElement>(_myServer->getOctree()->getRoot());
 
@@ -110,36 +125,30 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
 
         int32_t lodLevelOffset = nodeData->getBoundaryLevelAdjust() + (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
         newView.lodScaleFactor = powf(2.0f, lodLevelOffset);
-        
+
+        // rather than walking the whole tree for our first view, take what another agent just found for the same view
+        auto traversalPool = getTraversalPool();
+        if (traversalPool && !isFullScene && _traversal.getStartOfCompletedTraversal() == 0 &&
+                adoptSharedTraversal(*traversalPool, newView)) {
+            return;
+        }
+
         startNewTraversal(newView, root, isFullScene);
 
-        // When the viewFrustum changed the sort order may be incorrect, so we re-sort
+        // When the viewFrustum changed the sort order may be incorrect, so we re-score the queue in place
         // and also use the opportunity to cull anything no longer in view
         if (viewFrustumChanged && !_sendQueue.empty()) {
-            EntityPriorityQueue prevSendQueue;
-            std::swap(_sendQueue, prevSendQueue);
-            assert(_sendQueue.empty());
-
-            // Re-add elements from previous traversal if they still need to be sent
-            while (!prevSendQueue.empty()) {
-                EntityItemPointer entity = prevSendQueue.top().getEntity();
-                bool forceRemove = prevSendQueue.top().shouldForceRemove();
-                prevSendQueue.pop();
-                if (entity) {
-                    float priority = PrioritizedEntity::DO_NOT_SEND;
-
-                    if (forceRemove) {
-                        priority = PrioritizedEntity::FORCE_REMOVE;
-                    } else {
-                        const auto& view = _traversal.getCurrentView();
-                        priority = view.computePriority(entity);
-                    }
-
-                    if (priority != PrioritizedEntity::DO_NOT_SEND) {
-                        _sendQueue.emplace(entity, priority, forceRemove);
-                    }
+            const auto& view = _traversal.getCurrentView();
+            _sendQueue.reprioritize([&](const PrioritizedEntity& queuedItem) {
+                EntityItemPointer entity = queuedItem.getEntity();
+                if (!entity) {
+                    return PrioritizedEntity::DO_NOT_SEND;
                 }
-            }
+                if (queuedItem.shouldForceRemove()) {
+                    return PrioritizedEntity::FORCE_REMOVE;
+                }
+                return view.computePriority(entity);
+            });
         }
     }
 
@@ -153,7 +162,72 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
         #endif
         _traversal.traverse(TIME_BUDGET);
         OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
+
+        if (_traversal.finished()) {
+            traversalCompleted();
+        }
     }
+}
+
+EntityTraversalPool* EntityTreeSendThread::getTraversalPool() const {
+    return static_cast<EntityServer*>(_myServer)->getTraversalPool();
+}
+
+bool EntityTreeSendThread::adoptSharedTraversal(EntityTraversalPool& traversalPool, const DiffTraversal::View& view) {
+    auto sharedTraversal = traversalPool.findSharedTraversal(view);
+    if (!sharedTraversal) {
+        return false;
+    }
+
+    // same as a First traversal: forget what we knew, and queue everything that was found in view
+    _knownState.clear();
+    for (const auto& found : sharedTraversal->entities) {
+        EntityItemPointer entity = found.first.lock();
+        if (entity && !_sendQueue.contains(entity.get())) {
+            _sendQueue.emplace(entity, found.second);
+        }
+    }
+    _traversal.adoptCompletedTraversal(sharedTraversal->view);
+    _sharingFirstTraversal = false;
+    _firstTraversalEntities.clear();
+
+    traversalPool.traversalCompleted(_nodeUuid, true);
+    return true;
+}
+
+void EntityTreeSendThread::traversalCompleted() {
+    auto traversalPool = getTraversalPool();
+    if (!traversalPool) {
+        return;
+    }
+
+    if (_sharingFirstTraversal) {
+        auto sharedTraversal = std::make_shared<EntityTraversalPool::SharedTraversal>();
+        sharedTraversal->view = _traversal.getCurrentView();
+        sharedTraversal->entities.swap(_firstTraversalEntities);
+        traversalPool->shareTraversal(sharedTraversal);
+        _sharingFirstTraversal = false;
+    }
+    traversalPool->traversalCompleted(_nodeUuid);
+}
+
+bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
+            bool viewFrustumChanged, bool isFullScene) {
+    auto traversalPool = getTraversalPool();
+    if (traversalPool) {
+        // a worker of the pool takes the tree lock for us, we must not hold it while we wait for one
+        traversalPool->run(_nodeUuid, [&] {
+            withTreeReadLock([&] {
+                updateTraversal(nodeData, viewFrustumChanged, isFullScene);
+            });
+        });
+    } else {
+        withTreeReadLock([&] {
+            updateTraversal(nodeData, viewFrustumChanged, isFullScene);
+        });
+    }
+
+    processEntityDataAck(*static_cast<EntityNodeData*>(nodeData));
 
     bool sendComplete = OctreeSendThread::traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
 
@@ -229,6 +303,10 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
                                              bool forceFirstPass) {
 
     DiffTraversal::Type type = _traversal.prepareNewTraversal(view, root, forceFirstPass);
+
+    // only a First traversal finds everything in view, the others are no use to another agent
+    _sharingFirstTraversal = (type == DiffTraversal::First) && getTraversalPool();
+    _firstTraversalEntities.clear();
     // there are three types of traversal:
     //
     //      (1) FirstTime = at login --> find everything in view
@@ -243,15 +321,22 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
             _knownState.clear();
             _traversal.setScanCallback([this](DiffTraversal::VisibleElement& next) {
                 next.element->forEachEntity([&](EntityItemPointer entity) {
-                    // Bail early if we've already checked this entity this frame
-                    if (_sendQueue.contains(entity.get())) {
+                    // Bail early if we've already checked this entity this frame,
+                    // unless we're collecting everything in view for the other agents
+                    bool isQueued = _sendQueue.contains(entity.get());
+                    if (isQueued && !_sharingFirstTraversal) {
                         return;
                     }
                     const auto& view = _traversal.getCurrentView();
                     float priority = view.computePriority(entity);
 
                     if (priority != PrioritizedEntity::DO_NOT_SEND) {
-                        _sendQueue.emplace(entity, priority);
+                        if (!isQueued) {
+                            _sendQueue.emplace(entity, priority);
+                        }
+                        if (_sharingFirstTraversal) {
+                            _firstTraversalEntities.emplace_back(entity, priority);
+                        }
                     }
                 });
             });
@@ -326,6 +411,9 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
     quint64 encodeStart = usecTimestampNow();
     if (!_packetData.hasContent()) {
         // This is the beginning of a new packet.
+        // Whatever was in the previous one and didn't make it to the agent's packet is gone.
+        _sectionFullUpdates.clear();
+
         // We pack minimal data for this to be accepted as an OctreeElement payload for the root element.
         // The Octree header bytes look like this:
         //
@@ -363,7 +451,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
     auto entityNode = _node.toStrongRef();
     auto entityNodeData = static_cast<EntityNodeData*>(entityNode->getLinkedData());
     while(!_sendQueue.empty()) {
-        PrioritizedEntity queuedItem = _sendQueue.top();
+        const PrioritizedEntity& queuedItem = _sendQueue.top();
         EntityItemPointer entity = queuedItem.getEntity();
         if (entity) {
             const QUuid& entityID = entity->getID();
@@ -377,7 +465,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
                     // Record explicitly filtered-in entity so that extra entities can be flagged.
                     entityNodeData->insertSentFilteredEntity(entityID);
                 }
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(&_packetData, params, _extraEncodeData, entityNode->getCanGetAndSetPrivateUserData());
+                OctreeElement::AppendState appendEntityState = appendEntity(*entity, params, entityNode->getCanGetAndSetPrivateUserData());
 
                 if (appendEntityState != OctreeElement::COMPLETED) {
                     if (appendEntityState == OctreeElement::PARTIAL) {
@@ -418,6 +506,150 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
     return true;
 }
 
+OctreeElement::AppendState EntityTreeSendThread::appendEntity(const EntityItem& entity, EncodeBitstreamParams& params,
+                                                              bool canGetAndSetPrivateUserData) {
+    // the rest of an entity split over several packets is always encoded for this viewer
+    if (_extraEncodeData->entities.contains(entity.getEntityItemID())) {
+        return entity.appendEntityData(&_packetData, params, _extraEncodeData, canGetAndSetPrivateUserData);
+    }
+
+    auto entityServer = static_cast<EntityServer*>(_myServer);
+    bool wantKinematicDeltas = entityServer->wantKinematicDeltas();
+    OctreeElement::AppendState appendState;
+    if (wantKinematicDeltas && appendKinematicDelta(entity, params, appendState)) {
+        return appendState;
+    }
+
+    int startSize = _packetData.getUncompressedSize();
+    QByteArray encoded = entityServer->getEncodeCache().get(entity, canGetAndSetPrivateUserData);
+    if (!encoded.isEmpty() && _packetData.appendRawData((const unsigned char*)encoded.constData(), encoded.size())) {
+        params.trackSend(entity.getID(), entity.getLastEdited());
+        appendState = OctreeElement::COMPLETED;
+    } else {
+        appendState = entity.appendEntityData(&_packetData, params, _extraEncodeData, canGetAndSetPrivateUserData);
+    }
+    // only an update that went out whole can be a baseline
+    if (wantKinematicDeltas && appendState == OctreeElement::COMPLETED) {
+        fullUpdateAppended(entity, _packetData.getUncompressedSize() - startSize);
+    }
+    return appendState;
+}
+
+bool EntityTreeSendThread::appendKinematicDelta(const EntityItem& entity, EncodeBitstreamParams& params,
+                                                OctreeElement::AppendState& appendState) {
+    auto itr = _kinematicBaselines.find(&entity);
+    if (itr == _kinematicBaselines.end() || !itr->second.hasAcked || itr->second.entityID != entity.getID()) {
+        return false;
+    }
+    const KinematicBaselines& baselines = itr->second;
+    const KinematicBaseline& baseline = baselines.acked;
+
+    // the agent only keeps the last few full updates
+    if (baselines.numFullUpdates - baseline.index > EntityKinematicDelta::MAX_BASELINES) {
+        return false;
+    }
+    quint64 now = usecTimestampNow();
+    if (now - baseline.sentAt > KINEMATIC_REBASE_AGE && now - baselines.lastFullUpdateAt > KINEMATIC_REBASE_INTERVAL) {
+        return false;
+    }
+    // the delta carries nothing but the kinematic state
+    if (entity.getLastNonKinematicChange() != baseline.lastNonKinematicChange ||
+            entity.getSimulatorID() != baseline.simulatorID ||
+            entity.getSimulationPriority() != baseline.simulationPriority ||
+            entity.getLastEditedBy() != baseline.lastEditedBy) {
+        return false;
+    }
+
+    QByteArray delta;
+    if (!EntityKinematicDelta::encode(baseline.sequence, baseline.state, entity.getKinematicState(), delta)) {
+        return false;
+    }
+    int startSize = _packetData.getUncompressedSize();
+    if (!entity.appendKinematicDelta(&_packetData, params, delta)) {
+        appendState = OctreeElement::NONE;
+        return true;
+    }
+    static_cast<EntityServer*>(_myServer)->trackKinematicUpdate(true, _packetData.getUncompressedSize() - startSize);
+    appendState = OctreeElement::COMPLETED;
+    return true;
+}
+
+void EntityTreeSendThread::fullUpdateAppended(const EntityItem& entity, int numBytes) {
+    KinematicBaselines& baselines = _kinematicBaselines[&entity];
+    if (baselines.entityID != entity.getID()) {
+        // a new entity, or one that took the place of a deleted one
+        baselines = KinematicBaselines();
+        baselines.entityID = entity.getID();
+    }
+
+    KinematicBaseline baseline;
+    baseline.entityID = baselines.entityID;
+    baseline.index = baselines.numFullUpdates++;
+    baseline.lastNonKinematicChange = entity.getLastNonKinematicChange();
+    baseline.simulatorID = entity.getSimulatorID();
+    baseline.simulationPriority = entity.getSimulationPriority();
+    baseline.lastEditedBy = entity.getLastEditedBy();
+    baseline.state = entity.getKinematicState();
+    baselines.lastFullUpdateAt = usecTimestampNow();
+    _sectionFullUpdates.emplace_back(&entity, baseline);
+
+    if (baseline.state.velocity != glm::vec3(0.0f) || baseline.state.angularVelocity != glm::vec3(0.0f)) {
+        static_cast<EntityServer*>(_myServer)->trackKinematicUpdate(false, numBytes);
+    }
+}
+
+void EntityTreeSendThread::sectionWritten() {
+    _packetFullUpdates.insert(_packetFullUpdates.end(), _sectionFullUpdates.begin(), _sectionFullUpdates.end());
+    _sectionFullUpdates.clear();
+}
+
+void EntityTreeSendThread::packetSent(OCTREE_PACKET_SEQUENCE sequence) {
+    if (_packetFullUpdates.empty()) {
+        return;
+    }
+    quint64 now = usecTimestampNow();
+    for (auto& fullUpdate : _packetFullUpdates) {
+        fullUpdate.second.sequence = sequence;
+        fullUpdate.second.sentAt = now;
+    }
+    _unackedFullUpdates.emplace_back(sequence, KinematicBaselineList());
+    _unackedFullUpdates.back().second.swap(_packetFullUpdates);
+    if (_unackedFullUpdates.size() > MAX_UNACKED_PACKETS) {
+        _unackedFullUpdates.pop_front();
+    }
+}
+
+void EntityTreeSendThread::packetDropped() {
+    _packetFullUpdates.clear();
+}
+
+void EntityTreeSendThread::processEntityDataAck(EntityNodeData& nodeData) {
+    OCTREE_PACKET_SEQUENCE lastReceived;
+    std::vector<OCTREE_PACKET_SEQUENCE> missing;
+    if (!nodeData.takeEntityDataAck(lastReceived, missing)) {
+        return;
+    }
+
+    // sequence numbers wrap around, but we never have more than MAX_UNACKED_PACKETS in flight
+    while (!_unackedFullUpdates.empty() && (int16_t)(_unackedFullUpdates.front().first - lastReceived) <= 0) {
+        const auto& packet = _unackedFullUpdates.front();
+        if (std::find(missing.begin(), missing.end(), packet.first) == missing.end()) {
+            for (const auto& fullUpdate : packet.second) {
+                auto itr = _kinematicBaselines.find(fullUpdate.first);
+                if (itr == _kinematicBaselines.end() || itr->second.entityID != fullUpdate.second.entityID) {
+                    continue;
+                }
+                KinematicBaselines& baselines = itr->second;
+                if (!baselines.hasAcked || fullUpdate.second.index > baselines.acked.index) {
+                    baselines.acked = fullUpdate.second;
+                    baselines.hasAcked = true;
+                }
+            }
+        }
+        _unackedFullUpdates.pop_front();
+    }
+}
+
 void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity) {
     if (entity) {
         if (!_sendQueue.contains(entity.get()) && _knownState.find(entity.get()) != _knownState.end()) {
@@ -436,4 +668,5 @@ void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity)
 
 void EntityTreeSendThread::deletingEntityPointer(EntityItem* entity) {
     _knownState.erase(entity);
+    _kinematicBaselines.erase(entity);
 }
@@ -12,17 +12,21 @@
 #ifndef hifi_EntityTreeSendThread_h
 #define hifi_EntityTreeSendThread_h
 
+#include <deque>
 #include <unordered_set>
+#include <vector>
 
 #include "../octree/OctreeSendThread.h"
 
 #include <DiffTraversal.h>
+#include <EntityKinematicDelta.h>
 #include <EntityPriorityQueue.h>
 #include <shared/ConicalViewFrustum.h>
 
 
 class EntityNodeData;
 class EntityItem;
+class EntityTraversalPool;
 
 class EntityTreeSendThread : public OctreeSendThread {
     Q_OBJECT
@@ -34,6 +38,10 @@ protected:
     bool traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene) override;
 
+    void sectionWritten() override;
+    void packetSent(OCTREE_PACKET_SEQUENCE sequence) override;
+    void packetDropped() override;
+
 private slots:
     void resetState(); // clears our known state forcing entities to appear unsent
 
@@ -43,8 +51,44 @@ private:
     bool addDescendantsToExtraFlaggedEntities(const QUuid& filteredEntityID, EntityItem& entityItem, EntityNodeData& nodeData);
 
     void startNewTraversal(const DiffTraversal::View& viewFrustum, EntityTreeElementPointer root, bool forceFirstPass = false);
+    void updateTraversal(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene); // with the tree read locked
+
+    // the server's traversal pool, or nullptr when we traverse on this thread
+    EntityTraversalPool* getTraversalPool() const;
+    // starts us off with a First traversal another agent completed with a very similar view, if there is one
+    bool adoptSharedTraversal(EntityTraversalPool& traversalPool, const DiffTraversal::View& view);
+    void traversalCompleted();
     bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) override;
 
+    // appends the server's shared encode of the entity when it fits whole, and encodes it for this packet otherwise
+    OctreeElement::AppendState appendEntity(const EntityItem& entity, EncodeBitstreamParams& params, bool canGetAndSetPrivateUserData);
+
+    // a full update of an entity, that kinematic deltas are relative to once the agent acks the packet it went out in
+    struct KinematicBaseline {
+        QUuid entityID;
+        uint32_t index { 0 }; // of the full update, among those of the entity we sent
+        OCTREE_PACKET_SEQUENCE sequence { 0 };
+        quint64 sentAt { 0 };
+        quint64 lastNonKinematicChange { 0 };
+        QUuid simulatorID;
+        uint8_t simulationPriority { 0 };
+        QUuid lastEditedBy;
+        EntityKinematicState state;
+    };
+    struct KinematicBaselines {
+        QUuid entityID;
+        uint32_t numFullUpdates { 0 };
+        quint64 lastFullUpdateAt { 0 };
+        bool hasAcked { false };
+        KinematicBaseline acked;
+    };
+    using KinematicBaselineList = std::vector<std::pair<const EntityItem*, KinematicBaseline>>;
+
+    // returns false if the entity has to go out in full, and the state of the append of its delta otherwise
+    bool appendKinematicDelta(const EntityItem& entity, EncodeBitstreamParams& params, OctreeElement::AppendState& appendState);
+    void fullUpdateAppended(const EntityItem& entity, int numBytes);
+    void processEntityDataAck(EntityNodeData& nodeData);
+
     void preDistributionProcessing() override;
     bool hasSomethingToSend(OctreeQueryNode* nodeData) override { return !_sendQueue.empty(); }
     bool shouldStartNewTraversal(OctreeQueryNode* nodeData, bool viewFrustumChanged) override { return viewFrustumChanged || _traversal.finished(); }
@@ -53,11 +97,22 @@ private:
     EntityPriorityQueue _sendQueue;
     std::unordered_map<EntityItem*, uint64_t> _knownState;
 
+    // what the current First traversal found, shared through the traversal pool once it completes
+    std::vector<std::pair<EntityItemWeakPointer, float>> _firstTraversalEntities;
+    bool _sharingFirstTraversal { false };
+
     // packet construction stuff
     EntityTreeElementExtraEncodeDataPointer _extraEncodeData { new EntityTreeElementExtraEncodeData() };
     int32_t _numEntitiesOffset { 0 };
     uint16_t _numEntities { 0 };
 
+    // kinematic deltas: the baselines the agent acked, and the full updates of the section being built, of the packet
+    // being filled and of the packets sent that the agent didn't ack yet
+    std::unordered_map<const EntityItem*, KinematicBaselines> _kinematicBaselines;
+    KinematicBaselineList _sectionFullUpdates;
+    KinematicBaselineList _packetFullUpdates;
+    std::deque<std::pair<OCTREE_PACKET_SEQUENCE, KinematicBaselineList>> _unackedFullUpdates;
+
 private slots:
     void editingEntityPointer(const EntityItemPointer& entity);
     void deletingEntityPointer(EntityItem* entity);
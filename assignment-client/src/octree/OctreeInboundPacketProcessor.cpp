@@ -22,6 +22,8 @@
 
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
+// edit packets are applied in batches of at most this many, under one write lock
+const size_t MAX_EDIT_BATCH_SIZE = 64;
 
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
@@ -31,6 +33,9 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
+    _totalBatches(0),
+    _totalBatchedEdits(0),
+    _totalCoalescedEdits(0),
     _lastNackTime(usecTimestampNow()),
     _shuttingDown(false)
 {
@@ -42,6 +47,9 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalLockWaitTime = 0;
     _totalElementsInPacket = 0;
     _totalPackets = 0;
+    _totalBatches = 0;
+    _totalBatchedEdits = 0;
+    _totalCoalescedEdits = 0;
     _lastNackTime = usecTimestampNow();
 
     QWriteLocker locker(&_senderStatsLock);
@@ -72,10 +80,56 @@ void OctreeInboundPacketProcessor::midProcess() {
     quint64 now = usecTimestampNow();
     if (now - _lastNackTime >= TOO_LONG_SINCE_LAST_NACK) {
         _lastNackTime = now;
+        // the sequence numbers of the batched packets are only tracked once they're applied
+        flushEditBatch();
         sendNackPackets();
     }
 }
 
+void OctreeInboundPacketProcessor::postProcess() {
+    flushEditBatch();
+}
+
+void OctreeInboundPacketProcessor::flushEditBatch() {
+    if (_editBatch.empty()) {
+        return;
+    }
+
+    bool debugProcessPacket = _myServer->wantsVerboseDebug();
+    PerformanceWarning warn(debugProcessPacket, "flushEditBatch", debugProcessPacket);
+
+    // one write lock for the whole batch
+    quint64 startProcess, startLock = usecTimestampNow();
+    _myServer->getOctree()->withWriteLock([&] {
+        startProcess = usecTimestampNow();
+        _myServer->getOctree()->processEditBatch(_editBatch);
+    });
+    quint64 lockWaitTime = (startProcess - startLock) / _editBatch.size();
+
+    int batchedEdits = 0;
+    int coalescedEdits = 0;
+    for (size_t i = 0; i < _editBatch.size(); i++) {
+        const OctreeEditBatchMessage& batchMessage = _editBatch[i];
+        const EditBatchPacket& packet = _editBatchPackets[i];
+        trackInboundPacket(packet.nodeUUID, packet.sequence, packet.transitTime, batchMessage.numEdits,
+            batchMessage.processTime, lockWaitTime);
+        batchedEdits += batchMessage.numEdits;
+        coalescedEdits += batchMessage.numCoalescedEdits;
+    }
+
+    if (debugProcessPacket) {
+        qDebug() << "OctreeInboundPacketProcessor::flushEditBatch() packets=" << _editBatch.size()
+            << "edits=" << batchedEdits << "coalescedEdits=" << coalescedEdits;
+    }
+
+    _totalBatches++;
+    _totalBatchedEdits += batchedEdits;
+    _totalCoalescedEdits += coalescedEdits;
+
+    _editBatch.clear();
+    _editBatchPackets.clear();
+}
+
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
@@ -93,6 +147,12 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
     // Ask our tree subclass if it can handle the incoming packet...
     PacketType packetType = message->getType();
     
+    if (packetType == PacketType::ChallengeOwnership || packetType == PacketType::ChallengeOwnershipRequest ||
+            packetType == PacketType::ChallengeOwnershipReply) {
+        // edits queued ahead of this packet go first
+        flushEditBatch();
+    }
+
     if (packetType == PacketType::ChallengeOwnership) {
         _myServer->getOctree()->withWriteLock([&] {
             _myServer->getOctree()->processChallengeOwnershipPacket(*message, sendingNode);
@@ -125,9 +185,6 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         }
 
         quint64 transitTime = arrivedAt - sentAt;
-        int editsInPacket = 0;
-        quint64 processTime = 0;
-        quint64 lockWaitTime = 0;
 
         if (debugProcessPacket || _myServer->wantsDebugReceiving()) {
             qDebug() << "PROCESSING THREAD: got '" << packetType << "' packet - " << _receivedPacketCount << " command from client";
@@ -153,60 +210,6 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             }
         }
         
-        const unsigned char* editData = nullptr;
-        
-        while (message->getBytesLeftToRead() > 0) {
-
-            editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
-
-            int maxSize = message->getBytesLeftToRead();
-
-            if (debugProcessPacket) {
-                qDebug() << " --- inside while loop ---";
-                qDebug() << "    maxSize=" << maxSize;
-                qDebug("OctreeInboundPacketProcessor::processPacket() %hhu "
-                       "payload=%p payloadLength=%lld editData=%p payloadPosition=%lld maxSize=%d",
-                       (unsigned char)packetType, message->getRawMessage(), message->getSize(), editData,
-                        message->getPosition(), maxSize);
-            }
-
-            quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
-                    _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
-            quint64 endProcess = usecTimestampNow();
-
-            if (debugProcessPacket) {
-                qDebug() << "OctreeInboundPacketProcessor::processPacket() after processEditPacketData()..."
-                    << "editDataBytesRead=" << editDataBytesRead;
-            }
-
-            editsInPacket++;
-            quint64 thisProcessTime = endProcess - startProcess;
-            quint64 thisLockWaitTime = startProcess - startLock;
-            processTime += thisProcessTime;
-            lockWaitTime += thisLockWaitTime;
-
-            // skip to next edit record in the packet
-            message->seek(message->getPosition() + editDataBytesRead);
-
-            if (debugProcessPacket) {
-                qDebug() << "    editDataBytesRead=" << editDataBytesRead;
-                qDebug() << "    AFTER processEditPacketData payload position=" << message->getPosition();
-                qDebug() << "    AFTER processEditPacketData payload size=" << message->getSize();
-            }
-
-        }
-
-        if (debugProcessPacket) {
-            qDebug("OctreeInboundPacketProcessor::processPacket() DONE LOOPING FOR %hhu "
-                   "payload=%p payloadLength=%lld editData=%p payloadPosition=%lld",
-                   (unsigned char)packetType, message->getRawMessage(), message->getSize(), editData, message->getPosition());
-        }
-
         // Make sure our Node and NodeList knows we've heard from this node.
         QUuid& nodeUUID = DEFAULT_NODE_ID_REF;
         if (sendingNode) {
@@ -219,7 +222,14 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                 qDebug() << "sender has no known nodeUUID.";
             }
         }
-        trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+
+        // applied, and tracked, with the rest of its batch
+        _editBatch.emplace_back(message, sendingNode);
+        _editBatchPackets.push_back({ nodeUUID, sequence, transitTime });
+
+        if (_editBatch.size() >= MAX_EDIT_BATCH_SIZE) {
+            flushEditBatch();
+        }
     } else {
         qDebug("unknown packet ignored... packetType=%hhu", (unsigned char)packetType);
     }
@@ -14,6 +14,9 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <vector>
+
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -69,6 +72,11 @@ public:
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
+    // edits applied per batch, and the share of them that a later edit in their batch made redundant
+    float getAverageBatchSize() const
+                { return _totalBatches == 0 ? 0.0f : (float)_totalBatchedEdits / (float)_totalBatches; }
+    float getCoalescedEditRatio() const
+                { return _totalBatchedEdits == 0 ? 0.0f : (float)_totalCoalescedEdits / (float)_totalBatchedEdits; }
 
     void resetStats();
 
@@ -83,11 +91,21 @@ protected:
     virtual uint32_t getMaxWait() const override;
     virtual void preProcess() override;
     virtual void midProcess() override;
+    virtual void postProcess() override;
 
 private:
     int sendNackPackets();
 
+    // applies the queued edit packets under one write lock, and tracks them
+    void flushEditBatch();
+
 private:
+    struct EditBatchPacket {
+        QUuid nodeUUID;
+        unsigned short int sequence;
+        quint64 transitTime;
+    };
+
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
 
@@ -99,6 +117,13 @@ private:
     std::atomic<uint64_t> _totalLockWaitTime;
     std::atomic<uint64_t> _totalElementsInPacket;
     std::atomic<uint64_t> _totalPackets;
+    std::atomic<uint64_t> _totalBatches;
+    std::atomic<uint64_t> _totalBatchedEdits;
+    std::atomic<uint64_t> _totalCoalescedEdits;
+
+    // edit packets read up to their first edit, waiting for flushEditBatch(), and what we track about each
+    OctreeEditBatch _editBatch;
+    std::vector<EditBatchPacket> _editBatchPackets;
     
     NodeToSenderStatsMap _singleSenderStats;
     QReadWriteLock _senderStatsLock;
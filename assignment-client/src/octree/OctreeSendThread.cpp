@@ -149,6 +149,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
     // obscure the packet and not send it. This allows the callers and upper level logic to not need to know about
     // this rate control savings.
     if (!dontSuppressDuplicate && nodeData->shouldSuppressDuplicatePacket()) {
+        packetDropped();
         nodeData->resetOctreePacket(); // we still need to reset it though!
         return numPackets; // without sending...
     }
@@ -294,6 +295,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
     // remember to track our stats
     if (numPackets > 0) {
         nodeData->stats.packetSent(nodeData->getPacket().getPayloadSize());
+        packetSent(nodeData->getSequenceNumber());
         nodeData->octreePacketSent();
         nodeData->resetOctreePacket();
     }
@@ -363,9 +365,8 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
     quint64 start = usecTimestampNow();
 
-    _myServer->getOctree()->withReadLock([&]{
-        traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
-    });
+    // the tree is only read locked while payloads are built, compressing and sending happen without it
+    traverseTreeAndSendContents(node, nodeData, viewFrustumChanged, isFullScene);
 
     // Here's where we can/should allow the server to send other data...
     // send the environment packet
@@ -373,6 +374,9 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     if (_myServer->hasSpecialPacketsToSend(node) && !nodeData->isShuttingDown()) {
         int specialPacketsSent = 0;
         int specialBytesSent = _myServer->sendSpecialPackets(node, nodeData, specialPacketsSent);
+        if (nodeData->isPacketWaiting()) {
+            packetDropped();
+        }
         nodeData->resetOctreePacket();   // because nodeData's _sequenceNumber has changed
         _truePacketsSent += specialPacketsSent;
         _trueBytesSent += specialBytesSent;
@@ -425,6 +429,16 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     return _truePacketsSent;
 }
 
+void OctreeSendThread::withTreeReadLock(const std::function<void()>& f) {
+    quint64 lockWaitStart = usecTimestampNow();
+    _myServer->getOctree()->withReadLock([&] {
+        quint64 lockStart = usecTimestampNow();
+        OctreeServer::trackTreeWaitTime((float)(lockStart - lockWaitStart));
+        f();
+        OctreeServer::trackTreeHoldTime((float)(usecTimestampNow() - lockStart));
+    });
+}
+
 bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged, bool isFullScene) {
     // calculate max number of packets that can be sent during this interval
     int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
@@ -450,7 +464,9 @@ bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
         bool lastNodeDidntFit = false; // assume each node fits
         params.stopReason = EncodeBitstreamParams::UNKNOWN; // reset params.stopReason before traversal
 
-        somethingToSend = traverseTreeAndBuildNextPacketPayload(params, nodeData->getJSONParameters());
+        withTreeReadLock([&] {
+            somethingToSend = traverseTreeAndBuildNextPacketPayload(params, nodeData->getJSONParameters());
+        });
 
         if (params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
             lastNodeDidntFit = true;
@@ -474,6 +490,7 @@ bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
                 // either there is room, or we've flushed and reset nodeData's data buffer
                 // so we can transfer whatever is in _packetData to nodeData
                 nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
+                sectionWritten();
                 compressAndWriteElapsedUsec = (float)(usecTimestampNow()- compressAndWriteStart);
             }
 
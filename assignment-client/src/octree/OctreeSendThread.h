@@ -15,6 +15,7 @@
 #define hifi_OctreeSendThread_h
 
 #include <atomic>
+#include <functional>
 
 #include <GenericThread.h>
 #include <Node.h>
@@ -56,6 +57,16 @@ protected:
             bool viewFrustumChanged, bool isFullScene);
     virtual bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) = 0;
 
+    // runs f holding the tree read lock, tracking how long we waited for it and how long we held it
+    void withTreeReadLock(const std::function<void()>& f);
+
+    // called when the section in _packetData has been written to the agent's packet
+    virtual void sectionWritten() {}
+    // called when the agent's packet went out with this sequence number
+    virtual void packetSent(OCTREE_PACKET_SEQUENCE sequence) {}
+    // called when the agent's packet was reset without going out
+    virtual void packetDropped() {}
+
     OctreePacketData _packetData;
     QWeakPointer<Node> _node;
     OctreeServer* _myServer { nullptr };
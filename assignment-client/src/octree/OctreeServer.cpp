@@ -62,6 +62,7 @@ int OctreeServer::_extraLongTreeWait = 0;
 int OctreeServer::_longTreeWait = 0;
 int OctreeServer::_shortTreeWait = 0;
 int OctreeServer::_noTreeWait = 0;
+SimpleMovingAverage OctreeServer::_averageTreeHoldTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 
 SimpleMovingAverage OctreeServer::_averageTreeTraverseTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 
@@ -108,6 +109,7 @@ void OctreeServer::resetSendingStats() {
     _averageTreeShortWaitTime.reset();
     _averageTreeLongWaitTime.reset();
     _averageTreeExtraLongWaitTime.reset();
+    _averageTreeHoldTime.reset();
     _extraLongTreeWait = 0;
     _longTreeWait = 0;
     _shortTreeWait = 0;
@@ -366,7 +368,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
             statsString += QString("%1 File Load Took ").arg(getMyServerName());
             statsString += getFileLoadTime();
-            statsString += "\r\n";
+            statsString += wasLoadedFromSnapshot() ? " (binary snapshot)\r\n" : " (JSON)\r\n";
+
+            statsString += QString("Journal replay took %1 msecs for %2 records\r\n")
+                .arg((double)getJournalReplayTime() / USECS_PER_MSEC, 0, 'f', 1).arg(getJournalReplayedRecords());
+            statsString += QString("Journal size: %1 bytes\r\n").arg(getJournalSize());
 
             if (_persistFileDownload) {
                 statsString += QString("Persist file: <a href='%1'>Click to Download</a>\r\n").arg(PERSIST_FILE_DOWNLOAD_PATH);
@@ -514,6 +520,9 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          (double)_averageTreeExtraLongWaitTime.getAverage(),
                                          (double)(extraLongVsTotal * AS_PERCENT), _extraLongTreeWait);
 
+        float averageTreeHoldTime = getAverageTreeHoldTime();
+        statsString += QString().sprintf("         Average tree lock hold time:    %9.2f usecs\r\n\r\n", (double)averageTreeHoldTime);
+
         // traverse
         float averageTreeTraverseTime = getAverageTreeTraverseTime();
         statsString += QString().sprintf("          Average tree traverse time:    %9.2f usecs\r\n\r\n", (double)averageTreeTraverseTime);
@@ -655,6 +664,8 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         quint64 averageLockWaitTimePerElement = _octreeInboundPacketProcessor->getAverageLockWaitTimePerElement();
         quint64 totalElementsProcessed = _octreeInboundPacketProcessor->getTotalElementsProcessed();
         quint64 totalPacketsProcessed = _octreeInboundPacketProcessor->getTotalPacketsProcessed();
+        float averageBatchSize = _octreeInboundPacketProcessor->getAverageBatchSize();
+        float coalescedEditRatio = _octreeInboundPacketProcessor->getCoalescedEditRatio();
 
         quint64 averageDecodeTime = _tree->getAverageDecodeTime();
         quint64 averageLookupTime = _tree->getAverageLookupTime();
@@ -680,6 +691,10 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             .arg(locale.toString((uint)totalElementsProcessed).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString().sprintf(" Average Inbound Elements/Packet: %f elements/packet\r\n",
                                          (double)averageElementsPerPacket);
+        statsString += QString("        Average Edits/Write Lock: %1 elements\r\n")
+            .arg(locale.toString(averageBatchSize, 'f', FLOAT_PRECISION).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("              Coalesced Elements: %1 %\r\n")
+            .arg(locale.toString(coalescedEditRatio * 100.0f, 'f', FLOAT_PRECISION).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("     Average Transit Time/Packet: %1 usecs\r\n")
             .arg(locale.toString((uint)averageTransitTimePerPacket).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("     Average Process Time/Packet: %1 usecs\r\n")
@@ -1445,6 +1460,8 @@ void OctreeServer::sendStatsPacket() {
     timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
     timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
     timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    timingArray1["8. treeLockWaitTime"] = getAverageTreeWaitTime();
+    timingArray1["9. treeLockHoldTime"] = getAverageTreeHoldTime();
 
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
@@ -1458,6 +1475,8 @@ void OctreeServer::sendStatsPacket() {
         dataArray2["1. packetQueue"] = (double)_octreeInboundPacketProcessor->packetsToProcessCount();
         dataArray2["2. totalPackets"] = (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
         dataArray2["3. totalElements"] = (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+        dataArray2["4. avgBatchSize"] = (double)_octreeInboundPacketProcessor->getAverageBatchSize();
+        dataArray2["5. coalescedEditRatio"] = (double)_octreeInboundPacketProcessor->getCoalescedEditRatio();
 
         timingArray2["1. avgTransitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
         timingArray2["2. avgProcessTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerPacket();
@@ -1476,6 +1495,7 @@ void OctreeServer::sendStatsPacket() {
     jsonArray["2. octree"] = octreeStats;
     jsonArray["3. outbound"] = statsObject2;
     jsonArray["4. inbound"] = statsObject3;
+    addServerSubclassStats(jsonArray);
 
     QJsonObject statsObject;
     statsObject[QString(getMyServerName()) + "Server"] = jsonArray;
@@ -63,6 +63,10 @@ public:
     bool isInitialLoadComplete() const { return (_persistManager) ? _persistManager->isInitialLoadComplete() : true; }
     bool isPersistEnabled() const { return (_persistManager) ? true : false; }
     quint64 getLoadElapsedTime() const { return (_persistManager) ? _persistManager->getLoadElapsedTime() : 0; }
+    quint64 getJournalReplayTime() const { return (_persistManager) ? _persistManager->getJournalReplayTime() : 0; }
+    int getJournalReplayedRecords() const { return (_persistManager) ? _persistManager->getJournalReplayedRecords() : 0; }
+    qint64 getJournalSize() const { return (_persistManager) ? _persistManager->getJournalSize() : 0; }
+    bool wasLoadedFromSnapshot() const { return (_persistManager) ? _persistManager->wasLoadedFromSnapshot() : false; }
     QString getPersistFilename() const { return (_persistManager) ? _persistManager->getPersistFilename() : ""; }
     QString getPersistFileMimeType() const { return (_persistManager) ? _persistManager->getPersistFileMimeType() : "text/plain"; }
     QByteArray getPersistFileContents() const { return (_persistManager) ? _persistManager->getPersistFileContents() : QByteArray(); }
@@ -82,6 +86,7 @@ public:
     virtual bool hasSpecialPacketsToSend(const SharedNodePointer& node) { return false; }
     virtual int sendSpecialPackets(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent) { return 0; }
     virtual QString serverSubclassStats() { return QString(); }
+    virtual void addServerSubclassStats(QJsonObject& statsObject) { }
     virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& viewerNode) { }
     virtual void trackViewerGone(const QUuid& viewerNode) { }
 
@@ -99,6 +104,9 @@ public:
     static void trackTreeWaitTime(float time);
     static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
 
+    static void trackTreeHoldTime(float time) { _averageTreeHoldTime.updateAverage(time); }
+    static float getAverageTreeHoldTime() { return _averageTreeHoldTime.getAverage(); }
+
     static void trackTreeTraverseTime(float time) { _averageTreeTraverseTime.updateAverage(time); }
     static float getAverageTreeTraverseTime() { return _averageTreeTraverseTime.getAverage(); }
 
@@ -225,6 +233,7 @@ protected:
     static int _longTreeWait;
     static int _shortTreeWait;
     static int _noTreeWait;
+    static SimpleMovingAverage _averageTreeHoldTime;
 
     static SimpleMovingAverage _averageTreeTraverseTime;
 
@@ -1063,6 +1063,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     _raiseMirror(0.0f),
     _enableProcessOctreeThread(true),
     _lastNackTime(usecTimestampNow()),
+    _lastEntityDataAckTime(usecTimestampNow()),
     _lastSendDownstreamAudioStats(usecTimestampNow()),
     _notifiedPacketVersionMismatchThisDomain(false),
     _maxOctreePPS(maxOctreePacketsPerSecond.get()),
@@ -6627,6 +6628,15 @@ void Application::update(float deltaTime) {
         }
     }
 
+    // ack the entity data packets we got, so that the entity server can send kinematic deltas against them
+    {
+        const quint64 TOO_LONG_SINCE_LAST_ENTITY_DATA_ACK = USECS_PER_SECOND / 4;
+        if (now - _lastEntityDataAckTime > TOO_LONG_SINCE_LAST_ENTITY_DATA_ACK) {
+            _lastEntityDataAckTime = now;
+            sendEntityDataAcks();
+        }
+    }
+
     // send packet containing downstream audio stats to the AudioMixer
     {
         quint64 sinceLastNack = now - _lastSendDownstreamAudioStats;
@@ -6881,6 +6891,50 @@ int Application::sendNackPackets() {
     return packetsSent;
 }
 
+int Application::sendEntityDataAcks() {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    int packetsSent = 0;
+
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        if (node->getActiveSocket() && node->getType() == NodeType::EntityServer) {
+            QUuid nodeUUID = node->getUUID();
+
+            bool hasReceived = false;
+            OCTREE_PACKET_SEQUENCE lastReceived = 0;
+            QSet<OCTREE_PACKET_SEQUENCE> missingSequenceNumbers;
+            _octreeServerSceneStats.withReadLock([&] {
+                if (_octreeServerSceneStats.find(nodeUUID) == _octreeServerSceneStats.end()) {
+                    return;
+                }
+                const SequenceNumberStats& sequenceNumberStats = _octreeServerSceneStats[nodeUUID].getIncomingOctreeSequenceNumberStats();
+                hasReceived = sequenceNumberStats.getReceived() > 0;
+                lastReceived = sequenceNumberStats.getLastReceivedSequence();
+                missingSequenceNumbers = sequenceNumberStats.getMissingSet();
+            });
+            if (!hasReceived) {
+                return;
+            }
+
+            // everything up to the last packet we received but the missing ones, which must all fit for the ack to be right
+            auto ackPacket = NLPacket::create(PacketType::EntityDataAck);
+            if (ackPacket->bytesAvailableForWrite() <
+                    (qint64)((missingSequenceNumbers.size() + 1) * sizeof(OCTREE_PACKET_SEQUENCE))) {
+                return;
+            }
+            ackPacket->writePrimitive(lastReceived);
+            foreach(const OCTREE_PACKET_SEQUENCE& missingNumber, missingSequenceNumbers) {
+                ackPacket->writePrimitive(missingNumber);
+            }
+
+            nodeList->sendPacket(std::move(ackPacket), *node);
+            packetsSent++;
+        }
+    });
+
+    return packetsSent;
+}
+
 void Application::queryOctree(NodeType_t serverType, PacketType packetType) {
     if (!_settingsLoaded) {
         return; // bail early if settings are not loaded
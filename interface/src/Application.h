@@ -563,6 +563,7 @@ private:
     void queryAvatars();
 
     int sendNackPackets();
+    int sendEntityDataAcks();
 
     std::shared_ptr<MyAvatar> getMyAvatar() const;
 
@@ -700,6 +701,7 @@ private:
     TouchEvent _lastTouchEvent;
 
     quint64 _lastNackTime;
+    quint64 _lastEntityDataAckTime;
     quint64 _lastSendDownstreamAudioStats;
 
     bool _notifiedPacketVersionMismatchThisDomain;
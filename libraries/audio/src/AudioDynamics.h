@@ -148,99 +148,12 @@ static const int IEEE754_EXPN_BITS = 8;
 static const int IEEE754_EXPN_BIAS = 127;
 
 //
-// Peak detection and -log2(x) for float input (mono)
+// Peak detection and -log2(x) for float input, given as the IEEE-754 bits of
+// the largest absolute value of the frame (see peakAbsBits() in AudioKernels.h)
 // x < 2^(31-LOG2_HEADROOM) returns 0x7fffffff
 // x > 2^LOG2_HEADROOM returns 0
 //
-FORCEINLINE static int32_t peaklog2(float* input) {
-
-    // float as integer bits
-    uint32_t u = *(uint32_t*)input;
-
-    // absolute value
-    uint32_t peak = u & IEEE754_FABS_MASK;
-
-    // split into e and x - 1.0
-    int32_t e = IEEE754_EXPN_BIAS - (peak >> IEEE754_MANT_BITS) + LOG2_HEADROOM;
-    int32_t x = (peak << IEEE754_EXPN_BITS) & 0x7fffffff;
-
-    // saturate when e > 31 or e < 0
-    if ((uint32_t)e > 31) {
-        return 0x7fffffff & ~(e >> 31);
-    }
-
-    int k = x >> (31 - LOG2_TABBITS);
-
-    // polynomial for log2(1+x) over x=[0,1]
-    int32_t c0 = log2Table[k][0];
-    int32_t c1 = log2Table[k][1];
-    int32_t c2 = log2Table[k][2];
-
-    c1 += MULHI(c0, x);
-    c2 += MULHI(c1, x);
-
-    // reconstruct result in Q26
-    return (e << LOG2_FRACBITS) - (c2 >> 3);
-}
-
-//
-// Peak detection and -log2(x) for float input (stereo)
-// x < 2^(31-LOG2_HEADROOM) returns 0x7fffffff
-// x > 2^LOG2_HEADROOM returns 0
-//
-FORCEINLINE static int32_t peaklog2(float* input0, float* input1) {
-
-    // float as integer bits
-    uint32_t u0 = *(uint32_t*)input0;
-    uint32_t u1 = *(uint32_t*)input1;
-
-    // max absolute value
-    u0 &= IEEE754_FABS_MASK;
-    u1 &= IEEE754_FABS_MASK;
-    uint32_t peak = MAX(u0, u1);
-
-    // split into e and x - 1.0
-    int32_t e = IEEE754_EXPN_BIAS - (peak >> IEEE754_MANT_BITS) + LOG2_HEADROOM;
-    int32_t x = (peak << IEEE754_EXPN_BITS) & 0x7fffffff;
-
-    // saturate when e > 31 or e < 0
-    if ((uint32_t)e > 31) {
-        return 0x7fffffff & ~(e >> 31);
-    }
-
-    int k = x >> (31 - LOG2_TABBITS);
-
-    // polynomial for log2(1+x) over x=[0,1]
-    int32_t c0 = log2Table[k][0];
-    int32_t c1 = log2Table[k][1];
-    int32_t c2 = log2Table[k][2];
-
-    c1 += MULHI(c0, x);
-    c2 += MULHI(c1, x);
-
-    // reconstruct result in Q26
-    return (e << LOG2_FRACBITS) - (c2 >> 3);
-}
-
-//
-// Peak detection and -log2(x) for float input (quad)
-// x < 2^(31-LOG2_HEADROOM) returns 0x7fffffff
-// x > 2^LOG2_HEADROOM returns 0
-//
-FORCEINLINE static int32_t peaklog2(float* input0, float* input1, float* input2, float* input3) {
-
-    // float as integer bits
-    uint32_t u0 = *(uint32_t*)input0;
-    uint32_t u1 = *(uint32_t*)input1;
-    uint32_t u2 = *(uint32_t*)input2;
-    uint32_t u3 = *(uint32_t*)input3;
-
-    // max absolute value
-    u0 &= IEEE754_FABS_MASK;
-    u1 &= IEEE754_FABS_MASK;
-    u2 &= IEEE754_FABS_MASK;
-    u3 &= IEEE754_FABS_MASK;
-    uint32_t peak = MAX(MAX(u0, u1), MAX(u2, u3));
+FORCEINLINE static int32_t peaklog2(uint32_t peak) {
 
     // split into e and x - 1.0
     int32_t e = IEEE754_EXPN_BIAS - (peak >> IEEE754_MANT_BITS) + LOG2_HEADROOM;
@@ -356,9 +269,8 @@ FORCEINLINE static int32_t fixexp2(int32_t x) {
     return c2 >> e;
 }
 
-// fast TPDF dither in [-1.0f, 1.0f]
-FORCEINLINE static float dither() {
-    static uint32_t rz = 0;
+// fast TPDF dither in [-1.0f, 1.0f], rz is the generator state
+FORCEINLINE static float dither(uint32_t& rz) {
     rz = rz * 69069 + 1;
     int32_t r0 = rz & 0xffff;
     int32_t r1 = rz >> 16;
@@ -16,6 +16,7 @@
 #include <assert.h>
 
 #include "AudioHRTFData.h"
+#include "AudioKernels.h"
 
 #if defined(_MSC_VER)
 #define ALIGN32 __declspec(align(32))
@@ -686,43 +687,6 @@ static void interpolate(const float* src0, const float* src1, float* dst, float
 
 #endif
 
-// apply gain crossfade with accumulation (interleaved)
-static void gainfade_1x2(int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
-
-    gain0 *= (1/32768.0f);  // int16_t to float
-    gain1 *= (1/32768.0f);
-
-    for (int i = 0; i < numFrames; i++) {
-
-        float frac = win[i];
-        float gain = gain1 + frac * (gain0 - gain1);
-
-        float x0 = (float)src[i] * gain;
-
-        dst[2*i+0] += x0;
-        dst[2*i+1] += x0;
-    }
-}
-
-// apply gain crossfade with accumulation (interleaved)
-static void gainfade_2x2(int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
-
-    gain0 *= (1/32768.0f);  // int16_t to float
-    gain1 *= (1/32768.0f);
-
-    for (int i = 0; i < numFrames; i++) {
-
-        float frac = win[i];
-        float gain = gain1 + frac * (gain0 - gain1);
-
-        float x0 = (float)src[2*i+0] * gain;
-        float x1 = (float)src[2*i+1] * gain;
-
-        dst[2*i+0] += x0;
-        dst[2*i+1] += x1;
-    }
-}
-
 // design a 2nd order Thiran allpass
 static void ThiranBiquad(float f, float& b0, float& b1, float& b2, float& a1, float& a2) {
 
@@ -0,0 +1,218 @@
+//
+//  AudioKernels.cpp
+//  libraries/audio/src
+//
+//  Created on 11/12/19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioKernels.h"
+
+#include <assert.h>
+
+#include "AudioDynamics.h"
+
+//
+// Portable reference code
+//
+// The SIMD versions hand their remainders to these, so they must stay free of anything
+// the compiler could fuse or reorder differently (no FMA contraction outside of the avx2 sources).
+//
+
+bool hasNonZeroSamples_ref(const float* src, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        if (src[i] != 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void accumulateFloat_ref(const float* src, float* dst, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] += src[i];
+    }
+}
+
+void accumulateInt16_ref(const int16_t* src, int16_t* dst, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] = (int16_t)(dst[i] + src[i]);
+    }
+}
+
+void scaleFloat_ref(const float* src, float* dst, float gain, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] = src[i] * gain;
+    }
+}
+
+void scaleInt16_ref(const int16_t* src, int16_t* dst, float gain, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] = (int16_t)((float)src[i] * gain);
+    }
+}
+
+// apply gain crossfade with accumulation (mono input, interleaved stereo output)
+void gainfade_1x2_ref(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+
+    gain0 *= (1/32768.0f);  // int16_t to float
+    gain1 *= (1/32768.0f);
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float frac = win[i];
+        float gain = gain1 + frac * (gain0 - gain1);
+
+        float x0 = (float)src[i] * gain;
+
+        dst[2*i+0] += x0;
+        dst[2*i+1] += x0;
+    }
+}
+
+// apply gain crossfade with accumulation (interleaved)
+void gainfade_2x2_ref(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+
+    gain0 *= (1/32768.0f);  // int16_t to float
+    gain1 *= (1/32768.0f);
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float frac = win[i];
+        float gain = gain1 + frac * (gain0 - gain1);
+
+        float x0 = (float)src[2*i+0] * gain;
+        float x1 = (float)src[2*i+1] * gain;
+
+        dst[2*i+0] += x0;
+        dst[2*i+1] += x1;
+    }
+}
+
+void peakAbsBits_ref(const float* src, uint32_t* peak, int numFrames, int numChannels) {
+    const uint32_t* u = (const uint32_t*)src;
+
+    for (int n = 0; n < numFrames; n++) {
+        uint32_t p = 0;
+        for (int c = 0; c < numChannels; c++) {
+            p = MAX(p, u[numChannels*n+c] & IEEE754_FABS_MASK);
+        }
+        peak[n] = p;
+    }
+}
+
+void gainDitherToInt16_ref(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                           uint32_t& ditherState) {
+    uint32_t rz = ditherState;
+
+    for (int n = 0; n < numFrames; n++) {
+        float g = gain[n];
+        float d = dither(rz);
+        for (int c = 0; c < numChannels; c++) {
+            float x = src[numChannels*n+c];
+            x *= g;
+            x += d;
+            dst[numChannels*n+c] = (int16_t)floatToInt(x);
+        }
+    }
+
+    ditherState = rz;
+}
+
+//
+// Runtime CPU dispatch
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include "CPUDetect.h"
+
+bool hasNonZeroSamples(const float* src, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? hasNonZeroSamples_AVX2 : hasNonZeroSamples_ref;
+    return (*f)(src, numSamples); // dispatch
+}
+
+void accumulateSamples(const float* src, float* dst, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? accumulateFloat_AVX2 : accumulateFloat_ref;
+    (*f)(src, dst, numSamples); // dispatch
+}
+
+void accumulateSamples(const int16_t* src, int16_t* dst, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? accumulateInt16_AVX2 : accumulateInt16_ref;
+    (*f)(src, dst, numSamples); // dispatch
+}
+
+void scaleSamples(const float* src, float* dst, float gain, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? scaleFloat_AVX2 : scaleFloat_ref;
+    (*f)(src, dst, gain, numSamples); // dispatch
+}
+
+void scaleSamples(const int16_t* src, int16_t* dst, float gain, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? scaleInt16_AVX2 : scaleInt16_ref;
+    (*f)(src, dst, gain, numSamples); // dispatch
+}
+
+void gainfade_1x2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? gainfade_1x2_AVX2 : gainfade_1x2_ref;
+    (*f)(src, dst, win, gain0, gain1, numFrames); // dispatch
+}
+
+void gainfade_2x2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? gainfade_2x2_AVX2 : gainfade_2x2_ref;
+    (*f)(src, dst, win, gain0, gain1, numFrames); // dispatch
+}
+
+void peakAbsBits(const float* src, uint32_t* peak, int numFrames, int numChannels) {
+    static auto f = cpuSupportsAVX2() ? peakAbsBits_AVX2 : peakAbsBits_ref;
+    (*f)(src, peak, numFrames, numChannels); // dispatch
+}
+
+void gainDitherToInt16(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                       uint32_t& ditherState) {
+    static auto f = cpuSupportsAVX2() ? gainDitherToInt16_AVX2 : gainDitherToInt16_ref;
+    (*f)(src, gain, dst, numFrames, numChannels, ditherState); // dispatch
+}
+
+#else   // portable reference code
+
+bool hasNonZeroSamples(const float* src, int numSamples) {
+    return hasNonZeroSamples_ref(src, numSamples);
+}
+
+void accumulateSamples(const float* src, float* dst, int numSamples) {
+    accumulateFloat_ref(src, dst, numSamples);
+}
+
+void accumulateSamples(const int16_t* src, int16_t* dst, int numSamples) {
+    accumulateInt16_ref(src, dst, numSamples);
+}
+
+void scaleSamples(const float* src, float* dst, float gain, int numSamples) {
+    scaleFloat_ref(src, dst, gain, numSamples);
+}
+
+void scaleSamples(const int16_t* src, int16_t* dst, float gain, int numSamples) {
+    scaleInt16_ref(src, dst, gain, numSamples);
+}
+
+void gainfade_1x2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+    gainfade_1x2_ref(src, dst, win, gain0, gain1, numFrames);
+}
+
+void gainfade_2x2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+    gainfade_2x2_ref(src, dst, win, gain0, gain1, numFrames);
+}
+
+void peakAbsBits(const float* src, uint32_t* peak, int numFrames, int numChannels) {
+    peakAbsBits_ref(src, peak, numFrames, numChannels);
+}
+
+void gainDitherToInt16(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                       uint32_t& ditherState) {
+    gainDitherToInt16_ref(src, gain, dst, numFrames, numChannels, ditherState);
+}
+
+#endif
@@ -0,0 +1,76 @@
+//
+//  AudioKernels.h
+//  libraries/audio/src
+//
+//  Created on 11/12/19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+//
+// Block kernels for the mixing, limiting and buffering loops.
+//
+// Each kernel has a portable reference version, and SIMD versions picked at runtime through CPUDetect.
+// All versions give bit-identical results.
+//
+
+#ifndef hifi_AudioKernels_h
+#define hifi_AudioKernels_h
+
+#include <stdint.h>
+
+// true if any sample is not 0.0f
+bool hasNonZeroSamples(const float* src, int numSamples);
+
+// dst[i] += src[i], the int16_t version wraps around like the scalar add
+void accumulateSamples(const float* src, float* dst, int numSamples);
+void accumulateSamples(const int16_t* src, int16_t* dst, int numSamples);
+
+// dst[i] = src[i] * gain, the int16_t version rounds toward zero like the scalar cast
+void scaleSamples(const float* src, float* dst, float gain, int numSamples);
+void scaleSamples(const int16_t* src, int16_t* dst, float gain, int numSamples);
+
+// crossfade the gain from gain0 to gain1 along win, with accumulation (mono to stereo, and interleaved stereo)
+void gainfade_1x2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames);
+void gainfade_2x2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames);
+
+// peak[n] = largest absolute value of the interleaved samples of frame n, as IEEE-754 bits (1, 2 or 4 channels)
+void peakAbsBits(const float* src, uint32_t* peak, int numFrames, int numChannels);
+
+// dst = round(src * gain[n] + dither) for the interleaved samples of frame n, with one TPDF dither value per frame
+// drawn from ditherState (1, 2 or 4 channels)
+void gainDitherToInt16(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                       uint32_t& ditherState);
+
+//
+// Versions behind the dispatch, for tests and benchmarks
+//
+bool hasNonZeroSamples_ref(const float* src, int numSamples);
+void accumulateFloat_ref(const float* src, float* dst, int numSamples);
+void accumulateInt16_ref(const int16_t* src, int16_t* dst, int numSamples);
+void scaleFloat_ref(const float* src, float* dst, float gain, int numSamples);
+void scaleInt16_ref(const int16_t* src, int16_t* dst, float gain, int numSamples);
+void gainfade_1x2_ref(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames);
+void gainfade_2x2_ref(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames);
+void peakAbsBits_ref(const float* src, uint32_t* peak, int numFrames, int numChannels);
+void gainDitherToInt16_ref(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                           uint32_t& ditherState);
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+bool hasNonZeroSamples_AVX2(const float* src, int numSamples);
+void accumulateFloat_AVX2(const float* src, float* dst, int numSamples);
+void accumulateInt16_AVX2(const int16_t* src, int16_t* dst, int numSamples);
+void scaleFloat_AVX2(const float* src, float* dst, float gain, int numSamples);
+void scaleInt16_AVX2(const int16_t* src, int16_t* dst, float gain, int numSamples);
+void gainfade_1x2_AVX2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames);
+void gainfade_2x2_AVX2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames);
+void peakAbsBits_AVX2(const float* src, uint32_t* peak, int numFrames, int numChannels);
+void gainDitherToInt16_AVX2(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                            uint32_t& ditherState);
+
+#endif
+
+#endif // hifi_AudioKernels_h
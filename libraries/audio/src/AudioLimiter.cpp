@@ -11,6 +11,7 @@
 #include <assert.h>
 
 #include "AudioDynamics.h"
+#include "AudioKernels.h"
 
 //
 // Limiter (common)
@@ -34,6 +35,11 @@ protected:
     int _sampleRate;
     float _outGain = 0.0f;
 
+    uint32_t _ditherState = 0;
+
+    // frames processed at a time, the peak detection and output stages run on whole blocks
+    static const int BLOCK = 64;
+
 public:
     LimiterImpl(int sampleRate);
     virtual ~LimiterImpl() {}
@@ -209,36 +215,44 @@ public:
 template<int N>
 void LimiterMono<N>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    uint32_t peaks[BLOCK];
+    float gains[BLOCK];
+    float delayed[BLOCK];
+
+    for (int i = 0; i < numFrames; i += BLOCK) {
 
-        // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[n]);
+        int numBlockFrames = MIN(numFrames - i, BLOCK);
+        float* in = &input[i];
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+        // peak detect
+        peakAbsBits(in, peaks, numBlockFrames, 1);
 
-        // apply envelope
-        attn = envelope(attn);
+        for (int n = 0; n < numBlockFrames; n++) {
 
-        // convert from log2 domain
-        attn = fixexp2(attn);
+            // convert to log2 domain
+            int32_t peak = peaklog2(peaks[n]);
 
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+            // compute limiter attenuation
+            int32_t attn = MAX(_threshold - peak, 0);
 
-        // delay audio
-        float x = input[n];
-        _delay.process(x);
+            // apply envelope
+            attn = envelope(attn);
 
-        // apply gain
-        x *= gain;
+            // convert from log2 domain
+            attn = fixexp2(attn);
 
-        // apply dither
-        x += dither();
+            // lowpass filter
+            attn = _filter.process(attn);
+            gains[n] = attn * _outGain;
+
+            // delay audio
+            float x = in[n];
+            _delay.process(x);
+            delayed[n] = x;
+        }
 
-        // store 16-bit output
-        output[n] = (int16_t)floatToInt(x);
+        // apply gain and dither, store 16-bit output
+        gainDitherToInt16(delayed, gains, &output[i], numBlockFrames, 1, _ditherState);
     }
 }
 
@@ -261,41 +275,46 @@ public:
 template<int N>
 void LimiterStereo<N>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    uint32_t peaks[BLOCK];
+    float gains[BLOCK];
+    float delayed[2*BLOCK];
 
-        // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[2*n+0], &input[2*n+1]);
+    for (int i = 0; i < numFrames; i += BLOCK) {
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+        int numBlockFrames = MIN(numFrames - i, BLOCK);
+        float* in = &input[2*i];
 
-        // apply envelope
-        attn = envelope(attn);
+        // peak detect
+        peakAbsBits(in, peaks, numBlockFrames, 2);
 
-        // convert from log2 domain
-        attn = fixexp2(attn);
+        for (int n = 0; n < numBlockFrames; n++) {
 
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+            // convert to log2 domain
+            int32_t peak = peaklog2(peaks[n]);
 
-        // delay audio
-        float x0 = input[2*n+0];
-        float x1 = input[2*n+1];
-        _delay.process(x0, x1);
+            // compute limiter attenuation
+            int32_t attn = MAX(_threshold - peak, 0);
 
-        // apply gain
-        x0 *= gain;
-        x1 *= gain;
+            // apply envelope
+            attn = envelope(attn);
 
-        // apply dither
-        float d = dither();
-        x0 += d;
-        x1 += d;
+            // convert from log2 domain
+            attn = fixexp2(attn);
 
-        // store 16-bit output
-        output[2*n+0] = (int16_t)floatToInt(x0);
-        output[2*n+1] = (int16_t)floatToInt(x1);
+            // lowpass filter
+            attn = _filter.process(attn);
+            gains[n] = attn * _outGain;
+
+            // delay audio
+            float x0 = in[2*n+0];
+            float x1 = in[2*n+1];
+            _delay.process(x0, x1);
+            delayed[2*n+0] = x0;
+            delayed[2*n+1] = x1;
+        }
+
+        // apply gain and dither, store 16-bit output
+        gainDitherToInt16(delayed, gains, &output[2*i], numBlockFrames, 2, _ditherState);
     }
 }
 
@@ -318,49 +337,50 @@ public:
 template<int N>
 void LimiterQuad<N>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
-
-        // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[4*n+0], &input[4*n+1], &input[4*n+2], &input[4*n+3]);
-
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
-
-        // apply envelope
-        attn = envelope(attn);
-
-        // convert from log2 domain
-        attn = fixexp2(attn);
-
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
-
-        // delay audio
-        float x0 = input[4*n+0];
-        float x1 = input[4*n+1];
-        float x2 = input[4*n+2];
-        float x3 = input[4*n+3];
-        _delay.process(x0, x1, x2, x3);
-
-        // apply gain
-        x0 *= gain;
-        x1 *= gain;
-        x2 *= gain;
-        x3 *= gain;
-
-        // apply dither
-        float d = dither();
-        x0 += d;
-        x1 += d;
-        x2 += d;
-        x3 += d;
-
-        // store 16-bit output
-        output[4*n+0] = (int16_t)floatToInt(x0);
-        output[4*n+1] = (int16_t)floatToInt(x1);
-        output[4*n+2] = (int16_t)floatToInt(x2);
-        output[4*n+3] = (int16_t)floatToInt(x3);
+    uint32_t peaks[BLOCK];
+    float gains[BLOCK];
+    float delayed[4*BLOCK];
+
+    for (int i = 0; i < numFrames; i += BLOCK) {
+
+        int numBlockFrames = MIN(numFrames - i, BLOCK);
+        float* in = &input[4*i];
+
+        // peak detect
+        peakAbsBits(in, peaks, numBlockFrames, 4);
+
+        for (int n = 0; n < numBlockFrames; n++) {
+
+            // convert to log2 domain
+            int32_t peak = peaklog2(peaks[n]);
+
+            // compute limiter attenuation
+            int32_t attn = MAX(_threshold - peak, 0);
+
+            // apply envelope
+            attn = envelope(attn);
+
+            // convert from log2 domain
+            attn = fixexp2(attn);
+
+            // lowpass filter
+            attn = _filter.process(attn);
+            gains[n] = attn * _outGain;
+
+            // delay audio
+            float x0 = in[4*n+0];
+            float x1 = in[4*n+1];
+            float x2 = in[4*n+2];
+            float x3 = in[4*n+3];
+            _delay.process(x0, x1, x2, x3);
+            delayed[4*n+0] = x0;
+            delayed[4*n+1] = x1;
+            delayed[4*n+2] = x2;
+            delayed[4*n+3] = x3;
+        }
+
+        // apply gain and dither, store 16-bit output
+        gainDitherToInt16(delayed, gains, &output[4*i], numBlockFrames, 4, _ditherState);
     }
 }
 
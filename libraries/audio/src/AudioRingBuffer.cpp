@@ -125,25 +125,17 @@ int AudioRingBufferTemplate<T>::appendData(char *data, int maxSize) {
     int numReadSamples = std::min(maxSamples, samplesAvailable());
 
     Sample* dest = reinterpret_cast<Sample*>(data);
-    Sample* output = _nextOutput;
     if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
         // we're going to need to do two reads to get this data, it wraps around the edge
         int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
 
         // read to the end of the buffer
-        for (int i = 0; i < numSamplesToEnd; i++) {
-            *dest++ += *output++;
-        }
+        accumulateSamples(_nextOutput, dest, numSamplesToEnd);
 
         // read the rest from the beginning of the buffer
-        output = _buffer;
-        for (int i = 0; i < (numReadSamples - numSamplesToEnd); i++) {
-            *dest++ += *output++;
-        }
+        accumulateSamples(_buffer, dest + numSamplesToEnd, numReadSamples - numSamplesToEnd);
     } else {
-        for (int i = 0; i < numReadSamples; i++) {
-            *dest++ += *output++;
-        }
+        accumulateSamples(_nextOutput, dest, numReadSamples);
     }
 
     shiftReadPosition(numReadSamples);
@@ -285,13 +277,17 @@ int AudioRingBufferTemplate<T>::writeSamples(ConstIterator source, int maxSample
         HIFI_FCDEBUG_ID(audio(), repeatedOverflowMessageID, RING_BUFFER_OVERFLOW_DEBUG);
     }
 
-    Sample* bufferLast = _buffer + _bufferLength - 1;
-    for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
-        ++source;
+    if (_endOfLastWrite + samplesToCopy > _buffer + _bufferLength) {
+        // we're going to need to do two writes to set this data, it wraps around the edge
+        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
+        source.readSamples(_endOfLastWrite, numSamplesToEnd);
+        source.readSamples(_buffer, samplesToCopy - numSamplesToEnd);
+    } else {
+        source.readSamples(_endOfLastWrite, samplesToCopy);
     }
 
+    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+
     return samplesToCopy;
 }
 
@@ -310,13 +306,18 @@ int AudioRingBufferTemplate<T>::writeSamplesWithFade(ConstIterator source, int m
         HIFI_FCDEBUG_ID(audio(), repeatedOverflowMessageID, RING_BUFFER_OVERFLOW_DEBUG);
     }
 
-    Sample* bufferLast = _buffer + _bufferLength - 1;
-    for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (Sample)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
-        ++source;
+    if (_endOfLastWrite + samplesToCopy > _buffer + _bufferLength) {
+        // we're going to need to do two writes to set this data, it wraps around the edge
+        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
+        source.readSamplesWithFade(_endOfLastWrite, numSamplesToEnd, fade);
+        source = source + numSamplesToEnd;
+        source.readSamplesWithFade(_buffer, samplesToCopy - numSamplesToEnd, fade);
+    } else {
+        source.readSamplesWithFade(_endOfLastWrite, samplesToCopy, fade);
     }
 
+    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+
     return samplesToCopy;
 }
 
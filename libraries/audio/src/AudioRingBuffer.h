@@ -19,6 +19,8 @@
 #include <SharedUtil.h>
 #include <NodeData.h>
 
+#include "AudioKernels.h"
+
 const int DEFAULT_RING_BUFFER_FRAME_CAPACITY = 10;
 
 template <class T>
@@ -174,11 +176,14 @@ public:
             }
         }
         void readSamplesWithFade(Sample* dest, int numSamples, float fade) {
-            Sample* at = _at;
-            for (int i = 0; i < numSamples; i++) {
-                *dest = (float)*at * fade;
-                ++dest;
-                at = (at == _bufferLast) ? _bufferFirst : at + 1;
+            auto samplesToEnd = _bufferLast - _at + 1;
+
+            if (samplesToEnd >= numSamples) {
+                scaleSamples(_at, dest, fade, numSamples);
+            } else {
+                auto samplesFromStart = numSamples - samplesToEnd;
+                scaleSamples(_at, dest, fade, (int)samplesToEnd);
+                scaleSamples(_bufferFirst, dest + samplesToEnd, fade, (int)samplesFromStart);
             }
         }
 
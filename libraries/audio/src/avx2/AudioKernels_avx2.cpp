@@ -0,0 +1,288 @@
+//
+//  AudioKernels_avx2.cpp
+//  libraries/audio/src
+//
+//  Created on 11/12/19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "../AudioKernels.h"
+
+// keep multiplies and adds separate, the results must match the reference code bit for bit
+// this file is built with -ffp-contract=off (see libraries/audio/CMakeLists.txt)
+
+// low 16 bits of each int32_t, like the scalar int16_t cast
+static inline __m128i truncateToInt16(__m256i x) {
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,
+                                             0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm256_castsi256_si128(x);
+}
+
+// duplicate each lane of x into adjacent pairs, frames 0-3 into lo and frames 4-7 into hi
+static inline void duplicatePairs(__m256 x, __m256& lo, __m256& hi) {
+    __m256 t0 = _mm256_unpacklo_ps(x, x);   // 0 0 1 1 | 4 4 5 5
+    __m256 t1 = _mm256_unpackhi_ps(x, x);   // 2 2 3 3 | 6 6 7 7
+    lo = _mm256_permute2f128_ps(t0, t1, 0x20);
+    hi = _mm256_permute2f128_ps(t0, t1, 0x31);
+}
+
+bool hasNonZeroSamples_AVX2(const float* src, int numSamples) {
+
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i < numSamples - 31; i += 32) {
+
+        // unordered compare, so NaN counts as nonzero like the scalar code
+        __m256 x0 = _mm256_cmp_ps(_mm256_loadu_ps(&src[i+0]), zero, _CMP_NEQ_UQ);
+        __m256 x1 = _mm256_cmp_ps(_mm256_loadu_ps(&src[i+8]), zero, _CMP_NEQ_UQ);
+        __m256 x2 = _mm256_cmp_ps(_mm256_loadu_ps(&src[i+16]), zero, _CMP_NEQ_UQ);
+        __m256 x3 = _mm256_cmp_ps(_mm256_loadu_ps(&src[i+24]), zero, _CMP_NEQ_UQ);
+
+        x0 = _mm256_or_ps(_mm256_or_ps(x0, x1), _mm256_or_ps(x2, x3));
+        if (_mm256_movemask_ps(x0)) {
+            return true;
+        }
+    }
+    for (; i < numSamples - 7; i += 8) {
+        __m256 x0 = _mm256_cmp_ps(_mm256_loadu_ps(&src[i]), zero, _CMP_NEQ_UQ);
+        if (_mm256_movemask_ps(x0)) {
+            return true;
+        }
+    }
+    return hasNonZeroSamples_ref(&src[i], numSamples - i);
+}
+
+void accumulateFloat_AVX2(const float* src, float* dst, int numSamples) {
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m256 x0 = _mm256_loadu_ps(&dst[i]);
+        x0 = _mm256_add_ps(x0, _mm256_loadu_ps(&src[i]));
+        _mm256_storeu_ps(&dst[i], x0);
+    }
+    accumulateFloat_ref(&src[i], &dst[i], numSamples - i);
+}
+
+void accumulateInt16_AVX2(const int16_t* src, int16_t* dst, int numSamples) {
+
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        __m256i x0 = _mm256_loadu_si256((const __m256i*)&dst[i]);
+        x0 = _mm256_add_epi16(x0, _mm256_loadu_si256((const __m256i*)&src[i]));
+        _mm256_storeu_si256((__m256i*)&dst[i], x0);
+    }
+    accumulateInt16_ref(&src[i], &dst[i], numSamples - i);
+}
+
+void scaleFloat_AVX2(const float* src, float* dst, float gain, int numSamples) {
+
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        _mm256_storeu_ps(&dst[i], _mm256_mul_ps(_mm256_loadu_ps(&src[i]), g));
+    }
+    scaleFloat_ref(&src[i], &dst[i], gain, numSamples - i);
+}
+
+void scaleInt16_AVX2(const int16_t* src, int16_t* dst, float gain, int numSamples) {
+
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m256 x0 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&src[i])));
+        x0 = _mm256_mul_ps(x0, g);
+        _mm_storeu_si128((__m128i*)&dst[i], truncateToInt16(_mm256_cvttps_epi32(x0)));
+    }
+    scaleInt16_ref(&src[i], &dst[i], gain, numSamples - i);
+}
+
+// apply gain crossfade with accumulation (mono input, interleaved stereo output)
+void gainfade_1x2_AVX2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+
+    float g0 = gain0 * (1/32768.0f);    // int16_t to float
+    float g1 = gain1 * (1/32768.0f);
+
+    __m256 base = _mm256_set1_ps(g1);
+    __m256 delta = _mm256_set1_ps(g0 - g1);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+
+        __m256 gain = _mm256_add_ps(base, _mm256_mul_ps(_mm256_loadu_ps(&win[i]), delta));
+
+        __m256 x0 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&src[i])));
+        x0 = _mm256_mul_ps(x0, gain);
+
+        __m256 lo, hi;
+        duplicatePairs(x0, lo, hi);
+
+        _mm256_storeu_ps(&dst[2*i+0], _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+0]), lo));
+        _mm256_storeu_ps(&dst[2*i+8], _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+8]), hi));
+    }
+    gainfade_1x2_ref(&src[i], &dst[2*i], &win[i], gain0, gain1, numFrames - i);
+}
+
+// apply gain crossfade with accumulation (interleaved)
+void gainfade_2x2_AVX2(const int16_t* src, float* dst, const float* win, float gain0, float gain1, int numFrames) {
+
+    float g0 = gain0 * (1/32768.0f);    // int16_t to float
+    float g1 = gain1 * (1/32768.0f);
+
+    __m256 base = _mm256_set1_ps(g1);
+    __m256 delta = _mm256_set1_ps(g0 - g1);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+
+        __m256 gain = _mm256_add_ps(base, _mm256_mul_ps(_mm256_loadu_ps(&win[i]), delta));
+
+        __m256 lo, hi;
+        duplicatePairs(gain, lo, hi);
+
+        __m256i x = _mm256_loadu_si256((const __m256i*)&src[2*i]);
+        __m256 x0 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(x)));
+        __m256 x1 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1)));
+
+        x0 = _mm256_mul_ps(x0, lo);
+        x1 = _mm256_mul_ps(x1, hi);
+
+        _mm256_storeu_ps(&dst[2*i+0], _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+0]), x0));
+        _mm256_storeu_ps(&dst[2*i+8], _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+8]), x1));
+    }
+    gainfade_2x2_ref(&src[2*i], &dst[2*i], &win[i], gain0, gain1, numFrames - i);
+}
+
+void peakAbsBits_AVX2(const float* src, uint32_t* peak, int numFrames, int numChannels) {
+
+    const __m256i mask = _mm256_set1_epi32(0x7fffffff);
+    const __m256i* in = (const __m256i*)src;
+
+    int n = 0;
+    if (numChannels == 1) {
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256i x0 = _mm256_and_si256(_mm256_loadu_si256(&in[n/8]), mask);
+            _mm256_storeu_si256((__m256i*)&peak[n], x0);
+        }
+
+    } else if (numChannels == 2) {
+
+        // the absolute values are positive as int32_t, so signed max works
+        const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256i x0 = _mm256_and_si256(_mm256_loadu_si256(&in[n/4+0]), mask);
+            __m256i x1 = _mm256_and_si256(_mm256_loadu_si256(&in[n/4+1]), mask);
+
+            x0 = _mm256_max_epi32(x0, _mm256_shuffle_epi32(x0, _MM_SHUFFLE(2, 3, 0, 1)));
+            x1 = _mm256_max_epi32(x1, _mm256_shuffle_epi32(x1, _MM_SHUFFLE(2, 3, 0, 1)));
+
+            x0 = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x0, even), _mm256_permutevar8x32_epi32(x1, even), 0xf0);
+            _mm256_storeu_si256((__m256i*)&peak[n], x0);
+        }
+
+    } else if (numChannels == 4) {
+
+        const __m256i first = _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4);
+
+        for (; n < numFrames - 7; n += 8) {
+            __m256i x[4];
+            for (int k = 0; k < 4; k++) {
+                __m256i x0 = _mm256_and_si256(_mm256_loadu_si256(&in[n/2+k]), mask);
+                x0 = _mm256_max_epi32(x0, _mm256_shuffle_epi32(x0, _MM_SHUFFLE(2, 3, 0, 1)));
+                x0 = _mm256_max_epi32(x0, _mm256_shuffle_epi32(x0, _MM_SHUFFLE(1, 0, 3, 2)));
+                x[k] = _mm256_permutevar8x32_epi32(x0, first);
+            }
+
+            __m256i x0 = _mm256_blend_epi32(x[0], x[1], 0x0c);
+            x0 = _mm256_blend_epi32(x0, x[2], 0x30);
+            x0 = _mm256_blend_epi32(x0, x[3], 0xc0);
+            _mm256_storeu_si256((__m256i*)&peak[n], x0);
+        }
+    }
+    peakAbsBits_ref(&src[numChannels*n], &peak[n], numFrames - n, numChannels);
+}
+
+void gainDitherToInt16_AVX2(const float* src, const float* gain, int16_t* dst, int numFrames, int numChannels,
+                            uint32_t& ditherState) {
+
+    if (numChannels != 1 && numChannels != 2 && numChannels != 4) {
+        gainDitherToInt16_ref(src, gain, dst, numFrames, numChannels, ditherState);
+        return;
+    }
+
+    // jump ahead coefficients, lane k holds the generator state after k+1 steps
+    uint32_t a[8], c[8];
+    uint32_t ak = 1, ck = 0;
+    for (int k = 0; k < 8; k++) {
+        ak *= 69069;
+        ck = ck * 69069 + 1;
+        a[k] = ak;
+        c[k] = ck;
+    }
+    const __m256i mulA = _mm256_loadu_si256((const __m256i*)a);
+    const __m256i addC = _mm256_loadu_si256((const __m256i*)c);
+    const __m256i lowMask = _mm256_set1_epi32(0xffff);
+    const __m256 ditherScale = _mm256_set1_ps(1/65536.0f);
+
+    uint32_t rz = ditherState;
+
+    int n = 0;
+    for (; n < numFrames - 7; n += 8) {
+
+        // TPDF dither for the next 8 frames
+        __m256i s = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int32_t)rz), mulA), addC);
+        rz = (uint32_t)_mm256_extract_epi32(s, 7);
+        __m256i r = _mm256_sub_epi32(_mm256_and_si256(s, lowMask), _mm256_srli_epi32(s, 16));
+        __m256 d = _mm256_mul_ps(_mm256_cvtepi32_ps(r), ditherScale);
+
+        __m256 g = _mm256_loadu_ps(&gain[n]);
+
+        if (numChannels == 1) {
+
+            __m256 x0 = _mm256_mul_ps(_mm256_loadu_ps(&src[n]), g);
+            x0 = _mm256_add_ps(x0, d);
+            _mm_storeu_si128((__m128i*)&dst[n], truncateToInt16(_mm256_cvtps_epi32(x0)));
+
+        } else if (numChannels == 2) {
+
+            __m256 g0, g1, d0, d1;
+            duplicatePairs(g, g0, g1);
+            duplicatePairs(d, d0, d1);
+
+            __m256 x0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&src[2*n+0]), g0), d0);
+            __m256 x1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&src[2*n+8]), g1), d1);
+            _mm_storeu_si128((__m128i*)&dst[2*n+0], truncateToInt16(_mm256_cvtps_epi32(x0)));
+            _mm_storeu_si128((__m128i*)&dst[2*n+8], truncateToInt16(_mm256_cvtps_epi32(x1)));
+
+        } else {
+
+            for (int k = 0; k < 4; k++) {
+                __m256i quad = _mm256_setr_epi32(2*k, 2*k, 2*k, 2*k, 2*k+1, 2*k+1, 2*k+1, 2*k+1);
+                __m256 gk = _mm256_permutevar8x32_ps(g, quad);
+                __m256 dk = _mm256_permutevar8x32_ps(d, quad);
+
+                __m256 x0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&src[4*n+8*k]), gk), dk);
+                _mm_storeu_si128((__m128i*)&dst[4*n+8*k], truncateToInt16(_mm256_cvtps_epi32(x0)));
+            }
+        }
+    }
+
+    gainDitherToInt16_ref(&src[numChannels*n], &gain[n], &dst[numChannels*n], numFrames - n, numChannels, rz);
+    ditherState = rz;
+}
+
+#endif
@@ -250,21 +250,32 @@ void AvatarData::lazyInitHeadData() const {
 }
 
 
-float AvatarData::getDistanceBasedMinRotationDOT(glm::vec3 viewerPosition) const {
+int AvatarData::getDistanceBasedLevel(glm::vec3 viewerPosition) const {
     auto distance = glm::distance(_globalPosition, viewerPosition);
-    float result = ROTATION_CHANGE_179D; // assume worst
     if (distance < AVATAR_DISTANCE_LEVEL_1) {
-        result = AVATAR_MIN_ROTATION_DOT;
+        return 0;
     } else if (distance < AVATAR_DISTANCE_LEVEL_2) {
-        result = ROTATION_CHANGE_2D;
+        return 1;
     } else if (distance < AVATAR_DISTANCE_LEVEL_3) {
-        result = ROTATION_CHANGE_4D;
+        return 2;
     } else if (distance < AVATAR_DISTANCE_LEVEL_4) {
-        result = ROTATION_CHANGE_6D;
+        return 3;
     } else if (distance < AVATAR_DISTANCE_LEVEL_5) {
-        result = ROTATION_CHANGE_15D;
+        return 4;
     }
-    return result;
+    return AVATAR_NUM_DISTANCE_LEVELS - 1;
+}
+
+float AvatarData::getDistanceBasedMinRotationDOT(glm::vec3 viewerPosition) const {
+    static const float MIN_ROTATION_DOTS[AVATAR_NUM_DISTANCE_LEVELS] = {
+        AVATAR_MIN_ROTATION_DOT,
+        ROTATION_CHANGE_2D,
+        ROTATION_CHANGE_4D,
+        ROTATION_CHANGE_6D,
+        ROTATION_CHANGE_15D,
+        ROTATION_CHANGE_179D // assume worst
+    };
+    return MIN_ROTATION_DOTS[getDistanceBasedLevel(viewerPosition)];
 }
 
 float AvatarData::getDistanceBasedMinTranslationDistance(glm::vec3 viewerPosition) const {
@@ -287,6 +298,32 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
                                    bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
                                    QVector<JointData>* sentJointDataOut,
                                    int maxDataSize, AvatarDataRate* outboundDataRateOut) const {
+    lazyInitHeadData();
+
+    // the most this avatar can encode to
+    const int byteArraySize = (int)(AvatarDataPacket::MAX_CONSTANT_HEADER_SIZE + NUM_BYTES_RFC4122_UUID +
+        AvatarDataPacket::maxFaceTrackerInfoSize(_headData->getBlendshapeCoefficients().size()) +
+        AvatarDataPacket::maxJointDataSize(_jointData.size()) +
+        AvatarDataPacket::maxJointDefaultPoseFlagsSize(_jointData.size()) +
+        AvatarDataPacket::FAR_GRAB_JOINTS_SIZE);
+
+    if (maxDataSize == 0 || maxDataSize > byteArraySize) {
+        maxDataSize = byteArraySize;
+    }
+
+    QByteArray avatarDataByteArray(maxDataSize, 0);
+    int avatarDataSize = toBuffer(reinterpret_cast<unsigned char*>(avatarDataByteArray.data()), maxDataSize,
+                                  dataDetail, lastSentTime, lastSentJointData, sendStatus, dropFaceTracking,
+                                  distanceAdjust, viewerPosition, sentJointDataOut, outboundDataRateOut);
+    avatarDataByteArray.resize(avatarDataSize);
+    return avatarDataByteArray;
+}
+
+int AvatarData::toBuffer(unsigned char* destinationBuffer, int maxDataSize, AvatarDataDetail dataDetail,
+                         quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
+                         AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking, bool distanceAdjust,
+                         glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut,
+                         AvatarDataRate* outboundDataRateOut) const {
 
     bool cullSmallChanges = (dataDetail == CullSmallData);
     bool sendAll = (dataDetail == SendAllData);
@@ -294,7 +331,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     bool sendPALMinimum = (dataDetail == PALMinimum);
 
     lazyInitHeadData();
-    ASSERT(maxDataSize == 0 || (size_t)maxDataSize >= AvatarDataPacket::MIN_BULK_PACKET_SIZE);
+    ASSERT((size_t)maxDataSize >= AvatarDataPacket::MIN_BULK_PACKET_SIZE);
 
     // Leading flags, to indicate how much data is actually included in the packet...
     AvatarDataPacket::HasFlags wantedFlags = 0;
@@ -305,13 +342,15 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     if (dataDetail == NoData) {
         sendStatus.itemFlags = wantedFlags;
 
-        QByteArray avatarDataByteArray;
+        int avatarDataSize = 0;
         if (sendStatus.sendUUID) {
-            avatarDataByteArray.append(getSessionUUID().toRfc4122().data(), NUM_BYTES_RFC4122_UUID);
+            memcpy(destinationBuffer, getSessionUUID().toRfc4122().data(), NUM_BYTES_RFC4122_UUID);
+            avatarDataSize += NUM_BYTES_RFC4122_UUID;
         }
 
-        avatarDataByteArray.append((char*) &wantedFlags, sizeof wantedFlags);
-        return avatarDataByteArray;
+        memcpy(destinationBuffer + avatarDataSize, &wantedFlags, sizeof wantedFlags);
+        avatarDataSize += sizeof wantedFlags;
+        return avatarDataSize;
     }
 
     // FIXME -
@@ -434,18 +473,6 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         parentID = getParentID();
     }
 
-    const size_t byteArraySize = AvatarDataPacket::MAX_CONSTANT_HEADER_SIZE + NUM_BYTES_RFC4122_UUID +
-        AvatarDataPacket::maxFaceTrackerInfoSize(_headData->getBlendshapeCoefficients().size()) +
-        AvatarDataPacket::maxJointDataSize(_jointData.size()) +
-        AvatarDataPacket::maxJointDefaultPoseFlagsSize(_jointData.size()) +
-        AvatarDataPacket::FAR_GRAB_JOINTS_SIZE;
-
-    if (maxDataSize == 0) {
-        maxDataSize = (int)byteArraySize;
-    }
-
-    QByteArray avatarDataByteArray((int)byteArraySize, 0);
-    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
     const unsigned char* const startPosition = destinationBuffer;
     const unsigned char* const packetEnd = destinationBuffer + maxDataSize;
 
@@ -890,12 +917,12 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
     int avatarDataSize = destinationBuffer - startPosition;
 
-    if (avatarDataSize > (int)byteArraySize) {
-        qCCritical(avatars) << "AvatarData::toByteArray buffer overflow"; // We've overflown into the heap
+    if (avatarDataSize > maxDataSize) {
+        qCCritical(avatars) << "AvatarData::toBuffer buffer overflow"; // We've overflown into the heap
         ASSERT(false);
     }
 
-    return avatarDataByteArray.left(avatarDataSize);
+    return avatarDataSize;
 
 #undef AVATAR_MEMCPY
 #undef IF_AVATAR_SPACE
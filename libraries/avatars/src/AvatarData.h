@@ -412,6 +412,7 @@ const float AVATAR_DISTANCE_LEVEL_2 = 16.6f; // meters
 const float AVATAR_DISTANCE_LEVEL_3 = 25.0f; // meters
 const float AVATAR_DISTANCE_LEVEL_4 = 50.0f; // meters
 const float AVATAR_DISTANCE_LEVEL_5 = 200.0f; // meters
+const int AVATAR_NUM_DISTANCE_LEVELS = 6; // closer than each of the thresholds above, and beyond all of them
 
 // Where one's own Avatar begins in the world (will be overwritten if avatar data file is found).
 // This is the start location in the Sandbox (xyz: 6270, 211, 6000).
@@ -627,6 +628,13 @@ public:
         AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
         QVector<JointData>* sentJointDataOut, int maxDataSize = 0, AvatarDataRate* outboundDataRateOut = nullptr) const;
 
+    // Same encoding as toByteArray, written straight to destinationBuffer (e.g. a packet's payload) which has room for
+    // maxDataSize bytes, at least AvatarDataPacket::MIN_BULK_PACKET_SIZE. Returns the number of bytes written.
+    int toBuffer(unsigned char* destinationBuffer, int maxDataSize, AvatarDataDetail dataDetail, quint64 lastSentTime,
+        const QVector<JointData>& lastSentJointData, AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking,
+        bool distanceAdjust, glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut,
+        AvatarDataRate* outboundDataRateOut = nullptr) const;
+
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
@@ -1668,6 +1676,10 @@ public slots:
      */
     void resetLastSent() { _lastToByteArray = 0; }
 
+    // which of the rotation culling distance thresholds a viewer at viewerPosition falls in, 0 being the closest
+    // toByteArray encodes the same data for every viewer in a given level
+    int getDistanceBasedLevel(glm::vec3 viewerPosition) const;
+
 protected:
     void insertRemovedEntityID(const QUuid entityID);
     void lazyInitHeadData() const;
@@ -0,0 +1,62 @@
+//
+//  AvatarEncodeCache.cpp
+//  libraries/avatars/src
+//
+//  Created on 2019-11-04.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarEncodeCache.h"
+
+#include <assert.h>
+
+#include <SharedUtil.h>
+
+std::atomic<uint32_t> AvatarEncodeCache::_nextVersion { 1 };
+
+const AvatarEncodeCache::Encode& AvatarEncodeCache::get(const AvatarData& avatar, uint64_t frame, glm::vec3 viewerPosition,
+                                                       bool wantKeyframe, bool* encoded) {
+    auto& level = _levels[avatar.getDistanceBasedLevel(viewerPosition)];
+
+    std::lock_guard<std::mutex> lock(level.mutex);
+
+    if (level.hasEncode && level.frame == frame) {
+        if (encoded) {
+            *encoded = false;
+        }
+        return level.encode;
+    }
+
+    bool isKeyframe = wantKeyframe || !level.hasEncode;
+    auto& encode = level.encode;
+
+    // encode against what the viewers in sync with this level got last time, any viewer in this level culls the same
+    AvatarDataPacket::SendStatus sendStatus;
+    sendStatus.sendUUID = true;
+    const bool dropFaceTracking = false;
+    const bool distanceAdjust = true;
+    quint64 encodeTime = usecTimestampNow();
+    encode.bytes = avatar.toByteArray(isKeyframe ? AvatarData::SendAllData : AvatarData::CullSmallData, level.encodeTime,
+                                      encode.sentJoints, sendStatus, dropFaceTracking, distanceAdjust, viewerPosition,
+                                      &encode.sentJoints);
+    assert(sendStatus);
+
+    encode.baseVersion = isKeyframe ? 0 : encode.version;
+    encode.version = _nextVersion++;
+    if (encode.version == 0) {
+        // wrapped around, 0 is reserved for viewers that are not in sync with anything
+        encode.version = _nextVersion++;
+    }
+
+    level.encodeTime = encodeTime;
+    level.frame = frame;
+    level.hasEncode = true;
+
+    if (encoded) {
+        *encoded = true;
+    }
+    return encode;
+}
@@ -0,0 +1,65 @@
+//
+//  AvatarEncodeCache.h
+//  libraries/avatars/src
+//
+//  Created on 2019-11-04.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarEncodeCache_h
+#define hifi_AvatarEncodeCache_h
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+#include <JointData.h>
+
+#include "AvatarData.h"
+
+// Avatar data encoded once per frame and distance level, to be fanned out to every viewer in that level.
+//
+// Each level keeps its own stream of encodes: a keyframe (SendAllData) followed by deltas (CullSmallData), each of
+// them against the joints of the previous one. A viewer that got the previous encode of a level is in sync with it and
+// can be sent the next one as is; anyone can be sent a keyframe. Viewers that are out of sync (they were skipped, or
+// moved to another level) need an encode of their own until the next keyframe.
+class AvatarEncodeCache {
+public:
+    struct Encode {
+        QByteArray bytes;                 // avatar data record, with the session UUID
+        QVector<JointData> sentJoints;    // the joints a viewer has once it was sent bytes
+        uint32_t version { 0 };
+        uint32_t baseVersion { 0 };       // version a viewer must have for bytes to apply, 0 for a keyframe
+
+        bool isKeyframe() const { return baseVersion == 0; }
+        bool appliesTo(uint32_t viewerVersion) const { return isKeyframe() || viewerVersion == baseVersion; }
+    };
+
+    // Returns the encode of avatar for frame at the distance level of viewerPosition, encoding it if this is the first
+    // request for that frame and level (wantKeyframe only matters then). encoded is set if this call did the encoding.
+    // Thread-safe, the returned encode stays valid until the next frame.
+    const Encode& get(const AvatarData& avatar, uint64_t frame, glm::vec3 viewerPosition, bool wantKeyframe,
+                      bool* encoded = nullptr);
+
+private:
+    struct Level {
+        std::mutex mutex;
+        uint64_t frame { 0 };
+        bool hasEncode { false };
+        quint64 encodeTime { 0 };
+        Encode encode;
+    };
+
+    std::array<Level, AVATAR_NUM_DISTANCE_LEVELS> _levels;
+
+    // versions are unique across avatars, so a viewer never mistakes a new avatar's stream for an old one's
+    static std::atomic<uint32_t> _nextVersion;
+};
+
+#endif // hifi_AvatarEncodeCache_h
@@ -0,0 +1,51 @@
+//
+//  BakeVersions.h
+//  libraries/baking/src
+//
+//  Created on 2019-12-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeVersions_h
+#define hifi_BakeVersions_h
+
+// The versions of the bakes, shared by the asset server, which re-bakes assets baked by an older version, and the
+// bakers, which don't reuse what an older version baked.
+
+using BakeVersion = int;
+static const BakeVersion INITIAL_BAKE_VERSION = 0;
+static const BakeVersion NEEDS_BAKING_BAKE_VERSION = -1;
+
+// ATTENTION! Do not remove baking versions, and do not reorder them. If you add
+// a new value, it will immediately become the "current" version.
+enum class ModelBakeVersion : BakeVersion {
+    Initial = INITIAL_BAKE_VERSION,
+    MetaTextureJson,
+
+    COUNT
+};
+
+// ATTENTION! See above.
+enum class TextureBakeVersion : BakeVersion {
+    Initial = INITIAL_BAKE_VERSION,
+    MetaTextureJson,
+
+    COUNT
+};
+
+// ATTENTION! See above.
+enum class ScriptBakeVersion : BakeVersion {
+    Initial = INITIAL_BAKE_VERSION,
+    FixEmptyScripts,
+
+    COUNT
+};
+
+static const ModelBakeVersion CURRENT_MODEL_BAKE_VERSION = (ModelBakeVersion)((BakeVersion)ModelBakeVersion::COUNT - 1);
+static const TextureBakeVersion CURRENT_TEXTURE_BAKE_VERSION = (TextureBakeVersion)((BakeVersion)TextureBakeVersion::COUNT - 1);
+static const ScriptBakeVersion CURRENT_SCRIPT_BAKE_VERSION = (ScriptBakeVersion)((BakeVersion)ScriptBakeVersion::COUNT - 1);
+
+#endif // hifi_BakeVersions_h
@@ -0,0 +1,196 @@
+//
+//  BakedTextureCache.cpp
+//  libraries/baking/src
+//
+//  Created on 2019-12-01.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedTextureCache.h"
+
+#include <cstring>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include <ktx/KTX.h>
+
+#include "BakeVersions.h"
+#include "ModelBakingLoggingCategory.h"
+
+static const QString ENTRY_FILE_EXTENSION = ".bake";
+
+// the directory is trimmed again whenever this process wrote this fraction of its budget since the last time
+static const int DIRECTORY_TRIM_FRACTION = 16;
+
+// marks the file of an entry as just used, the directory is trimmed by modification time
+static void touch(const QString& filePath) {
+    QFile file { filePath };
+    // not if another process trimmed it meanwhile
+    if (file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly)) {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+}
+
+// drops the least recently used entries of directory until the rest fit in budget, returns how many are left
+static int trimDirectory(const QString& directory, qint64 budget) {
+    auto files = QDir(directory).entryInfoList({ "*" + ENTRY_FILE_EXTENSION }, QDir::Files, QDir::Time);
+    qint64 size = 0;
+    int numRemoved = 0;
+    for (const auto& file : files) {
+        size += file.size();
+        if (size > budget && QFile::remove(file.absoluteFilePath())) {
+            ++numRemoved;
+        }
+    }
+    return files.size() - numRemoved;
+}
+
+// a file cut short or damaged on disk must not be served as a baked texture
+static bool isValidKTX(const QByteArray& data) {
+    auto storage = std::make_shared<storage::MemoryStorage>(data.size(), reinterpret_cast<const uint8_t*>(data.constData()));
+    return ktx::KTX::validate(storage);
+}
+
+BakedTextureCache& BakedTextureCache::getInstance() {
+    static BakedTextureCache instance;
+    return instance;
+}
+
+BakedTextureCache::Key BakedTextureCache::makeKey(const QByteArray& sourceHash, image::TextureUsage::Type textureType,
+                                                  gpu::BackendTarget target, bool compress) {
+    return QString("%1-%2-%3-%4-b%5-p%6-v%7").arg(QString(sourceHash.toHex())).arg((int)textureType).arg((int)target)
+        .arg(compress ? "c" : "u").arg((int)CURRENT_TEXTURE_BAKE_VERSION).arg(image::TEXTURE_PROCESSING_VERSION)
+        .arg(CACHE_VERSION);
+}
+
+void BakedTextureCache::setDirectory(const QString& directory, qint64 budget) {
+    QDir cacheDir { directory };
+    if (!cacheDir.mkpath(".")) {
+        qCWarning(model_baking) << "Could not create baked texture cache directory" << directory;
+        return;
+    }
+
+    int numEntries = trimDirectory(directory, budget);
+    qCDebug(model_baking) << "Using baked texture cache at" << directory << "with" << numEntries << "entries";
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _directory = directory;
+    _directoryBudget = budget;
+    _bytesWrittenSinceTrim = 0;
+}
+
+QByteArray BakedTextureCache::find(const Key& key) {
+    QString directory;
+    QByteArray ktx;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        directory = _directory;
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            ++_stats.hits;
+            _stats.savedUsecs += it->bakeUsecs;
+            ktx = it->ktx;
+        }
+    }
+    if (!ktx.isEmpty()) {
+        if (!directory.isEmpty()) {
+            // so that the processes sharing the directory don't trim the file of an entry we keep using
+            touch(QDir(directory).absoluteFilePath(key + ENTRY_FILE_EXTENSION));
+        }
+        return ktx;
+    }
+
+    if (!directory.isEmpty()) {
+        QFile file { QDir(directory).absoluteFilePath(key + ENTRY_FILE_EXTENSION) };
+        if (file.open(QIODevice::ReadOnly)) {
+            Entry entry;
+            auto contents = file.readAll();
+            if (contents.size() > (int)sizeof(entry.bakeUsecs)) {
+                memcpy(&entry.bakeUsecs, contents.constData(), sizeof(entry.bakeUsecs));
+                entry.ktx = contents.mid(sizeof(entry.bakeUsecs));
+            }
+            file.close();
+
+            if (isValidKTX(entry.ktx)) {
+                touch(file.fileName());
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_stats.hits;
+                _stats.savedUsecs += entry.bakeUsecs;
+                insertInMemory(key, entry);
+                return entry.ktx;
+            }
+
+            qCWarning(model_baking) << "Removing invalid baked texture cache entry" << file.fileName();
+            file.remove();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_stats.misses;
+    return QByteArray();
+}
+
+void BakedTextureCache::insert(const Key& key, const QByteArray& ktx, uint64_t bakeUsecs) {
+    Entry entry { ktx, bakeUsecs };
+    QString directory;
+    qint64 budget;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.bakedUsecs += bakeUsecs;
+        insertInMemory(key, entry);
+        directory = _directory;
+        budget = _directoryBudget;
+    }
+
+    if (directory.isEmpty()) {
+        return;
+    }
+
+    QSaveFile file { QDir(directory).absoluteFilePath(key + ENTRY_FILE_EXTENSION) };
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write((const char*)&entry.bakeUsecs, sizeof(entry.bakeUsecs)) == -1 ||
+        file.write(ktx) == -1 || !file.commit()) {
+        qCWarning(model_baking) << "Could not write baked texture cache entry" << key;
+        return;
+    }
+
+    // the oven workers live as long as the asset server, so the budget is kept while they run and not only at startup
+    bool needsTrim;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bytesWrittenSinceTrim += (qint64)sizeof(entry.bakeUsecs) + ktx.size();
+        needsTrim = _bytesWrittenSinceTrim > budget / DIRECTORY_TRIM_FRACTION;
+        if (needsTrim) {
+            _bytesWrittenSinceTrim = 0;
+        }
+    }
+    if (needsTrim) {
+        trimDirectory(directory, budget);
+    }
+}
+
+BakedTextureCache::Stats BakedTextureCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void BakedTextureCache::insertInMemory(const Key& key, const Entry& entry) {
+    if (_entries.contains(key) || entry.ktx.size() > MEMORY_BUDGET) {
+        return;
+    }
+
+    while (_memoryUsage + entry.ktx.size() > MEMORY_BUDGET && !_insertionOrder.isEmpty()) {
+        _memoryUsage -= _entries.take(_insertionOrder.dequeue()).ktx.size();
+    }
+
+    _entries.insert(key, entry);
+    _insertionOrder.enqueue(key);
+    _memoryUsage += entry.ktx.size();
+}
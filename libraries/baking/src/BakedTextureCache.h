@@ -0,0 +1,86 @@
+//
+//  BakedTextureCache.h
+//  libraries/baking/src
+//
+//  Created on 2019-12-01.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakedTextureCache_h
+#define hifi_BakedTextureCache_h
+
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QQueue>
+#include <QtCore/QString>
+
+#include <image/TextureProcessing.h>
+
+// The KTX textures we baked, by what they were baked from: the content of the source image, its usage type, the backend
+// target and whether it was compressed, and by how: the texture bake version and the image processing version. The same
+// image embedded in many models or referenced by many materials is then only processed and compressed once.
+//
+// Entries are kept in memory up to a budget and, once a directory is set, in files there as well so that they are
+// shared with the other oven processes and later bakes. Each file holds the time the bake took, for the stats, ahead
+// of the KTX. Files are written whole or not at all, so processes can share a directory, and are touched whenever
+// they're used so that the directory is trimmed least recently used first. It is trimmed when it is set and again every
+// so often as entries are written to it. A file that doesn't hold a valid KTX is removed instead of being served.
+class BakedTextureCache {
+public:
+    struct Stats {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        uint64_t savedUsecs { 0 }; // time the bakes found in the cache took when they were made
+        uint64_t bakedUsecs { 0 }; // time spent on the bakes that weren't found
+    };
+
+    using Key = QString;
+
+    // bump to ignore the entries of previous versions of the cache format
+    static const int CACHE_VERSION = 1;
+
+    static const qint64 MEMORY_BUDGET = 256 * 1024 * 1024;
+    static const qint64 DEFAULT_DIRECTORY_BUDGET = 2048LL * 1024 * 1024;
+
+    static BakedTextureCache& getInstance();
+
+    // sourceHash is the SHA-256 of the content of the source image
+    static Key makeKey(const QByteArray& sourceHash, image::TextureUsage::Type textureType,
+                       gpu::BackendTarget target, bool compress);
+
+    // keeps entries in directory too, trimming the least recently used files there until they fit in budget, now and
+    // as entries are inserted
+    void setDirectory(const QString& directory, qint64 budget = DEFAULT_DIRECTORY_BUDGET);
+
+    // returns the KTX baked for key, or an empty array if there's none
+    QByteArray find(const Key& key);
+
+    // bakeUsecs is the time the bake took
+    void insert(const Key& key, const QByteArray& ktx, uint64_t bakeUsecs);
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        QByteArray ktx;
+        uint64_t bakeUsecs;
+    };
+
+    void insertInMemory(const Key& key, const Entry& entry);
+
+    mutable std::mutex _mutex;
+    QString _directory;
+    qint64 _directoryBudget { DEFAULT_DIRECTORY_BUDGET };
+    qint64 _bytesWrittenSinceTrim { 0 };
+    QHash<Key, Entry> _entries;
+    QQueue<Key> _insertionOrder; // the oldest entry is evicted first
+    qint64 _memoryUsage { 0 };
+    Stats _stats;
+};
+
+#endif // hifi_BakedTextureCache_h
@@ -24,6 +24,7 @@
 
 #include <OwningBuffer.h>
 
+#include "BakedTextureCache.h"
 #include "ModelBakingLoggingCategory.h"
 
 const QString BAKED_TEXTURE_KTX_EXT = ".ktx";
@@ -136,6 +137,19 @@ void TextureBaker::processTexture() {
     auto hashData = hasher.result();
     std::string hash = hashData.toHex().toStdString();
 
+    // the same image may well have been baked already, for another model or material
+    auto sourceHash = QCryptographicHash::hash(_originalTexture, QCryptographicHash::Sha256);
+    auto cacheKey = [&](gpu::BackendTarget target, bool compress) {
+        return BakedTextureCache::makeKey(sourceHash, _textureType, target, compress);
+    };
+    std::vector<std::pair<gpu::BackendTarget, BakedTextureCache::Key>> compressedCacheKeys;
+    if (_compressionEnabled) {
+        for (auto target : { gpu::BackendTarget::GL45, gpu::BackendTarget::GLES32 }) {
+            compressedCacheKeys.emplace_back(target, cacheKey(target, true));
+        }
+    }
+    auto uncompressedCacheKey = cacheKey(gpu::BackendTarget::GL45, false);
+
     TextureMeta meta;
 
     QString originalCopyFilePath = _originalCopyFilePath.toString();
@@ -161,88 +175,48 @@ void TextureBaker::processTexture() {
     }
 
     // Compressed KTX
-    if (_compressionEnabled) {
-        constexpr std::array<gpu::BackendTarget, 2> BACKEND_TARGETS {{
-            gpu::BackendTarget::GL45,
-            gpu::BackendTarget::GLES32
-        }};
-        for (auto target : BACKEND_TARGETS) {
-            auto processedTexture = image::processImage(buffer, _textureURL.toString().toStdString(), image::ColorChannel::NONE,
-                                                        ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, true,
-                                                        target, _abortProcessing);
-            if (!processedTexture) {
-                handleError("Could not process texture " + _textureURL.toString());
-                return;
-            }
-            processedTexture->setSourceHash(hash);
-
-            if (shouldStop()) {
-                return;
-            }
-
-            auto memKTX = gpu::Texture::serialize(*processedTexture);
-            if (!memKTX) {
-                handleError("Could not serialize " + _textureURL.toString() + " to KTX");
-                return;
-            }
-
-            const char* name = khronos::gl::texture::toString(memKTX->_header.getGLInternaFormat());
-            if (name == nullptr) {
-                handleError("Could not determine internal format for compressed KTX: " + _textureURL.toString());
-                return;
-            }
-
-            const char* data = reinterpret_cast<const char*>(memKTX->_storage->data());
-            const size_t length = memKTX->_storage->size();
-
-            auto fileName = _baseFilename + "_" + name + ".ktx";
-            auto filePath = _outputDirectory.absoluteFilePath(fileName);
-            QFile bakedTextureFile { filePath };
-            if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(data, length) == -1) {
-                handleError("Could not write baked texture for " + _textureURL.toString());
-                return;
-            }
-            _outputFiles.push_back(filePath);
-            meta.availableTextureTypes[memKTX->_header.getGLInternaFormat()] = fileName;
+    for (const auto& targetKey : compressedCacheKeys) {
+        auto ktxData = bakeKTX(buffer, hash, targetKey.first, true, targetKey.second);
+        if (ktxData.isEmpty()) {
+            return;
         }
-    }
 
-    // Uncompressed KTX
-    if (_textureType == image::TextureUsage::Type::SKY_TEXTURE || _textureType == image::TextureUsage::Type::AMBIENT_TEXTURE) {
-        buffer->reset();
-        auto processedTexture = image::processImage(std::move(buffer), _textureURL.toString().toStdString(), image::ColorChannel::NONE,
-                                                    ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, false, gpu::BackendTarget::GL45, _abortProcessing);
-        if (!processedTexture) {
-            handleError("Could not process texture " + _textureURL.toString());
+        auto internalFormat = reinterpret_cast<const ktx::Header*>(ktxData.constData())->getGLInternaFormat();
+        const char* name = khronos::gl::texture::toString(internalFormat);
+        if (name == nullptr) {
+            handleError("Could not determine internal format for compressed KTX: " + _textureURL.toString());
             return;
         }
-        processedTexture->setSourceHash(hash);
 
-        if (shouldStop()) {
+        auto fileName = _baseFilename + "_" + name + ".ktx";
+        auto filePath = _outputDirectory.absoluteFilePath(fileName);
+        QFile bakedTextureFile { filePath };
+        if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(ktxData) == -1) {
+            handleError("Could not write baked texture for " + _textureURL.toString());
             return;
         }
+        _outputFiles.push_back(filePath);
+        meta.availableTextureTypes[internalFormat] = fileName;
+    }
 
-        auto memKTX = gpu::Texture::serialize(*processedTexture);
-        if (!memKTX) {
-            handleError("Could not serialize " + _textureURL.toString() + " to KTX");
+    // Uncompressed KTX
+    if (_textureType == image::TextureUsage::Type::SKY_TEXTURE || _textureType == image::TextureUsage::Type::AMBIENT_TEXTURE) {
+        auto ktxData = bakeKTX(buffer, hash, gpu::BackendTarget::GL45, false, uncompressedCacheKey);
+        if (ktxData.isEmpty()) {
             return;
         }
 
-        const char* data = reinterpret_cast<const char*>(memKTX->_storage->data());
-        const size_t length = memKTX->_storage->size();
-
         auto fileName = _baseFilename + ".ktx";
         auto filePath = _outputDirectory.absoluteFilePath(fileName);
         QFile bakedTextureFile { filePath };
-        if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(data, length) == -1) {
+        if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(ktxData) == -1) {
             handleError("Could not write baked texture for " + _textureURL.toString());
             return;
         }
         _outputFiles.push_back(filePath);
         meta.uncompressed = fileName;
-    } else {
-        buffer.reset();
     }
+    buffer.reset();
 
     {
         auto data = meta.serialize();
@@ -260,6 +234,42 @@ void TextureBaker::processTexture() {
     setIsFinished(true);
 }
 
+QByteArray TextureBaker::bakeKTX(const std::shared_ptr<QIODevice>& buffer, const std::string& hash,
+                                 gpu::BackendTarget target, bool compress, const BakedTextureCache::Key& cacheKey) {
+    auto& cache = BakedTextureCache::getInstance();
+    auto ktxData = cache.find(cacheKey);
+    if (!ktxData.isEmpty()) {
+        qCDebug(model_baking) << "Found baked texture for" << _textureURL << "in the baked texture cache";
+        return ktxData;
+    }
+
+    auto start = usecTimestampNow();
+
+    buffer->reset();
+    auto processedTexture = image::processImage(buffer, _textureURL.toString().toStdString(), image::ColorChannel::NONE,
+                                                ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType, compress,
+                                                target, _abortProcessing);
+    if (!processedTexture) {
+        handleError("Could not process texture " + _textureURL.toString());
+        return QByteArray();
+    }
+    processedTexture->setSourceHash(hash);
+
+    if (shouldStop()) {
+        return QByteArray();
+    }
+
+    auto memKTX = gpu::Texture::serialize(*processedTexture);
+    if (!memKTX) {
+        handleError("Could not serialize " + _textureURL.toString() + " to KTX");
+        return QByteArray();
+    }
+
+    ktxData = QByteArray(reinterpret_cast<const char*>(memKTX->_storage->data()), (int)memKTX->_storage->size());
+    cache.insert(cacheKey, ktxData, usecTimestampNow() - start);
+    return ktxData;
+}
+
 void TextureBaker::setWasAborted(bool wasAborted) {
     Baker::setWasAborted(wasAborted);
 
@@ -20,6 +20,7 @@
 
 #include <image/TextureProcessing.h>
 
+#include "BakedTextureCache.h"
 #include "Baker.h"
 
 #include <graphics/Material.h>
@@ -65,6 +66,11 @@ private:
     void loadTexture();
     void handleTextureNetworkReply();
 
+    // returns the serialized KTX of the texture for target, from the baked texture cache if it has it, or an empty
+    // array after reporting the error if it couldn't be baked
+    QByteArray bakeKTX(const std::shared_ptr<QIODevice>& buffer, const std::string& hash,
+                       gpu::BackendTarget target, bool compress, const BakedTextureCache::Key& cacheKey);
+
     QUrl _textureURL;
     QByteArray _originalTexture;
     image::TextureUsage::Type _textureType;
@@ -73,6 +73,10 @@ public:
 
     void reset() { _path.clear(); _completedView.startTime = 0; } // resets our state to force a new "First" traversal
 
+    // takes the result of a First traversal run elsewhere with view as our completed traversal,
+    // the next one is then a Repeat that looks for what changed since view.startTime
+    void adoptCompletedTraversal(const View& view) { _path.clear(); _currentView = view; _completedView = view; }
+
 private:
     void getNextVisibleElement(VisibleElement& next);
 
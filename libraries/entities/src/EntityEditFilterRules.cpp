@@ -0,0 +1,208 @@
+//
+//  EntityEditFilterRules.cpp
+//  libraries/entities/src
+//
+//  Created on 2019-11-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEditFilterRules.h"
+
+#include <algorithm>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <NumericalConstants.h>
+
+// buckets are dropped once they're full again, whenever there are more than this many
+static const size_t MAX_RATE_LIMIT_BUCKETS = 1024;
+
+static bool vec3FromJson(const QJsonValue& value, glm::vec3& vec) {
+    QJsonObject object = value.toObject();
+    if (!object.contains("x") || !object.contains("y") || !object.contains("z")) {
+        return false;
+    }
+    vec = glm::vec3(object["x"].toDouble(), object["y"].toDouble(), object["z"].toDouble());
+    return true;
+}
+
+static void readWantsToFilter(const QJsonObject& object, const char* key, bool& wantsToFilter) {
+    if (object[key].isBool()) {
+        wantsToFilter = object[key].toBool();
+    }
+}
+
+bool EntityEditFilterRules::isRuleSet(const QByteArray& contents) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(contents, &parseError);
+    return parseError.error == QJsonParseError::NoError && document.isObject() && document.object().contains("rules");
+}
+
+std::shared_ptr<EntityEditFilterRules> EntityEditFilterRules::parse(const QByteArray& contents, QString& error) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(contents, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = parseError.errorString();
+        return nullptr;
+    }
+    QJsonObject object = document.object();
+    if (!object["rules"].isArray()) {
+        error = "rules is not an array";
+        return nullptr;
+    }
+
+    auto rules = std::make_shared<EntityEditFilterRules>();
+    readWantsToFilter(object, "wantsToFilterAdd", rules->_wantsToFilterAdd);
+    readWantsToFilter(object, "wantsToFilterEdit", rules->_wantsToFilterEdit);
+    readWantsToFilter(object, "wantsToFilterPhysics", rules->_wantsToFilterPhysics);
+    readWantsToFilter(object, "wantsToFilterDelete", rules->_wantsToFilterDelete);
+
+    QJsonArray ruleArray = object["rules"].toArray();
+    for (int i = 0; i < ruleArray.size(); i++) {
+        QJsonObject ruleObject = ruleArray[i].toObject();
+        if (ruleObject.size() != 1) {
+            error = QString("rule %1 should have exactly one key").arg(i);
+            return nullptr;
+        }
+        QString type = ruleObject.begin().key();
+        QJsonValue value = ruleObject.begin().value();
+
+        if (type == "rejectProperties") {
+            EntityPropertyFlags rejectedProperties;
+            QJsonArray names = value.isArray() ? value.toArray() : QJsonArray { value };
+            for (const auto& name : names) {
+                EntityPropertyInfo propertyInfo;
+                if (!EntityItemProperties::getPropertyInfo(name.toString(), propertyInfo)) {
+                    error = QString("rule %1 names an unknown property %2").arg(i).arg(name.toString());
+                    return nullptr;
+                }
+                rejectedProperties << propertyInfo.propertyEnum;
+            }
+            rules->_rules.push_back([rejectedProperties](Edit& edit) {
+                EntityPropertyFlags changedProperties = edit.propertiesIn.getChangedProperties();
+                for (int flag = (int)rejectedProperties.firstFlag(); flag <= (int)rejectedProperties.lastFlag(); flag++) {
+                    if (rejectedProperties.getHasProperty((EntityPropertyList)flag) &&
+                            changedProperties.getHasProperty((EntityPropertyList)flag)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+
+        } else if (type == "clampPosition") {
+            bool toZone = value.toString() == "zone";
+            glm::vec3 minimum, maximum;
+            if (!toZone && (!vec3FromJson(value.toObject()["min"], minimum) || !vec3FromJson(value.toObject()["max"], maximum))) {
+                error = QString("rule %1 should clamp to \"zone\" or to a min and max").arg(i);
+                return nullptr;
+            }
+            rules->_needsZone |= toZone;
+            rules->_rules.push_back([toZone, minimum, maximum](Edit& edit) {
+                if (!edit.propertiesIn.containsPositionChange()) {
+                    return true;
+                }
+                glm::vec3 low = minimum;
+                glm::vec3 high = maximum;
+                if (toZone) {
+                    bool success = false;
+                    AABox box = edit.zone ? edit.zone->getAABox(success) : AABox();
+                    if (!success) {
+                        // the global filter has no zone to clamp to
+                        return true;
+                    }
+                    low = box.getMinimumPoint();
+                    high = box.getMaximumPoint();
+                }
+                glm::vec3 position = edit.propertiesIn.getPosition();
+                glm::vec3 clampedPosition = glm::clamp(position, low, high);
+                if (clampedPosition != position) {
+                    edit.propertiesIn.setPosition(clampedPosition);
+                    edit.propertiesOut.setPosition(clampedPosition);
+                    edit.wasChanged = true;
+                }
+                return true;
+            });
+
+        } else if (type == "rateLimit") {
+            float editsPerSecond = (float)value.toObject()["editsPerSecond"].toDouble();
+            float burst = (float)value.toObject()["burst"].toDouble(editsPerSecond);
+            if (editsPerSecond <= 0.0f || burst < 1.0f) {
+                error = QString("rule %1 should allow a positive editsPerSecond, in bursts of at least 1").arg(i);
+                return nullptr;
+            }
+            rules->_rateLimits.emplace_back(new RateLimit { editsPerSecond, burst });
+            RateLimit* rateLimit = rules->_rateLimits.back().get();
+            rules->_rules.push_back([rateLimit](Edit& edit) {
+                if (edit.senderID.isNull()) {
+                    return true;
+                }
+
+                std::lock_guard<std::mutex> lock(rateLimit->mutex);
+                auto refilled = [&](const TokenBucket& bucket) {
+                    quint64 sinceRefill = edit.now > bucket.lastRefill ? edit.now - bucket.lastRefill : 0;
+                    float elapsed = (float)sinceRefill / (float)USECS_PER_SECOND;
+                    return std::min(rateLimit->burst, bucket.tokens + elapsed * rateLimit->editsPerSecond);
+                };
+                auto it = rateLimit->buckets.find(edit.senderID);
+                if (it == rateLimit->buckets.end()) {
+                    if (rateLimit->buckets.size() >= MAX_RATE_LIMIT_BUCKETS) {
+                        for (auto bucket = rateLimit->buckets.begin(); bucket != rateLimit->buckets.end();) {
+                            if (refilled(bucket->second) >= rateLimit->burst) {
+                                bucket = rateLimit->buckets.erase(bucket);
+                            } else {
+                                ++bucket;
+                            }
+                        }
+                    }
+                    it = rateLimit->buckets.emplace(edit.senderID, TokenBucket { rateLimit->burst, edit.now }).first;
+                }
+                TokenBucket& bucket = it->second;
+                bucket.tokens = refilled(bucket);
+                bucket.lastRefill = edit.now;
+                if (bucket.tokens < 1.0f) {
+                    return false;
+                }
+                bucket.tokens -= 1.0f;
+                return true;
+            });
+
+        } else if (type == "reject") {
+            if (value.toBool()) {
+                rules->_rules.push_back([](Edit& edit) { return false; });
+            }
+
+        } else {
+            error = QString("rule %1 has an unknown type %2").arg(i).arg(type);
+            return nullptr;
+        }
+    }
+    return rules;
+}
+
+bool EntityEditFilterRules::wantsToFilter(EntityTree::FilterType filterType) const {
+    switch (filterType) {
+        case EntityTree::FilterType::Add:
+            return _wantsToFilterAdd;
+        case EntityTree::FilterType::Edit:
+            return _wantsToFilterEdit;
+        case EntityTree::FilterType::Physics:
+            return _wantsToFilterPhysics;
+        case EntityTree::FilterType::Delete:
+            return _wantsToFilterDelete;
+    }
+    return true;
+}
+
+bool EntityEditFilterRules::apply(Edit& edit) const {
+    for (const auto& rule : _rules) {
+        if (!rule(edit)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,107 @@
+//
+//  EntityEditFilterRules.h
+//  libraries/entities/src
+//
+//  Created on 2019-11-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditFilterRules_h
+#define hifi_EntityEditFilterRules_h
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include <UUIDHasher.h>
+
+#include "EntityItemProperties.h"
+#include "EntityTree.h"
+
+// A declarative entity edit filter, compiled to a chain of native rules so that filtering an edit doesn't go through
+// the script engine. It is loaded from the same filter URL as a script filter, as a JSON object like:
+//
+//  {
+//      "wantsToFilterPhysics": false,
+//      "rules": [
+//          { "rejectProperties": [ "locked", "serverScripts" ] },
+//          { "clampPosition": "zone" },
+//          { "clampPosition": { "min": { "x": -10, "y": 0, "z": -10 }, "max": { "x": 10, "y": 5, "z": 10 } } },
+//          { "rateLimit": { "editsPerSecond": 10, "burst": 20 } },
+//          { "reject": true }
+//      ]
+//  }
+//
+// The wantsToFilter* flags default like they do for a script filter. The rules run in order, and the first one that
+// rejects an edit stops the chain:
+//  - rejectProperties rejects edits that change any of the properties
+//  - clampPosition clamps the position an edit sets to the bounding box of the filter's zone, or to the given box
+//  - rateLimit lets each sending node through at most editsPerSecond edits on average, in bursts of at most burst
+//    edits; edits the server makes itself aren't limited
+//  - reject rejects every edit
+class EntityEditFilterRules {
+public:
+    struct Edit {
+        Edit(EntityTree::FilterType filterType, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut,
+                bool& wasChanged, const EntityItemPointer& existingEntity, const EntityItemPointer& zone,
+                const QUuid& senderID, quint64 now) :
+            filterType(filterType), propertiesIn(propertiesIn), propertiesOut(propertiesOut), wasChanged(wasChanged),
+            existingEntity(existingEntity), zone(zone), senderID(senderID), now(now) {}
+
+        EntityTree::FilterType filterType;
+        EntityItemProperties& propertiesIn;
+        EntityItemProperties& propertiesOut;
+        bool& wasChanged;
+        const EntityItemPointer& existingEntity;
+        const EntityItemPointer& zone; // the zone of the filter, null for the global filter
+        const QUuid& senderID; // the node that sent the edit, null for edits the server makes itself
+        quint64 now;
+    };
+
+    // whether the contents of a filter URL are a rule set rather than a script
+    static bool isRuleSet(const QByteArray& contents);
+
+    // returns null, with the reason in error, if contents isn't a valid rule set
+    static std::shared_ptr<EntityEditFilterRules> parse(const QByteArray& contents, QString& error);
+
+    bool wantsToFilter(EntityTree::FilterType filterType) const;
+    bool needsZone() const { return _needsZone; }
+
+    // returns false if the edit is rejected, may change the properties of the edit and set wasChanged
+    bool apply(Edit& edit) const;
+
+private:
+    using Rule = std::function<bool(Edit&)>;
+
+    struct TokenBucket {
+        float tokens;
+        quint64 lastRefill;
+    };
+
+    struct RateLimit {
+        float editsPerSecond;
+        float burst;
+        std::mutex mutex;
+        std::unordered_map<QUuid, TokenBucket> buckets;
+    };
+
+    bool _wantsToFilterAdd { true };
+    bool _wantsToFilterEdit { true };
+    bool _wantsToFilterPhysics { true };
+    bool _wantsToFilterDelete { false };
+    bool _needsZone { false };
+
+    std::vector<Rule> _rules;
+    std::vector<std::unique_ptr<RateLimit>> _rateLimits;
+};
+
+#endif // hifi_EntityEditFilterRules_h
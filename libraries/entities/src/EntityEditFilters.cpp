@@ -43,7 +43,8 @@ QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
 }
 
 bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut,
-        bool& wasChanged, EntityTree::FilterType filterType, EntityItemID& itemID, const EntityItemPointer& existingEntity) {
+        bool& wasChanged, EntityTree::FilterType filterType, EntityItemID& itemID, const EntityItemPointer& existingEntity,
+        const QUuid& senderID) {
     
     // get the ids of all the zones (plus the global entity edit filter) that the position
     // lies within
@@ -60,6 +61,7 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
     
         if (filterData.valid()) {
             if (filterData.rejectAll) {
+                filterData.counters->track(false, 0);
                 return false;
             }
 
@@ -73,97 +75,140 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 return true; // accept the message
             }
 
-            auto oldProperties = propertiesIn.getDesiredProperties();
-            auto specifiedProperties = propertiesIn.getChangedProperties();
-            propertiesIn.setDesiredProperties(specifiedProperties);
-            QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
-            propertiesIn.setDesiredProperties(oldProperties);
-
-            auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
-
-            QScriptValueList args;
-            args << inputValues;
-            args << filterType;
+            quint64 startFilter = usecTimestampNow();
+            bool accepted;
+            if (filterData.rules) {
+                EntityItemPointer zone = (filterData.rules->needsZone() && !id.isInvalidID()) ?
+                    _tree->findEntityByEntityItemID(id) : EntityItemPointer();
+                EntityEditFilterRules::Edit edit(filterType, propertiesIn, propertiesOut, wasChanged, existingEntity, zone,
+                                                 senderID, startFilter);
+                accepted = filterData.rules->apply(edit);
+            } else {
+                accepted = callFilterFunction(filterData, id, propertiesIn, propertiesOut, wasChanged, filterType, existingEntity);
+            }
+            filterData.counters->track(accepted, usecTimestampNow() - startFilter);
 
-            // get the current properties for then entity and include them for the filter call
-            if (existingEntity && filterData.wantsOriginalProperties) {
-                auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
-                QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
-                args << currentValues;
+            if (!accepted) {
+                return false;
             }
+        }
+    }
+    // if we made it here, 
+    return true;
+}
 
+bool EntityEditFilters::callFilterFunction(FilterData& filterData, const EntityItemID& id, EntityItemProperties& propertiesIn,
+        EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+        const EntityItemPointer& existingEntity) {
+    auto oldProperties = propertiesIn.getDesiredProperties();
+    auto specifiedProperties = propertiesIn.getChangedProperties();
+    propertiesIn.setDesiredProperties(specifiedProperties);
+    QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
+    propertiesIn.setDesiredProperties(oldProperties);
+
+    auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
+
+    QScriptValueList args;
+    args << inputValues;
+    args << filterType;
+
+    // get the current properties for then entity and include them for the filter call
+    if (existingEntity && filterData.wantsOriginalProperties) {
+        auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
+        QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
+        args << currentValues;
+    }
 
-            // get the zone properties
-            if (filterData.wantsZoneProperties) {
-                auto zoneEntity = _tree->findEntityByEntityItemID(id);
-                if (zoneEntity) {
-                    auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
-                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
-
-                    if (filterData.wantsZoneBoundingBox) {
-                        bool success = true;
-                        AABox aaBox = zoneEntity->getAABox(success);
-                        if (success) {
-                            QScriptValue boundingBox = filterData.engine->newObject();
-                            QScriptValue bottomRightNear = vec3ToScriptValue(filterData.engine, aaBox.getCorner());
-                            QScriptValue topFarLeft = vec3ToScriptValue(filterData.engine, aaBox.calcTopFarLeft());
-                            QScriptValue center = vec3ToScriptValue(filterData.engine, aaBox.calcCenter());
-                            QScriptValue boundingBoxDimensions = vec3ToScriptValue(filterData.engine, aaBox.getDimensions());
-                            boundingBox.setProperty("brn", bottomRightNear);
-                            boundingBox.setProperty("tfl", topFarLeft);
-                            boundingBox.setProperty("center", center);
-                            boundingBox.setProperty("dimensions", boundingBoxDimensions);
-                            zoneValues.setProperty("boundingBox", boundingBox);
-                        }
-                    }
 
-                    // If this is an add or delete, or original properties weren't requested
-                    // there won't be original properties in the args, but zone properties need
-                    // to be the fourth parameter, so we need to pad the args accordingly
-                    int EXPECTED_ARGS = 3;
-                    if (args.length() < EXPECTED_ARGS) {
-                        args << QScriptValue();
-                    }
-                    assert(args.length() == EXPECTED_ARGS); // we MUST have 3 args by now!
-                    args << zoneValues;
+    // get the zone properties
+    if (filterData.wantsZoneProperties) {
+        auto zoneEntity = _tree->findEntityByEntityItemID(id);
+        if (zoneEntity) {
+            auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
+            QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
+
+            if (filterData.wantsZoneBoundingBox) {
+                bool success = true;
+                AABox aaBox = zoneEntity->getAABox(success);
+                if (success) {
+                    QScriptValue boundingBox = filterData.engine->newObject();
+                    QScriptValue bottomRightNear = vec3ToScriptValue(filterData.engine, aaBox.getCorner());
+                    QScriptValue topFarLeft = vec3ToScriptValue(filterData.engine, aaBox.calcTopFarLeft());
+                    QScriptValue center = vec3ToScriptValue(filterData.engine, aaBox.calcCenter());
+                    QScriptValue boundingBoxDimensions = vec3ToScriptValue(filterData.engine, aaBox.getDimensions());
+                    boundingBox.setProperty("brn", bottomRightNear);
+                    boundingBox.setProperty("tfl", topFarLeft);
+                    boundingBox.setProperty("center", center);
+                    boundingBox.setProperty("dimensions", boundingBoxDimensions);
+                    zoneValues.setProperty("boundingBox", boundingBox);
                 }
             }
 
-            QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
-
-            if (filterData.uncaughtExceptions()) {
-                return false;
+            // If this is an add or delete, or original properties weren't requested
+            // there won't be original properties in the args, but zone properties need
+            // to be the fourth parameter, so we need to pad the args accordingly
+            int EXPECTED_ARGS = 3;
+            if (args.length() < EXPECTED_ARGS) {
+                args << QScriptValue();
             }
+            assert(args.length() == EXPECTED_ARGS); // we MUST have 3 args by now!
+            args << zoneValues;
+        }
+    }
 
-            if (result.isObject()) {
-                // make propertiesIn reflect the changes, for next filter...
-                propertiesIn.copyFromScriptValue(result, false);
+    QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
 
-                // and update propertiesOut too.  TODO: this could be more efficient...
-                propertiesOut.copyFromScriptValue(result, false);
-                // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
-                auto out = QJsonValue::fromVariant(result.toVariant());
-                wasChanged |= (in != out);
-            } else if (result.isBool()) {
+    if (filterData.uncaughtExceptions()) {
+        return false;
+    }
 
-                // if the filter returned false, then it's authoritative
-                if (!result.toBool()) {
-                    return false;
-                }
+    if (result.isObject()) {
+        // make propertiesIn reflect the changes, for next filter...
+        propertiesIn.copyFromScriptValue(result, false);
 
-                // otherwise, assume it wants to pass all properties
-                propertiesOut = propertiesIn;
-                wasChanged = false;
-                
-            } else {
-                return false;
-            }
+        // and update propertiesOut too.  TODO: this could be more efficient...
+        propertiesOut.copyFromScriptValue(result, false);
+        // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
+        auto out = QJsonValue::fromVariant(result.toVariant());
+        wasChanged |= (in != out);
+    } else if (result.isBool()) {
+
+        // if the filter returned false, then it's authoritative
+        if (!result.toBool()) {
+            return false;
         }
+
+        // otherwise, assume it wants to pass all properties
+        propertiesOut = propertiesIn;
+        wasChanged = false;
+
+    } else {
+        return false;
     }
-    // if we made it here, 
     return true;
 }
 
+QVector<EntityEditFilters::FilterStats> EntityEditFilters::getFilterStats() {
+    QVector<FilterStats> filterStats;
+    QReadLocker readLock(&_lock);
+    for (auto it = _filterDataMap.begin(); it != _filterDataMap.end(); ++it) {
+        FilterStats stats;
+        stats.zoneID = it.key();
+        stats.isNative = (bool)it.value().rules;
+        stats.evaluations = it.value().counters->evaluations;
+        stats.rejections = it.value().counters->rejections;
+        stats.averageTime = stats.evaluations == 0 ? 0.0f :
+            (float)it.value().counters->totalTime / (float)stats.evaluations;
+        filterStats.push_back(stats);
+    }
+    return filterStats;
+}
+
+bool EntityEditFilters::hasFilters() {
+    QReadLocker readLock(&_lock);
+    return !_filterDataMap.isEmpty();
+}
+
 void EntityEditFilters::removeFilter(EntityItemID entityID) {
     QWriteLocker writeLock(&_lock);
     FilterData filterData = _filterDataMap.value(entityID);
@@ -254,6 +299,10 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
     if (scriptRequest && scriptRequest->getResult() == ResourceRequest::Success) {
         const QString urlString = scriptRequest->getUrl().toString();
         auto scriptContents = scriptRequest->getData();
+        if (EntityEditFilterRules::isRuleSet(scriptContents)) {
+            addFilterRules(entityID, urlString, scriptContents);
+            return;
+        }
         qInfo() << "Downloaded script:" << scriptContents;
         QScriptProgram program(scriptContents, urlString);
         if (hasCorrectSyntax(program)) {
@@ -390,3 +439,29 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
     }
     emit filterAdded(entityID, false);
 }
+
+void EntityEditFilters::addFilterRules(EntityItemID entityID, const QString& urlString, const QByteArray& contents) {
+    qInfo() << "Downloaded filter rules:" << contents;
+    QString error;
+    auto rules = EntityEditFilterRules::parse(contents, error);
+    if (!rules) {
+        // keep rejecting everything, like we do for a script that doesn't load
+        qCritical() << "Invalid filter rules in" << urlString << ":" << error;
+        emit filterAdded(entityID, false);
+        return;
+    }
+
+    FilterData filterData;
+    filterData.rules = rules;
+    filterData.wantsToFilterAdd = rules->wantsToFilter(EntityTree::FilterType::Add);
+    filterData.wantsToFilterEdit = rules->wantsToFilter(EntityTree::FilterType::Edit);
+    filterData.wantsToFilterPhysics = rules->wantsToFilter(EntityTree::FilterType::Physics);
+    filterData.wantsToFilterDelete = rules->wantsToFilter(EntityTree::FilterType::Delete);
+
+    _lock.lockForWrite();
+    _filterDataMap.insert(entityID, filterData);
+    _lock.unlock();
+
+    qDebug() << "filter rules processed for entity id " << entityID;
+    emit filterAdded(entityID, true);
+}
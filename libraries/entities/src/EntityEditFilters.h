@@ -17,8 +17,11 @@
 #include <QScriptEngine>
 #include <glm/glm.hpp>
 
+#include <atomic>
 #include <functional>
+#include <memory>
 
+#include "EntityEditFilterRules.h"
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
 #include "EntityTree.h"
@@ -26,8 +29,30 @@
 class EntityEditFilters : public QObject, public Dependency {
     Q_OBJECT
 public:
+    // how often a filter ran, shared by the copies of its FilterData
+    struct FilterCounters {
+        std::atomic<uint64_t> evaluations { 0 };
+        std::atomic<uint64_t> rejections { 0 };
+        std::atomic<uint64_t> totalTime { 0 }; // usecs
+
+        void track(bool accepted, uint64_t time) {
+            evaluations++;
+            rejections += accepted ? 0 : 1;
+            totalTime += time;
+        }
+    };
+
+    struct FilterStats {
+        EntityItemID zoneID; // null for the global filter
+        bool isNative { false };
+        uint64_t evaluations { 0 };
+        uint64_t rejections { 0 };
+        float averageTime { 0.0f }; // usecs
+    };
+
     struct FilterData {
         QScriptValue filterFn;
+        std::shared_ptr<EntityEditFilterRules> rules; // set for a declarative filter, which has no script engine
         bool wantsOriginalProperties { false };
         bool wantsZoneProperties { false };
 
@@ -43,9 +68,10 @@ public:
         std::function<bool()> uncaughtExceptions;
         QScriptEngine* engine;
         bool rejectAll;
+        std::shared_ptr<FilterCounters> counters { std::make_shared<FilterCounters>() };
         
         FilterData(): engine(nullptr), rejectAll(false) {};
-        bool valid() { return (rejectAll || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+        bool valid() { return (rejectAll || rules || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
     };
 
     EntityEditFilters() {};
@@ -55,7 +81,16 @@ public:
     void removeFilter(EntityItemID entityID);
 
     bool filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, 
-                EntityTree::FilterType filterType, EntityItemID& entityID, const EntityItemPointer& existingEntity);
+                EntityTree::FilterType filterType, EntityItemID& entityID, const EntityItemPointer& existingEntity,
+                const QUuid& senderID);
+
+    QVector<FilterStats> getFilterStats();
+
+    // true if any filter, global or zone, is set
+    bool hasFilters();
+
+    // sets the filter of entityID to the rule set in contents, as if it had been downloaded from urlString
+    void addFilterRules(EntityItemID entityID, const QString& urlString, const QByteArray& contents);
 
 signals:
     void filterAdded(EntityItemID id, bool success);
@@ -65,6 +100,9 @@ private slots:
     
 private:
     QList<EntityItemID> getZonesByPosition(glm::vec3& position);
+    bool callFilterFunction(FilterData& filterData, const EntityItemID& id, EntityItemProperties& propertiesIn,
+                            EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+                            const EntityItemPointer& existingEntity);
 
     EntityTreePointer _tree {};
     bool _rejectAll {false};
@@ -0,0 +1,137 @@
+//
+//  EntityEncodeCache.cpp
+//  libraries/entities/src
+//
+//  Created on 2019-11-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCache.h"
+
+#include "EntityItem.h"
+#include "EntityTreeElement.h"
+
+EntityEncodeCache::Stamp EntityEncodeCache::getStamp(const EntityItem& entity) {
+    Stamp stamp;
+    stamp.lastEdited = entity.getLastEdited();
+    stamp.lastUpdated = entity.getLastUpdated();
+    stamp.lastSimulated = entity.getLastSimulated();
+    stamp.lastChangedOnServer = entity.getLastChangedOnServer();
+    return stamp;
+}
+
+QByteArray EntityEncodeCache::encode(const EntityItem& entity, bool withPrivateUserData, bool& isTooBig) {
+    // encode into an empty packet of the largest size a send thread could give us
+    static thread_local OctreePacketData packetData(false, MAX_ENCODE_SIZE);
+    packetData.reset();
+
+    // the default trackSend does nothing, the send thread tracks the send when it appends the encode
+    EncodeBitstreamParams params;
+    auto extraEncodeData = std::make_shared<EntityTreeElementExtraEncodeData>();
+
+    OctreeElement::AppendState appendState = entity.appendEntityData(&packetData, params, extraEncodeData,
+                                                                     withPrivateUserData);
+    isTooBig = appendState != OctreeElement::COMPLETED;
+    if (isTooBig) {
+        return QByteArray();
+    }
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+QByteArray EntityEncodeCache::get(const EntityItem& entity, bool withPrivateUserData) {
+    const QUuid entityID = entity.getID();
+    const Stamp stamp = getStamp(entity);
+    const int variant = withPrivateUserData ? 1 : 0;
+    Shard& shard = getShard(entityID);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(entityID);
+        if (it != shard.entries.end()) {
+            const Encode& cached = it->second.encodes[variant];
+            if (cached.isValid && cached.stamp == stamp) {
+                if (cached.isTooBig) {
+                    ++_tooBig;
+                } else {
+                    ++_hits;
+                }
+                return cached.bytes;
+            }
+        }
+    }
+
+    // encode outside of the lock, two threads racing on the same entity both encode the same bytes
+    ++_misses;
+    bool isTooBig = false;
+    QByteArray bytes = encode(entity, withPrivateUserData, isTooBig);
+    if (isTooBig) {
+        ++_tooBig;
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(entityID);
+    if (it == shard.entries.end()) {
+        if (_numBytes.load() + bytes.size() > _maxBytes.load()) {
+            return bytes;
+        }
+        it = shard.entries.emplace(entityID, Entry()).first;
+    }
+
+    Encode& cached = it->second.encodes[variant];
+    _numBytes -= cached.bytes.size();
+    cached.stamp = stamp;
+    cached.isValid = true;
+    cached.isTooBig = isTooBig;
+    cached.bytes = bytes;
+    _numBytes += cached.bytes.size();
+    return bytes;
+}
+
+void EntityEncodeCache::invalidate(const QUuid& entityID) {
+    Shard& shard = getShard(entityID);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(entityID);
+    if (it != shard.entries.end()) {
+        for (const Encode& cached : it->second.encodes) {
+            _numBytes -= cached.bytes.size();
+        }
+        shard.entries.erase(it);
+        ++_invalidations;
+    }
+}
+
+void EntityEncodeCache::clear() {
+    for (Shard& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.entries) {
+            for (const Encode& cached : entry.second.encodes) {
+                _numBytes -= cached.bytes.size();
+            }
+        }
+        shard.entries.clear();
+    }
+}
+
+EntityEncodeCache::Stats EntityEncodeCache::getStats() const {
+    Stats stats;
+    stats.hits = _hits.load();
+    stats.misses = _misses.load();
+    stats.tooBig = _tooBig.load();
+    stats.invalidations = _invalidations.load();
+    for (const Shard& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.numEntries += shard.entries.size();
+    }
+    stats.numBytes = _numBytes.load();
+    return stats;
+}
+
+void EntityEncodeCache::resetStats() {
+    _hits = 0;
+    _misses = 0;
+    _tooBig = 0;
+    _invalidations = 0;
+}
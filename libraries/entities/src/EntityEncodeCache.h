@@ -0,0 +1,108 @@
+//
+//  EntityEncodeCache.h
+//  libraries/entities/src
+//
+//  Created on 2019-11-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCache_h
+#define hifi_EntityEncodeCache_h
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QUuid>
+
+#include <OctreePacketData.h>
+#include <UUIDHasher.h>
+
+class EntityItem;
+class EncodeBitstreamParams;
+
+// Server wide cache of the full wire encode of each entity, the bytes appendEntityData writes for it into an empty
+// packet. Send threads share it, so an entity is encoded once per change instead of once per viewer.
+//
+// An encode is keyed by the entity's edit, update, simulation and server change times, and whether it includes the
+// private user data. The tree's editingEntityPointer/deletingEntityPointer signals drop the encodes of an entity.
+// Entities too big for a packet are remembered as such, and are left to the per-viewer encode that splits them up.
+class EntityEncodeCache {
+public:
+    struct Stats {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        uint64_t tooBig { 0 };
+        uint64_t invalidations { 0 };
+        size_t numEntries { 0 };
+        size_t numBytes { 0 };
+    };
+
+    static const size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+    static const int MAX_ENCODE_SIZE = MAX_OCTREE_PACKET_DATA_SIZE;
+
+    // Returns the encode of entity's current state, encoding it if the cache doesn't have it. Returns an empty array
+    // for entities that don't fit in a single packet. Thread-safe, the caller holds the tree's read lock.
+    QByteArray get(const EntityItem& entity, bool withPrivateUserData);
+
+    void invalidate(const QUuid& entityID);
+    void clear();
+
+    // once the cache holds that many bytes, new encodes are still returned but no longer kept
+    void setMaxBytes(size_t maxBytes) { _maxBytes = maxBytes; }
+
+    // hit, miss and invalidation counts are since the last reset
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Stamp {
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        quint64 lastChangedOnServer { 0 };
+
+        bool operator==(const Stamp& other) const {
+            return lastEdited == other.lastEdited && lastUpdated == other.lastUpdated &&
+                lastSimulated == other.lastSimulated && lastChangedOnServer == other.lastChangedOnServer;
+        }
+    };
+
+    struct Encode {
+        Stamp stamp;
+        bool isValid { false };
+        bool isTooBig { false };
+        QByteArray bytes;
+    };
+
+    // one encode without the private user data, one with it
+    struct Entry {
+        Encode encodes[2];
+    };
+
+    static const int NUM_SHARDS = 16;
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<QUuid, Entry> entries;
+    };
+
+    Shard& getShard(const QUuid& entityID) { return _shards[qHash(entityID) % NUM_SHARDS]; }
+    static Stamp getStamp(const EntityItem& entity);
+    static QByteArray encode(const EntityItem& entity, bool withPrivateUserData, bool& isTooBig);
+
+    std::array<Shard, NUM_SHARDS> _shards;
+    std::atomic<size_t> _numBytes { 0 };
+    std::atomic<size_t> _maxBytes { DEFAULT_MAX_BYTES };
+
+    std::atomic<uint64_t> _hits { 0 };
+    std::atomic<uint64_t> _misses { 0 };
+    std::atomic<uint64_t> _tooBig { 0 };
+    std::atomic<uint64_t> _invalidations { 0 };
+};
+
+#endif // hifi_EntityEncodeCache_h
@@ -11,6 +11,8 @@
 
 #include "EntityItem.h"
 
+#include <algorithm>
+
 #include <QtCore/QObject>
 #include <QtEndian>
 #include <QJsonDocument>
@@ -398,6 +400,43 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     return appendState;
 }
 
+bool EntityItem::appendKinematicDelta(OctreePacketData* packetData, EncodeBitstreamParams& params,
+                                      const QByteArray& delta) const {
+    // the same header as appendEntityData, followed by the delta as the only property
+    QByteArray encodedID = getID().toRfc4122();
+    ByteCountCoded<quint32> typeCoder = getType();
+    QByteArray encodedType = typeCoder;
+
+    quint64 lastEdited = getLastEdited();
+    quint64 updateDelta = getLastUpdated() <= lastEdited ? 0 : getLastUpdated() - lastEdited;
+    ByteCountCoded<quint64> updateDeltaCoder = updateDelta;
+    QByteArray encodedUpdateDelta = updateDeltaCoder;
+    quint64 simulatedDelta = getLastSimulated() <= lastEdited ? 0 : getLastSimulated() - lastEdited;
+    ByteCountCoded<quint64> simulatedDeltaCoder = simulatedDelta;
+    QByteArray encodedSimulatedDelta = simulatedDeltaCoder;
+
+    EntityPropertyFlags propertyFlags;
+    propertyFlags += PROP_KINEMATIC_DELTA;
+    QByteArray encodedPropertyFlags = propertyFlags;
+
+    LevelDetails entityLevel = packetData->startLevel();
+    bool success = packetData->appendRawData(encodedID) &&
+        packetData->appendRawData(encodedType) &&
+        packetData->appendValue(_created) &&
+        packetData->appendValue(lastEdited) &&
+        packetData->appendRawData(encodedUpdateDelta) &&
+        packetData->appendRawData(encodedSimulatedDelta) &&
+        packetData->appendRawData(encodedPropertyFlags) &&
+        packetData->appendValue(delta);
+    if (!success) {
+        packetData->discardLevel(entityLevel);
+        return false;
+    }
+    packetData->endLevel(entityLevel);
+    params.trackSend(getID(), lastEdited);
+    return true;
+}
+
 // TODO: My goal is to get rid of this concept completely. The old code (and some of the current code) used this
 // result to calculate if a packet being sent to it was potentially bad or corrupt. I've adjusted this to now
 // only consider the minimum header bytes as being required. But it would be preferable to completely eliminate
@@ -795,6 +834,32 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         }
     }
 
+    // a record can carry a kinematic delta in place of the transform and velocities, relative to the kinematic state of
+    // an earlier update from the server, see EntityKinematicDelta
+    EntityKinematicState kinematicState;
+    int numKinematicPropertiesRead = 0;
+    bool hasKinematicDelta = false;
+    if (propertyFlags.getHasProperty(PROP_KINEMATIC_DELTA)) {
+        QByteArray delta;
+        int bytes = OctreePacketData::unpackDataFromBytes(dataAt, delta);
+        dataAt += bytes;
+        bytesRead += bytes;
+
+        OCTREE_PACKET_SEQUENCE baselineSequence;
+        if (EntityKinematicDelta::readBaselineSequence(delta, baselineSequence)) {
+            for (const auto& baseline : _kinematicBaselines) {
+                if (baseline.first == baselineSequence) {
+                    hasKinematicDelta = EntityKinematicDelta::decode(delta, baseline.second, kinematicState);
+                    break;
+                }
+            }
+        }
+        if (!hasKinematicDelta) {
+            // the server sends the entity in full again every few seconds
+            args.droppedKinematicDeltas++;
+        }
+    }
+
     auto lastEdited = lastEditedFromBufferAdjusted;
     bool otherOverwrites = overwriteLocalData && !weOwnSimulation;
     // calculate hasGrab once outside the lambda rather than calling it every time inside
@@ -842,7 +907,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 _lastUpdatedPositionValue = value;
             }
         };
-        READ_ENTITY_PROPERTY(PROP_POSITION, glm::vec3, customUpdatePositionFromNetwork);
+        READ_KINEMATIC_ENTITY_PROPERTY(PROP_POSITION, glm::vec3, customUpdatePositionFromNetwork, position);
     }
     READ_ENTITY_PROPERTY(PROP_DIMENSIONS, glm::vec3, setScaledDimensions);
     {   // See comment above
@@ -853,7 +918,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 _lastUpdatedRotationValue = value;
             }
         };
-        READ_ENTITY_PROPERTY(PROP_ROTATION, glm::quat, customUpdateRotationFromNetwork);
+        READ_KINEMATIC_ENTITY_PROPERTY(PROP_ROTATION, glm::quat, customUpdateRotationFromNetwork, rotation);
     }
     READ_ENTITY_PROPERTY(PROP_REGISTRATION_POINT, glm::vec3, setRegistrationPoint);
     READ_ENTITY_PROPERTY(PROP_CREATED, quint64, setCreated);
@@ -868,7 +933,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 _lastUpdatedQueryAACubeValue = value;
             }
         };
-        READ_ENTITY_PROPERTY(PROP_QUERY_AA_CUBE, AACube, customUpdateQueryAACubeFromNetwork);
+        READ_KINEMATIC_ENTITY_PROPERTY(PROP_QUERY_AA_CUBE, AACube, customUpdateQueryAACubeFromNetwork, queryAACube);
     }
     READ_ENTITY_PROPERTY(PROP_CAN_CAST_SHADOW, bool, setCanCastShadow);
     // READ_ENTITY_PROPERTY(PROP_VISIBLE_IN_SECONDARY_CAMERA, bool, setIsVisibleInSecondaryCamera);  // not sent over the wire
@@ -892,7 +957,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 _lastUpdatedVelocityValue = value;
             }
         };
-        READ_ENTITY_PROPERTY(PROP_VELOCITY, glm::vec3, customUpdateVelocityFromNetwork);
+        READ_KINEMATIC_ENTITY_PROPERTY(PROP_VELOCITY, glm::vec3, customUpdateVelocityFromNetwork, velocity);
         auto customUpdateAngularVelocityFromNetwork = [this, shouldUpdate, lastEdited](glm::vec3 value){
             if (shouldUpdate(_lastUpdatedAngularVelocityTimestamp, value != _lastUpdatedAngularVelocityValue)) {
                 setAngularVelocity(value);
@@ -900,7 +965,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 _lastUpdatedAngularVelocityValue = value;
             }
         };
-        READ_ENTITY_PROPERTY(PROP_ANGULAR_VELOCITY, glm::vec3, customUpdateAngularVelocityFromNetwork);
+        READ_KINEMATIC_ENTITY_PROPERTY(PROP_ANGULAR_VELOCITY, glm::vec3, customUpdateAngularVelocityFromNetwork, angularVelocity);
         READ_ENTITY_PROPERTY(PROP_GRAVITY, glm::vec3, setGravity);
         auto customSetAcceleration = [this, shouldUpdate, lastEdited](glm::vec3 value){
             if (shouldUpdate(_lastUpdatedAccelerationTimestamp, value != _lastUpdatedAccelerationValue)) {
@@ -909,7 +974,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 _lastUpdatedAccelerationValue = value;
             }
         };
-        READ_ENTITY_PROPERTY(PROP_ACCELERATION, glm::vec3, customSetAcceleration);
+        READ_KINEMATIC_ENTITY_PROPERTY(PROP_ACCELERATION, glm::vec3, customSetAcceleration, acceleration);
     }
     READ_ENTITY_PROPERTY(PROP_DAMPING, float, setDamping);
     READ_ENTITY_PROPERTY(PROP_ANGULAR_DAMPING, float, setAngularDamping);
@@ -993,6 +1058,20 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         }
     }
 
+    // a full update is the baseline of the kinematic deltas the server may send next
+    if (!hasKinematicDelta && numKinematicPropertiesRead == EntityKinematicDelta::NUM_PROPERTIES) {
+        auto sameSequence = std::find_if(_kinematicBaselines.begin(), _kinematicBaselines.end(),
+            [&](const std::pair<OCTREE_PACKET_SEQUENCE, EntityKinematicState>& baseline) {
+                return baseline.first == args.sequence;
+            });
+        if (sameSequence != _kinematicBaselines.end()) {
+            _kinematicBaselines.erase(sameSequence);
+        } else if (_kinematicBaselines.size() >= EntityKinematicDelta::MAX_BASELINES) {
+            _kinematicBaselines.erase(_kinematicBaselines.begin());
+        }
+        _kinematicBaselines.emplace_back(args.sequence, kinematicState);
+    }
+
     // Tracking for editing roundtrips here. We will tell our EntityTree that we just got incoming data about
     // and entity that was edited at some time in the past. The tree will determine how it wants to track this
     // information.
@@ -1575,6 +1654,15 @@ bool EntityItem::setProperties(const EntityItemProperties& properties) {
             // when position and/or velocity was changed).
             _lastSimulated = now;
         }
+
+        // the simulation owner and last editor are compared with what the agent has when sending it a kinematic delta
+        EntityPropertyFlags nonKinematicChanges = properties.getChangedProperties();
+        nonKinematicChanges -= EntityKinematicDelta::getProperties();
+        nonKinematicChanges -= PROP_SIMULATION_OWNER;
+        nonKinematicChanges -= PROP_LAST_EDITED_BY;
+        if ((int)nonKinematicChanges.lastFlag() >= 0) {
+            _lastNonKinematicChange = std::max(now, _lastNonKinematicChange + 1);
+        }
     }
 
     // timestamps
@@ -2719,6 +2807,15 @@ void EntityItem::markAsChangedOnServer() {
     withWriteLock([&] {
         _changedOnServer = usecTimestampNow();
     });
+
+    // the simulation changes entities on the server outside of the tree's edit paths, journal those too
+    EntityTreeElementPointer element = getElement();
+    if (element) {
+        EntityTreePointer tree = element->getTree();
+        if (tree) {
+            tree->trackJournalChange(getID());
+        }
+    }
 }
 
 quint64 EntityItem::getLastChangedOnServer() const {
@@ -2729,6 +2826,25 @@ quint64 EntityItem::getLastChangedOnServer() const {
     return result;
 }
 
+EntityKinematicState EntityItem::getKinematicState() const {
+    EntityKinematicState state;
+    state.position = getLocalPosition();
+    state.rotation = getLocalOrientation();
+    state.velocity = getLocalVelocity();
+    state.angularVelocity = getLocalAngularVelocity();
+    state.acceleration = getAcceleration();
+    state.queryAACube = getQueryAACube();
+    return state;
+}
+
+quint64 EntityItem::getLastNonKinematicChange() const {
+    quint64 result;
+    withReadLock([&] {
+        result = _lastNonKinematicChange;
+    });
+    return result;
+}
+
 void EntityItem::update(const quint64& now) {
     withWriteLock([&] {
         _lastUpdated = now;
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <stdint.h>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -32,6 +33,7 @@
 
 #include "EntityItemID.h"
 #include "EntityItemPropertiesDefaults.h"
+#include "EntityKinematicDelta.h"
 #include "EntityPropertyFlags.h"
 #include "EntityTypes.h"
 #include "SimulationOwner.h"
@@ -133,6 +135,10 @@ public:
     void markAsChangedOnServer();
     quint64 getLastChangedOnServer() const;
 
+    EntityKinematicState getKinematicState() const;
+    /// Last time anything but the kinematic state, simulation owner and last editor of this entity changed, in local usecs
+    quint64 getLastNonKinematicChange() const;
+
     virtual EntityPropertyFlags getEntityProperties(EncodeBitstreamParams& params) const;
 
     virtual OctreeElement::AppendState appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
@@ -147,6 +153,9 @@ public:
                                     int& propertyCount,
                                     OctreeElement::AppendState& appendState) const { /* do nothing*/ };
 
+    /// appends a record of this entity that only carries a kinematic delta, returns false if it doesn't fit
+    bool appendKinematicDelta(OctreePacketData* packetData, EncodeBitstreamParams& params, const QByteArray& delta) const;
+
     static EntityItemID readEntityItemIDFromBuffer(const unsigned char* data, int bytesLeftToRead,
                                     ReadBitstreamToTreeParams& args);
 
@@ -608,6 +617,11 @@ protected:
     quint64 _lastEditedFromRemoteInRemoteTime { 0 }; // last time we received an edit from the server (in server-time-frame)
     quint64 _created { 0 };
     quint64 _changedOnServer { 0 };
+    quint64 _lastNonKinematicChange { 0 };
+
+    // the kinematic states of the latest full updates from the server and the sequence numbers of their packets, that
+    // kinematic deltas are relative to, oldest first
+    std::vector<std::pair<OCTREE_PACKET_SEQUENCE, EntityKinematicState>> _kinematicBaselines;
 
     mutable AABox _cachedAABox;
     mutable AACube _maxAACube;
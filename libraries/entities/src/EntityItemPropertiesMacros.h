@@ -45,6 +45,28 @@
             somethingChanged = true;                                               \
         }
 
+// reads one of the properties of an EntityKinematicState into kinematicState.N, where it is kept as the baseline of later
+// kinematic deltas whether or not it overwrites the local data; a record that carries a delta instead has the value
+// decoded into kinematicState.N already
+#define READ_KINEMATIC_ENTITY_PROPERTY(P,T,S,N)                                    \
+        if (propertyFlags.getHasProperty(P)) {                                     \
+            T fromBuffer;                                                          \
+            int bytes = OctreePacketData::unpackDataFromBytes(dataAt, fromBuffer); \
+            dataAt += bytes;                                                       \
+            bytesRead += bytes;                                                    \
+            kinematicState.N = fromBuffer;                                         \
+            numKinematicPropertiesRead++;                                          \
+            if (overwriteLocalData) {                                              \
+                S(fromBuffer);                                                     \
+            }                                                                      \
+            somethingChanged = true;                                               \
+        } else if (hasKinematicDelta) {                                            \
+            if (overwriteLocalData) {                                              \
+                S(kinematicState.N);                                               \
+            }                                                                      \
+            somethingChanged = true;                                               \
+        }
+
 #define SKIP_ENTITY_PROPERTY(P,T)                                                  \
         if (propertyFlags.getHasProperty(P)) {                                     \
             T fromBuffer;                                                          \
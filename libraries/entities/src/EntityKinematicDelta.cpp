@@ -0,0 +1,167 @@
+//
+//  EntityKinematicDelta.cpp
+//  libraries/entities/src
+//
+//  Created on 2019-11-28.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityKinematicDelta.h"
+
+#include <cstring>
+#include <limits>
+
+#include <GLMHelpers.h>
+
+static const int FIXED_VEC3_SIZE = 3 * sizeof(int16_t);
+static const int ROTATION_SIZE = 6;
+static const int MAX_DELTA_SIZE = sizeof(OCTREE_PACKET_SEQUENCE) + sizeof(uint8_t) + 4 * FIXED_VEC3_SIZE + ROTATION_SIZE +
+    sizeof(glm::vec3) + sizeof(float);
+
+const EntityPropertyFlags& EntityKinematicDelta::getProperties() {
+    static const EntityPropertyFlags PROPERTIES = EntityPropertyFlags() + PROP_POSITION + PROP_ROTATION + PROP_VELOCITY +
+        PROP_ANGULAR_VELOCITY + PROP_ACCELERATION + PROP_QUERY_AA_CUBE;
+    return PROPERTIES;
+}
+
+static bool fitsFixed(const glm::vec3& offset, int radix) {
+    float limit = (float)std::numeric_limits<int16_t>::max() / (float)(1 << radix);
+    return glm::all(glm::lessThanEqual(glm::abs(offset), glm::vec3(limit)));
+}
+
+// packs offset at destination, and returns its size, or 0 if it packs to zero
+static int packOffset(unsigned char* destination, const glm::vec3& offset, int radix) {
+    int size = packFloatVec3ToSignedTwoByteFixed(destination, offset, radix);
+    for (int i = 0; i < size; i++) {
+        if (destination[i] != 0) {
+            return size;
+        }
+    }
+    return 0;
+}
+
+bool EntityKinematicDelta::encode(OCTREE_PACKET_SEQUENCE baselineSequence, const EntityKinematicState& baseline,
+        const EntityKinematicState& state, QByteArray& delta) {
+    if (state.velocity == glm::vec3(0.0f) && state.angularVelocity == glm::vec3(0.0f)) {
+        return false;
+    }
+    glm::vec3 positionOffset = state.position - baseline.position;
+    glm::vec3 velocityOffset = state.velocity - baseline.velocity;
+    glm::vec3 angularVelocityOffset = state.angularVelocity - baseline.angularVelocity;
+    glm::vec3 cornerOffset = state.queryAACube.getCorner() - baseline.queryAACube.getCorner();
+    if (!fitsFixed(positionOffset, POSITION_RADIX) || !fitsFixed(velocityOffset, VELOCITY_RADIX) ||
+            !fitsFixed(angularVelocityOffset, VELOCITY_RADIX) || !fitsFixed(cornerOffset, POSITION_RADIX)) {
+        return false;
+    }
+
+    unsigned char buffer[MAX_DELTA_SIZE];
+    memcpy(buffer, &baselineSequence, sizeof(baselineSequence));
+    unsigned char* mask = buffer + sizeof(baselineSequence);
+    *mask = 0;
+    unsigned char* destination = mask + sizeof(uint8_t);
+
+    int size = packOffset(destination, positionOffset, POSITION_RADIX);
+    if (size > 0) {
+        *mask |= POSITION;
+        destination += size;
+    }
+    if (state.rotation != baseline.rotation) {
+        *mask |= ROTATION;
+        destination += packOrientationQuatToSixBytes(destination, state.rotation);
+    }
+    size = packOffset(destination, velocityOffset, VELOCITY_RADIX);
+    if (size > 0) {
+        *mask |= VELOCITY;
+        destination += size;
+    }
+    size = packOffset(destination, angularVelocityOffset, VELOCITY_RADIX);
+    if (size > 0) {
+        *mask |= ANGULAR_VELOCITY;
+        destination += size;
+    }
+    if (state.acceleration != baseline.acceleration) {
+        *mask |= ACCELERATION;
+        memcpy(destination, &state.acceleration, sizeof(glm::vec3));
+        destination += sizeof(glm::vec3);
+    }
+    size = packOffset(destination, cornerOffset, POSITION_RADIX);
+    if (size > 0) {
+        *mask |= QUERY_AA_CUBE_CORNER;
+        destination += size;
+    }
+    if (state.queryAACube.getScale() != baseline.queryAACube.getScale()) {
+        *mask |= QUERY_AA_CUBE_SCALE;
+        float scale = state.queryAACube.getScale();
+        memcpy(destination, &scale, sizeof(float));
+        destination += sizeof(float);
+    }
+
+    delta = QByteArray((const char*)buffer, (int)(destination - buffer));
+    return true;
+}
+
+bool EntityKinematicDelta::readBaselineSequence(const QByteArray& delta, OCTREE_PACKET_SEQUENCE& baselineSequence) {
+    if (delta.size() < (int)(sizeof(baselineSequence) + sizeof(uint8_t))) {
+        return false;
+    }
+    memcpy(&baselineSequence, delta.constData(), sizeof(baselineSequence));
+    return true;
+}
+
+bool EntityKinematicDelta::decode(const QByteArray& delta, const EntityKinematicState& baseline, EntityKinematicState& state) {
+    if (delta.size() < (int)(sizeof(OCTREE_PACKET_SEQUENCE) + sizeof(uint8_t))) {
+        return false;
+    }
+    const unsigned char* source = (const unsigned char*)delta.constData() + sizeof(OCTREE_PACKET_SEQUENCE);
+    const unsigned char* end = (const unsigned char*)delta.constData() + delta.size();
+    uint8_t mask = *source++;
+
+    int expectedSize = 0;
+    expectedSize += (mask & POSITION) ? FIXED_VEC3_SIZE : 0;
+    expectedSize += (mask & ROTATION) ? ROTATION_SIZE : 0;
+    expectedSize += (mask & VELOCITY) ? FIXED_VEC3_SIZE : 0;
+    expectedSize += (mask & ANGULAR_VELOCITY) ? FIXED_VEC3_SIZE : 0;
+    expectedSize += (mask & ACCELERATION) ? (int)sizeof(glm::vec3) : 0;
+    expectedSize += (mask & QUERY_AA_CUBE_CORNER) ? FIXED_VEC3_SIZE : 0;
+    expectedSize += (mask & QUERY_AA_CUBE_SCALE) ? (int)sizeof(float) : 0;
+    if (end - source != expectedSize) {
+        return false;
+    }
+
+    state = baseline;
+    glm::vec3 offset;
+    if (mask & POSITION) {
+        source += unpackFloatVec3FromSignedTwoByteFixed(source, offset, POSITION_RADIX);
+        state.position = baseline.position + offset;
+    }
+    if (mask & ROTATION) {
+        source += unpackOrientationQuatFromSixBytes(source, state.rotation);
+    }
+    if (mask & VELOCITY) {
+        source += unpackFloatVec3FromSignedTwoByteFixed(source, offset, VELOCITY_RADIX);
+        state.velocity = baseline.velocity + offset;
+    }
+    if (mask & ANGULAR_VELOCITY) {
+        source += unpackFloatVec3FromSignedTwoByteFixed(source, offset, VELOCITY_RADIX);
+        state.angularVelocity = baseline.angularVelocity + offset;
+    }
+    if (mask & ACCELERATION) {
+        memcpy(&state.acceleration, source, sizeof(glm::vec3));
+        source += sizeof(glm::vec3);
+    }
+    glm::vec3 corner = baseline.queryAACube.getCorner();
+    float scale = baseline.queryAACube.getScale();
+    if (mask & QUERY_AA_CUBE_CORNER) {
+        source += unpackFloatVec3FromSignedTwoByteFixed(source, offset, POSITION_RADIX);
+        corner += offset;
+    }
+    if (mask & QUERY_AA_CUBE_SCALE) {
+        memcpy(&scale, source, sizeof(float));
+        source += sizeof(float);
+    }
+    state.queryAACube = AACube(corner, scale);
+    return true;
+}
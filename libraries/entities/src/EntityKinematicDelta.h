@@ -0,0 +1,79 @@
+//
+//  EntityKinematicDelta.h
+//  libraries/entities/src
+//
+//  Created on 2019-11-28.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityKinematicDelta_h
+#define hifi_EntityKinematicDelta_h
+
+#include <QtCore/QByteArray>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <AACube.h>
+#include <OctreePacketData.h>
+
+#include "EntityPropertyFlags.h"
+
+// the properties of an entity that physics changes many times a second, as they go over the wire
+struct EntityKinematicState {
+    glm::vec3 position; // local
+    glm::quat rotation; // local
+    glm::vec3 velocity; // local
+    glm::vec3 angularVelocity; // local
+    glm::vec3 acceleration;
+    AACube queryAACube;
+};
+
+// The kinematic state of an entity, encoded relative to a baseline: the state sent in full in an earlier entity data
+// packet that the agent acked, named by the sequence number of that packet. Like the joint deltas of AvatarData, the
+// position, velocities and query cube corner go as 16 bit fixed point offsets from the baseline and the rotation as a
+// six byte quaternion; the components that are the same as in the baseline are left out.
+//
+//  baseline sequence [2 bytes]
+//  mask [1 byte]
+//  position offset [6 bytes] ... in the order of the mask bits
+class EntityKinematicDelta {
+public:
+    enum Component : uint8_t {
+        POSITION = 1,
+        ROTATION = 2,
+        VELOCITY = 4,
+        ANGULAR_VELOCITY = 8,
+        ACCELERATION = 16,
+        QUERY_AA_CUBE_CORNER = 32,
+        QUERY_AA_CUBE_SCALE = 64
+    };
+
+    // the properties of an EntityKinematicState
+    static const int NUM_PROPERTIES = 6;
+    static const EntityPropertyFlags& getProperties();
+
+    // the full updates of an entity an agent keeps as baselines, the server only sends deltas against one of the last
+    // MAX_BASELINES full updates it sent
+    static const size_t MAX_BASELINES = 4;
+
+    // 1/1024 of a meter, up to 32 meters away from the baseline
+    static const int POSITION_RADIX = 10;
+    // 1/512 of a meter (or radian) per second, up to 64 away from the baseline
+    static const int VELOCITY_RADIX = 9;
+
+    // returns false when state is too far from baseline to be encoded, or has come to rest: a settled entity goes out in
+    // full so that the agent sees it stop exactly where it is
+    static bool encode(OCTREE_PACKET_SEQUENCE baselineSequence, const EntityKinematicState& baseline,
+        const EntityKinematicState& state, QByteArray& delta);
+
+    static bool readBaselineSequence(const QByteArray& delta, OCTREE_PACKET_SEQUENCE& baselineSequence);
+
+    // returns false if delta is malformed
+    static bool decode(const QByteArray& delta, const EntityKinematicState& baseline, EntityKinematicState& state);
+};
+
+#endif // hifi_EntityKinematicDelta_h
@@ -11,6 +11,8 @@
 
 #include "EntityNodeData.h"
 
+#include <ReceivedMessage.h>
+
 bool EntityNodeData::insertFlaggedExtraEntity(const QUuid& filteredEntityID, const QUuid& extraEntityID) {
     _flaggedExtraEntities[filteredEntityID].insert(extraEntityID);
     return !_previousFlaggedExtraEntities[filteredEntityID].contains(extraEntityID);
@@ -28,3 +30,31 @@ bool EntityNodeData::isEntityFlaggedAsExtra(const QUuid& entityID) const {
 
     return false;
 }
+
+void EntityNodeData::parseEntityDataAckPacket(ReceivedMessage& message) {
+    if (message.getBytesLeftToRead() < (qint64)sizeof(OCTREE_PACKET_SEQUENCE)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_entityDataAckMutex);
+    // a newer ack supersedes the one we haven't taken yet, its missing set is the current one
+    message.readPrimitive(&_lastReceivedSequence);
+    _missingSequences.clear();
+    while (message.getBytesLeftToRead() >= (qint64)sizeof(OCTREE_PACKET_SEQUENCE)) {
+        OCTREE_PACKET_SEQUENCE sequenceNumber;
+        message.readPrimitive(&sequenceNumber);
+        _missingSequences.push_back(sequenceNumber);
+    }
+    _hasEntityDataAck = true;
+}
+
+bool EntityNodeData::takeEntityDataAck(OCTREE_PACKET_SEQUENCE& lastReceived, std::vector<OCTREE_PACKET_SEQUENCE>& missing) {
+    std::lock_guard<std::mutex> lock(_entityDataAckMutex);
+    if (!_hasEntityDataAck) {
+        return false;
+    }
+    lastReceived = _lastReceivedSequence;
+    missing.swap(_missingSequences);
+    _missingSequences.clear();
+    _hasEntityDataAck = false;
+    return true;
+}
@@ -12,6 +12,9 @@
 #ifndef hifi_EntityNodeData_h
 #define hifi_EntityNodeData_h
 
+#include <mutex>
+#include <vector>
+
 #include <udt/PacketHeaders.h>
 
 #include <OctreeQueryNode.h>
@@ -44,11 +47,21 @@ public:
     bool isEntityFlaggedAsExtra(const QUuid& entityID) const;
     void resetFlaggedExtraEntities() { _previousFlaggedExtraEntities = _flaggedExtraEntities; _flaggedExtraEntities.clear(); }
 
+    // the agent acks the entity data packets it got, up to the last one it received but for the missing ones
+    void parseEntityDataAckPacket(ReceivedMessage& message);
+    // returns false if no ack came since the last call
+    bool takeEntityDataAck(OCTREE_PACKET_SEQUENCE& lastReceived, std::vector<OCTREE_PACKET_SEQUENCE>& missing);
+
 private:
     quint64 _lastDeletedEntitiesSentAt { usecTimestampNow() };
     QSet<QUuid> _sentFilteredEntities;
     QHash<QUuid, QSet<QUuid>> _flaggedExtraEntities;
     QHash<QUuid, QSet<QUuid>> _previousFlaggedExtraEntities;
+
+    std::mutex _entityDataAckMutex;
+    bool _hasEntityDataAck { false };
+    OCTREE_PACKET_SEQUENCE _lastReceivedSequence { 0 };
+    std::vector<OCTREE_PACKET_SEQUENCE> _missingSequences;
 };
 
 #endif // hifi_EntityNodeData_h
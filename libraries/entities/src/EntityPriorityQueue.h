@@ -12,8 +12,9 @@
 #ifndef hifi_EntityPriorityQueue_h
 #define hifi_EntityPriorityQueue_h
 
-#include <queue>
-#include <unordered_set>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 #include "EntityItem.h"
 
@@ -30,29 +31,32 @@ public:
     float getPriority() const { return _priority; }
     bool shouldForceRemove() const { return _forceRemove; }
 
-    class Compare {
-    public:
-        bool operator() (const PrioritizedEntity& A, const PrioritizedEntity& B) { return A._priority < B._priority; }
-    };
-    friend class Compare;
-
 private:
+    friend class EntityPriorityQueue;
+
     EntityItemWeakPointer _weakEntity;
     EntityItem* _rawEntityPointer;
     float _priority;
     bool _forceRemove;
 };
 
+// EntityPriorityQueue is an indexed 4-ary max heap of PrioritizedEntity.
+//
+// The heap itself only moves {priority, slot} pairs around, the entities stay put in their slot, which knows where its
+// pair is in the heap. That lets the priority of a queued entity be changed in place, and the whole queue be re-scored
+// for a new view in one pass followed by a linear time heapify, instead of being rebuilt one emplace at a time.
 class EntityPriorityQueue {
 public:
     inline bool empty() const {
-        assert(_queue.empty() == _entities.empty());
-        return _queue.empty();
+        assert(_heap.size() == _entities.size());
+        return _heap.empty();
     }
 
+    inline size_t size() const { return _heap.size(); }
+
     inline const PrioritizedEntity& top() const {
-        assert(!_queue.empty());
-        return _queue.top();
+        assert(!_heap.empty());
+        return _slots[_heap.front().slot].entity;
     }
 
     inline bool contains(const EntityItem* entity) const {
@@ -61,32 +65,165 @@ public:
 
     inline void emplace(const EntityItemPointer& entity, float priority, bool forceRemove = false) {
         assert(entity && !contains(entity.get()));
-        _queue.emplace(entity, priority, forceRemove);
-        _entities.insert(entity.get());
-        assert(_queue.size() == _entities.size());
+        uint32_t slot;
+        if (_freeSlots.empty()) {
+            slot = (uint32_t)_slots.size();
+            _slots.push_back({ PrioritizedEntity(entity, priority, forceRemove), 0 });
+        } else {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            _slots[slot].entity = PrioritizedEntity(entity, priority, forceRemove);
+        }
+        _entities.emplace(entity.get(), slot);
+
+        _heap.push_back({ priority, slot });
+        siftUp(_heap.size() - 1);
+        assert(_heap.size() == _entities.size());
     }
 
     inline void pop() {
         assert(!empty());
-        _entities.erase(_queue.top().getRawEntityPointer());
-        _queue.pop();
-        assert(_queue.size() == _entities.size());
+        releaseSlot(_heap.front().slot);
+        Node last = _heap.back();
+        _heap.pop_back();
+        if (!_heap.empty()) {
+            _heap.front() = last;
+            siftDown(0);
+        }
+        assert(_heap.size() == _entities.size());
+    }
+
+    // changes the priority of a queued entity, returns false if it isn't queued
+    inline bool updatePriority(const EntityItem* entity, float priority) {
+        auto it = _entities.find(entity);
+        if (it == std::end(_entities)) {
+            return false;
+        }
+        auto& slot = _slots[it->second];
+        float oldPriority = slot.entity._priority;
+        slot.entity._priority = priority;
+        _heap[slot.heapIndex].priority = priority;
+        if (priority > oldPriority) {
+            siftUp(slot.heapIndex);
+        } else {
+            siftDown(slot.heapIndex);
+        }
+        return true;
+    }
+
+    // re-scores every queued entity with computePriority(const PrioritizedEntity&) and restores the heap order,
+    // entities scored DO_NOT_SEND are dropped from the queue
+    template <typename F>
+    void reprioritize(F computePriority) {
+        size_t numKept = 0;
+        for (size_t i = 0; i < _heap.size(); ++i) {
+            Node node = _heap[i];
+            auto& slot = _slots[node.slot];
+            const PrioritizedEntity& queued = slot.entity;
+            float priority = computePriority(queued);
+            if (priority == PrioritizedEntity::DO_NOT_SEND) {
+                releaseSlot(node.slot);
+                continue;
+            }
+            slot.entity._priority = priority;
+            slot.heapIndex = (uint32_t)numKept;
+            node.priority = priority;
+            _heap[numKept++] = node;
+        }
+        _heap.resize(numKept);
+
+        // heapify, from the parent of the last node back up to the root
+        if (numKept > 1) {
+            for (size_t i = (numKept - 2) / ARITY + 1; i-- > 0; ) {
+                siftDown(i);
+            }
+        }
+        assert(_heap.size() == _entities.size());
+    }
+
+    inline void clear() {
+        _heap.clear();
+        _slots.clear();
+        _freeSlots.clear();
+        _entities.clear();
     }
 
     inline void swap(EntityPriorityQueue& other) {
-        std::swap(_queue, other._queue);
+        std::swap(_heap, other._heap);
+        std::swap(_slots, other._slots);
+        std::swap(_freeSlots, other._freeSlots);
         std::swap(_entities, other._entities);
     }
 
 private:
-    using PriorityQueue = std::priority_queue<PrioritizedEntity,
-                                              std::vector<PrioritizedEntity>,
-                                              PrioritizedEntity::Compare>;
+    static const size_t ARITY = 4;
 
-    PriorityQueue _queue;
-    // Keep dictionary of all the entities in the queue for fast contain checks.
-    std::unordered_set<const EntityItem*> _entities;
+    struct Node {
+        float priority;
+        uint32_t slot;
+    };
+
+    struct Slot {
+        PrioritizedEntity entity;
+        uint32_t heapIndex;
+    };
+
+    inline void place(size_t index, const Node& node) {
+        _heap[index] = node;
+        _slots[node.slot].heapIndex = (uint32_t)index;
+    }
+
+    inline void siftUp(size_t index) {
+        Node node = _heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / ARITY;
+            if (!(_heap[parent].priority < node.priority)) {
+                break;
+            }
+            place(index, _heap[parent]);
+            index = parent;
+        }
+        place(index, node);
+    }
+
+    inline void siftDown(size_t index) {
+        Node node = _heap[index];
+        size_t size = _heap.size();
+        while (true) {
+            size_t firstChild = index * ARITY + 1;
+            if (firstChild >= size) {
+                break;
+            }
+            size_t endChild = std::min(firstChild + ARITY, size);
+            size_t best = firstChild;
+            for (size_t child = firstChild + 1; child < endChild; ++child) {
+                if (_heap[best].priority < _heap[child].priority) {
+                    best = child;
+                }
+            }
+            if (!(node.priority < _heap[best].priority)) {
+                break;
+            }
+            place(index, _heap[best]);
+            index = best;
+        }
+        place(index, node);
+    }
+
+    inline void releaseSlot(uint32_t slot) {
+        auto& entity = _slots[slot].entity;
+        _entities.erase(entity._rawEntityPointer);
+        // let go of the entity's control block, the slot waits in _freeSlots for the next emplace
+        entity._weakEntity.reset();
+        entity._rawEntityPointer = nullptr;
+        _freeSlots.push_back(slot);
+    }
 
+    std::vector<Node> _heap;
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _freeSlots;
+    // the slot of every entity in the queue, for fast contain checks and priority updates
+    std::unordered_map<const EntityItem*, uint32_t> _entities;
 };
 
 #endif // hifi_EntityPriorityQueue_h
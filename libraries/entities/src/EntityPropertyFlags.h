@@ -20,6 +20,7 @@ enum EntityPropertyList {
 
     // Core properties
     PROP_SIMULATION_OWNER,
+    PROP_KINEMATIC_DELTA,             // only in entity data packets, see EntityKinematicDelta
     PROP_PARENT_ID,
     PROP_PARENT_JOINT_INDEX,
     PROP_VISIBLE,
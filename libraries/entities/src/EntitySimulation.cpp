@@ -24,7 +24,6 @@ void EntitySimulation::setEntityTree(EntityTreePointer tree) {
         _changedEntities.clear();
         _entitiesToUpdate.clear();
         _mortalEntities.clear();
-        _nextExpiry = std::numeric_limits<uint64_t>::max();
     }
     _entityTree = tree;
 }
@@ -68,29 +67,22 @@ void EntitySimulation::prepareEntityForDelete(EntityItemPointer entity) {
 
 // protected
 void EntitySimulation::expireMortalEntities(uint64_t now) {
-    if (now > _nextExpiry) {
-        PROFILE_RANGE_EX(simulation_physics, "ExpireMortals", 0xffff00ff, (uint64_t)_mortalEntities.size());
-        // only search for expired entities if we expect to find one
-        _nextExpiry = std::numeric_limits<uint64_t>::max();
-        QMutexLocker lock(&_mutex);
-        SetOfEntities::iterator itemItr = _mortalEntities.begin();
-        while (itemItr != _mortalEntities.end()) {
-            EntityItemPointer entity = *itemItr;
-            uint64_t expiry = entity->getExpiry();
-            if (expiry < now) {
-                itemItr = _mortalEntities.erase(itemItr);
-                entity->die();
-                prepareEntityForDelete(entity);
-            } else {
-                if (expiry < _nextExpiry) {
-                    // remember the smallest _nextExpiry so we know when to start the next search
-                    _nextExpiry = expiry;
-                }
-                ++itemItr;
-            }
-        }
-        if (_mortalEntities.size() < 1) {
-            _nextExpiry = -1;
+    QMutexLocker lock(&_mutex);
+    std::vector<EntityItemPointer> expiredEntities;
+    _mortalEntities.expire(now, expiredEntities);
+    if (expiredEntities.empty()) {
+        return;
+    }
+
+    PROFILE_RANGE_EX(simulation_physics, "ExpireMortals", 0xffff00ff, (uint64_t)expiredEntities.size());
+    for (auto& entity : expiredEntities) {
+        // lifetime changes reschedule the entity, but check in case its expiry moved some other way
+        uint64_t expiry = entity->getExpiry();
+        if (expiry < now) {
+            entity->die();
+            prepareEntityForDelete(entity);
+        } else if (entity->isMortal()) {
+            _mortalEntities.schedule(entity, expiry);
         }
     }
 }
@@ -147,11 +139,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
 void EntitySimulation::addEntityToInternalLists(EntityItemPointer entity) {
     // protected: _mutex lock is guaranteed
     if (entity->isMortal()) {
-        _mortalEntities.insert(entity);
-        uint64_t expiry = entity->getExpiry();
-        if (expiry < _nextExpiry) {
-            _nextExpiry = expiry;
-        }
+        _mortalEntities.schedule(entity, entity->getExpiry());
     }
     if (entity->needsToCallUpdate()) {
         _entitiesToUpdate.insert(entity);
@@ -193,11 +181,7 @@ void EntitySimulation::processChangedEntity(const EntityItemPointer& entity) {
     if (dirtyFlags & (Simulation::DIRTY_LIFETIME | Simulation::DIRTY_UPDATEABLE)) {
         if (dirtyFlags & Simulation::DIRTY_LIFETIME) {
             if (entity->isMortal()) {
-                _mortalEntities.insert(entity);
-                uint64_t expiry = entity->getExpiry();
-                if (expiry < _nextExpiry) {
-                    _nextExpiry = expiry;
-                }
+                _mortalEntities.schedule(entity, entity->getExpiry());
             } else {
                 _mortalEntities.remove(entity);
             }
@@ -222,7 +206,6 @@ void EntitySimulation::clearEntities() {
     _deadEntitiesToRemoveFromTree.clear();
     _entitiesToUpdate.clear();
     _mortalEntities.clear();
-    _nextExpiry = std::numeric_limits<uint64_t>::max();
 }
 
 void EntitySimulation::moveSimpleKinematics(uint64_t now) {
@@ -256,6 +239,11 @@ void EntitySimulation::moveSimpleKinematics(uint64_t now) {
             itemItr = _simpleKinematicEntities.erase(itemItr);
         }
     }
+
+    // the moves happen outside of the tree's edit paths, let the journal know about them
+    if (_entityTree) {
+        _entityTree->trackJournalChanges(_entitiesToSort);
+    }
 }
 
 void EntitySimulation::processDeadEntities() {
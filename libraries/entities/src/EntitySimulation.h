@@ -19,6 +19,7 @@
 #include <QVector>
 
 #include <PerfStat.h>
+#include <TimingWheel.h>
 
 #include "EntityItem.h"
 #include "EntityTree.h"
@@ -42,9 +43,12 @@ const int DIRTY_SIMULATION_FLAGS =
         Simulation::DIRTY_MATERIAL |
         Simulation::DIRTY_SIMULATOR_ID;
 
+// the resolution of the timing wheels that keep track of when entities expire
+const uint64_t EXPIRY_WHEEL_TICK = 10 * USECS_PER_MSEC;
+
 class EntitySimulation : public QObject, public std::enable_shared_from_this<EntitySimulation> {
 public:
-    EntitySimulation() : _mutex(QMutex::Recursive), _nextExpiry(std::numeric_limits<uint64_t>::max()), _entityTree(nullptr) { }
+    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(nullptr) { }
     virtual ~EntitySimulation() { setEntityTree(nullptr); }
 
     inline EntitySimulationPointer getThisPointer() const {
@@ -104,8 +108,7 @@ private:
     std::unordered_set<EntityItemPointer> _changedEntities; // all changes this frame
     SetOfEntities _allEntities; // tracks all entities added the simulation
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
-    SetOfEntities _mortalEntities; // entities that have an expiry
-    uint64_t _nextExpiry;
+    TimingWheel<EntityItemPointer> _mortalEntities { EXPIRY_WHEEL_TICK, usecTimestampNow() }; // entities that have an expiry
 
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
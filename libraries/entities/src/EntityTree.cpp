@@ -10,6 +10,9 @@
 //
 
 #include "EntityTree.h"
+
+#include <unordered_map>
+
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
@@ -243,10 +246,12 @@ int EntityTree::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
                 } else {
                     entity = EntityTypes::constructEntityItem(dataAt, bytesLeftToRead);
                     if (entity) {
+                        int droppedKinematicDeltas = args.droppedKinematicDeltas;
                         bytesForThisEntity = entity->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
 
                         // don't add if we've recently deleted....
-                        if (!isDeletedEntity(entityItemID)) {
+                        // nor if all we got is a kinematic delta against an update we don't have
+                        if (!isDeletedEntity(entityItemID) && args.droppedKinematicDeltas == droppedKinematicDeltas) {
                             _entitiesToAdd.insert(entityItemID, entity);
 
                             if (entity->getCreated() == UNKNOWN_CREATED_TIME) {
@@ -307,6 +312,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     // find and hook up any entities with this entity as a (previously) missing parent
     fixupNeedsParentFixups();
 
+    trackJournalChange(entity->getID());
     emit addingEntity(entity->getEntityItemID());
     emit addingEntityPointer(entity.get());
 }
@@ -363,9 +369,9 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                 if (!success) {
                     qCWarning(entities) << "failed to get query-cube for" << entity->getID();
                 }
-                UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
-                recurseTreeWithOperator(&theOperator);
+                moveEntityInTree(containingElement, entity, queryCube);
                 if (entity->setProperties(tempProperties)) {
+                    trackJournalChange(entity->getID());
                     emit editingEntityPointer(entity);
                 }
                 _isDirty = true;
@@ -460,9 +466,9 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
         } else {
             newQueryAACube = entity->getQueryAACube();
         }
-        UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
-        recurseTreeWithOperator(&theOperator);
+        moveEntityInTree(containingElement, entity, newQueryAACube);
         if (entity->setProperties(properties)) {
+            trackJournalChange(entity->getID());
             emit editingEntityPointer(entity);
         }
 
@@ -494,8 +500,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                 addToNeedsParentFixupList(childEntity);
             }
 
-            UpdateEntityOperator theChildOperator(getThisPointer(), childContainingElement, childEntity, queryCube);
-            recurseTreeWithOperator(&theChildOperator);
+            moveEntityInTree(childContainingElement, childEntity, queryCube);
             foreach (SpatiallyNestablePointer childChild, childEntity->getChildren()) {
                 if (childChild && childChild->getNestableType() == NestableType::Entity) {
                     toProcess.enqueue(childChild);
@@ -536,6 +541,36 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
     return true;
 }
 
+void EntityTree::moveEntityInTree(const EntityTreeElementPointer& containingElement, const EntityItemPointer& entity,
+                                  const AACube& newQueryAACube) {
+    if (_deferEntityMoves) {
+        // the entity is sorted by its query cube as it is at the end of the batch
+        _entitiesToMove.insert(entity->getEntityItemID(), entity);
+        return;
+    }
+    UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
+    recurseTreeWithOperator(&theOperator);
+}
+
+void EntityTree::sortDeferredEntityMoves() {
+    // each entity is sorted once, however many edits of the batch moved it
+    for (const auto& entity : _entitiesToMove) {
+        EntityTreeElementPointer containingElement = entity->getElement();
+        if (!containingElement) {
+            continue; // erased later in the batch
+        }
+        bool success;
+        AACube queryCube = entity->getQueryAACube(success);
+        if (!success) {
+            addToNeedsParentFixupList(entity);
+            continue;
+        }
+        UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
+        recurseTreeWithOperator(&theOperator);
+    }
+    _entitiesToMove.clear();
+}
+
 EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const EntityItemProperties& properties, bool isClone) {
     EntityItemProperties props = properties;
 
@@ -742,6 +777,7 @@ void EntityTree::deleteEntitiesByPointer(const std::vector<EntityItemPointer>& e
     for (auto entity : entities) {
         if (entity->getElement()) {
             theOperator.addEntityToDeleteList(entity);
+            trackJournalChange(entity->getID());
             emit deletingEntity(entity->getID());
             emit deletingEntityPointer(entity.get());
         }
@@ -1390,13 +1426,13 @@ void EntityTree::fixupTerseEditLogging(EntityItemProperties& properties, QList<Q
 }
 
 
-bool EntityTree::filterProperties(const EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType) const {
+bool EntityTree::filterProperties(const EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType, const QUuid& senderID) const {
     bool accepted = true;
     auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
     if (entityEditFilters) {
         auto position = existingEntity ? existingEntity->getWorldPosition() : propertiesIn.getPosition();
         auto entityID = existingEntity ? existingEntity->getEntityItemID() : EntityItemID();
-        accepted = entityEditFilters->filter(position, propertiesIn, propertiesOut, wasChanged, filterType, entityID, existingEntity);
+        accepted = entityEditFilters->filter(position, propertiesIn, propertiesOut, wasChanged, filterType, entityID, existingEntity, senderID);
     }
 
     return accepted;
@@ -1773,6 +1809,13 @@ void EntityTree::processChallengeOwnershipPacket(ReceivedMessage& message, const
 // NOTE: Caller must lock the tree before calling this.
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                      const SharedNodePointer& senderNode) {
+    bool editAccepted;
+    return processEditPacketData(message, editData, maxLength, senderNode, editAccepted);
+}
+
+int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, bool& editAccepted) {
+    editAccepted = false;
     if (!getIsServer()) {
         qCWarning(entities) << "EntityTree::processEditPacketData() should only be called on a server tree.";
         return 0;
@@ -1940,7 +1983,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                 bool wasChanged = false;
                 // Having (un)lock rights bypasses the filter, unless it's a physics result.
                 FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType, senderNode->getUUID());
                 if (!allowed) {
                     // the update failed and we need to convey that fact to the sender
                     // our method is to re-assert the current properties and bump the lastEdited timestamp
@@ -1990,7 +2033,9 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                     if (!isPhysics) {
                         properties.setLastEditedBy(senderNode->getUUID());
                     }
-                    updateEntity(existingEntity, properties, senderNode);
+                    bool updated = updateEntity(existingEntity, properties, senderNode);
+                    editAccepted = updated && allowed && !wasChanged && !suppressDisallowedClientScript &&
+                        !suppressDisallowedServerScript && !suppressDisallowedPrivateUserData;
                     existingEntity->markAsChangedOnServer();
                     endUpdate = usecTimestampNow();
                     _totalUpdates++;
@@ -2099,6 +2144,158 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
 }
 
 
+// NOTE: Caller must lock the tree before calling this.
+void EntityTree::processEditBatch(OctreeEditBatch& batch) {
+    if (!getIsServer()) {
+        qCWarning(entities) << "EntityTree::processEditBatch() should only be called on a server tree.";
+        return;
+    }
+
+    // An edit of an existing entity is covered by a later edit of the same entity in the batch, from the same
+    // sender and of the same packet type, that is at least as recent and changes every property it changes: applying
+    // both would leave the entity as the later one alone does. A covered edit is skipped once its covering edit has
+    // been accepted as sent; if that one is rejected or partly suppressed, the covered edits are applied after all and
+    // the covering edit is applied again on top of them. Edits that change the simulation owner or the lock neither
+    // cover nor are covered, since they change how the edits around them are checked, and neither do edits that go
+    // through the edit filter, since a filter has to see every edit exactly once (it may count them, as rateLimit does).
+    // Adds, clones and erases (and edits we can't decode) are applied as they come and nothing coalesces across them.
+    struct BatchEdit {
+        int message;
+        int offset;
+        bool isBarrier { false }; // the rest of the message is applied as it comes
+        EntityItemID entityID;
+        quint64 lastEdited { 0 };
+        EntityPropertyFlags changedProperties;
+        int coveredBy { -1 }; // index of the later edit that covers this one
+    };
+    std::vector<BatchEdit> edits;
+
+    for (int i = 0; i < (int)batch.size(); i++) {
+        ReceivedMessage& message = *batch[i].message;
+        int offset = (int)message.getPosition();
+        PacketType type = message.getType();
+        if (type != PacketType::EntityEdit && type != PacketType::EntityPhysics) {
+            edits.push_back({ i, offset, true });
+            continue;
+        }
+
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(message.getRawMessage());
+        int size = (int)message.getSize();
+        while (offset < size) {
+            BatchEdit edit { i, offset, false };
+            EntityItemProperties properties;
+            int processedBytes = 0;
+            if (!EntityItemProperties::decodeEntityEditPacket(data + offset, size - offset, processedBytes,
+                                                              edit.entityID, properties) || processedBytes <= 0) {
+                edit.isBarrier = true;
+                edits.push_back(edit);
+                break;
+            }
+            edit.lastEdited = properties.getLastEdited();
+            edit.changedProperties = properties.getChangedProperties();
+            edits.push_back(edit);
+            offset += processedBytes;
+        }
+    }
+
+    // the same test processEditPacketData() uses to decide whether an edit is filtered
+    auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+    bool haveFilters = entityEditFilters && entityEditFilters->hasFilters();
+    auto isFiltered = [&](const OctreeEditBatchMessage& message) {
+        return haveFilters && (message.message->getType() == PacketType::EntityPhysics ||
+                               !message.senderNode->isAllowedEditor());
+    };
+
+    // walk the batch backwards, remembering the nearest later edit of each entity that isn't covered itself
+    std::unordered_map<EntityItemID, int> laterEdits;
+    std::unordered_map<int, std::vector<int>> coveredEdits;
+    for (int index = (int)edits.size() - 1; index >= 0; index--) {
+        BatchEdit& edit = edits[index];
+        if (edit.isBarrier) {
+            laterEdits.clear();
+            continue;
+        }
+        if (edit.changedProperties.getHasProperty(PROP_SIMULATION_OWNER) ||
+                edit.changedProperties.getHasProperty(PROP_LOCKED) || isFiltered(batch[edit.message])) {
+            laterEdits.erase(edit.entityID);
+            continue;
+        }
+
+        auto later = laterEdits.find(edit.entityID);
+        if (later != laterEdits.end()) {
+            const BatchEdit& laterEdit = edits[later->second];
+            const OctreeEditBatchMessage& message = batch[edit.message];
+            const OctreeEditBatchMessage& laterMessage = batch[laterEdit.message];
+            bool covered = message.senderNode == laterMessage.senderNode &&
+                message.message->getType() == laterMessage.message->getType() &&
+                laterEdit.lastEdited >= edit.lastEdited;
+            for (int flag = (int)edit.changedProperties.firstFlag();
+                    covered && flag <= (int)edit.changedProperties.lastFlag(); flag++) {
+                if (edit.changedProperties.getHasProperty((EntityPropertyList)flag) &&
+                        !laterEdit.changedProperties.getHasProperty((EntityPropertyList)flag)) {
+                    covered = false;
+                }
+            }
+            if (covered) {
+                edit.coveredBy = later->second;
+                coveredEdits[later->second].push_back(index);
+            }
+        }
+        if (edit.coveredBy < 0) {
+            laterEdits[edit.entityID] = index;
+        }
+    }
+
+    auto applyEdit = [&](const BatchEdit& edit) {
+        OctreeEditBatchMessage& batchMessage = batch[edit.message];
+        ReceivedMessage& message = *batchMessage.message;
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(message.getRawMessage());
+        bool editAccepted;
+        quint64 startProcess = usecTimestampNow();
+        processEditPacketData(message, data + edit.offset, (int)message.getSize() - edit.offset,
+                              batchMessage.senderNode, editAccepted);
+        batchMessage.processTime += usecTimestampNow() - startProcess;
+        return editAccepted;
+    };
+
+    _deferEntityMoves = true;
+    for (int index = 0; index < (int)edits.size(); index++) {
+        const BatchEdit& edit = edits[index];
+        OctreeEditBatchMessage& batchMessage = batch[edit.message];
+        if (edit.isBarrier) {
+            processEditMessage(batchMessage, edit.offset);
+            continue;
+        }
+        if (edit.coveredBy >= 0) {
+            continue; // settled by the edit that covers it
+        }
+
+        batchMessage.numEdits++;
+        bool editAccepted = applyEdit(edit);
+        auto covered = coveredEdits.find(index);
+        if (covered == coveredEdits.end()) {
+            continue;
+        }
+        // the covered edits were collected latest first
+        for (auto it = covered->second.rbegin(); it != covered->second.rend(); ++it) {
+            const BatchEdit& coveredEdit = edits[*it];
+            OctreeEditBatchMessage& coveredMessage = batch[coveredEdit.message];
+            coveredMessage.numEdits++;
+            if (editAccepted) {
+                coveredMessage.numCoalescedEdits++;
+            } else {
+                applyEdit(coveredEdit);
+            }
+        }
+        if (!editAccepted) {
+            applyEdit(edit);
+        }
+    }
+    _deferEntityMoves = false;
+    sortDeferredEntityMoves();
+}
+
+
 void EntityTree::notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
     _newlyCreatedHooksLock.lockForRead();
     for (int i = 0; i < _newlyCreatedHooks.size(); i++) {
@@ -2354,7 +2551,7 @@ bool EntityTree::shouldEraseEntity(EntityItemID entityID, const SharedNodePointe
     EntityItemProperties dummyProperties;
     bool wasChanged = false;
 
-    bool allowed = (sourceNode->isAllowedEditor()) || filterProperties(existingEntity, dummyProperties, dummyProperties, wasChanged, filterType);
+    bool allowed = (sourceNode->isAllowedEditor()) || filterProperties(existingEntity, dummyProperties, dummyProperties, wasChanged, filterType, sourceNode->getUUID());
     auto endFilter = usecTimestampNow();
 
     _totalFilterTime += endFilter - startFilter;
@@ -3100,14 +3297,251 @@ bool EntityTree::readFromMap(QVariantMap& map) {
 bool EntityTree::writeToJSON(QString& jsonString, const OctreeElementPointer& element) {
     QScriptEngine scriptEngine;
     RecurseOctreeToJSONOperator theOperator(element, &scriptEngine, jsonString);
+
+    // only copy the entity properties with the tree locked, so that edits don't wait on the JSON conversion
+    quint64 lockWaitStart = usecTimestampNow();
+    quint64 lockStart = 0;
+    quint64 lockEnd = 0;
     withReadLock([&] {
+        lockStart = usecTimestampNow();
         recurseTreeWithOperator(&theOperator);
+        lockEnd = usecTimestampNow();
     });
+    qCDebug(entities) << "Snapshot of" << theOperator.getSnapshotSize() << "entities for JSON waited"
+        << (lockStart - lockWaitStart) << "usecs for the tree lock and held it" << (lockEnd - lockStart) << "usecs";
 
+    theOperator.writeSnapshot();
     jsonString = theOperator.getJson();
     return true;
 }
 
+namespace {
+// A snapshot item is the entity's edit packet encoding with every property of its type, followed by the
+// properties that are not sent over the wire but are kept in the JSON save.
+const int INITIAL_SNAPSHOT_ENCODE_SIZE = MAX_OCTREE_PACKET_DATA_SIZE * 4;
+const int MAX_SNAPSHOT_ENCODE_SIZE = 64 * 1024 * 1024;
+
+bool encodeSnapshotItem(const EntityItemID& entityItemID, EntityItemProperties& properties, QByteArray& buffer,
+                        QByteArray& item) {
+    EntityPropertyFlags requestedProperties = properties.getDesiredProperties();
+    for (int size = INITIAL_SNAPSHOT_ENCODE_SIZE; size <= MAX_SNAPSHOT_ENCODE_SIZE; size *= 4) {
+        buffer.resize(size);
+        EntityPropertyFlags didntFitProperties;
+        auto appendState = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entityItemID, properties,
+            buffer, requestedProperties, didntFitProperties);
+        if (appendState == OctreeElement::COMPLETED) {
+            item.clear();
+            QDataStream stream(&item, QIODevice::WriteOnly);
+            stream << buffer << (quint32)properties.getEntityHostType() << properties.getOwningAvatarID()
+                << properties.getIsVisibleInSecondaryCamera();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool decodeSnapshotItem(const QByteArray& item, QByteArray& buffer, EntityItemID& entityItemID,
+                        EntityItemProperties& properties) {
+    QDataStream stream(item);
+    quint32 entityHostType = 0;
+    QUuid owningAvatarID;
+    bool isVisibleInSecondaryCamera = true;
+    stream >> buffer >> entityHostType >> owningAvatarID >> isVisibleInSecondaryCamera;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    int processedBytes = 0;
+    if (!EntityItemProperties::decodeEntityEditPacket(reinterpret_cast<const unsigned char*>(buffer.constData()),
+                                                      buffer.size(), processedBytes, entityItemID, properties)) {
+        return false;
+    }
+    properties.setEntityHostType((entity::HostType)entityHostType);
+    properties.setOwningAvatarID(owningAvatarID);
+    properties.setIsVisibleInSecondaryCamera(isVisibleInSecondaryCamera);
+    return true;
+}
+}
+
+QVariantMap EntityTree::getSnapshotMetadata() const {
+    QVariantMap namedPathsMap;
+    for (const auto& namedPath : _namedPaths) {
+        namedPathsMap[namedPath.first] = namedPath.second;
+    }
+    QVariantMap metadata;
+    metadata["Paths"] = namedPathsMap;
+    return metadata;
+}
+
+bool EntityTree::writeToSnapshot(OctreeSnapshotWriter& writer) {
+    // like writeToJSON(), only copy the properties with the tree locked
+    std::vector<std::pair<EntityItemID, EntityItemProperties>> snapshot;
+    quint64 lockWaitStart = usecTimestampNow();
+    quint64 lockStart = 0;
+    quint64 lockEnd = 0;
+    withReadLock([&] {
+        lockStart = usecTimestampNow();
+        QReadLocker locker(&_entityMapLock);
+        snapshot.reserve(_entityMap.size());
+        for (const auto& entity : _entityMap) {
+            snapshot.emplace_back(entity->getEntityItemID(), entity->getProperties());
+        }
+        lockEnd = usecTimestampNow();
+    });
+    qCDebug(entities) << "Snapshot of" << snapshot.size() << "entities for binary save waited"
+        << (lockStart - lockWaitStart) << "usecs for the tree lock and held it" << (lockEnd - lockStart) << "usecs";
+
+    QByteArray buffer;
+    QByteArray item;
+    for (auto& entry : snapshot) {
+        if (!encodeSnapshotItem(entry.first, entry.second, buffer, item)) {
+            qCWarning(entities) << "Failed to encode entity" << entry.first << "for binary save";
+            return false;
+        }
+        if (!writer.append(item)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EntityTree::readFromSnapshot(OctreeSnapshotReader& reader) {
+    _namedPaths.clear();
+    QVariantMap namedPathsMap = reader.getHeader().metadata["Paths"].toMap();
+    for (auto iter = namedPathsMap.begin(); iter != namedPathsMap.end(); ++iter) {
+        _namedPaths[iter.key()] = iter.value().toString();
+    }
+
+    // the snapshot has the current item version, so unlike readFromMap() there is no older content to convert
+    QMap<QUuid, QVector<QUuid>> cloneIDs;
+    bool success = true;
+    QByteArray item;
+    QByteArray buffer;
+    while (reader.readNext(item)) {
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        if (!decodeSnapshotItem(item, buffer, entityItemID, properties)) {
+            qCDebug(entities) << "Failed to decode entity" << reader.getNumItemsRead() << "of binary save";
+            success = false;
+            continue;
+        }
+
+        if (properties.getEntityHostType() == entity::HostType::AVATAR) {
+            auto nodeList = DependencyManager::get<NodeList>();
+            properties.setOwningAvatarID(nodeList->getSessionUUID());
+        }
+
+        EntityItemPointer entity = addEntity(entityItemID, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            success = false;
+            continue;
+        }
+
+        const QUuid& cloneOriginID = entity->getCloneOriginID();
+        if (!cloneOriginID.isNull()) {
+            cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
+        }
+    }
+
+    for (const auto& entityID : cloneIDs.keys()) {
+        auto entity = findEntityByID(entityID);
+        if (entity) {
+            entity->setCloneIDs(cloneIDs.value(entityID));
+        }
+    }
+
+    return success && reader.atEnd();
+}
+
+void EntityTree::takeJournalRecords(std::vector<OctreeJournal::Record>& records) {
+    QSet<QUuid> changes;
+    {
+        QWriteLocker locker(&_journalChangesLock);
+        changes.swap(_journalChanges);
+    }
+    if (changes.isEmpty()) {
+        return;
+    }
+
+    // copy the properties with the tree locked, and turn them into JSON without it
+    std::vector<std::pair<QUuid, EntityItemProperties>> snapshot;
+    snapshot.reserve(changes.size());
+    withReadLock([&] {
+        for (const auto& id : changes) {
+            EntityItemPointer entity = findEntityByID(id);
+            if (entity) {
+                snapshot.emplace_back(id, entity->getProperties());
+            } else {
+                OctreeJournal::Record record;
+                record.type = OctreeJournal::Delete;
+                record.id = id;
+                records.push_back(record);
+            }
+        }
+    });
+
+    // every property is written, so that replaying the record over an older version of the entity resets the rest
+    QScriptEngine scriptEngine;
+    QScriptValue toStringMethod = scriptEngine.evaluate("(function() { return JSON.stringify(this) })");
+    for (const auto& entry : snapshot) {
+        QScriptValue scriptValue = EntityItemPropertiesToScriptValue(&scriptEngine, entry.second);
+        scriptValue.setProperty("toString", toStringMethod);
+
+        OctreeJournal::Record record;
+        record.type = OctreeJournal::Upsert;
+        record.id = entry.first;
+        record.data = scriptValue.toString().toUtf8();
+        records.push_back(record);
+    }
+}
+
+void EntityTree::replayJournalRecords(const std::vector<OctreeJournal::Record>& records) {
+    // tree must be write-locked before calling this method
+    QScriptEngine scriptEngine;
+    for (const auto& record : records) {
+        EntityItemID entityItemID(record.id);
+        EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
+
+        if (record.type == OctreeJournal::Delete) {
+            if (existingEntity) {
+                deleteEntity(entityItemID, true, true);
+            }
+            continue;
+        }
+
+        QVariantMap entityMap = QJsonDocument::fromJson(record.data).toVariant().toMap();
+        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+        EntityItemProperties properties;
+        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+        if (existingEntity) {
+            // replace the state in place, deleting and adding it again would take its children with it
+            if (existingEntity->getElement()) {
+                UpdateEntityOperator theOperator(getThisPointer(), existingEntity->getElement(), existingEntity,
+                                                 properties.getQueryAACube());
+                recurseTreeWithOperator(&theOperator);
+            }
+            existingEntity->setProperties(properties);
+            _isDirty = true;
+        } else {
+            EntityItemPointer entity = addEntity(entityItemID, properties);
+            if (!entity) {
+                qCDebug(entities) << "replaying Entity add failed:" << entityItemID << properties.getType();
+                continue;
+            }
+
+            const QUuid& cloneOriginID = entity->getCloneOriginID();
+            if (!cloneOriginID.isNull()) {
+                EntityItemPointer cloneOrigin = findEntityByID(cloneOriginID);
+                if (cloneOrigin) {
+                    cloneOrigin->addCloneID(entity->getID());
+                }
+            }
+        }
+    }
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
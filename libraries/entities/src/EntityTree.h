@@ -89,6 +89,7 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual void processEditBatch(OctreeEditBatch& batch) override;
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
@@ -197,6 +198,29 @@ public:
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
     virtual bool writeToJSON(QString& jsonString, const OctreeElementPointer& element) override;
+    virtual QVariantMap getSnapshotMetadata() const override;
+    virtual bool writeToSnapshot(OctreeSnapshotWriter& writer) override;
+    virtual bool readFromSnapshot(OctreeSnapshotReader& reader) override;
+
+    virtual void setWantJournal(bool wantJournal) override { _wantJournal = wantJournal; }
+    virtual void takeJournalRecords(std::vector<OctreeJournal::Record>& records) override;
+    virtual void replayJournalRecords(const std::vector<OctreeJournal::Record>& records) override;
+
+    // records entities changed on the server (edits, simulation, ownership) for the next journal records
+    void trackJournalChange(const QUuid& id) {
+        if (_wantJournal) {
+            QWriteLocker locker(&_journalChangesLock);
+            _journalChanges << id;
+        }
+    }
+    void trackJournalChanges(const SetOfEntities& entities) {
+        if (_wantJournal && !entities.empty()) {
+            QWriteLocker locker(&_journalChangesLock);
+            for (const auto& entity : entities) {
+                _journalChanges << entity->getID();
+            }
+        }
+    }
 
 
     glm::vec3 getContentsDimensions();
@@ -310,6 +334,10 @@ protected:
     mutable QReadWriteLock _recentlyDeletedEntitiesLock; /// lock of server side recent deletes
     QMultiMap<quint64, QUuid> _recentlyDeletedEntityItemIDs; /// server side recent deletes
 
+    std::atomic<bool> _wantJournal { false };
+    mutable QReadWriteLock _journalChangesLock; /// lock of server side changes to journal
+    QSet<QUuid> _journalChanges; /// server side entities added, edited or deleted since the last journal records
+
     mutable QReadWriteLock _deletedEntitiesLock; /// lock of client side recent deletes
     QSet<QUuid> _deletedEntityItemIDs; /// client side recent deletes
 
@@ -367,16 +395,27 @@ protected:
 
     float _maxTmpEntityLifetime { DEFAULT_MAX_TMP_ENTITY_LIFETIME };
 
-    bool filterProperties(const EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType) const;
+    bool filterProperties(const EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType, const QUuid& senderID = QUuid()) const;
     bool _hasEntityEditFilter{ false };
     QStringList _entityScriptSourceWhitelist;
 
     MovingEntitiesOperator _entityMover;
     QHash<EntityItemID, EntityItemPointer> _entitiesToAdd;
 
+    // while an edit batch is applied, moved entities are collected here and re-sorted once at the end of the batch
+    bool _deferEntityMoves { false };
+    QHash<EntityItemID, EntityItemPointer> _entitiesToMove;
+
     Q_INVOKABLE void startChallengeOwnershipTimer(const EntityItemID& entityItemID);
 
 private:
+    // editAccepted is set when the edit of an existing entity was applied as sent: it passed the edit filter unchanged
+    // and none of its properties were suppressed
+    int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                              const SharedNodePointer& senderNode, bool& editAccepted);
+    void moveEntityInTree(const EntityTreeElementPointer& containingElement, const EntityItemPointer& entity, const AACube& newQueryAACube);
+    void sortDeferredEntityMoves();
+
     void addCertifiedEntityOnServer(EntityItemPointer entity);
     void removeCertifiedEntityOnServer(EntityItemPointer entity);
     void sendChallengeOwnershipPacket(const QString& certID, const QString& ownerKey, const EntityItemID& entityItemID, const SharedNodePointer& senderNode);
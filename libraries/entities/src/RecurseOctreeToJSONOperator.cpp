@@ -34,17 +34,24 @@ void RecurseOctreeToJSONOperator::processEntity(const EntityItemPointer& entity)
         return;  // we weren't able to resolve a parent from _parentID, so don't save this entity.
     }
 
-    QScriptValue qScriptValues = _skipDefaults
-        ? EntityItemNonDefaultPropertiesToScriptValue(_engine, entity->getProperties())
-        : EntityItemPropertiesToScriptValue(_engine, entity->getProperties());
-
-    if (_comma) {
-        _json += ',';
-    };
-    _comma = true;
-    _json += "\n    ";
-
-    // Override default toString():
-    qScriptValues.setProperty("toString", _toStringMethod);
-    _json += qScriptValues.toString();
+    _snapshot.push_back(entity->getProperties());
+}
+
+void RecurseOctreeToJSONOperator::writeSnapshot() {
+    for (const auto& properties : _snapshot) {
+        QScriptValue qScriptValues = _skipDefaults
+            ? EntityItemNonDefaultPropertiesToScriptValue(_engine, properties)
+            : EntityItemPropertiesToScriptValue(_engine, properties);
+
+        if (_comma) {
+            _json += ',';
+        };
+        _comma = true;
+        _json += "\n    ";
+
+        // Override default toString():
+        qScriptValues.setProperty("toString", _toStringMethod);
+        _json += qScriptValues.toString();
+    }
+    _snapshot.clear();
 }
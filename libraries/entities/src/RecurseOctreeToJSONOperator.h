@@ -9,6 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <vector>
+
+#include "EntityItemProperties.h"
 #include "EntityTree.h"
 
 class RecurseOctreeToJSONOperator : public RecurseOctreeOperator {
@@ -18,7 +21,11 @@ public:
     virtual bool preRecursion(const OctreeElementPointer& element) override { return true; };
     virtual bool postRecursion(const OctreeElementPointer& element) override;
 
+    // the recursion only copies the properties of each entity, call this once the tree is unlocked to turn them into JSON
+    void writeSnapshot();
+
     QString getJson() const { return _json; }
+    int getSnapshotSize() const { return (int)_snapshot.size(); }
 
 private:
     void processEntity(const EntityItemPointer& entity);
@@ -26,6 +33,7 @@ private:
     QScriptEngine* _engine;
     QScriptValue _toStringMethod;
 
+    std::vector<EntityItemProperties> _snapshot;
     QString _json;
     const bool _skipDefaults;
     bool _skipThoseWithBadParents;
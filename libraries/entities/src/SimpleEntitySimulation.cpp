@@ -26,12 +26,12 @@ void SimpleEntitySimulation::clearOwnership(const QUuid& ownerID) {
         if (entity->getSimulatorID() == ownerID) {
             // the simulator has abandonded this object --> remove from owned list
             itemItr = _entitiesWithSimulationOwner.erase(itemItr);
+            _staleOwnershipExpiries.remove(entity);
 
             if (entity->getDynamic() && entity->hasLocalVelocity()) {
                 // it is still moving dynamically --> add to orphaned list
                 _entitiesThatNeedSimulationOwner.insert(entity);
-                uint64_t expiry = entity->getLastChangedOnServer() + MAX_OWNERLESS_PERIOD;
-                _nextOwnerlessExpiry = glm::min(_nextOwnerlessExpiry, expiry);
+                _ownerlessExpiries.schedule(entity, entity->getLastChangedOnServer() + MAX_OWNERLESS_PERIOD);
             }
 
             // remove ownership and dirty all the tree elements that contain the it
@@ -69,7 +69,7 @@ void SimpleEntitySimulation::addEntityToInternalLists(EntityItemPointer entity)
         }
     } else {
         _entitiesWithSimulationOwner.insert(entity);
-        _nextStaleOwnershipExpiry = glm::min(_nextStaleOwnershipExpiry, entity->getSimulationOwnershipExpiry());
+        _staleOwnershipExpiries.schedule(entity, entity->getSimulationOwnershipExpiry());
 
         if (entity->isMovingRelativeToParent()) {
             SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
@@ -84,6 +84,8 @@ void SimpleEntitySimulation::addEntityToInternalLists(EntityItemPointer entity)
 void SimpleEntitySimulation::removeEntityFromInternalLists(EntityItemPointer entity) {
     _entitiesWithSimulationOwner.remove(entity);
     _entitiesThatNeedSimulationOwner.remove(entity);
+    _staleOwnershipExpiries.remove(entity);
+    _ownerlessExpiries.remove(entity);
     EntitySimulation::removeEntityFromInternalLists(entity);
 }
 
@@ -95,6 +97,7 @@ void SimpleEntitySimulation::processChangedEntity(const EntityItemPointer& entit
         if (entity->getSimulatorID().isNull()) {
             QMutexLocker lock(&_mutex);
             _entitiesWithSimulationOwner.remove(entity);
+            _staleOwnershipExpiries.remove(entity);
 
             if (entity->getDynamic()) {
                 // we don't allow dynamic objects to move without an owner
@@ -117,8 +120,9 @@ void SimpleEntitySimulation::processChangedEntity(const EntityItemPointer& entit
         } else {
             QMutexLocker lock(&_mutex);
             _entitiesWithSimulationOwner.insert(entity);
-            _nextStaleOwnershipExpiry = glm::min(_nextStaleOwnershipExpiry, entity->getSimulationOwnershipExpiry());
+            _staleOwnershipExpiries.schedule(entity, entity->getSimulationOwnershipExpiry());
             _entitiesThatNeedSimulationOwner.remove(entity);
+            _ownerlessExpiries.remove(entity);
 
             if (entity->isMovingRelativeToParent()) {
                 SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
@@ -141,6 +145,8 @@ void SimpleEntitySimulation::clearEntities() {
     QMutexLocker lock(&_mutex);
     _entitiesWithSimulationOwner.clear();
     _entitiesThatNeedSimulationOwner.clear();
+    _staleOwnershipExpiries.clear();
+    _ownerlessExpiries.clear();
     EntitySimulation::clearEntities();
 }
 
@@ -155,62 +161,56 @@ void SimpleEntitySimulation::sortEntitiesThatMoved() {
 }
 
 void SimpleEntitySimulation::expireStaleOwnerships(uint64_t now) {
-    if (now > _nextStaleOwnershipExpiry) {
-        _nextStaleOwnershipExpiry = (uint64_t)(-1);
-        SetOfEntities::iterator itemItr = _entitiesWithSimulationOwner.begin();
-        while (itemItr != _entitiesWithSimulationOwner.end()) {
-            EntityItemPointer entity = *itemItr;
-            uint64_t expiry = entity->getSimulationOwnershipExpiry();
-            if (now > expiry) {
-                itemItr = _entitiesWithSimulationOwner.erase(itemItr);
-                if (entity->getDynamic()) {
-                    SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                    if (itr != _simpleKinematicEntities.end()) {
-                        _simpleKinematicEntities.erase(itr);
-                    }
+    std::vector<EntityItemPointer> expiredEntities;
+    _staleOwnershipExpiries.expire(now, expiredEntities);
+    for (auto& entity : expiredEntities) {
+        // the owner may have renewed its ownership since it was scheduled
+        uint64_t expiry = entity->getSimulationOwnershipExpiry();
+        if (now > expiry) {
+            _entitiesWithSimulationOwner.remove(entity);
+            if (entity->getDynamic()) {
+                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
+                if (itr != _simpleKinematicEntities.end()) {
+                    _simpleKinematicEntities.erase(itr);
                 }
-
-                // remove ownership and dirty all the tree elements that contain the it
-                entity->clearSimulationOwnership();
-                entity->markAsChangedOnServer();
-                DirtyOctreeElementOperator op(entity->getElement());
-                getEntityTree()->recurseTreeWithOperator(&op);
-            } else {
-                _nextStaleOwnershipExpiry = glm::min(_nextStaleOwnershipExpiry, expiry);
-                ++itemItr;
             }
+
+            // remove ownership and dirty all the tree elements that contain the it
+            entity->clearSimulationOwnership();
+            entity->markAsChangedOnServer();
+            DirtyOctreeElementOperator op(entity->getElement());
+            getEntityTree()->recurseTreeWithOperator(&op);
+        } else {
+            _staleOwnershipExpiries.schedule(entity, expiry);
         }
     }
 }
 
 void SimpleEntitySimulation::stopOwnerlessEntities(uint64_t now) {
-    if (now > _nextOwnerlessExpiry) {
-        // search for ownerless objects that have expired
-        QMutexLocker lock(&_mutex);
-        _nextOwnerlessExpiry = (uint64_t)(-1);
-        SetOfEntities::iterator itemItr = _entitiesThatNeedSimulationOwner.begin();
-        while (itemItr != _entitiesThatNeedSimulationOwner.end()) {
-            EntityItemPointer entity = *itemItr;
-            uint64_t expiry = entity->getLastChangedOnServer() + MAX_OWNERLESS_PERIOD;
-            if (expiry < now) {
-                // no simulators have volunteered ownership --> remove from list
-                itemItr = _entitiesThatNeedSimulationOwner.erase(itemItr);
-
-                if (entity->getSimulatorID().isNull() && entity->getDynamic() && entity->hasLocalVelocity()) {
-                    // zero the derivatives
-                    entity->setVelocity(Vectors::ZERO);
-                    entity->setAngularVelocity(Vectors::ZERO);
-                    entity->setAcceleration(Vectors::ZERO);
-
-                    // dirty all the tree elements that contain it
-                    entity->markAsChangedOnServer();
-                    DirtyOctreeElementOperator op(entity->getElement());
-                    getEntityTree()->recurseTreeWithOperator(&op);
-                }
-            } else {
-                _nextOwnerlessExpiry = glm::min(_nextOwnerlessExpiry, expiry);
-                ++itemItr;
+    // search for ownerless objects that have expired
+    QMutexLocker lock(&_mutex);
+    std::vector<EntityItemPointer> expiredEntities;
+    _ownerlessExpiries.expire(now, expiredEntities);
+    for (auto& entity : expiredEntities) {
+        // changes on the server push the expiry back
+        uint64_t expiry = entity->getLastChangedOnServer() + MAX_OWNERLESS_PERIOD;
+        if (expiry < now) {
+            // no simulators have volunteered ownership --> remove from list
+            _entitiesThatNeedSimulationOwner.remove(entity);
+
+            if (entity->getSimulatorID().isNull() && entity->getDynamic() && entity->hasLocalVelocity()) {
+                // zero the derivatives
+                entity->setVelocity(Vectors::ZERO);
+                entity->setAngularVelocity(Vectors::ZERO);
+                entity->setAcceleration(Vectors::ZERO);
+
+                // dirty all the tree elements that contain it
+                entity->markAsChangedOnServer();
+                DirtyOctreeElementOperator op(entity->getElement());
+                getEntityTree()->recurseTreeWithOperator(&op);
             }
+        } else {
+            _ownerlessExpiries.schedule(entity, expiry);
         }
     }
 }
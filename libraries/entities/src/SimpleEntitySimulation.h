@@ -41,8 +41,9 @@ protected:
 
     SetOfEntities _entitiesWithSimulationOwner;
     SetOfEntities _entitiesThatNeedSimulationOwner;
-    uint64_t _nextOwnerlessExpiry { 0 };
-    uint64_t _nextStaleOwnershipExpiry { (uint64_t)(-1) };
+    // when the ownership of each owned entity goes stale, and when each entity that needs an owner gives up on one
+    TimingWheel<EntityItemPointer> _staleOwnershipExpiries { EXPIRY_WHEEL_TICK, usecTimestampNow() };
+    TimingWheel<EntityItemPointer> _ownerlessExpiries { EXPIRY_WHEEL_TICK, usecTimestampNow() };
 };
 
 #endif // hifi_SimpleEntitySimulation_h
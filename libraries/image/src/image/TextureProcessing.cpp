@@ -23,6 +23,8 @@
 #include <Profile.h>
 #include <StatTracker.h>
 #include <GLMHelpers.h>
+#include <TBBHelpers.h>
+#include <tbb/task_arena.h>
 
 #include "TGAReader.h"
 #if !defined(Q_OS_ANDROID)
@@ -420,45 +422,40 @@ Image processSourceImage(Image&& srcImage, bool cubemap, BackendTarget target) {
     return localCopy;
 }
 
+// One compressed mip of a texture face. Faces are compressed side by side on the task pool into these, then
+// assigned to the texture in order once they are all done since it can't take them from several threads at once.
+struct CompressedMip {
+    int level { 0 };
+    std::vector<gpu::Byte> data;
+};
+using CompressedMips = std::vector<CompressedMip>;
+
 #if defined(NVTT_API)
 struct OutputHandler : public nvtt::OutputHandler {
-    OutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
+    OutputHandler(CompressedMip& mip) : _mip(mip) {}
 
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
-        _size = size;
-        _miplevel = miplevel;
-
-        _data = static_cast<gpu::Byte*>(malloc(size));
-        _current = _data;
+        _mip.level = miplevel;
+        _mip.data.resize(size);
+        _current = _mip.data.data();
     }
 
     virtual bool writeData(const void* data, int size) override {
-        assert(_current + size <= _data + _size);
+        assert(_current + size <= _mip.data.data() + _mip.data.size());
         memcpy(_current, data, size);
         _current += size;
         return true;
     }
 
     virtual void endImage() override {
-        if (_face >= 0) {
-            _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
-        } else {
-            _texture->assignStoredMip(_miplevel, _size, static_cast<const gpu::Byte*>(_data));
-        }
-        free(_data);
-        _data = nullptr;
     }
 
-    gpu::Byte* _data{ nullptr };
+    CompressedMip& _mip;
     gpu::Byte* _current{ nullptr };
-    gpu::Texture* _texture{ nullptr };
-    int _miplevel = 0;
-    int _size = 0;
-    int _face = -1;
 };
 
 struct PackedFloatOutputHandler : public OutputHandler {
-    PackedFloatOutputHandler(gpu::Texture* texture, int face, gpu::Element format) : OutputHandler(texture, face) {
+    PackedFloatOutputHandler(CompressedMip& mip, gpu::Element format) : OutputHandler(mip) {
         _packFunc = getHDRPackingFunction(format);
     }
 
@@ -500,25 +497,48 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-#if defined(NVTT_API)
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+// Runs the block compression tasks nvtt splits each mip into on the shared TBB pool. Every task encodes its own
+// blocks into its own place in the output, so the result is the same whichever order they run in.
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing = false) : _abortProcessing(abortProcessing) {
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {
     }
 
     const std::atomic<bool>& _abortProcessing;
 
     void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
+        tbb::parallel_for(0, count, [&](int i) {
             if (!_abortProcessing.load()) {
                 task(context, i);
-            } else {
-                break;
             }
-        }
+        });
     }
 };
-#endif
+
+// Compresses surface into baseMipLevel and, if buildMips is set, the mips below it. Each mip is filtered down in place
+// from the one above once it is compressed, so only one float surface of the chain is alive at a time; the block tasks
+// of each mip still run side by side on the task pool. A mip whose compression was aborted has skipped blocks and is
+// dropped along with the rest of the chain.
+template <typename CompressMip>
+CompressedMips compressMipChain(nvtt::Surface& surface, int baseMipLevel, bool buildMips,
+                                const std::atomic<bool>& abortProcessing, CompressMip compressMip) {
+    CompressedMips mips;
+    while (!abortProcessing.load()) {
+        CompressedMip mip;
+        mip.level = baseMipLevel + (int)mips.size();
+        compressMip(surface, mip);
+        if (abortProcessing.load()) {
+            break;
+        }
+        mips.push_back(std::move(mip));
+
+        if (!buildMips || !surface.canMakeNextMipmap()) {
+            break;
+        }
+        surface.buildNextMipmap(nvtt::MipmapFilter_Box);
+    }
+    return mips;
+}
 
 void convertToFloatFromPacked(const unsigned char* source, int width, int height, size_t srcLineByteStride, gpu::Element sourceFormat,
                               glm::vec4* output, size_t outputLinePixelStride) {
@@ -560,8 +580,7 @@ void convertToPackedFromFloat(unsigned char* output, int width, int height, size
     }
 }
 
-nvtt::OutputHandler* getNVTTCompressionOutputHandler(gpu::Texture* outputTexture, int face, nvtt::CompressionOptions& compressionOptions) {
-    auto outputFormat = outputTexture->getStoredMipFormat();
+nvtt::OutputHandler* getNVTTCompressionOutputHandler(gpu::Element outputFormat, CompressedMip& mip, nvtt::CompressionOptions& compressionOptions) {
     bool useNVTT = false;
 
     compressionOptions.setQuality(nvtt::Quality_Production);
@@ -590,13 +609,13 @@ nvtt::OutputHandler* getNVTTCompressionOutputHandler(gpu::Texture* outputTexture
 
     if (!useNVTT) {
         // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
-        return new PackedFloatOutputHandler(outputTexture, face, outputFormat);
+        return new PackedFloatOutputHandler(mip, outputFormat);
     } else {
-        return new OutputHandler(outputTexture, face);
+        return new OutputHandler(mip);
     }
 }
 
-void convertImageToHDRTexture(gpu::Texture* texture, Image&& image, BackendTarget target, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing, int face) {
+CompressedMips compressImageToHDRMips(Image&& image, gpu::Element mipFormat, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing) {
     assert(image.hasFloatFormat());
 
     Image localCopy = image.getConvertedToFormat(Image::Format_RGBAF);
@@ -604,45 +623,39 @@ void convertImageToHDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
     const int width = localCopy.getWidth();
     const int height = localCopy.getHeight();
 
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHeader(false);
-
-    nvtt::CompressionOptions compressionOptions;
-    std::unique_ptr<nvtt::OutputHandler> outputHandler{ getNVTTCompressionOutputHandler(texture, face, compressionOptions) };
-
-    MyErrorHandler errorHandler;
-    outputOptions.setErrorHandler(&errorHandler);
-    nvtt::Context context;
-    int mipLevel = baseMipLevel;
-
-    outputOptions.setOutputHandler(outputHandler.get());
-
     nvtt::Surface surface;
     surface.setImage(nvtt::InputFormat_RGBA_32F, width, height, 1, localCopy.getBits());
     surface.setAlphaMode(nvtt::AlphaMode_None);
     surface.setWrapMode(nvtt::WrapMode_Mirror);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
-    context.setTaskDispatcher(&dispatcher);
+    // Surface copies the memory, so free up the memory afterward to avoid bloating the heap
+    localCopy = Image();
 
-    context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-    if (buildMips) {
-        while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
-            surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-            context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-        }
-    }
+    return compressMipChain(surface, baseMipLevel, buildMips, abortProcessing, [&](const nvtt::Surface& mipSurface, CompressedMip& mip) {
+        nvtt::OutputOptions outputOptions;
+        outputOptions.setOutputHeader(false);
+
+        nvtt::CompressionOptions compressionOptions;
+        std::unique_ptr<nvtt::OutputHandler> outputHandler{ getNVTTCompressionOutputHandler(mipFormat, mip, compressionOptions) };
+
+        MyErrorHandler errorHandler;
+        outputOptions.setErrorHandler(&errorHandler);
+        outputOptions.setOutputHandler(outputHandler.get());
+
+        ParallelTaskDispatcher dispatcher(abortProcessing);
+        nvtt::Context context;
+        context.setTaskDispatcher(&dispatcher);
+
+        context.compress(mipSurface, 0, mip.level, compressionOptions, outputOptions);
+    });
 }
 
-void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarget target, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing, int face) {
+CompressedMips compressImageToLDRMips(Image&& image, gpu::Element mipFormat, BackendTarget target, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     Image localCopy = std::move(image);
 
     const int width = localCopy.getWidth(), height = localCopy.getHeight();
-    auto mipFormat = texture->getStoredMipFormat();
-    int mipLevel = baseMipLevel;
 
     if (target != BackendTarget::GLES32) {
         if (localCopy.getFormat() != Image::Format_ARGB32) {
@@ -749,26 +762,23 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
         } else {
             qCWarning(imagelogging) << "Unknown mip format";
             Q_UNREACHABLE();
-            return;
+            return CompressedMips();
         }
 
-        nvtt::OutputOptions outputOptions;
-        outputOptions.setOutputHeader(false);
-        OutputHandler outputHandler(texture, face);
-        outputOptions.setOutputHandler(&outputHandler);
-        MyErrorHandler errorHandler;
-        outputOptions.setErrorHandler(&errorHandler);
+        return compressMipChain(surface, baseMipLevel, buildMips, abortProcessing, [&](const nvtt::Surface& mipSurface, CompressedMip& mip) {
+            nvtt::OutputOptions outputOptions;
+            outputOptions.setOutputHeader(false);
+            OutputHandler outputHandler(mip);
+            outputOptions.setOutputHandler(&outputHandler);
+            MyErrorHandler errorHandler;
+            outputOptions.setErrorHandler(&errorHandler);
 
-        SequentialTaskDispatcher dispatcher(abortProcessing);
-        nvtt::Compressor context;
+            ParallelTaskDispatcher dispatcher(abortProcessing);
+            nvtt::Compressor context;
+            context.setTaskDispatcher(&dispatcher);
 
-        context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-        if (buildMips) {
-            while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
-                surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-                context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-            }
-        }
+            context.compress(mipSurface, 0, mip.level, compressionOptions, outputOptions);
+        });
     } else {
         int numMips = 1;
     
@@ -776,7 +786,7 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
             numMips += (int)log2(std::max(width, height)) - baseMipLevel;
         }
         assert(numMips > 0);
-        Etc::RawImage *mipMaps = new Etc::RawImage[numMips];
+        std::vector<Etc::RawImage> mipMaps(numMips);
         Etc::Image::Format etcFormat = Etc::Image::Format::DEFAULT;
 
         if (mipFormat == gpu::Element::COLOR_COMPRESSED_ETC2_RGB) {
@@ -802,14 +812,19 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
         } else {
             qCWarning(imagelogging) << "Unknown mip format";
             Q_UNREACHABLE();
-            return;
+            return CompressedMips();
         }
 
         const Etc::ErrorMetric errorMetric = Etc::ErrorMetric::RGBA;
         const float effort = 1.0f;
-        const int numEncodeThreads = 4;
+        // Etc runs its own threads, as many as the task pool has, so the faces and mips that go through here are
+        // compressed one at a time (see forEachCompression)
+        const int numEncodeThreads = tbb::this_task_arena::max_concurrency();
         int encodingTime;
 
+        if (abortProcessing.load()) {
+            return CompressedMips();
+        }
         if (localCopy.getFormat() != Image::Format_RGBAF) {
             localCopy = localCopy.getConvertedToFormat(Image::Format_RGBAF);
         }
@@ -819,46 +834,86 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
             etcFormat, errorMetric, effort,
             numEncodeThreads, numEncodeThreads,
             numMips, Etc::FILTER_WRAP_NONE,
-            mipMaps, &encodingTime
+            mipMaps.data(), &encodingTime
         );
 
+        CompressedMips mips(numMips);
         for (int i = 0; i < numMips; i++) {
-            if (mipMaps[i].paucEncodingBits.get()) {
-                if (face >= 0) {
-                    texture->assignStoredMipFace(i+baseMipLevel, face, mipMaps[i].uiEncodingBitsBytes, static_cast<const gpu::Byte*>(mipMaps[i].paucEncodingBits.get()));
-                } else {
-                    texture->assignStoredMip(i + baseMipLevel, mipMaps[i].uiEncodingBitsBytes, static_cast<const gpu::Byte*>(mipMaps[i].paucEncodingBits.get()));
-                }
+            mips[i].level = i + baseMipLevel;
+            const gpu::Byte* bits = static_cast<const gpu::Byte*>(mipMaps[i].paucEncodingBits.get());
+            if (bits) {
+                mips[i].data.assign(bits, bits + mipMaps[i].uiEncodingBitsBytes);
             }
         }
-
-        delete[] mipMaps;
+        return mips;
     }
 }
 
 #endif
 
-void convertImageToTexture(gpu::Texture* texture, Image& image, BackendTarget target, int face, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing) {
-    PROFILE_RANGE(resource_parse, "convertToTextureWithMips");
+CompressedMips compressImageToMips(Image&& image, gpu::Element mipFormat, BackendTarget target, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing) {
+    PROFILE_RANGE(resource_parse, "compressImageToMips");
 
     if (target == BackendTarget::GLES32) {
-        convertImageToLDRTexture(texture, std::move(image), target, baseMipLevel, buildMips, abortProcessing, face);
+        return compressImageToLDRMips(std::move(image), mipFormat, target, baseMipLevel, buildMips, abortProcessing);
     } else {
         if (image.hasFloatFormat()) {
-            convertImageToHDRTexture(texture, std::move(image), target, baseMipLevel, buildMips, abortProcessing, face);
+            return compressImageToHDRMips(std::move(image), mipFormat, baseMipLevel, buildMips, abortProcessing);
+        } else {
+            return compressImageToLDRMips(std::move(image), mipFormat, target, baseMipLevel, buildMips, abortProcessing);
+        }
+    }
+}
+
+void assignCompressedMips(gpu::Texture* texture, int face, const CompressedMips& mips) {
+    for (const auto& mip : mips) {
+        // the mips interrupted by an abort are dropped from the chain, but one that failed to compress is left empty
+        if (mip.data.empty()) {
+            continue;
+        }
+        if (face >= 0) {
+            texture->assignStoredMipFace(mip.level, face, mip.data.size(), mip.data.data());
         } else {
-            convertImageToLDRTexture(texture, std::move(image), target, baseMipLevel, buildMips, abortProcessing, face);
+            texture->assignStoredMip(mip.level, mip.data.size(), mip.data.data());
         }
     }
 }
 
+// Every face compressed at once holds its own float surface, so only a few of them run side by side; each one still
+// splits its blocks across the whole task pool. Etc starts its own encoding threads for every image instead, so on
+// GLES the faces are compressed one after the other.
+const int MAX_CONCURRENT_FACE_COMPRESSIONS = 2;
+
+template <typename F>
+void forEachCompression(int count, BackendTarget target, F compress) {
+    const int batchSize = (target == BackendTarget::GLES32) ? 1 : MAX_CONCURRENT_FACE_COMPRESSIONS;
+    for (int begin = 0; begin < count; begin += batchSize) {
+        tbb::parallel_for(begin, std::min(begin + batchSize, count), compress);
+    }
+}
+
 void convertToTextureWithMips(gpu::Texture* texture, Image&& image, BackendTarget target, const std::atomic<bool>& abortProcessing, int face) {
-    convertImageToTexture(texture, image, target, face, 0, true, abortProcessing);
+    PROFILE_RANGE(resource_parse, "convertToTextureWithMips");
+    auto mips = compressImageToMips(std::move(image), texture->getStoredMipFormat(), target, 0, true, abortProcessing);
+    assignCompressedMips(texture, face, mips);
 }
 
 void convertToTexture(gpu::Texture* texture, Image&& image, BackendTarget target, const std::atomic<bool>& abortProcessing, int face, int mipLevel) {
     PROFILE_RANGE(resource_parse, "convertToTexture");
-    convertImageToTexture(texture, image, target, face, mipLevel, false, abortProcessing);
+    auto mips = compressImageToMips(std::move(image), texture->getStoredMipFormat(), target, mipLevel, false, abortProcessing);
+    assignCompressedMips(texture, face, mips);
+}
+
+void convertToCubeTextureWithMips(gpu::Texture* texture, std::vector<Image>&& faces, BackendTarget target, const std::atomic<bool>& abortProcessing) {
+    PROFILE_RANGE(resource_parse, "convertToCubeTextureWithMips");
+    auto mipFormat = texture->getStoredMipFormat();
+    std::vector<CompressedMips> faceMips(faces.size());
+    forEachCompression((int)faces.size(), target, [&](int face) {
+        faceMips[face] = compressImageToMips(std::move(faces[face]), mipFormat, target, 0, true, abortProcessing);
+    });
+    for (int face = 0; face < (int)faceMips.size(); ++face) {
+        assignCompressedMips(texture, face, faceMips[face]);
+    }
 }
 
 void processTextureAlpha(const Image& srcImage, bool& validAlpha, bool& alphaAsMask) {
@@ -1491,10 +1546,17 @@ void convolveForGGX(const std::vector<Image>& faces, gpu::Texture* texture, Back
         output.applyGamma(1.0f/2.2f);
     }
 
-    for (int face = 0; face < 6; face++) {
-        for (gpu::uint16 mipLevel = 0; mipLevel < output.getMipCount(); mipLevel++) {
-            convertToTexture(texture, output.getFaceImage(mipLevel, face), target, abortProcessing, face, mipLevel);
-        }
+    // Every mip of every face is convolved already, so they can be compressed side by side
+    const int NUM_FACES = 6;
+    const int mipCount = output.getMipCount();
+    auto mipFormat = texture->getStoredMipFormat();
+    std::vector<CompressedMips> faceMips(NUM_FACES * mipCount);
+    forEachCompression((int)faceMips.size(), target, [&](int i) {
+        gpu::uint16 mipLevel = i % mipCount;
+        faceMips[i] = compressImageToMips(output.getFaceImage(mipLevel, i / mipCount), mipFormat, target, mipLevel, false, abortProcessing);
+    });
+    for (int i = 0; i < (int)faceMips.size(); i++) {
+        assignCompressedMips(texture, i / mipCount, faceMips[i]);
     }
 }
 
@@ -1600,11 +1662,8 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(Image&& srcIm
             // Performs and convolution AND mip map generation
             convolveForGGX(faces, theTexture.get(), target, abortProcessing);
         } else {
-            // Create mip maps and compress to final format in one go
-            for (uint8 face = 0; face < faces.size(); ++face) {
-                // Force building the mip maps right now on CPU if we are convolving for GGX later on
-                convertToTextureWithMips(theTexture.get(), std::move(faces[face]), target, abortProcessing, face);
-            }
+            // Create mip maps and compress to final format in one go, all the faces at once
+            convertToCubeTextureWithMips(theTexture.get(), std::move(faces), target, abortProcessing);
         }
     }
 
@@ -21,6 +21,9 @@
 
 namespace image {
 
+    // bump when a change to the processing changes the textures it makes, so that the ones made before aren't reused
+    const int TEXTURE_PROCESSING_VERSION = 1;
+
     std::function<gpu::uint32(const glm::vec3&)> getHDRPackingFunction();
     std::function<glm::vec3(gpu::uint32)> getHDRUnpackingFunction();
     void convertToFloatFromPacked(const unsigned char* source, int width, int height, size_t srcLineByteStride, gpu::Element sourceFormat, 
@@ -127,6 +130,8 @@ gpu::TexturePointer processImage(std::shared_ptr<QIODevice> content, const std::
 
 void convertToTextureWithMips(gpu::Texture* texture, Image&& image, gpu::BackendTarget target, const std::atomic<bool>& abortProcessing = false, int face = -1);
 void convertToTexture(gpu::Texture* texture, Image&& image, gpu::BackendTarget target, const std::atomic<bool>& abortProcessing = false, int face = -1, int mipLevel = 0);
+// Compresses the six faces of a cube texture, with their mips, side by side on the TBB task pool
+void convertToCubeTextureWithMips(gpu::Texture* texture, std::vector<Image>&& faces, gpu::BackendTarget target, const std::atomic<bool>& abortProcessing = false);
 
 } // namespace image
 
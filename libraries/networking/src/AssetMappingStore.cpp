@@ -0,0 +1,258 @@
+//
+//  AssetMappingStore.cpp
+//  libraries/networking/src
+//
+//  Created on 2019-11-29.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#include "NetworkLogging.h"
+
+static const QString LOG_FILE_SUFFIX = ".log";
+static const int RECORD_HEADER_SIZE = sizeof(quint32) + sizeof(quint16);
+static const QDataStream::Version LOG_STREAM_VERSION = QDataStream::Qt_5_6;
+
+bool AssetMappingStore::load(const QString& snapshotFilePath) {
+    _snapshotFilePath = snapshotFilePath;
+    _mappings.clear();
+    _hashReferences.clear();
+    return readSnapshot() && replayLog();
+}
+
+AssetMappingStore::FolderRange AssetMappingStore::getFolder(const AssetUtils::AssetPath& folder) const {
+    auto first = _mappings.lower_bound(folder);
+    if (folder.isEmpty() || folder.at(folder.size() - 1).unicode() == 0xFFFF) {
+        auto last = std::find_if(first, _mappings.end(), [&](const AssetUtils::Mappings::value_type& mapping) {
+            return !mapping.first.startsWith(folder);
+        });
+        return { first, last };
+    }
+    // the paths that start with folder sort before the ones that start with the next string of its length
+    AssetUtils::AssetPath next = folder;
+    next[next.size() - 1] = QChar(folder.at(folder.size() - 1).unicode() + 1);
+    return { first, _mappings.lower_bound(next) };
+}
+
+bool AssetMappingStore::commit(const Transaction& transaction) {
+    if (transaction.isEmpty()) {
+        return true;
+    }
+    if (!_log.isOpen()) {
+        qCWarning(networking) << "Cannot commit mappings before the mapping store is loaded";
+        return false;
+    }
+
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(LOG_STREAM_VERSION);
+        stream << (quint32)transaction._changes.size();
+        for (const auto& change : transaction._changes) {
+            stream << (quint8)change.operation << change.path;
+            if (change.operation == Transaction::SET) {
+                stream << change.hash;
+            }
+        }
+    }
+
+    quint32 payloadSize = (quint32)payload.size();
+    quint16 checksum = qChecksum(payload.constData(), payloadSize);
+    QByteArray record(RECORD_HEADER_SIZE, 0);
+    memcpy(record.data(), &payloadSize, sizeof(payloadSize));
+    memcpy(record.data() + sizeof(payloadSize), &checksum, sizeof(checksum));
+    record += payload;
+
+    if (_log.write(record) != record.size() || !_log.flush()) {
+        qCWarning(networking) << "Failed to append to mapping log at" << _log.fileName() << ":" << _log.errorString();
+        // don't leave a partial record for the next one to follow
+        _log.resize(_logSize);
+        _log.seek(_logSize);
+        return false;
+    }
+    _logSize += record.size();
+    apply(transaction);
+
+    if (_logSize > MIN_COMPACTION_LOG_SIZE && _logSize > _snapshotSize) {
+        // if this fails the transactions are still in the log, we'll try again after the next one
+        compact();
+    }
+    return true;
+}
+
+bool AssetMappingStore::compact() {
+    QSaveFile snapshotFile { _snapshotFilePath };
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qCWarning(networking) << "Failed to open map file at" << _snapshotFilePath;
+        return false;
+    }
+
+    QJsonObject root;
+    for (const auto& mapping : _mappings) {
+        root[mapping.first] = mapping.second;
+    }
+    QByteArray json = QJsonDocument(root).toJson();
+    if (snapshotFile.write(json) == -1 || !snapshotFile.commit()) {
+        qCWarning(networking) << "Failed to write JSON mappings to file at" << _snapshotFilePath;
+        return false;
+    }
+    _snapshotSize = json.size();
+
+    // replaying the log over the new snapshot would change nothing, so it doesn't matter if we go down before this
+    if (_log.isOpen() && (!_log.resize(0) || !_log.seek(0))) {
+        qCWarning(networking) << "Failed to empty mapping log at" << _log.fileName() << ":" << _log.errorString();
+    }
+    _logSize = _log.size();
+
+    qCDebug(networking) << "Compacted" << _mappings.size() << "mappings into" << _snapshotFilePath;
+    return true;
+}
+
+bool AssetMappingStore::readSnapshot() {
+    QFile snapshotFile { _snapshotFilePath };
+    if (!snapshotFile.exists()) {
+        qCInfo(networking) << "No existing mappings loaded from file since no file was found at" << _snapshotFilePath;
+        _snapshotSize = 0;
+        return true;
+    }
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        qCCritical(networking) << "Failed to read mapping file at" << _snapshotFilePath;
+        return false;
+    }
+    _snapshotSize = snapshotFile.size();
+
+    QJsonParseError error;
+    auto jsonDocument = QJsonDocument::fromJson(snapshotFile.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCCritical(networking) << "Failed to read mapping file at" << _snapshotFilePath;
+        return false;
+    }
+    if (!jsonDocument.isObject()) {
+        qCWarning(networking) << "Failed to read mapping file, root value in" << _snapshotFilePath << "is not an object";
+        return false;
+    }
+
+    auto root = jsonDocument.object();
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        auto key = it.key();
+        auto value = it.value();
+
+        if (!value.isString()) {
+            qCWarning(networking) << "Skipping" << key << ":" << value << "because it is not a string";
+            continue;
+        }
+
+        if (!AssetUtils::isValidFilePath(key)) {
+            qCWarning(networking) << "Will not keep mapping for" << key << "since it is not a valid path.";
+            continue;
+        }
+
+        if (!AssetUtils::isValidHash(value.toString())) {
+            qCWarning(networking) << "Will not keep mapping for" << key << "since it does not have a valid hash.";
+            continue;
+        }
+
+        _mappings[key] = value.toString();
+        _hashReferences[value.toString()]++;
+    }
+
+    qCInfo(networking) << "Loaded" << _mappings.size() << "mappings from map file at" << _snapshotFilePath;
+    return true;
+}
+
+bool AssetMappingStore::replayLog() {
+    _log.setFileName(_snapshotFilePath + LOG_FILE_SUFFIX);
+    if (!_log.open(QIODevice::ReadWrite)) {
+        qCCritical(networking) << "Failed to open mapping log at" << _log.fileName() << ":" << _log.errorString();
+        return false;
+    }
+
+    QByteArray contents = _log.readAll();
+    int offset = 0;
+    int numTransactions = 0;
+    while (offset + RECORD_HEADER_SIZE <= contents.size()) {
+        quint32 payloadSize;
+        quint16 checksum;
+        memcpy(&payloadSize, contents.constData() + offset, sizeof(payloadSize));
+        memcpy(&checksum, contents.constData() + offset + sizeof(payloadSize), sizeof(checksum));
+        if (payloadSize > (quint32)(contents.size() - offset - RECORD_HEADER_SIZE)) {
+            break;
+        }
+        const char* payloadData = contents.constData() + offset + RECORD_HEADER_SIZE;
+        if (qChecksum(payloadData, payloadSize) != checksum) {
+            break;
+        }
+
+        QByteArray payload = QByteArray::fromRawData(payloadData, (int)payloadSize);
+        QDataStream stream(payload);
+        stream.setVersion(LOG_STREAM_VERSION);
+        quint32 numChanges;
+        stream >> numChanges;
+        Transaction transaction;
+        for (quint32 i = 0; i < numChanges && stream.status() == QDataStream::Ok; i++) {
+            quint8 operation;
+            Transaction::Change change;
+            stream >> operation >> change.path;
+            change.operation = (Transaction::Operation)operation;
+            if (change.operation == Transaction::SET) {
+                stream >> change.hash;
+            }
+            transaction._changes.push_back(change);
+        }
+        if (stream.status() != QDataStream::Ok) {
+            break;
+        }
+
+        apply(transaction);
+        offset += RECORD_HEADER_SIZE + payloadSize;
+        numTransactions++;
+    }
+
+    if (offset < contents.size()) {
+        qCWarning(networking) << "Dropping the last" << contents.size() - offset << "bytes of the mapping log at"
+            << _log.fileName() << "since they are not a whole transaction";
+        _log.resize(offset);
+    }
+    _log.seek(offset);
+    _logSize = offset;
+
+    if (numTransactions > 0) {
+        qCInfo(networking) << "Replayed" << numTransactions << "mapping transactions from" << _log.fileName();
+    }
+    return true;
+}
+
+void AssetMappingStore::apply(const Transaction& transaction) {
+    for (const auto& change : transaction._changes) {
+        auto it = _mappings.find(change.path);
+        if (it != _mappings.end()) {
+            auto reference = _hashReferences.find(it->second);
+            if (--reference.value() == 0) {
+                _hashReferences.erase(reference);
+            }
+        }
+
+        if (change.operation == Transaction::SET) {
+            if (it != _mappings.end()) {
+                it->second = change.hash;
+            } else {
+                _mappings.emplace(change.path, change.hash);
+            }
+            _hashReferences[change.hash]++;
+        } else if (it != _mappings.end()) {
+            _mappings.erase(it);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+//
+//  AssetMappingStore.h
+//  libraries/networking/src
+//
+//  Created on 2019-11-29.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetMappingStore_h
+#define hifi_AssetMappingStore_h
+
+#include <utility>
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "AssetUtils.h"
+
+// The path => hash mappings of an asset server, kept on disk as a snapshot plus a log of the transactions committed
+// since. The snapshot is the JSON object of all the mappings the map file has always been; each transaction is
+// appended to the log next to it (the snapshot path with ".log" added) as one record:
+//
+//  payload size [4 bytes]
+//  payload checksum [2 bytes]
+//  payload: number of changes, then for each: operation, path, hash (for a set)
+//
+// so committing costs the size of the transaction rather than of all the mappings. A record that didn't make it to
+// disk whole, because the server went down while writing it, fails its checksum and is dropped with whatever follows
+// it when the log is replayed: a transaction is there all of it or not at all. Once the log outgrows the snapshot it is
+// compacted into a new one.
+class AssetMappingStore {
+public:
+    using FolderRange = std::pair<AssetUtils::Mappings::const_iterator, AssetUtils::Mappings::const_iterator>;
+
+    class Transaction {
+    public:
+        void set(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) { _changes.push_back({ SET, path, hash }); }
+        void remove(const AssetUtils::AssetPath& path) { _changes.push_back({ REMOVE, path, AssetUtils::AssetHash() }); }
+
+        bool isEmpty() const { return _changes.empty(); }
+        size_t size() const { return _changes.size(); }
+
+    private:
+        friend class AssetMappingStore;
+
+        enum Operation : uint8_t {
+            SET = 0,
+            REMOVE
+        };
+        struct Change {
+            Operation operation;
+            AssetUtils::AssetPath path;
+            AssetUtils::AssetHash hash;
+        };
+        std::vector<Change> _changes;
+    };
+
+    // the log is compacted once it's bigger than the snapshot, and than this
+    static const qint64 MIN_COMPACTION_LOG_SIZE = 1024 * 1024;
+
+    // loads the snapshot and replays the log, returns false if they can't be read
+    bool load(const QString& snapshotFilePath);
+
+    const AssetUtils::Mappings& getMappings() const { return _mappings; }
+    size_t size() const { return _mappings.size(); }
+    AssetUtils::Mappings::const_iterator find(const AssetUtils::AssetPath& path) const { return _mappings.find(path); }
+    AssetUtils::Mappings::const_iterator begin() const { return _mappings.begin(); }
+    AssetUtils::Mappings::const_iterator end() const { return _mappings.end(); }
+
+    // the mappings below folder (a path ending with a slash), in order
+    FolderRange getFolder(const AssetUtils::AssetPath& folder) const;
+
+    // whether any path maps to hash
+    bool isHashMapped(const AssetUtils::AssetHash& hash) const { return _hashReferences.contains(hash); }
+
+    // appends the transaction to the log and applies its changes in order, returns false and changes nothing if it
+    // can't be written
+    bool commit(const Transaction& transaction);
+
+    // writes the mappings to a new snapshot and empties the log
+    bool compact();
+
+    qint64 getLogSize() const { return _logSize; }
+
+private:
+    bool readSnapshot();
+    bool replayLog();
+    void apply(const Transaction& transaction);
+
+    QString _snapshotFilePath;
+    QFile _log;
+    qint64 _logSize { 0 };
+    qint64 _snapshotSize { 0 };
+
+    AssetUtils::Mappings _mappings;
+    QHash<AssetUtils::AssetHash, int> _hashReferences; // the number of paths mapped to each hash
+};
+
+#endif // hifi_AssetMappingStore_h
@@ -18,6 +18,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
 #include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QTcpSocket>
@@ -245,6 +246,8 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
 
         static QMultiHash<QUuid, PacketType> sourcedVersionDebugSuppressMap;
         static QMultiHash<HifiSockAddr, PacketType> versionDebugSuppressMap;
+        // packets can be verified on several receive threads at once (see udt::ReceiveShardPool)
+        static QMutex versionDebugSuppressMutex;
 
         bool hasBeenOutput = false;
         QString senderString;
@@ -252,6 +255,7 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
         QUuid sourceID;
 
         if (PacketTypeEnum::getNonSourcedPackets().contains(headerType)) {
+            QMutexLocker suppressLocker(&versionDebugSuppressMutex);
             hasBeenOutput = versionDebugSuppressMap.contains(senderSockAddr, headerType);
 
             if (!hasBeenOutput) {
@@ -263,6 +267,7 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
             if (sourceNode) {
                 sourceID = sourceNode->getUUID();
 
+                QMutexLocker suppressLocker(&versionDebugSuppressMutex);
                 hasBeenOutput = sourcedVersionDebugSuppressMap.contains(sourceID, headerType);
 
                 if (!hasBeenOutput) {
@@ -357,6 +362,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
                 // check if the HMAC-md5 hash in the header matches the hash we would expect
                 if (!sourceNodeHMACAuth || packetHeaderHash != expectedHash) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
+                    static QMutex hashDebugSuppressMutex;
+                    QMutexLocker suppressLocker(&hashDebugSuppressMutex);
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
                         qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
@@ -409,8 +416,7 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const Node&
     return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getAuthenticateHash());
 }
 
-qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-        HMACAuth* hmacAuth) {
+bool LimitedNodeList::prepareUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr, HMACAuth* hmacAuth) {
     Q_ASSERT(!packet.isPartOfMessage());
     Q_ASSERT_X(!packet.isReliable(), "LimitedNodeList::sendUnreliablePacket",
                "Trying to send a reliable packet unreliably.");
@@ -421,11 +427,19 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiS
         // findNodeWithAddr returns null for the address of the domain server
         if (!destinationNode.isNull()) {
             // This only suppresses individual unreliable packets, not unreliable packet lists
-            return ERROR_SENDING_PACKET_BYTES;
+            return false;
         }
     }
 
     fillPacketHeader(packet, hmacAuth);
+    return true;
+}
+
+qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
+        HMACAuth* hmacAuth) {
+    if (!prepareUnreliablePacket(packet, sockAddr, hmacAuth)) {
+        return ERROR_SENDING_PACKET_BYTES;
+    }
 
     return _nodeSocket.writePacket(packet, sockAddr);
 }
@@ -453,7 +467,9 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const HifiS
 
         return size;
     } else {
-        auto size = sendUnreliablePacket(*packet, sockAddr, hmacAuth);
+        // hand the packet itself to the socket so that a batched send doesn't have to copy it
+        auto size = prepareUnreliablePacket(*packet, sockAddr, hmacAuth) ?
+            _nodeSocket.writePacket(std::move(packet), sockAddr) : ERROR_SENDING_PACKET_BYTES;
         if (size < 0) {
             auto now = usecTimestampNow();
             if (now - _sendErrorStatsTime > ERROR_STATS_PERIOD_US) {
@@ -164,6 +164,11 @@ public:
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
+    // unreliable packets sent by the calling thread between these two calls are queued and written to the socket
+    // together on flush, when batched send is enabled on the node socket (see udt::Socket::beginSendBatch)
+    void beginSendBatch() { _nodeSocket.beginSendBatch(); }
+    qint64 flushSendBatch() { return _nodeSocket.flushSendBatch(); }
+
     std::function<void(Node*)> linkedDataCreateCallback;
 
     size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
@@ -308,6 +313,12 @@ public:
     void flagTimeForConnectionStep(ConnectionStep connectionStep);
 
     udt::Socket::StatsVector sampleStatsForAllConnections() { return _nodeSocket.sampleStatsForAllConnections(); }
+    bool isBatchedReceiveEnabled() const { return _nodeSocket.isBatchedReceiveEnabled(); }
+    udt::Socket::ReceiveBatchStats sampleReceiveBatchStats() { return _nodeSocket.sampleReceiveBatchStats(); }
+    bool isBatchedSendEnabled() const { return _nodeSocket.isBatchedSendEnabled(); }
+    udt::Socket::SendBatchStats sampleSendBatchStats() { return _nodeSocket.sampleSendBatchStats(); }
+    int getReceiveThreadCount() const { return _nodeSocket.getReceiveThreadCount(); }
+    std::vector<udt::ReceiveShardPool::ShardStats> sampleReceiveThreadStats() { return _nodeSocket.sampleReceiveThreadStats(); }
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
@@ -416,6 +427,7 @@ protected:
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode,
                       const HifiSockAddr& overridenSockAddr);
     void fillPacketHeader(const NLPacket& packet, HMACAuth* hmacAuth = nullptr);
+    bool prepareUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr, HMACAuth* hmacAuth);
 
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
@@ -12,7 +12,8 @@
 
 #include "PacketReceiver.h"
 
-#include <QMutexLocker>
+#include <QReadWriteLock>
+#include <QThread>
 
 #include "DependencyManager.h"
 #include "NetworkLogging.h"
@@ -72,7 +73,7 @@ void PacketReceiver::registerDirectListener(PacketType type, QObject* listener,
     
     bool success = registerListener(type, listener, slot);
     if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
+        QWriteLocker locker(&_directConnectSetLock);
         
         // if we successfully registered, add this object to the set of objects that are directly connected
         _directlyConnectedObjects.insert(listener);
@@ -87,7 +88,7 @@ void PacketReceiver::registerDirectListenerForTypes(PacketTypeList types,
     // just call register listener for types to start
     bool success = registerListenerForTypes(std::move(types), listener, slot);
     if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
+        QWriteLocker locker(&_directConnectSetLock);
         
         // if we successfully registered, add this object to the set of objects that are directly connected
         _directlyConnectedObjects.insert(listener);
@@ -167,7 +168,7 @@ QMetaMethod PacketReceiver::matchingMethodForListener(PacketType type, QObject*
 
 void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object, const QMetaMethod& slot, bool deliverPending) {
     Q_ASSERT_X(object, "PacketReceiver::registerVerifiedListener", "No object to register");
-    QMutexLocker locker(&_packetListenerLock);
+    QWriteLocker locker(&_packetListenerLock);
 
     if (_messageListenerMap.contains(type)) {
         qCWarning(networking) << "Registering a packet listener for packet type" << type
@@ -182,7 +183,7 @@ void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
     {
-        QMutexLocker packetListenerLocker(&_packetListenerLock);
+        QWriteLocker packetListenerLocker(&_packetListenerLock);
         
         // clear any registrations for this listener in _messageListenerMap
         auto it = _messageListenerMap.begin();
@@ -196,7 +197,7 @@ void PacketReceiver::unregisterListener(QObject* listener) {
         }
     }
     
-    QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
+    QWriteLocker directConnectSetLocker(&_directConnectSetLock);
     _directlyConnectedObjects.remove(listener);
 }
 
@@ -258,71 +259,95 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
     if (receivedMessage->getSourceID() != Node::NULL_LOCAL_ID) {
         matchingNode = nodeList->nodeWithLocalID(receivedMessage->getSourceID());
     }
-    QMutexLocker packetListenerLocker(&_packetListenerLock);
-    
-    auto it = _messageListenerMap.find(receivedMessage->getType());
-    if (it != _messageListenerMap.end() && it->method.isValid()) {
-         
-        auto listener = it.value();
 
-        if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
-            return;
-        }
-            
-        bool success = false;
-
-        Qt::ConnectionType connectionType;
-        // check if this is a directly connected listener
-        {
-            QMutexLocker directConnectLocker(&_directConnectSetMutex);
-            connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
-        }
+    bool listenerMissing = false;
+    bool listenerDestroyed = false;
+
+    {
+        // delivery only needs to read the listener map, so that receive shards don't serialize on each other here
+        // the read lock is held through the invoke so that unregisterListener still guarantees no further delivery
+        QReadLocker packetListenerLocker(&_packetListenerLock);
 
-        QMetaMethod metaMethod = listener.method;
+        auto it = _messageListenerMap.find(receivedMessage->getType());
+        if (it != _messageListenerMap.end() && it->method.isValid()) {
 
-        static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-        static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+            auto listener = it.value();
 
-        // one final check on the QPointer before we go to invoke
-        if (listener.object) {
-            if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                success = metaMethod.invoke(listener.object,
-                                            connectionType,
-                                            Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                            Q_ARG(SharedNodePointer, matchingNode));
+            if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
+                return;
+            }
+
+            bool success = false;
+
+            Qt::ConnectionType connectionType;
+            // check if this is a directly connected listener
+            {
+                QReadLocker directConnectLocker(&_directConnectSetLock);
+                connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
+            }
 
-            } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                success = metaMethod.invoke(listener.object,
-                                            connectionType,
-                                            Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                            Q_ARG(QSharedPointer<Node>, matchingNode));
+            if (connectionType == Qt::DirectConnection && QThread::currentThread() != thread()) {
+                // direct listeners were written to be called from the socket thread alone, so a packet for one that a
+                // receive shard verified goes back there instead of running next to the other shards
+                QMetaObject::invokeMethod(this, "handleVerifiedMessage", Qt::QueuedConnection,
+                                          Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                          Q_ARG(bool, justReceived));
+                return;
+            }
 
+            QMetaMethod metaMethod = listener.method;
+
+            static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+            static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+
+            // one final check on the QPointer before we go to invoke
+            if (listener.object) {
+                if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
+                    success = metaMethod.invoke(listener.object,
+                                                connectionType,
+                                                Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                                Q_ARG(SharedNodePointer, matchingNode));
+
+                } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+                    success = metaMethod.invoke(listener.object,
+                                                connectionType,
+                                                Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                                Q_ARG(QSharedPointer<Node>, matchingNode));
+
+                } else {
+                    success = metaMethod.invoke(listener.object,
+                                                connectionType,
+                                                Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+                }
             } else {
-                success = metaMethod.invoke(listener.object,
-                                            connectionType,
-                                            Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+                qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
+                    << " has been destroyed. Removing from listener map.";
+                listenerDestroyed = true;
             }
-        } else {
-            qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
-                << " has been destroyed. Removing from listener map.";
-            it = _messageListenerMap.erase(it);
 
-            // if it exists, remove the listener from _directlyConnectedObjects
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
-                _directlyConnectedObjects.remove(listener.object);
+            if (!success) {
+                qCDebug(networking).nospace() << "Error delivering packet " << receivedMessage->getType() << " to listener "
+                    << listener.object << "::" << qPrintable(listener.method.methodSignature());
             }
-        }
 
-        if (!success) {
-            qCDebug(networking).nospace() << "Error delivering packet " << receivedMessage->getType() << " to listener "
-                << listener.object << "::" << qPrintable(listener.method.methodSignature());
+        } else if (it == _messageListenerMap.end()) {
+            qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
+            listenerMissing = true;
         }
+    }
 
-    } else if (it == _messageListenerMap.end()) {
-        qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
-        
-        // insert a dummy listener so we don't print this again
-        _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
+    if (listenerDestroyed || listenerMissing) {
+        QWriteLocker packetListenerLocker(&_packetListenerLock);
+
+        auto it = _messageListenerMap.find(receivedMessage->getType());
+        if (listenerDestroyed) {
+            // another thread may have re-registered this type while we were waiting for the write lock
+            if (it != _messageListenerMap.end() && it->method.isValid() && !it->object) {
+                _messageListenerMap.erase(it);
+            }
+        } else if (it == _messageListenerMap.end()) {
+            // insert a dummy listener so we don't print this again
+            _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
+        }
     }
 }
@@ -18,9 +18,9 @@
 
 #include <QtCore/QMap>
 #include <QtCore/QMetaMethod>
-#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
 
 #include "NLPacket.h"
@@ -70,7 +70,8 @@ private:
         bool deliverPending;
     };
 
-    void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
+    // invokable so that a receive shard can hand a packet for a direct listener back to the socket thread
+    Q_INVOKABLE void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
 
     // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
     // should be changed to have a true event loop and be able to handle our QMetaMethod::invoke
@@ -80,11 +81,11 @@ private:
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
     void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot, bool deliverPending = false);
 
-    QMutex _packetListenerLock;
+    QReadWriteLock _packetListenerLock;
     QHash<PacketType, Listener> _messageListenerMap;
 
     bool _shouldDropPackets = false;
-    QMutex _directConnectSetMutex;
+    QReadWriteLock _directConnectSetLock;
     QSet<QObject*> _directlyConnectedObjects;
 
     std::unordered_map<std::pair<HifiSockAddr, udt::Packet::MessageNumber>, QSharedPointer<ReceivedMessage>> _pendingMessages;
@@ -89,6 +89,7 @@ public:
     const PacketStreamStats& getStats() const { return _stats; }
     PacketStreamStats getStatsForHistoryWindow() const;
     PacketStreamStats getStatsForLastHistoryInterval() const;
+    quint16 getLastReceivedSequence() const { return _lastReceivedSequence; }
     const QSet<quint16>& getMissingSet() const { return _missingSet; }
 
 private:
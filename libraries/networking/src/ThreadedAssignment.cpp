@@ -119,6 +119,45 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_kbps"] = nodeList->getOutboundKbps();
     ioStats["outbound_pps"] = nodeList->getOutboundPPS();
 
+    if (nodeList->isBatchedReceiveEnabled()) {
+        auto receiveBatchStats = nodeList->sampleReceiveBatchStats();
+        QJsonObject receiveBatchObject;
+        receiveBatchObject["batches"] = (double)receiveBatchStats.batches;
+        receiveBatchObject["datagrams"] = (double)receiveBatchStats.datagrams;
+        receiveBatchObject["avg_batch_size"] = receiveBatchStats.batches > 0 ?
+            (float)receiveBatchStats.datagrams / (float)receiveBatchStats.batches : 0.0f;
+        receiveBatchObject["max_batch_size"] = (int)receiveBatchStats.maxBatchSize;
+        receiveBatchObject["pool_hits"] = (double)receiveBatchStats.poolHits;
+        receiveBatchObject["pool_misses"] = (double)receiveBatchStats.poolMisses;
+        receiveBatchObject["truncated_datagrams"] = (double)receiveBatchStats.truncatedDatagrams;
+        ioStats["receive_batching"] = receiveBatchObject;
+    }
+
+    if (nodeList->isBatchedSendEnabled()) {
+        auto sendBatchStats = nodeList->sampleSendBatchStats();
+        QJsonObject sendBatchObject;
+        sendBatchObject["batches"] = (double)sendBatchStats.batches;
+        sendBatchObject["datagrams"] = (double)sendBatchStats.datagrams;
+        sendBatchObject["syscalls"] = (double)sendBatchStats.syscalls;
+        sendBatchObject["syscalls_per_datagram"] = sendBatchStats.datagrams > 0 ?
+            (float)sendBatchStats.syscalls / (float)sendBatchStats.datagrams : 0.0f;
+        sendBatchObject["segmented_datagrams"] = (double)sendBatchStats.segmentedDatagrams;
+        sendBatchObject["copied_datagrams"] = (double)sendBatchStats.copiedDatagrams;
+        ioStats["send_batching"] = sendBatchObject;
+    }
+
+    if (nodeList->getReceiveThreadCount() > 0) {
+        QJsonArray receiveThreadsArray;
+        for (auto& threadStats : nodeList->sampleReceiveThreadStats()) {
+            QJsonObject threadObject;
+            threadObject["processed"] = (double)threadStats.processed;
+            threadObject["dropped"] = (double)threadStats.dropped;
+            threadObject["max_queue_size"] = (double)threadStats.maxQueueSize;
+            receiveThreadsArray.push_back(threadObject);
+        }
+        ioStats["receive_threads"] = receiveThreadsArray;
+    }
+
     statsObject["io_stats"] = ioStats;
 
     QJsonObject assignmentStats;
@@ -12,6 +12,7 @@
 #include "BasePacket.h"
 
 #include "../NetworkLogging.h"
+#include "PacketBufferPool.h"
 
 using namespace udt;
 
@@ -60,7 +61,18 @@ BasePacket::BasePacket(qint64 size) {
     Q_ASSERT(size >= 0 || size < maxPayload);
     
     _packetSize = size;
-    _packet.reset(new char[_packetSize]());
+
+    auto& bufferPool = PacketBufferPool::getInstance();
+    if (_packetSize <= PacketBufferPool::BUFFER_SIZE && bufferPool.isThreadPooling()) {
+        // building packets in a burst on this thread, recycle a buffer instead of going to the heap
+        _packet = bufferPool.acquireForThread();
+        _hasPooledBuffer = true;
+        memset(_packet.get(), 0, _packetSize);
+    } else {
+        _packet.reset(new char[_packetSize]());
+        PacketBufferPool::recordThreadAllocation();
+    }
+
     _payloadCapacity = _packetSize;
     _payloadSize = 0;
     _payloadStart = _packet.get();
@@ -77,9 +89,16 @@ BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSock
     
 }
 
+BasePacket::~BasePacket() {
+    if (_hasPooledBuffer && _packet) {
+        PacketBufferPool::getInstance().release(std::move(_packet));
+    }
+}
+
 BasePacket& BasePacket::operator=(const BasePacket& other) {
     _packetSize = other._packetSize;
     _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    _hasPooledBuffer = false;
     memcpy(_packet.get(), other._packet.get(), _packetSize);
     
     _payloadStart = _packet.get() + (other._payloadStart - other._packet.get());
@@ -105,6 +124,8 @@ BasePacket::BasePacket(BasePacket&& other) {
 BasePacket& BasePacket::operator=(BasePacket&& other) {
     _packetSize = other._packetSize;
     _packet = std::move(other._packet);
+    _hasPooledBuffer = other._hasPooledBuffer;
+    other._hasPooledBuffer = false;
     
     _payloadStart = other._payloadStart;
     _payloadCapacity = other._payloadCapacity;
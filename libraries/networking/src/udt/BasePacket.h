@@ -32,6 +32,8 @@ public:
     static std::unique_ptr<BasePacket> create(qint64 size = -1);
     static std::unique_ptr<BasePacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
                                                           const HifiSockAddr& senderSockAddr);
+
+    virtual ~BasePacket();
     
     // Current level's header size
     static int localHeaderSize();
@@ -84,6 +86,10 @@ public:
 
     void setReceiveTime(p_high_resolution_clock::time_point receiveTime) { _receiveTime = receiveTime; }
     p_high_resolution_clock::time_point getReceiveTime() const { return _receiveTime; }
+
+    // Marks the packet's memory as coming from the PacketBufferPool, it is handed back to the pool on destruction
+    void setHasPooledBuffer(bool hasPooledBuffer) { _hasPooledBuffer = hasPooledBuffer; }
+    bool hasPooledBuffer() const { return _hasPooledBuffer; }
     
 protected:
     BasePacket(qint64 size);
@@ -101,6 +107,7 @@ protected:
     
     qint64 _packetSize = 0;        // Total size of the allocated memory
     std::unique_ptr<char[]> _packet; // Allocated memory
+    bool _hasPooledBuffer { false }; // _packet is PacketBufferPool::BUFFER_SIZE bytes owned by the pool
     
     char* _payloadStart = nullptr; // Start of the payload
     qint64 _payloadCapacity = 0;          // Total capacity of the payload
@@ -0,0 +1,112 @@
+//
+//  ConnectionLookupTable.cpp
+//  libraries/networking/src/udt
+//
+//  Created on 2019-11-07.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ConnectionLookupTable.h"
+
+#include <thread>
+
+using namespace udt;
+
+// tables are told apart by id rather than address in the per-thread slot caches, a new table can reuse the address
+// of one that was deleted
+static std::atomic<uint64_t> nextTableID { 1 };
+
+ConnectionLookupTable::ConnectionLookupTable() :
+    _id(nextTableID++),
+    _snapshot(new Snapshot())
+{
+}
+
+ConnectionLookupTable::~ConnectionLookupTable() {
+    delete _snapshot.load();
+}
+
+Connection* ConnectionLookupTable::find(const HifiSockAddr& sockAddr) const {
+    Connection* connection = nullptr;
+
+    withSnapshot([&](const Snapshot& snapshot) {
+        auto it = snapshot.find(sockAddr);
+        if (it != snapshot.end()) {
+            connection = it->second;
+        }
+    });
+
+    return connection;
+}
+
+size_t ConnectionLookupTable::getNumReaderSlots() const {
+    std::lock_guard<std::mutex> lock(_readerSlotsMutex);
+    return _readerSlots.size();
+}
+
+ConnectionLookupTable::ReaderSlot& ConnectionLookupTable::getReaderSlot() const {
+    // a thread mostly reads from the one table, so remember the last slot before looking in the others
+    thread_local uint64_t lastTableID { 0 };
+    thread_local ReaderSlot* lastSlot { nullptr };
+    if (lastTableID == _id) {
+        return *lastSlot;
+    }
+
+    thread_local std::unordered_map<uint64_t, ReaderSlot*> threadSlots;
+    auto& slot = threadSlots[_id];
+    if (!slot) {
+        std::lock_guard<std::mutex> lock(_readerSlotsMutex);
+        _readerSlots.emplace_back(new ReaderSlot());
+        slot = _readerSlots.back().get();
+    }
+
+    lastTableID = _id;
+    lastSlot = slot;
+    return *slot;
+}
+
+ConnectionLookupTable::ReaderSlot& ConnectionLookupTable::enterRead() const {
+    auto& slot = getReaderSlot();
+    if (slot.depth++ == 0) {
+        // sequentially consistent, so that either the writer sees this slot taken or we see its new snapshot
+        slot.epoch.store(_epoch.load() + 1);
+    }
+    return slot;
+}
+
+void ConnectionLookupTable::exitRead(ReaderSlot& slot) const {
+    if (--slot.depth == 0) {
+        slot.epoch.store(0, std::memory_order_release);
+    }
+}
+
+void ConnectionLookupTable::publish(Snapshot snapshot) {
+    auto previous = _snapshot.exchange(new Snapshot(std::move(snapshot)));
+
+    // readers that enter from now on announce the new epoch and can only see the new snapshot
+    auto previousEpoch = _epoch.fetch_add(1);
+
+    // wait out the readers that may still be holding the previous snapshot, a lookup is short so spin for a bit first
+    {
+        std::lock_guard<std::mutex> lock(_readerSlotsMutex);
+        for (auto& slot : _readerSlots) {
+            int spins = 0;
+            while (true) {
+                auto readerEpoch = slot->epoch.load();
+                if (readerEpoch == 0 || readerEpoch > previousEpoch + 1) {
+                    break;
+                }
+                static const int MAX_SPINS = 128;
+                if (++spins > MAX_SPINS) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    delete previous;
+    ++_numPublishes;
+}
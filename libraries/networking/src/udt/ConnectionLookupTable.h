@@ -0,0 +1,89 @@
+//
+//  ConnectionLookupTable.h
+//  libraries/networking/src/udt
+//
+//  Created on 2019-11-07.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ConnectionLookupTable_h
+#define hifi_ConnectionLookupTable_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+class Connection;
+
+// Read-copy-update view of the connections a Socket owns.
+// Readers never lock: they look up in the current immutable snapshot after announcing, in a slot of their own, the
+// epoch they entered in. Each thread gets its slot, on its own cache line, the first time it reads from a table, so
+// readers on different threads never write to the same memory. Writers build a whole new snapshot, swap it in and
+// wait for the slots still showing an earlier epoch to clear before freeing the old one. This only covers the map
+// itself, the Connection objects it points to are still owned (and deleted) by the Socket.
+class ConnectionLookupTable {
+public:
+    using Snapshot = std::unordered_map<HifiSockAddr, Connection*>;
+
+    ConnectionLookupTable();
+    ~ConnectionLookupTable();
+
+    ConnectionLookupTable(const ConnectionLookupTable&) = delete;
+    ConnectionLookupTable& operator=(const ConnectionLookupTable&) = delete;
+
+    // returns the connection for sockAddr in the current snapshot, or nullptr
+    Connection* find(const HifiSockAddr& sockAddr) const;
+
+    // calls function with the current snapshot, it must not call publish
+    template <typename F>
+    void withSnapshot(F function) const {
+        auto& slot = enterRead();
+        function(*_snapshot.load());
+        exitRead(slot);
+    }
+
+    // replaces the current snapshot, calls to publish must be serialized by the caller
+    // returns once no reader can still be looking at the previous snapshot
+    void publish(Snapshot snapshot);
+
+    uint64_t getNumPublishes() const { return _numPublishes.load(std::memory_order_relaxed); }
+
+    // the number of threads that have read from the table
+    size_t getNumReaderSlots() const;
+
+private:
+    // one per reading thread, it holds the epoch the thread entered in plus one while it reads and zero otherwise
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch { 0 };
+        int depth { 0 }; // nested reads, only touched by the owning thread
+    };
+
+    ReaderSlot& enterRead() const;
+    void exitRead(ReaderSlot& slot) const;
+    ReaderSlot& getReaderSlot() const;
+
+    const uint64_t _id;
+    std::atomic<const Snapshot*> _snapshot;
+    std::atomic<uint64_t> _epoch { 0 };
+
+    // slots stay with the table once their thread is gone, there's only ever a handful of threads reading a socket
+    mutable std::mutex _readerSlotsMutex;
+    mutable std::vector<std::unique_ptr<ReaderSlot>> _readerSlots;
+
+    std::atomic<uint64_t> _numPublishes { 0 };
+};
+
+} // namespace udt
+
+#endif // hifi_ConnectionLookupTable_h
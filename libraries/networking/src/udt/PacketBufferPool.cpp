@@ -0,0 +1,181 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Created on 2019-11-04.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <QtCore/QtGlobal>
+
+using namespace udt;
+
+PacketBufferPool& PacketBufferPool::getInstance() {
+    static PacketBufferPool instance;
+    return instance;
+}
+
+PacketBufferPool::Buffer PacketBufferPool::acquire() {
+    {
+        Lock lock(_freeBuffersMutex);
+        if (!_freeBuffers.empty()) {
+            auto buffer = std::move(_freeBuffers.back());
+            _freeBuffers.pop_back();
+            ++_hits;
+            return buffer;
+        }
+    }
+
+    ++_misses;
+    return Buffer(new char[BUFFER_SIZE]);
+}
+
+size_t PacketBufferPool::acquire(std::vector<Buffer>& buffers, size_t numBuffers) {
+    size_t numTaken = takeFree(buffers, numBuffers);
+
+    _hits += numTaken;
+    _misses += numBuffers - numTaken;
+
+    for (size_t i = numTaken; i < numBuffers; ++i) {
+        buffers.emplace_back(new char[BUFFER_SIZE]);
+    }
+
+    return numTaken;
+}
+
+void PacketBufferPool::release(Buffer buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    auto& threadCache = getThreadCache();
+    if (threadCache.depth > 0 && threadCache.buffers.size() < THREAD_CACHE_SIZE) {
+        // keep it for the next packet this thread builds, without touching the shared list
+        threadCache.buffers.push_back(std::move(buffer));
+        ++_recycled;
+        return;
+    }
+
+    {
+        Lock lock(_freeBuffersMutex);
+        if (_freeBuffers.size() < _maxFreeBuffers) {
+            _freeBuffers.push_back(std::move(buffer));
+            ++_recycled;
+            return;
+        }
+    }
+
+    // the pool is full, let the buffer go back to the heap (outside of the lock)
+    ++_discarded;
+}
+
+void PacketBufferPool::setMaxFreeBuffers(size_t maxFreeBuffers) {
+    Lock lock(_freeBuffersMutex);
+    _maxFreeBuffers = maxFreeBuffers;
+    if (_freeBuffers.size() > _maxFreeBuffers) {
+        _freeBuffers.resize(_maxFreeBuffers);
+    }
+}
+
+size_t PacketBufferPool::getNumFreeBuffers() {
+    Lock lock(_freeBuffersMutex);
+    return _freeBuffers.size();
+}
+
+size_t PacketBufferPool::takeFree(std::vector<Buffer>& buffers, size_t numBuffers) {
+    size_t numTaken = 0;
+    Lock lock(_freeBuffersMutex);
+    while (numTaken < numBuffers && !_freeBuffers.empty()) {
+        buffers.push_back(std::move(_freeBuffers.back()));
+        _freeBuffers.pop_back();
+        ++numTaken;
+    }
+    return numTaken;
+}
+
+void PacketBufferPool::spillFree(std::vector<Buffer>& buffers, size_t keep) {
+    size_t numDiscarded = 0;
+    {
+        Lock lock(_freeBuffersMutex);
+        while (buffers.size() > keep) {
+            if (_freeBuffers.size() < _maxFreeBuffers) {
+                _freeBuffers.push_back(std::move(buffers.back()));
+            } else {
+                ++numDiscarded;
+            }
+            buffers.pop_back();
+        }
+    }
+    _discarded += numDiscarded;
+}
+
+PacketBufferPool::Stats PacketBufferPool::sampleStats() {
+    Stats stats;
+    stats.hits = _hits.exchange(0);
+    stats.misses = _misses.exchange(0);
+    stats.recycled = _recycled.exchange(0);
+    stats.discarded = _discarded.exchange(0);
+    return stats;
+}
+
+PacketBufferPool::ThreadCache& PacketBufferPool::getThreadCache() {
+    thread_local ThreadCache threadCache;
+    return threadCache;
+}
+
+void PacketBufferPool::beginThreadPooling() {
+    ++getThreadCache().depth;
+}
+
+void PacketBufferPool::endThreadPooling() {
+    auto& threadCache = getThreadCache();
+    Q_ASSERT(threadCache.depth > 0);
+    if (--threadCache.depth == 0 && threadCache.buffers.size() > THREAD_CACHE_REFILL) {
+        // keep enough to start the next burst, the rest can serve the socket thread and the other pooling threads
+        spillFree(threadCache.buffers, THREAD_CACHE_REFILL);
+    }
+}
+
+bool PacketBufferPool::isThreadPooling() const {
+    return getThreadCache().depth > 0;
+}
+
+PacketBufferPool::Buffer PacketBufferPool::acquireForThread() {
+    auto& threadCache = getThreadCache();
+    if (threadCache.depth == 0) {
+        return Buffer();
+    }
+
+    if (threadCache.buffers.empty()) {
+        // refill in one go, whatever other threads gave back since the last time
+        takeFree(threadCache.buffers, THREAD_CACHE_REFILL);
+    }
+
+    if (!threadCache.buffers.empty()) {
+        auto buffer = std::move(threadCache.buffers.back());
+        threadCache.buffers.pop_back();
+        ++_hits;
+        ++threadCache.stats.pooled;
+        return buffer;
+    }
+
+    ++_misses;
+    ++threadCache.stats.allocated;
+    return Buffer(new char[BUFFER_SIZE]);
+}
+
+void PacketBufferPool::recordThreadAllocation() {
+    ++getThreadCache().stats.allocated;
+}
+
+PacketBufferPool::ThreadStats PacketBufferPool::sampleThreadStats() {
+    auto& threadCache = getThreadCache();
+    auto stats = threadCache.stats;
+    threadCache.stats = ThreadStats();
+    return stats;
+}
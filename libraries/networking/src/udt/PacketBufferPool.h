@@ -0,0 +1,120 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Created on 2019-11-04.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Constants.h"
+
+namespace udt {
+
+// Process wide free list of MTU sized packet buffers.
+// Packets that were handed a pooled buffer give it back here when they are destroyed, on whatever thread that happens,
+// so that the socket thread can recycle it for the next datagram instead of going back to the heap.
+//
+// A thread that builds many packets in a burst (the mixer slaves, once per frame) can also bracket that burst with
+// beginThreadPooling/endThreadPooling. Packets constructed on that thread in between then draw their buffer from a
+// cache local to the thread, which is refilled from the shared free list in batches. When the outermost
+// endThreadPooling returns, the buffers the cache holds beyond one refill are spilled back to the shared free list in one
+// batch, so that they are not left idle on the thread until its next burst.
+class PacketBufferPool {
+    using Mutex = std::mutex;
+    using Lock = std::lock_guard<Mutex>;
+
+public:
+    using Buffer = std::unique_ptr<char[]>;
+
+    struct Stats {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        uint64_t recycled { 0 };
+        uint64_t discarded { 0 };
+    };
+
+    // packet buffers handed out to one thread, split by where they came from
+    struct ThreadStats {
+        uint64_t pooled { 0 };
+        uint64_t allocated { 0 };
+    };
+
+    static const int BUFFER_SIZE = MAX_PACKET_SIZE;
+    static const size_t DEFAULT_MAX_FREE_BUFFERS = 4096;
+    static const size_t THREAD_CACHE_SIZE = 256;
+    static const size_t THREAD_CACHE_REFILL = 32;
+
+    static PacketBufferPool& getInstance();
+
+    // returns a buffer of BUFFER_SIZE bytes, re-using a free one if there is one
+    Buffer acquire();
+
+    // appends numBuffers buffers to the passed vector, taking the pool lock once
+    // returns how many of them were re-used from the free list
+    size_t acquire(std::vector<Buffer>& buffers, size_t numBuffers);
+
+    // gives a buffer of BUFFER_SIZE bytes back to the pool, it is freed if the pool is already full
+    void release(Buffer buffer);
+
+    void setMaxFreeBuffers(size_t maxFreeBuffers);
+    size_t getNumFreeBuffers();
+
+    // returns the counters accumulated since the last call and resets them
+    Stats sampleStats();
+
+    // calls can be nested, the thread keeps up to THREAD_CACHE_REFILL buffers in its cache between bursts
+    void beginThreadPooling();
+    void endThreadPooling();
+    bool isThreadPooling() const;
+
+    // returns a buffer from the calling thread's cache, or nullptr if the thread is not pooling
+    Buffer acquireForThread();
+
+    // counts a packet buffer the calling thread had to allocate outside of the pool
+    static void recordThreadAllocation();
+
+    // returns the calling thread's counters accumulated since its last call and resets them
+    static ThreadStats sampleThreadStats();
+
+private:
+    PacketBufferPool() = default;
+
+    struct ThreadCache {
+        int depth { 0 };
+        std::vector<Buffer> buffers;
+        ThreadStats stats;
+    };
+    static ThreadCache& getThreadCache();
+
+    // moves up to numBuffers free buffers to the passed vector, without allocating any, returns how many it moved
+    size_t takeFree(std::vector<Buffer>& buffers, size_t numBuffers);
+
+    // moves the buffers past the first keep ones of the passed vector to the free list, taking the lock once
+    void spillFree(std::vector<Buffer>& buffers, size_t keep);
+
+    Mutex _freeBuffersMutex;
+    std::vector<Buffer> _freeBuffers;
+    size_t _maxFreeBuffers { DEFAULT_MAX_FREE_BUFFERS };
+
+    std::atomic<uint64_t> _hits { 0 };
+    std::atomic<uint64_t> _misses { 0 };
+    std::atomic<uint64_t> _recycled { 0 };
+    std::atomic<uint64_t> _discarded { 0 };
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
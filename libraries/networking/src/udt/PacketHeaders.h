@@ -136,6 +136,7 @@ public:
         BulkAvatarTraitsAck,
         StopInjector,
         AvatarZonePresence,
+        EntityDataAck,
         NUM_PACKET_TYPE
     };
 
@@ -157,6 +158,7 @@ public:
             << PacketTypeEnum::Value::NodeJsonStats
             << PacketTypeEnum::Value::EntityQuery
             << PacketTypeEnum::Value::OctreeDataNack
+            << PacketTypeEnum::Value::EntityDataAck
             << PacketTypeEnum::Value::EntityEditNack
             << PacketTypeEnum::Value::DomainListRequest
             << PacketTypeEnum::Value::StopNode
@@ -277,6 +279,7 @@ enum class EntityVersion : PacketVersion {
     ShadowBiasAndDistance,
     TextEntityFonts,
     ScriptServerKinematicMotion,
+    KinematicDeltas,
 
     // Add new versions above here
     NUM_PACKET_TYPE,
@@ -0,0 +1,109 @@
+//
+//  ReceiveShardPool.cpp
+//  libraries/networking/src/udt
+//
+//  Created on 2019-11-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceiveShardPool.h"
+
+#include "Packet.h"
+
+using namespace udt;
+
+ReceiveShardPool::ReceiveShardPool(int numShards, PacketProcessor processor) :
+    _processor(std::move(processor))
+{
+    Q_ASSERT(numShards > 0);
+
+    for (int i = 0; i < numShards; ++i) {
+        auto shard = std::unique_ptr<Shard>(new Shard(_processor));
+        shard->setObjectName(QString("ReceiveShard %1").arg(i));
+        shard->start();
+        _shards.push_back(std::move(shard));
+    }
+}
+
+ReceiveShardPool::~ReceiveShardPool() {
+    for (auto& shard : _shards) {
+        shard->stop();
+    }
+    for (auto& shard : _shards) {
+        shard->wait();
+    }
+}
+
+void ReceiveShardPool::queuePacket(std::unique_ptr<Packet> packet) {
+    auto index = std::hash<HifiSockAddr>()(packet->getSenderSockAddr()) % _shards.size();
+    _shards[index]->queuePacket(std::move(packet));
+}
+
+std::vector<ReceiveShardPool::ShardStats> ReceiveShardPool::sampleStats() {
+    std::vector<ShardStats> stats;
+    stats.reserve(_shards.size());
+    for (auto& shard : _shards) {
+        stats.push_back(shard->sampleStats());
+    }
+    return stats;
+}
+
+void ReceiveShardPool::Shard::queuePacket(std::unique_ptr<Packet> packet) {
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        if (_queue.size() >= MAX_QUEUED_PACKETS_PER_SHARD) {
+            ++_dropped;
+            return;
+        }
+        _queue.push_back(std::move(packet));
+
+        auto queueSize = (uint32_t)_queue.size();
+        if (queueSize > _maxQueueSize.load(std::memory_order_relaxed)) {
+            _maxQueueSize.store(queueSize, std::memory_order_relaxed);
+        }
+    }
+    _queueCondition.notify_one();
+}
+
+void ReceiveShardPool::Shard::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stopping = true;
+    }
+    _queueCondition.notify_one();
+}
+
+ReceiveShardPool::ShardStats ReceiveShardPool::Shard::sampleStats() {
+    ShardStats stats;
+    stats.processed = _processed.exchange(0);
+    stats.dropped = _dropped.exchange(0);
+    stats.maxQueueSize = _maxQueueSize.exchange(0);
+    return stats;
+}
+
+void ReceiveShardPool::Shard::run() {
+    std::vector<std::unique_ptr<Packet>> packets;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueCondition.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_stopping) {
+                // anything still queued is dropped with the pool
+                return;
+            }
+
+            // take everything that is queued so the socket thread only waits on us for a swap
+            packets.swap(_queue);
+        }
+
+        for (auto& packet : packets) {
+            _processor(std::move(packet));
+            ++_processed;
+        }
+        packets.clear();
+    }
+}
@@ -0,0 +1,90 @@
+//
+//  ReceiveShardPool.h
+//  libraries/networking/src/udt
+//
+//  Created on 2019-11-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ReceiveShardPool_h
+#define hifi_ReceiveShardPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QThread>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+class Packet;
+
+// A fixed set of threads that run the verification and handling of received packets off of the socket thread.
+// Packets are sharded by their sender address, so every packet from a given sender is processed by the same thread
+// and in the order it was queued.
+class ReceiveShardPool {
+public:
+    using PacketProcessor = std::function<void(std::unique_ptr<Packet>)>;
+
+    struct ShardStats {
+        uint64_t processed { 0 };
+        uint64_t dropped { 0 };
+        uint32_t maxQueueSize { 0 };
+    };
+
+    // packets queued to a shard that already has this many waiting are dropped
+    static const size_t MAX_QUEUED_PACKETS_PER_SHARD = 8192;
+
+    ReceiveShardPool(int numShards, PacketProcessor processor);
+    ~ReceiveShardPool();
+
+    int numShards() const { return (int)_shards.size(); }
+
+    void queuePacket(std::unique_ptr<Packet> packet);
+
+    // returns the counters of every shard accumulated since the last call and resets them
+    std::vector<ShardStats> sampleStats();
+
+private:
+    class Shard : public QThread {
+    public:
+        Shard(const PacketProcessor& processor) : _processor(processor) {}
+
+        void queuePacket(std::unique_ptr<Packet> packet);
+        void stop();
+
+        ShardStats sampleStats();
+
+    protected:
+        void run() override;
+
+    private:
+        const PacketProcessor& _processor;
+
+        std::mutex _queueMutex;
+        std::condition_variable _queueCondition;
+        std::vector<std::unique_ptr<Packet>> _queue;
+        bool _stopping { false };
+
+        std::atomic<uint64_t> _processed { 0 };
+        std::atomic<uint64_t> _dropped { 0 };
+        std::atomic<uint32_t> _maxQueueSize { 0 };
+    };
+
+    PacketProcessor _processor;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+} // namespace udt
+
+#endif // hifi_ReceiveShardPool_h
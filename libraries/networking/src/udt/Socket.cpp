@@ -11,10 +11,19 @@
 
 #include "Socket.h"
 
-#ifdef Q_OS_ANDROID
+#include <algorithm>
+#include <cstring>
+
+#if defined(Q_OS_ANDROID) || defined(Q_OS_LINUX)
 #include <sys/socket.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <errno.h>
+#include <netinet/udp.h>
+#endif
+
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
@@ -24,6 +33,7 @@
 #include "Connection.h"
 #include "ControlPacket.h"
 #include "Packet.h"
+#include "PacketBufferPool.h"
 #include "../NLPacket.h"
 #include "../NLPacketList.h"
 #include "PacketList.h"
@@ -38,6 +48,24 @@ using namespace udt;
 #include <netinet/in.h>
 #endif
 
+static const QString BATCHED_RECEIVE_ENV = "HIFI_UDT_BATCHED_RECEIVE";
+static const QString BATCHED_SEND_ENV = "HIFI_UDT_BATCHED_SEND";
+static const QString RECEIVE_THREADS_ENV = "HIFI_UDT_RECEIVE_THREADS";
+
+#if defined(Q_OS_LINUX)
+static const int RECEIVE_BATCH_SIZE = 64;
+static const int SEND_BATCH_SIZE = 64;
+
+// UDP generic segmentation offload (Linux 4.18+), the headers we build against may predate it
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+static const int MAX_SEGMENTS_PER_SEND = 64;
+static const int MAX_SEGMENTED_SEND_BYTES = 65000;
+#endif
 
 Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     QObject(parent),
@@ -56,6 +84,22 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     const int READY_READ_BACKUP_CHECK_MSECS = 2 * 1000;
     connect(_readyReadBackupTimer, &QTimer::timeout, this, &Socket::checkForReadyReadBackup);
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
+
+    auto environment = QProcessEnvironment::systemEnvironment();
+    if (environment.contains(BATCHED_RECEIVE_ENV)) {
+        setBatchedReceiveEnabled(true);
+    }
+    if (environment.contains(BATCHED_SEND_ENV)) {
+        setBatchedSendEnabled(true);
+    }
+    if (environment.contains(RECEIVE_THREADS_ENV)) {
+        setReceiveThreadCount(environment.value(RECEIVE_THREADS_ENV).toInt());
+    }
+}
+
+Socket::~Socket() {
+    // stop the receive threads before the handlers they call into go away
+    _receiveShards.reset();
 }
 
 void Socket::bind(const QHostAddress& address, quint16 port) {
@@ -69,6 +113,10 @@ void Socket::bind(const QHostAddress& address, quint16 port) {
         auto sd = _udpSocket.socketDescriptor();
         int val = IP_PMTUDISC_DONT;
         setsockopt(sd, IPPROTO_IP, IP_MTU_DISCOVER, &val, sizeof(val));
+
+        // a zero segment size leaves the socket as is, this only tells us if the kernel knows about UDP_SEGMENT
+        int segmentSize = 0;
+        _isSegmentationOffloadSupported = setsockopt(sd, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize)) == 0;
 #elif defined(Q_OS_WIN)
         auto sd = _udpSocket.socketDescriptor();
         int val = 0; // false
@@ -133,9 +181,7 @@ qint64 Socket::writeBasePacket(const udt::BasePacket& packet, const HifiSockAddr
     return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
 }
 
-qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
-    Q_ASSERT_X(!packet.isReliable(), "Socket::writePacket", "Cannot send a reliable packet unreliably");
-
+void Socket::writeUnreliableSequenceNumber(const Packet& packet, const HifiSockAddr& sockAddr) {
     SequenceNumber sequenceNumber;
     {
         Lock lock(_unreliableSequenceNumbersMutex);
@@ -150,6 +196,12 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
 
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(sequenceNumber);
+}
+
+qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
+    Q_ASSERT_X(!packet.isReliable(), "Socket::writePacket", "Cannot send a reliable packet unreliably");
+
+    writeUnreliableSequenceNumber(packet, sockAddr);
 
     return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
 }
@@ -171,6 +223,22 @@ qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& s
         return 0;
     }
 
+    auto& sendBatch = getThreadSendBatch();
+    if (sendBatch.socket == this) {
+        // this thread is batching its sends, hold on to the packet itself until the batch is flushed
+        writeUnreliableSequenceNumber(*packet, sockAddr);
+
+        QueuedDatagram datagram;
+        datagram.size = packet->getDataSize();
+        datagram.address = sockAddr.getAddress();
+        datagram.port = sockAddr.getPort();
+        datagram.packet = std::move(packet);
+
+        auto size = datagram.size;
+        sendBatch.datagrams.push_back(std::move(datagram));
+        return size;
+    }
+
     return writePacket(*packet, sockAddr);
 }
 
@@ -236,6 +304,21 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
 
+    auto& sendBatch = getThreadSendBatch();
+    if (sendBatch.socket == this && datagram.size() <= PacketBufferPool::BUFFER_SIZE) {
+        // the caller keeps ownership of this data, queue a copy of it in a pooled buffer
+        QueuedDatagram queuedDatagram;
+        queuedDatagram.pooledBuffer = PacketBufferPool::getInstance().acquire();
+        memcpy(queuedDatagram.pooledBuffer.get(), datagram.constData(), datagram.size());
+        queuedDatagram.size = datagram.size();
+        queuedDatagram.address = sockAddr.getAddress();
+        queuedDatagram.port = sockAddr.getPort();
+
+        sendBatch.datagrams.push_back(std::move(queuedDatagram));
+        ++_copiedBatchDatagrams;
+        return datagram.size();
+    }
+
     // don't attempt to write the datagram if we're unbound.  Just drop it.
     // _udpSocket.writeDatagram will return an error anyway, but there are
     // potential crashes in Qt when that happens.
@@ -271,6 +354,12 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
 }
 
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr, bool filterCreate) {
+    // the common case, the connection already exists and we don't need the lock
+    auto existingConnection = _connectionLookupTable.find(sockAddr);
+    if (existingConnection) {
+        return existingConnection;
+    }
+
     Lock connectionsLock(_connectionsHashMutex);
     auto it = _connectionsHash.find(sockAddr);
 
@@ -299,37 +388,96 @@ Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr, bool fi
             qCDebug(networking) << "Creating new Connection class for" << sockAddr;
 
             it = _connectionsHash.insert(it, std::make_pair(sockAddr, std::move(connection)));
+            publishConnections();
         }
     }
 
     return it->second.get();
 }
 
+Connection* Socket::findConnectionForBatch(const HifiSockAddr& sockAddr, BatchConnectionCache* connectionCache) {
+    if (connectionCache) {
+        // a connection was removed since we started filling the cache, the pointers in it can't be trusted anymore
+        auto generation = _connectionsGeneration.load();
+        if (connectionCache->generation != generation) {
+            connectionCache->connections.clear();
+            connectionCache->generation = generation;
+        }
+
+        for (auto connection : connectionCache->connections) {
+            if (connection->getDestination() == sockAddr) {
+                return connection;
+            }
+        }
+    }
+
+    auto connection = _connectionLookupTable.find(sockAddr);
+    if (connection && connectionCache) {
+        connectionCache->connections.push_back(connection);
+    }
+    return connection;
+}
+
+Connection* Socket::findOrCreateConnectionForBatch(const HifiSockAddr& sockAddr, BatchConnectionCache* connectionCache) {
+    if (!connectionCache) {
+        return findOrCreateConnection(sockAddr, true);
+    }
+
+    auto connection = findConnectionForBatch(sockAddr, connectionCache);
+    if (!connection) {
+        connection = findOrCreateConnection(sockAddr, true);
+        if (connection) {
+            connectionCache->connections.push_back(connection);
+        }
+    }
+    return connection;
+}
+
 void Socket::clearConnections() {
     if (QThread::currentThread() != thread()) {
         BLOCKING_INVOKE_METHOD(this, "clearConnections");
         return;
     }
 
+    // the connections are only destroyed once they are out of the lookup snapshot, outside of the lock
+    std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> removedConnections;
+
     Lock connectionsLock(_connectionsHashMutex);
     if (_connectionsHash.size() > 0) {
         // clear all of the current connections in the socket
         qCDebug(networking) << "Clearing all remaining connections in Socket.";
-        _connectionsHash.clear();
+        removedConnections.swap(_connectionsHash);
+        ++_connectionsGeneration;
+        publishConnections();
     }
 }
 
 void Socket::cleanupConnection(HifiSockAddr sockAddr) {
+    std::unique_ptr<Connection> removedConnection;
+
     Lock connectionsLock(_connectionsHashMutex);
-    auto numErased = _connectionsHash.erase(sockAddr);
+    auto it = _connectionsHash.find(sockAddr);
 
-    if (numErased > 0) {
+    if (it != _connectionsHash.end()) {
+        removedConnection = std::move(it->second);
+        _connectionsHash.erase(it);
+        ++_connectionsGeneration;
+        publishConnections();
 #ifdef UDT_CONNECTION_DEBUG
         qCDebug(networking) << "Socket::cleanupConnection called for UDT connection to" << sockAddr;
 #endif
     }
 }
 
+void Socket::publishConnections() {
+    ConnectionLookupTable::Snapshot snapshot;
+    snapshot.reserve(_connectionsHash.size());
+    for (const auto& connectionPair : _connectionsHash) {
+        snapshot.emplace(connectionPair.first, connectionPair.second.get());
+    }
+    _connectionLookupTable.publish(std::move(snapshot));
+}
+
 void Socket::messageReceived(std::unique_ptr<Packet> packet) {
     if (_messageHandler) {
         _messageHandler(std::move(packet));
@@ -404,89 +552,215 @@ void Socket::readPendingDatagrams() {
         _lastPacketSizeRead = sizeRead;
         _lastPacketSockAddr = senderSockAddr;
 
-        if (sizeRead <= 0) {
-            // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
-            // on windows even if there's not a packet available)
-            continue;
+        if (sizeRead > 0) {
+            processDatagram(std::move(buffer), packetSizeWithHeader, false, senderSockAddr, receiveTime);
         }
+        // otherwise we either didn't pull anything for this packet or there was an error reading (this seems to trigger
+        // on windows even if there's not a packet available)
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
-
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
-            }
+#if defined(Q_OS_LINUX)
+        if (_batchedReceiveEnabled) {
+            // QUdpSocket only re-arms its read notifier from its own read calls, which is why the first datagram
+            // always goes through readDatagram above - drain whatever else is queued on the socket in batches
+            readDatagramBatches(abortTime);
+        }
+#endif
+    }
+}
 
-            continue;
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, qint64 size, bool isPooledBuffer,
+                             const HifiSockAddr& senderSockAddr, p_high_resolution_clock::time_point receiveTime,
+                             BatchConnectionCache* connectionCache) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setHasPooledBuffer(isPooledBuffer);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        } else if (isPooledBuffer) {
+            PacketBufferPool::getInstance().release(std::move(buffer));
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        return;
+    }
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr, true);
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setHasPooledBuffer(isPooledBuffer);
+        controlPacket->setReceiveTime(receiveTime);
 
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnectionForBatch(senderSockAddr, connectionCache);
+
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setHasPooledBuffer(isPooledBuffer);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        if (_receiveShards && !packet->isReliable() && !packet->isPartOfMessage()) {
+            // Connection is only used from the socket thread, so record this packet against an existing one here
+            // and leave verification and handling to the receive thread for this sender
+            auto connection = findConnectionForBatch(senderSockAddr, connectionCache);
             if (connection) {
-                connection->processControl(move(controlPacket));
+                connection->recordReceivedUnreliablePackets(packet->getWireSize(), packet->getPayloadSize());
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
+            _receiveShards->queuePacket(std::move(packet));
+            return;
+        }
 
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                auto connection = findOrCreateConnection(senderSockAddr, true);
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            auto connection = findOrCreateConnectionForBatch(senderSockAddr, connectionCache);
 
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
 
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
 #ifdef UDT_CONNECTION_DEBUG
-                        qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
-                            << ", type" << NLPacket::typeInHeader(*packet);
+                    qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
+                        << ", type" << NLPacket::typeInHeader(*packet);
 #endif
-                        continue;
-                    }
-                } else if (connection) {
-                    connection->recordReceivedUnreliablePackets(packet->getWireSize(),
-                                                                packet->getPayloadSize());
+                    return;
                 }
+            } else if (connection) {
+                connection->recordReceivedUnreliablePackets(packet->getWireSize(),
+                                                            packet->getPayloadSize());
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr, true);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnectionForBatch(senderSockAddr, connectionCache);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
 }
 
+#if defined(Q_OS_LINUX)
+
+void Socket::readDatagramBatches(std::chrono::system_clock::time_point abortTime) {
+    using namespace std::chrono;
+
+    auto socketDescriptor = _udpSocket.socketDescriptor();
+    if (socketDescriptor == -1) {
+        return;
+    }
+
+    auto& bufferPool = PacketBufferPool::getInstance();
+
+    mmsghdr messages[RECEIVE_BATCH_SIZE];
+    iovec bufferVectors[RECEIVE_BATCH_SIZE];
+    sockaddr_storage senderAddresses[RECEIVE_BATCH_SIZE];
+
+    while (system_clock::now() <= abortTime) {
+        // top up the receive buffers from the pool - the ones handed to packets last batch are still out
+        size_t numMissingBuffers = RECEIVE_BATCH_SIZE - _receiveBatchBuffers.size();
+        if (numMissingBuffers > 0) {
+            auto numHits = bufferPool.acquire(_receiveBatchBuffers, numMissingBuffers);
+            _receiveBatchPoolHits += numHits;
+            _receiveBatchPoolMisses += numMissingBuffers - numHits;
+        }
+
+        for (int i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+            bufferVectors[i].iov_base = _receiveBatchBuffers[i].get();
+            bufferVectors[i].iov_len = PacketBufferPool::BUFFER_SIZE;
+
+            memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &senderAddresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            messages[i].msg_hdr.msg_iov = &bufferVectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int numReceived = recvmmsg(socketDescriptor, messages, RECEIVE_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+        if (numReceived <= 0) {
+            if (numReceived < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                HIFI_FCDEBUG(networking(), "udt::Socket recvmmsg error -" << errno);
+            }
+            break;
+        }
+
+        // we're reading packets so re-start the readyRead backup timer
+        _readyReadBackupTimer->start();
+
+        auto receiveTime = p_high_resolution_clock::now();
+
+        ++_receivedBatches;
+        _receivedBatchDatagrams += numReceived;
+
+        uint32_t previousMax = _maxReceivedBatchSize.load();
+        while ((uint32_t)numReceived > previousMax &&
+               !_maxReceivedBatchSize.compare_exchange_weak(previousMax, (uint32_t)numReceived)) {}
+
+        BatchConnectionCache connectionCache;
+        connectionCache.generation = _connectionsGeneration.load();
+
+        for (int i = 0; i < numReceived; ++i) {
+            const auto& message = messages[i];
+
+            if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                // this datagram was larger than any packet we send, drop it and keep the buffer
+                ++_truncatedDatagrams;
+                continue;
+            }
+
+            int sizeRead = message.msg_len;
+            HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&senderAddresses[i]));
+
+            // save information for this packet, in case it is the one that sticks readyRead
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddr;
+
+            if (sizeRead <= 0) {
+                continue;
+            }
+
+            processDatagram(std::move(_receiveBatchBuffers[i]), sizeRead, true,
+                            senderSockAddr, receiveTime, &connectionCache);
+        }
+
+        // forget about the buffers that were handed off to packets, they'll come back through the pool
+        _receiveBatchBuffers.erase(std::remove_if(_receiveBatchBuffers.begin(), _receiveBatchBuffers.end(),
+                                                  [](const std::unique_ptr<char[]>& buffer) { return !buffer; }),
+                                   _receiveBatchBuffers.end());
+
+        if (numReceived < RECEIVE_BATCH_SIZE) {
+            // the socket has been drained
+            break;
+        }
+    }
+}
+
+#endif
+
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
-    Lock connectionsLock(_connectionsHashMutex);
-    auto it = _connectionsHash.find(destinationAddr);
-    if (it != _connectionsHash.end()) {
-        connect(it->second.get(), SIGNAL(packetSent()), receiver, slot);
+    auto connection = _connectionLookupTable.find(destinationAddr);
+    if (connection) {
+        connect(connection, SIGNAL(packetSent()), receiver, slot);
     }
 }
 
@@ -507,10 +781,278 @@ void Socket::setConnectionMaxBandwidth(int maxBandwidth) {
     }
 }
 
+void Socket::setBatchedReceiveEnabled(bool enabled) {
+#if defined(Q_OS_LINUX)
+    if (_batchedReceiveEnabled != enabled) {
+        qCDebug(networking) << "udt::Socket batched receive" << (enabled ? "enabled" : "disabled");
+        _batchedReceiveEnabled = enabled;
+    }
+#else
+    if (enabled) {
+        qCDebug(networking) << "udt::Socket batched receive is only available on Linux";
+    }
+#endif
+}
+
+Socket::ReceiveBatchStats Socket::sampleReceiveBatchStats() {
+    ReceiveBatchStats stats;
+    stats.batches = _receivedBatches.exchange(0);
+    stats.datagrams = _receivedBatchDatagrams.exchange(0);
+    stats.maxBatchSize = _maxReceivedBatchSize.exchange(0);
+    stats.poolHits = _receiveBatchPoolHits.exchange(0);
+    stats.poolMisses = _receiveBatchPoolMisses.exchange(0);
+    stats.truncatedDatagrams = _truncatedDatagrams.exchange(0);
+    return stats;
+}
+
+void Socket::setBatchedSendEnabled(bool enabled) {
+#if defined(Q_OS_LINUX)
+    if (_batchedSendEnabled != enabled) {
+        qCDebug(networking) << "udt::Socket batched send" << (enabled ? "enabled" : "disabled");
+        _batchedSendEnabled = enabled;
+    }
+#else
+    if (enabled) {
+        qCDebug(networking) << "udt::Socket batched send is only available on Linux";
+    }
+#endif
+}
+
+Socket::SendBatch& Socket::getThreadSendBatch() {
+    thread_local SendBatch sendBatch;
+    return sendBatch;
+}
+
+void Socket::beginSendBatch() {
+    if (!_batchedSendEnabled) {
+        return;
+    }
+
+    auto& sendBatch = getThreadSendBatch();
+    if (sendBatch.depth++ == 0) {
+        sendBatch.socket = this;
+    }
+
+    Q_ASSERT_X(sendBatch.socket == this, "Socket::beginSendBatch", "A thread can only batch sends for one socket at a time");
+}
+
+qint64 Socket::flushSendBatch() {
+    auto& sendBatch = getThreadSendBatch();
+    if (sendBatch.socket != this || --sendBatch.depth > 0) {
+        return 0;
+    }
+
+    // stop queueing before we write, anything sent from here on goes straight out
+    sendBatch.socket = nullptr;
+
+    if (sendBatch.datagrams.empty()) {
+        return 0;
+    }
+
+    ++_sentBatches;
+    _sentBatchDatagrams += sendBatch.datagrams.size();
+
+    qint64 bytesWritten = 0;
+
+#if defined(Q_OS_LINUX)
+    if (_udpSocket.state() == QAbstractSocket::BoundState) {
+        bytesWritten = writeDatagramBatch(sendBatch.datagrams);
+    } else {
+        qCDebug(networking) << "Attempt to flush a send batch when in unbound state - dropping"
+            << sendBatch.datagrams.size() << "datagrams";
+        bytesWritten = -1;
+    }
+#else
+    for (const auto& datagram : sendBatch.datagrams) {
+        bytesWritten += writeDatagram(datagram.getData(), datagram.size, HifiSockAddr(datagram.address, datagram.port));
+        ++_sendBatchSyscalls;
+    }
+#endif
+
+    // give the copied buffers back to the pool, the packets we took ownership of are freed with the batch
+    auto& bufferPool = PacketBufferPool::getInstance();
+    for (auto& datagram : sendBatch.datagrams) {
+        if (datagram.pooledBuffer) {
+            bufferPool.release(std::move(datagram.pooledBuffer));
+        }
+    }
+    sendBatch.datagrams.clear();
+
+    return bytesWritten;
+}
+
+#if defined(Q_OS_LINUX)
+
+static socklen_t fillSockAddr(const QHostAddress& address, quint16 port, sockaddr_storage& sockAddr) {
+    memset(&sockAddr, 0, sizeof(sockaddr_storage));
+
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        auto sockAddrIPv6 = reinterpret_cast<sockaddr_in6*>(&sockAddr);
+        sockAddrIPv6->sin6_family = AF_INET6;
+        sockAddrIPv6->sin6_port = htons(port);
+        Q_IPV6ADDR ipv6Address = address.toIPv6Address();
+        memcpy(&sockAddrIPv6->sin6_addr, &ipv6Address, sizeof(in6_addr));
+        return sizeof(sockaddr_in6);
+    } else {
+        auto sockAddrIPv4 = reinterpret_cast<sockaddr_in*>(&sockAddr);
+        sockAddrIPv4->sin_family = AF_INET;
+        sockAddrIPv4->sin_port = htons(port);
+        sockAddrIPv4->sin_addr.s_addr = htonl(address.toIPv4Address());
+        return sizeof(sockaddr_in);
+    }
+}
+
+qint64 Socket::writeDatagramBatch(const std::vector<QueuedDatagram>& datagrams) {
+    auto socketDescriptor = _udpSocket.socketDescriptor();
+
+    mmsghdr messages[SEND_BATCH_SIZE];
+    sockaddr_storage destinations[SEND_BATCH_SIZE];
+    iovec bufferVectors[SEND_BATCH_SIZE * MAX_SEGMENTS_PER_SEND];
+    union {
+        char buffer[CMSG_SPACE(sizeof(uint16_t))];
+        cmsghdr align;
+    } segmentControls[SEND_BATCH_SIZE];
+    int firstDatagramIndices[SEND_BATCH_SIZE];
+
+    qint64 bytesWritten = 0;
+    size_t nextDatagram = 0;
+
+    while (nextDatagram < datagrams.size()) {
+        bool useSegmentation = _isSegmentationOffloadSupported;
+
+        // build up to SEND_BATCH_SIZE messages
+        // with segmentation offload, consecutive datagrams of the same size to the same destination
+        // are sent as a single message that the kernel (or the NIC) splits back up
+        int numMessages = 0;
+        int numVectors = 0;
+        size_t datagramIndex = nextDatagram;
+
+        while (numMessages < SEND_BATCH_SIZE && datagramIndex < datagrams.size()) {
+            const auto& first = datagrams[datagramIndex];
+
+            auto& message = messages[numMessages];
+            memset(&message, 0, sizeof(mmsghdr));
+            message.msg_hdr.msg_name = &destinations[numMessages];
+            message.msg_hdr.msg_namelen = fillSockAddr(first.address, first.port, destinations[numMessages]);
+            message.msg_hdr.msg_iov = &bufferVectors[numVectors];
+
+            firstDatagramIndices[numMessages] = (int)datagramIndex;
+
+            int numSegments = 0;
+            qint64 segmentedBytes = 0;
+            do {
+                const auto& datagram = datagrams[datagramIndex];
+                bufferVectors[numVectors].iov_base = const_cast<char*>(datagram.getData());
+                bufferVectors[numVectors].iov_len = datagram.size;
+                ++numVectors;
+                ++numSegments;
+                segmentedBytes += datagram.size;
+                ++datagramIndex;
+
+                if (!useSegmentation || datagram.size < first.size) {
+                    // a shorter datagram can only be the last segment
+                    break;
+                }
+            } while (datagramIndex < datagrams.size() && numSegments < MAX_SEGMENTS_PER_SEND &&
+                     datagrams[datagramIndex].port == first.port &&
+                     datagrams[datagramIndex].address == first.address &&
+                     datagrams[datagramIndex].size <= first.size &&
+                     segmentedBytes + datagrams[datagramIndex].size <= MAX_SEGMENTED_SEND_BYTES);
+
+            message.msg_hdr.msg_iovlen = numSegments;
+
+            if (numSegments > 1) {
+                message.msg_hdr.msg_control = segmentControls[numMessages].buffer;
+                message.msg_hdr.msg_controllen = sizeof(segmentControls[numMessages].buffer);
+
+                auto control = CMSG_FIRSTHDR(&message.msg_hdr);
+                control->cmsg_level = SOL_UDP;
+                control->cmsg_type = UDP_SEGMENT;
+                control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t segmentSize = (uint16_t)first.size;
+                memcpy(CMSG_DATA(control), &segmentSize, sizeof(segmentSize));
+            }
+
+            ++numMessages;
+        }
+
+        int numSent = sendmmsg(socketDescriptor, messages, numMessages, 0);
+        ++_sendBatchSyscalls;
+
+        if (numSent < 0) {
+            int error = errno;
+            if (error == EIO && useSegmentation) {
+                // the device can't checksum segmented sends, stop using segmentation and retry
+                qCDebug(networking) << "udt::Socket disabling UDP segmentation offload after EIO from sendmmsg";
+                _isSegmentationOffloadSupported = false;
+                continue;
+            }
+
+            HIFI_FCDEBUG(networking(), "udt::Socket sendmmsg error -" << error << "- dropping"
+                << (datagrams.size() - nextDatagram) << "datagrams");
+            return bytesWritten > 0 ? bytesWritten : -1;
+        }
+
+        for (int i = 0; i < numSent; ++i) {
+            bytesWritten += messages[i].msg_len;
+            if (messages[i].msg_hdr.msg_iovlen > 1) {
+                _sentSegmentedDatagrams += messages[i].msg_hdr.msg_iovlen;
+            }
+        }
+
+        // when the kernel stops part way we pick up from the first message it didn't send
+        nextDatagram = numSent < numMessages ? firstDatagramIndices[numSent] : datagramIndex;
+        if (numSent == 0) {
+            break;
+        }
+    }
+
+    return bytesWritten;
+}
+
+#endif
+
+Socket::SendBatchStats Socket::sampleSendBatchStats() {
+    SendBatchStats stats;
+    stats.batches = _sentBatches.exchange(0);
+    stats.datagrams = _sentBatchDatagrams.exchange(0);
+    stats.syscalls = _sendBatchSyscalls.exchange(0);
+    stats.segmentedDatagrams = _sentSegmentedDatagrams.exchange(0);
+    stats.copiedDatagrams = _copiedBatchDatagrams.exchange(0);
+    return stats;
+}
+
+void Socket::setReceiveThreadCount(int numThreads) {
+    numThreads = std::max(numThreads, 0);
+    if (numThreads == getReceiveThreadCount()) {
+        return;
+    }
+
+    _receiveShards.reset();
+
+    if (numThreads > 0) {
+        qCDebug(networking) << "Handling unreliable packets on" << numThreads << "receive threads";
+
+        _receiveShards.reset(new ReceiveShardPool(numThreads, [this](std::unique_ptr<Packet> packet) {
+            // call our verification operator to see if this packet is verified
+            if ((!_packetFilterOperator || _packetFilterOperator(*packet)) && _packetHandler) {
+                _packetHandler(std::move(packet));
+            }
+        }));
+    }
+}
+
+std::vector<ReceiveShardPool::ShardStats> Socket::sampleReceiveThreadStats() {
+    if (!_receiveShards) {
+        return {};
+    }
+    return _receiveShards->sampleStats();
+}
+
 ConnectionStats::Stats Socket::sampleStatsForConnection(const HifiSockAddr& destination) {
-    auto it = _connectionsHash.find(destination);
-    if (it != _connectionsHash.end()) {
-        return it->second->sampleStats();
+    auto connection = _connectionLookupTable.find(destination);
+    if (connection) {
+        return connection->sampleStats();
     } else {
         return ConnectionStats::Stats();
     }
@@ -518,25 +1060,27 @@ ConnectionStats::Stats Socket::sampleStatsForConnection(const HifiSockAddr& dest
 
 Socket::StatsVector Socket::sampleStatsForAllConnections() {
     StatsVector result;
-    Lock connectionsLock(_connectionsHashMutex);
 
-    result.reserve(_connectionsHash.size());
-    for (const auto& connectionPair : _connectionsHash) {
-        result.emplace_back(connectionPair.first, connectionPair.second->sampleStats());
-    }
+    _connectionLookupTable.withSnapshot([&](const ConnectionLookupTable::Snapshot& connections) {
+        result.reserve(connections.size());
+        for (const auto& connectionPair : connections) {
+            result.emplace_back(connectionPair.first, connectionPair.second->sampleStats());
+        }
+    });
     return result;
 }
 
 
 std::vector<HifiSockAddr> Socket::getConnectionSockAddrs() {
     std::vector<HifiSockAddr> addr;
-    Lock connectionsLock(_connectionsHashMutex);
 
-    addr.reserve(_connectionsHash.size());
+    _connectionLookupTable.withSnapshot([&](const ConnectionLookupTable::Snapshot& connections) {
+        addr.reserve(connections.size());
 
-    for (const auto& connectionPair : _connectionsHash) {
-        addr.push_back(connectionPair.first);
-    }
+        for (const auto& connectionPair : connections) {
+            addr.push_back(connectionPair.first);
+        }
+    });
     return addr;
 }
 
@@ -578,8 +1122,12 @@ void Socket::handleRemoteAddressChange(HifiSockAddr previousAddress, HifiSockAdd
         if (connectionIter != _connectionsHash.end() && connectionIter->second->hasReceivedHandshake()) {
             auto connection = move(connectionIter->second);
             _connectionsHash.erase(connectionIter);
+            ++_connectionsGeneration;
             connection->setDestinationAddress(currentAddress);
+            // a connection we replace at the new address can only be destroyed once it is out of the lookup snapshot
+            auto replacedConnection = move(_connectionsHash[currentAddress]);
             _connectionsHash[currentAddress] = move(connection);
+            publishConnections();
             connectionsLock.unlock();
             qCDebug(networking) << "Moved Connection class from" << previousAddress << "to" << currentAddress;
 
@@ -14,10 +14,13 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
 #include <list>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -26,6 +29,8 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "ConnectionLookupTable.h"
+#include "ReceiveShardPool.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -54,8 +59,26 @@ class Socket : public QObject {
 
 public:
     using StatsVector = std::vector<std::pair<HifiSockAddr, ConnectionStats::Stats>>;
+
+    struct ReceiveBatchStats {
+        uint64_t batches { 0 };
+        uint64_t datagrams { 0 };
+        uint32_t maxBatchSize { 0 };
+        uint64_t poolHits { 0 };
+        uint64_t poolMisses { 0 };
+        uint64_t truncatedDatagrams { 0 };
+    };
+
+    struct SendBatchStats {
+        uint64_t batches { 0 };
+        uint64_t datagrams { 0 };
+        uint64_t syscalls { 0 };
+        uint64_t segmentedDatagrams { 0 };
+        uint64_t copiedDatagrams { 0 };
+    };
     
     Socket(QObject* object = 0, bool shouldChangeSocketOptions = true);
+    ~Socket();
     
     quint16 localPort() const { return _udpSocket.localPort(); }
     
@@ -89,6 +112,41 @@ public:
     
     StatsVector sampleStatsForAllConnections();
 
+    // Batched receive drains the socket with recvmmsg into pooled MTU sized buffers (Linux only, no-op elsewhere)
+    // It can also be turned on for every socket in the process with the HIFI_UDT_BATCHED_RECEIVE environment variable
+    void setBatchedReceiveEnabled(bool enabled);
+    bool isBatchedReceiveEnabled() const { return _batchedReceiveEnabled; }
+
+    // returns the batched receive counters accumulated since the last call and resets them
+    ReceiveBatchStats sampleReceiveBatchStats();
+
+    // Batched send lets a thread queue the unreliable datagrams it writes between beginSendBatch and flushSendBatch
+    // and hands them to the kernel with sendmmsg (and UDP GSO when available) on flush (Linux only, no-op elsewhere)
+    // Sequence numbers and connection stats are recorded when a packet is queued, not when it is flushed
+    // It can also be turned on for every socket in the process with the HIFI_UDT_BATCHED_SEND environment variable
+    void setBatchedSendEnabled(bool enabled);
+    bool isBatchedSendEnabled() const { return _batchedSendEnabled; }
+
+    // calls can be nested, only the outermost flushSendBatch sends the queued datagrams
+    void beginSendBatch();
+    qint64 flushSendBatch();
+
+    // returns the batched send counters accumulated since the last call and resets them
+    SendBatchStats sampleSendBatchStats();
+
+    // Receive threads take the verification and handling of unreliable packets that are not part of a message off of
+    // the socket thread, the packets of a given sender are always handled by the same thread and in order
+    // Reliable packets, messages and control packets stay on the socket thread with their Connection, so a sender's
+    // sharded unreliable packets are no longer ordered against its reliable and control packets
+    // Listeners registered with PacketReceiver::registerDirectListener are still only called from the socket thread
+    // It can also be set for every socket in the process with the HIFI_UDT_RECEIVE_THREADS environment variable
+    // Must be called before the socket starts receiving packets, zero (the default) handles everything on the socket thread
+    void setReceiveThreadCount(int numThreads);
+    int getReceiveThreadCount() const { return _receiveShards ? _receiveShards->numShards() : 0; }
+
+    // returns the counters of every receive thread accumulated since the last call and resets them
+    std::vector<ReceiveShardPool::ShardStats> sampleReceiveThreadStats();
+
 #if (PR_BUILD || DEV_BUILD)
     void sendFakedHandshakeRequest(const HifiSockAddr& sockAddr);
 #endif
@@ -109,8 +167,50 @@ private slots:
     void handleStateChanged(QAbstractSocket::SocketState socketState);
 
 private:
+    // a datagram waiting in a thread's send batch, it either owns the packet it came from or a pooled copy of the data
+    struct QueuedDatagram {
+        std::unique_ptr<Packet> packet;
+        std::unique_ptr<char[]> pooledBuffer;
+        qint64 size { 0 };
+        QHostAddress address;
+        quint16 port { 0 };
+
+        const char* getData() const { return packet ? packet->getData() : pooledBuffer.get(); }
+    };
+
+    // the datagrams a thread queued between beginSendBatch and flushSendBatch
+    struct SendBatch {
+        Socket* socket { nullptr };
+        int depth { 0 };
+        std::vector<QueuedDatagram> datagrams;
+    };
+
+    static SendBatch& getThreadSendBatch();
+
+    // connections already resolved while processing a batch of datagrams
+    // it is dropped as soon as a connection is removed from _connectionsHash (see _connectionsGeneration)
+    struct BatchConnectionCache {
+        uint32_t generation { 0 };
+        std::vector<Connection*> connections;
+    };
+
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr, bool filterCreation = false);
+    Connection* findOrCreateConnectionForBatch(const HifiSockAddr& sockAddr, BatchConnectionCache* connectionCache);
+    Connection* findConnectionForBatch(const HifiSockAddr& sockAddr, BatchConnectionCache* connectionCache);
+
+    // rebuilds the lock-free lookup snapshot from _connectionsHash, must be called with _connectionsHashMutex held
+    void publishConnections();
+
+    void writeUnreliableSequenceNumber(const Packet& packet, const HifiSockAddr& sockAddr);
+
+    void processDatagram(std::unique_ptr<char[]> buffer, qint64 size, bool isPooledBuffer,
+                         const HifiSockAddr& senderSockAddr, p_high_resolution_clock::time_point receiveTime,
+                         BatchConnectionCache* connectionCache = nullptr);
+#if defined(Q_OS_LINUX)
+    void readDatagramBatches(std::chrono::system_clock::time_point abortTime);
+    qint64 writeDatagramBatch(const std::vector<QueuedDatagram>& datagrams);
+#endif
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -134,6 +234,8 @@ private:
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
+    ConnectionLookupTable _connectionLookupTable; // lock-free view of _connectionsHash for lookups
+    std::atomic<uint32_t> _connectionsGeneration { 0 }; // bumped whenever a Connection is removed from _connectionsHash
 
     QTimer* _readyReadBackupTimer { nullptr };
 
@@ -146,6 +248,27 @@ private:
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
+
+    bool _batchedReceiveEnabled { false };
+    std::vector<std::unique_ptr<char[]>> _receiveBatchBuffers;
+
+    std::atomic<uint64_t> _receivedBatches { 0 };
+    std::atomic<uint64_t> _receivedBatchDatagrams { 0 };
+    std::atomic<uint32_t> _maxReceivedBatchSize { 0 };
+    std::atomic<uint64_t> _receiveBatchPoolHits { 0 };
+    std::atomic<uint64_t> _receiveBatchPoolMisses { 0 };
+    std::atomic<uint64_t> _truncatedDatagrams { 0 };
+
+    bool _batchedSendEnabled { false };
+    std::atomic<bool> _isSegmentationOffloadSupported { false };
+
+    std::atomic<uint64_t> _sentBatches { 0 };
+    std::atomic<uint64_t> _sentBatchDatagrams { 0 };
+    std::atomic<uint64_t> _sendBatchSyscalls { 0 };
+    std::atomic<uint64_t> _sentSegmentedDatagrams { 0 };
+    std::atomic<uint64_t> _copiedBatchDatagrams { 0 };
+
+    std::unique_ptr<ReceiveShardPool> _receiveShards;
     
     friend UDTTest;
 };
@@ -345,6 +345,31 @@ int Octree::readElementData(const OctreeElementPointer& destinationElement, cons
     return bytesRead;
 }
 
+void Octree::processEditBatch(OctreeEditBatch& batch) {
+    for (auto& batchMessage : batch) {
+        processEditMessage(batchMessage, (int)batchMessage.message->getPosition());
+    }
+}
+
+void Octree::processEditMessage(OctreeEditBatchMessage& batchMessage, int offset) {
+    ReceivedMessage& message = *batchMessage.message;
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(message.getRawMessage());
+    int size = (int)message.getSize();
+
+    while (offset < size) {
+        quint64 startProcess = usecTimestampNow();
+        int editDataBytesRead = processEditPacketData(message, data + offset, size - offset, batchMessage.senderNode);
+        batchMessage.processTime += usecTimestampNow() - startProcess;
+        batchMessage.numEdits++;
+
+        if (editDataBytesRead <= 0) {
+            // we can't tell where the next edit starts
+            break;
+        }
+        offset += editDataBytesRead;
+    }
+}
+
 void Octree::readBitstreamToTree(const unsigned char * bitstream, uint64_t bufferSizeBytes,
                                  ReadBitstreamToTreeParams& args) {
     int bytesRead = 0;
@@ -854,6 +879,39 @@ bool Octree::readJSONFromStream(
     return success;
 }
 
+bool Octree::writeToSnapshotFile(const QString& filename, const QByteArray& sourceTag) {
+    OctreeSnapshotHeader header;
+    header.id = _persistID;
+    header.dataVersion = _persistDataVersion;
+    header.itemVersion = expectedVersion();
+    header.sourceTag = sourceTag;
+    header.metadata = getSnapshotMetadata();
+
+    OctreeSnapshotWriter writer;
+    if (!writer.open(filename, header) || !writeToSnapshot(writer)) {
+        return false;
+    }
+    return writer.commit();
+}
+
+bool Octree::readFromSnapshotFile(const QString& filename) {
+    OctreeSnapshotReader reader;
+    if (!reader.open(filename)) {
+        return false;
+    }
+
+    const OctreeSnapshotHeader& header = reader.getHeader();
+    if (header.itemVersion != expectedVersion()) {
+        qCDebug(octree) << "Can't read snapshot" << filename << "of version" << (int)header.itemVersion
+            << "- expected version" << (int)expectedVersion();
+        return false;
+    }
+
+    _persistID = header.id;
+    _persistDataVersion = header.dataVersion;
+    return readFromSnapshot(reader);
+}
+
 bool Octree::writeToFile(const char* fileName, const OctreeElementPointer& element, QString persistAsFileType) {
     // make the sure file extension makes sense
     QString qFileName = fileNameWithoutExtension(QString(fileName), PERSIST_EXTENSIONS) + "." + persistAsFileType;
@@ -15,19 +15,23 @@
 #include <memory>
 #include <set>
 #include <stdint.h>
+#include <vector>
 
 #include <QHash>
 #include <QObject>
 #include <QtCore/QJsonObject>
 
+#include <ReceivedMessage.h>
 #include <shared/ReadWriteLockable.h>
 #include <SimpleMovingAverage.h>
 #include <ViewFrustum.h>
 
 #include "OctreeElement.h"
 #include "OctreeElementBag.h"
+#include "OctreeJournal.h"
 #include "OctreePacketData.h"
 #include "OctreeSceneStats.h"
+#include "OctreeSnapshot.h"
 #include "OctreeUtils.h"
 
 class ReadBitstreamToTreeParams;
@@ -109,6 +113,8 @@ public:
     SharedNodePointer sourceNode;
     int elementsPerPacket = 0;
     int entitiesPerPacket = 0;
+    OCTREE_PACKET_SEQUENCE sequence = 0; // of the packet being read
+    int droppedKinematicDeltas = 0; // entity updates relative to a baseline we don't have
 
     ReadBitstreamToTreeParams(
         bool includeExistsBits = WANT_EXISTS_BITS,
@@ -122,6 +128,22 @@ public:
     {}
 };
 
+// An edit message handed to Octree::processEditBatch(), read up to its first edit
+class OctreeEditBatchMessage {
+public:
+    OctreeEditBatchMessage(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) :
+        message(message), senderNode(senderNode) {}
+
+    QSharedPointer<ReceivedMessage> message;
+    SharedNodePointer senderNode;
+
+    // filled in by processEditBatch()
+    int numEdits { 0 };
+    int numCoalescedEdits { 0 }; // edits skipped because a later edit of the batch overwrites everything they change
+    quint64 processTime { 0 };
+};
+using OctreeEditBatch = std::vector<OctreeEditBatchMessage>;
+
 class Octree : public QObject, public std::enable_shared_from_this<Octree>, public ReadWriteLockable {
     Q_OBJECT
 public:
@@ -138,6 +160,9 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+    // Applies the edits of a batch of edit messages in order, the tree must be write locked. Trees that can tell may
+    // skip edits that a later edit of the batch overwrites, by default every edit goes to processEditPacketData().
+    virtual void processEditBatch(OctreeEditBatch& batch);
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
@@ -223,6 +248,14 @@ public:
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Binary snapshots, see OctreeSnapshot.h. Writing locks the tree, reading must be done with it write locked.
+    // A snapshot written with a different item version is rejected before anything is added to the tree.
+    bool writeToSnapshotFile(const QString& filename, const QByteArray& sourceTag = QByteArray());
+    bool readFromSnapshotFile(const QString& filename);
+    virtual QVariantMap getSnapshotMetadata() const { return QVariantMap(); }
+    virtual bool writeToSnapshot(OctreeSnapshotWriter& writer) { return false; }
+    virtual bool readFromSnapshot(OctreeSnapshotReader& reader) { return false; }
+
     uint64_t getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -260,9 +293,21 @@ public:
     virtual quint64 getAverageFilterTime() const { return 0; }
 
     void incrementPersistDataVersion() { _persistDataVersion++; }
+    QUuid getPersistID() const { return _persistID; }
+    int getPersistDataVersion() const { return _persistDataVersion; }
+
+    // Incremental persistence, trees that support it record which items changed between full saves.
+    // takeJournalRecords() returns the state of the items changed since the last call, replayJournalRecords()
+    // applies records on top of a loaded save and must be called with the tree write locked.
+    virtual void setWantJournal(bool wantJournal) { }
+    virtual void takeJournalRecords(std::vector<OctreeJournal::Record>& records) { }
+    virtual void replayJournalRecords(const std::vector<OctreeJournal::Record>& records) { }
 
 
 protected:
+    // applies the edits of the message from offset (in bytes from the start of the message) to its end
+    void processEditMessage(OctreeEditBatchMessage& batchMessage, int offset);
+
     void deleteOctalCodeFromTreeRecursion(const OctreeElementPointer& element, void* extraData);
 
     static bool countOctreeElementsOperation(const OctreeElementPointer& element, void* extraData);
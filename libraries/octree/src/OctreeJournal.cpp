@@ -0,0 +1,140 @@
+//
+//  OctreeJournal.cpp
+//  libraries/octree/src
+//
+//  Created on 2019-11-15.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournal.h"
+
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QHash>
+
+#include "OctreeLogging.h"
+
+static const quint32 JOURNAL_MAGIC = 0x4f4a524e; // "OJRN"
+static const quint16 JOURNAL_FORMAT_VERSION = 1;
+
+static quint16 recordChecksum(const OctreeJournal::Record& record) {
+    QByteArray bytes;
+    bytes.reserve(1 + 16 + record.data.size());
+    bytes.append((char)record.type);
+    bytes.append(record.id.toRfc4122());
+    bytes.append(record.data);
+    return qChecksum(bytes.constData(), bytes.size());
+}
+
+bool OctreeJournal::writeHeader(const QUuid& snapshotID, int64_t snapshotVersion) {
+    QDataStream stream(&_file);
+    stream << JOURNAL_MAGIC << JOURNAL_FORMAT_VERSION << snapshotID << (qint64)snapshotVersion;
+    _file.flush();
+    _size = _file.size();
+    _numRecords = 0;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool OctreeJournal::reset(const QUuid& snapshotID, int64_t snapshotVersion) {
+    _file.close();
+    _file.setFileName(_filename);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(octree) << "Failed to open journal" << _filename << _file.errorString();
+        _size = 0;
+        _numRecords = 0;
+        return false;
+    }
+    return writeHeader(snapshotID, snapshotVersion);
+}
+
+bool OctreeJournal::replay(const QUuid& snapshotID, int64_t snapshotVersion, std::vector<Record>& records) {
+    records.clear();
+
+    QFile file(_filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        reset(snapshotID, snapshotVersion);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint16 formatVersion = 0;
+    QUuid journalSnapshotID;
+    qint64 journalSnapshotVersion = -1;
+    stream >> magic >> formatVersion >> journalSnapshotID >> journalSnapshotVersion;
+    if (stream.status() != QDataStream::Ok || magic != JOURNAL_MAGIC || formatVersion != JOURNAL_FORMAT_VERSION) {
+        qCWarning(octree) << "Ignoring unreadable journal" << _filename;
+        file.close();
+        reset(snapshotID, snapshotVersion);
+        return false;
+    }
+    if (journalSnapshotID != snapshotID || journalSnapshotVersion != snapshotVersion) {
+        qCDebug(octree) << "Ignoring journal" << _filename << "for save" << journalSnapshotID << journalSnapshotVersion
+            << "- the loaded save is" << snapshotID << snapshotVersion;
+        file.close();
+        reset(snapshotID, snapshotVersion);
+        return false;
+    }
+
+    // later records of an item replace its earlier ones
+    QHash<QUuid, size_t> lastRecordOf;
+    qint64 goodSize = file.pos();
+    int numRecords = 0;
+    while (!stream.atEnd()) {
+        Record record;
+        quint8 type = Invalid;
+        quint16 checksum = 0;
+        stream >> type >> record.id >> record.data >> checksum;
+        record.type = (RecordType)type;
+        if (stream.status() != QDataStream::Ok || (record.type != Upsert && record.type != Delete) ||
+            checksum != recordChecksum(record)) {
+            qCWarning(octree) << "Journal" << _filename << "ends with a torn record at" << goodSize << "- dropping it";
+            break;
+        }
+        goodSize = file.pos();
+        numRecords++;
+
+        auto previous = lastRecordOf.find(record.id);
+        if (previous != lastRecordOf.end()) {
+            records[previous.value()].type = Invalid;
+        }
+        lastRecordOf[record.id] = records.size();
+        records.push_back(std::move(record));
+    }
+    file.close();
+
+    records.erase(std::remove_if(records.begin(), records.end(), [](const Record& record) {
+        return record.type == Invalid;
+    }), records.end());
+
+    // keep appending after the last good record
+    _file.close();
+    _file.setFileName(_filename);
+    if (!_file.open(QIODevice::ReadWrite) || !_file.resize(goodSize) || !_file.seek(goodSize)) {
+        qCWarning(octree) << "Failed to reopen journal" << _filename << _file.errorString();
+        reset(snapshotID, snapshotVersion);
+        return true;
+    }
+    _size = goodSize;
+    _numRecords = numRecords;
+    return true;
+}
+
+bool OctreeJournal::append(const std::vector<Record>& records) {
+    if (!_file.isOpen()) {
+        return false;
+    }
+
+    QDataStream stream(&_file);
+    for (const auto& record : records) {
+        stream << (quint8)record.type << record.id << record.data << recordChecksum(record);
+    }
+    _file.flush();
+    _size = _file.size();
+    _numRecords += (int)records.size();
+    return stream.status() == QDataStream::Ok;
+}
@@ -0,0 +1,67 @@
+//
+//  OctreeJournal.h
+//  libraries/octree/src
+//
+//  Created on 2019-11-15.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournal_h
+#define hifi_OctreeJournal_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+// Append-only log of the changes made to an octree since its last full save.
+//
+// The journal starts with the id and data version of the save it follows, so a journal left over from an older
+// save is never replayed on top of a newer one. Each record replaces or deletes one item. Records carry a checksum,
+// and a record torn by a crash ends the replay without failing it.
+class OctreeJournal {
+public:
+    enum RecordType : uint8_t {
+        Invalid = 0,
+        Upsert,
+        Delete
+    };
+
+    struct Record {
+        RecordType type { Invalid };
+        QUuid id;
+        QByteArray data; // the item's new state for Upsert, empty for Delete
+    };
+
+    void setFilename(const QString& filename) { _filename = filename; }
+    const QString& getFilename() const { return _filename; }
+
+    // drops the journal and starts an empty one following the given save
+    bool reset(const QUuid& snapshotID, int64_t snapshotVersion);
+
+    // reads the journal following the given save, keeping the last record of each item in the order they were
+    // written, and opens it for appending. Returns false and starts an empty journal if there is none for that save.
+    bool replay(const QUuid& snapshotID, int64_t snapshotVersion, std::vector<Record>& records);
+
+    // appends the records and flushes them to disk
+    bool append(const std::vector<Record>& records);
+
+    qint64 getSize() const { return _size; }
+    int getNumRecords() const { return _numRecords; }
+
+private:
+    bool writeHeader(const QUuid& snapshotID, int64_t snapshotVersion);
+
+    QString _filename;
+    QFile _file;
+    qint64 _size { 0 };
+    int _numRecords { 0 };
+};
+
+#endif // hifi_OctreeJournal_h
@@ -23,10 +23,12 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QRegExp>
+#include <QSaveFile>
 
 #include <NumericalConstants.h>
 #include <PerfStat.h>
@@ -38,6 +40,8 @@
 #include "OctreeDataUtils.h"
 
 constexpr std::chrono::seconds OctreePersistThread::DEFAULT_PERSIST_INTERVAL { 30 };
+constexpr std::chrono::minutes OctreePersistThread::DEFAULT_COMPACTION_INTERVAL { 10 };
+constexpr qint64 OctreePersistThread::MAX_JOURNAL_SIZE_BYTES { 32 * 1000 * 1000 };
 constexpr std::chrono::milliseconds TIME_BETWEEN_PROCESSING { 10 };
 
 constexpr int MAX_OCTREE_REPLACEMENT_BACKUP_FILES_COUNT { 20 };
@@ -49,6 +53,7 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _filename(filename),
     _persistInterval(persistInterval),
     _lastPersistCheck(std::chrono::steady_clock::now()),
+    _lastFullSave(std::chrono::steady_clock::now()),
     _initialLoadComplete(false),
     _loadTimeUSecs(0),
     _debugTimestampNow(debugTimestampNow),
@@ -58,6 +63,17 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+    _journal.setFilename(_filename + ".journal");
+    _snapshotFilename = _filename + ".snapshot";
+}
+
+// identifies a version of the save, so that a snapshot written next to it is ignored once the save is replaced
+static QByteArray persistFileTag(const QString& filename) {
+    QFileInfo fileInfo(filename);
+    if (!fileInfo.exists()) {
+        return QByteArray();
+    }
+    return QByteArray::number(fileInfo.size()) + ":" + QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch());
 }
 
 void OctreePersistThread::start() {
@@ -71,10 +87,24 @@ void OctreePersistThread::start() {
 
     auto packet = NLPacket::create(PacketType::OctreeDataFileRequest, -1, true, false);
 
+    // a snapshot written next to the save gives its id and version without parsing the JSON
+    OctreeSnapshotHeader snapshotHeader;
+    QByteArray sourceTag = persistFileTag(_filename);
+    _loadFromSnapshot = !sourceTag.isEmpty() && OctreeSnapshotReader::readHeader(_snapshotFilename, snapshotHeader) &&
+        snapshotHeader.sourceTag == sourceTag && !snapshotHeader.id.isNull() &&
+        snapshotHeader.itemVersion == _tree->expectedVersion();
+
     OctreeUtils::RawOctreeData data;
-    qCDebug(octree) << "Reading octree data from" << _filename;
     QFile file(_filename);
-    if (file.open(QIODevice::ReadOnly)) {
+    if (_loadFromSnapshot) {
+        qCDebug(octree) << "Current octree data from" << _snapshotFilename << ": ID(" << snapshotHeader.id
+            << ") DataVersion(" << snapshotHeader.dataVersion << ")";
+        packet->writePrimitive(true);
+        auto id = snapshotHeader.id.toRfc4122();
+        packet->write(id);
+        packet->writePrimitive((OctreeUtils::Version)snapshotHeader.dataVersion);
+    } else if (file.open(QIODevice::ReadOnly)) {
+        qCDebug(octree) << "Reading octree data from" << _filename;
         QByteArray jsonData(file.readAll());
         file.close();
         if (!gunzip(jsonData, _cachedJSONData)) {
@@ -114,10 +144,14 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     bool hasValidOctreeData { false };
     if (includesNewData) {
         _cachedJSONData.clear();
+        _loadFromSnapshot = false;
         replacementData = message->readAll();
         replaceData(replacementData);
         hasValidOctreeData = data.readOctreeDataInfoFromFile(_filename);
         qDebug() << "Got OctreeDataFileReply, new data sent";
+    } else if (_loadFromSnapshot) {
+        // the snapshot sets the id and version as it loads
+        qDebug() << "Got OctreeDataFileReply, current entity data is sufficient";
     } else {
         qDebug() << "Got OctreeDataFileReply, current entity data is sufficient";
         
@@ -153,12 +187,38 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     _tree->withWriteLock([&] {
         PerformanceWarning warn(true, "Loading Octree File", true);
 
-        if (_cachedJSONData.isEmpty()) {
+        if (_loadFromSnapshot) {
+            _loadedFromSnapshot = _tree->readFromSnapshotFile(_snapshotFilename);
+            if (!_loadedFromSnapshot) {
+                qCWarning(octree) << "Failed to load" << _snapshotFilename << "- loading" << _filename << "instead";
+                _tree->eraseAllOctreeElements();
+            }
+        }
+
+        if (_loadedFromSnapshot) {
+            persistentFileRead = true;
+        } else if (_cachedJSONData.isEmpty()) {
             persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
         } else {
             QDataStream jsonStream(_cachedJSONData);
             persistentFileRead = _tree->readFromStream(-1, jsonStream);
         }
+
+        // replay the changes made since that save, replacement data starts without any
+        if (replacementData.isNull()) {
+            quint64 replayStarted = usecTimestampNow();
+            std::vector<OctreeJournal::Record> records;
+            if (_journal.replay(_tree->getPersistID(), _tree->getPersistDataVersion(), records)) {
+                _tree->replayJournalRecords(records);
+            }
+            _journalReplayTimeUSecs = usecTimestampNow() - replayStarted;
+            _journalReplayedRecords = (int)records.size();
+            _journalReplayedBytes = _journal.getSize();
+        } else {
+            _journal.reset(_tree->getPersistID(), _tree->getPersistDataVersion());
+        }
+        _journalSize = _journal.getSize();
+
         _tree->pruneTree();
     });
 
@@ -167,6 +227,15 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     _loadTimeUSecs = loadDone - loadStarted;
 
     _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+    if (_journalReplayedRecords > 0) {
+        // except for the replayed changes, which are only in the journal until the next full save
+        _tree->setDirtyBit();
+    }
+    _tree->setWantJournal(true);
+
+    qCDebug(octree) << "Loaded" << (_loadedFromSnapshot ? _snapshotFilename : _filename) << "in" << _loadTimeUSecs << "usecs";
+    qCDebug(octree) << "Replayed" << _journalReplayedRecords << "journal records (" << _journalReplayedBytes
+        << "bytes) in" << _journalReplayTimeUSecs << "usecs";
 
     unsigned long nodeCount = OctreeElement::getNodeCount();
     unsigned long internalNodeCount = OctreeElement::getInternalNodeCount();
@@ -190,11 +259,17 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
 
     // Since we just loaded the persistent file, we can consider ourselves as having just persisted
     _lastPersistCheck = std::chrono::steady_clock::now();
+    _lastFullSave = _lastPersistCheck;
 
     if (replacementData.isNull()) {
         sendLatestEntityDataToDS();
     }
 
+    // so that the next start loads the snapshot, it's kept in step with the save by every full save
+    if (!_loadedFromSnapshot) {
+        writeSnapshot();
+    }
+
     QTimer::singleShot(TIME_BETWEEN_PROCESSING.count(), this, &OctreePersistThread::process);
 
     emit loadCompleted();
@@ -258,7 +333,7 @@ void OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+    persist(true);
     qCDebug(octree) << "Persist thread done with about to finish...";
 }
 
@@ -301,40 +376,120 @@ void OctreePersistThread::cleanupOldReplacementBackups() {
     qDebug() << "Found" << count << "backups";
 }
 
-void OctreePersistThread::persist() {
-    if (_tree->isDirty() && _initialLoadComplete) {
-
-        _tree->withWriteLock([&] {
-            qCDebug(octree) << "pruning Octree before saving...";
-            _tree->pruneTree();
-            qCDebug(octree) << "DONE pruning Octree before saving...";
-        });
+void OctreePersistThread::persist(bool forceFullSave) {
+    if (!_initialLoadComplete) {
+        return;
+    }
 
-        _tree->incrementPersistDataVersion();
+    // the changes go in the journal on every pass, even when a full save follows,
+    // in case the full save fails
+    writeJournal();
 
-        qCDebug(octree) << "Saving Octree data to:" << _filename;
-        if (_tree->writeToFile(_filename.toLocal8Bit().constData(), nullptr, _persistAsFileType)) {
-            _tree->clearDirtyBit(); // tree is clean after saving
-            qCDebug(octree) << "DONE persisting Octree data to" << _filename;
-        } else {
-            qCWarning(octree) << "Failed to persist Octree data to" << _filename;
+    if (_tree->isDirty()) {
+        auto timeSinceFullSave = std::chrono::steady_clock::now() - _lastFullSave;
+        if (forceFullSave || _journal.getSize() > MAX_JOURNAL_SIZE_BYTES || timeSinceFullSave > DEFAULT_COMPACTION_INTERVAL) {
+            writeFullSave();
         }
+    }
 
+    // the domain server keeps its copy (and its backups) as current as it was before the journal,
+    // so it still gets the whole tree on every pass that changed something
+    if (_hasUnsentChanges) {
         sendLatestEntityDataToDS();
     }
 }
 
-void OctreePersistThread::sendLatestEntityDataToDS() {
-    qDebug() << "Sending latest entity data to DS";
-    auto nodeList = DependencyManager::get<NodeList>();
-    const DomainHandler& domainHandler = nodeList->getDomainHandler();
+void OctreePersistThread::writeJournal() {
+    std::vector<OctreeJournal::Record> records;
+    _tree->takeJournalRecords(records);
+    if (!records.empty()) {
+        _hasUnsentChanges = true;
+        if (!_journal.append(records)) {
+            qCWarning(octree) << "Failed to append" << records.size() << "records to journal" << _journal.getFilename();
+        }
+        _journalSize = _journal.getSize();
+    }
+}
+
+bool OctreePersistThread::writeFullSave() {
+    _tree->withWriteLock([&] {
+        qCDebug(octree) << "pruning Octree before saving...";
+        _tree->pruneTree();
+        qCDebug(octree) << "DONE pruning Octree before saving...";
+    });
+
+    _tree->incrementPersistDataVersion();
+
+    // serialize the tree once, for the save and for the domain server
+    qCDebug(octree) << "Saving Octree data to:" << _filename;
+    bool doGzip = _persistAsFileType == "json.gz";
+    QByteArray data;
+    bool success = false;
+    if (_tree->toJSON(&data, nullptr, doGzip)) {
+        QSaveFile persistFile(_filename);
+        if (persistFile.open(QIODevice::WriteOnly) && persistFile.write(data) != -1) {
+            success = persistFile.commit();
+        }
+        if (!success) {
+            qCWarning(octree) << "Failed to persist Octree data to" << _filename << persistFile.errorString();
+        }
+    }
+    if (!success) {
+        return false;
+    }
+
+    // the journal now starts from this save, changes made while saving were queued for it
+    _tree->clearDirtyBit(); // tree is clean after saving
+    _journal.reset(_tree->getPersistID(), _tree->getPersistDataVersion());
+    _journalSize = _journal.getSize();
+    _lastFullSave = std::chrono::steady_clock::now();
+    qCDebug(octree) << "DONE persisting Octree data to" << _filename;
+
+    writeSnapshot();
+
+    if (!doGzip) {
+        QByteArray gzippedData;
+        if (!gzip(data, gzippedData, -1)) {
+            qCWarning(octree) << "Failed to gzip octree data for DS";
+            return true;
+        }
+        data = gzippedData;
+    }
+    sendEntityDataToDS(data);
+    return true;
+}
+
+void OctreePersistThread::writeSnapshot() {
+    QByteArray sourceTag = persistFileTag(_filename);
+    if (sourceTag.isEmpty()) {
+        return;
+    }
+
+    quint64 snapshotStarted = usecTimestampNow();
+    if (_tree->writeToSnapshotFile(_snapshotFilename, sourceTag)) {
+        qCDebug(octree) << "Wrote" << _snapshotFilename << "in" << (usecTimestampNow() - snapshotStarted) << "usecs";
+    } else {
+        qCWarning(octree) << "Failed to write" << _snapshotFilename;
+        QFile::remove(_snapshotFilename);
+    }
+}
 
+void OctreePersistThread::sendLatestEntityDataToDS() {
     QByteArray data;
     if (_tree->toJSON(&data, nullptr, true)) {
-        auto message = NLPacketList::create(PacketType::OctreeDataPersist, QByteArray(), true, true);
-        message->write(data);
-        nodeList->sendPacketList(std::move(message), domainHandler.getSockAddr());
+        sendEntityDataToDS(data);
     } else {
         qCWarning(octree) << "Failed to persist octree to DS";
     }
 }
+
+void OctreePersistThread::sendEntityDataToDS(const QByteArray& gzippedData) {
+    qDebug() << "Sending latest entity data to DS";
+    auto nodeList = DependencyManager::get<NodeList>();
+    const DomainHandler& domainHandler = nodeList->getDomainHandler();
+
+    auto message = NLPacketList::create(PacketType::OctreeDataPersist, QByteArray(), true, true);
+    message->write(gzippedData);
+    nodeList->sendPacketList(std::move(message), domainHandler.getSockAddr());
+    _hasUnsentChanges = false;
+}
@@ -14,9 +14,12 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <atomic>
+
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeJournal.h"
 
 class OctreePersistThread : public QObject {
     Q_OBJECT
@@ -31,6 +34,8 @@ public:
     };
 
     static const std::chrono::seconds DEFAULT_PERSIST_INTERVAL;
+    static const std::chrono::minutes DEFAULT_COMPACTION_INTERVAL;
+    static const qint64 MAX_JOURNAL_SIZE_BYTES;
 
     OctreePersistThread(OctreePointer tree,
                         const QString& filename,
@@ -41,6 +46,15 @@ public:
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
 
+    // the journal of changes since the last full save, and how long replaying it took on startup
+    qint64 getJournalSize() const { return _journalSize; }
+    quint64 getJournalReplayTime() const { return _journalReplayTimeUSecs; }
+    int getJournalReplayedRecords() const { return _journalReplayedRecords; }
+    qint64 getJournalReplayedBytes() const { return _journalReplayedBytes; }
+
+    // true if the initial load read the binary snapshot written next to the save instead of its JSON
+    bool wasLoadedFromSnapshot() const { return _loadedFromSnapshot; }
+
     QString getPersistFilename() const { return _filename; }
     QString getPersistFileMimeType() const;
     QByteArray getPersistFileContents() const;
@@ -58,12 +72,16 @@ protected slots:
     void handleOctreeDataFileReply(QSharedPointer<ReceivedMessage> message);
 
 protected:
-    void persist();
+    void persist(bool forceFullSave = false);
+    void writeJournal();
+    bool writeFullSave();
+    void writeSnapshot();
     bool backupCurrentFile();
     void cleanupOldReplacementBackups();
 
     void replaceData(QByteArray data);
     void sendLatestEntityDataToDS();
+    void sendEntityDataToDS(const QByteArray& gzippedData);
 
 private:
     OctreePointer _tree;
@@ -79,6 +97,18 @@ private:
 
     QString _persistAsFileType;
     QByteArray _cachedJSONData;
+
+    OctreeJournal _journal;
+    std::chrono::steady_clock::time_point _lastFullSave;
+    std::atomic<qint64> _journalSize { 0 };
+    bool _hasUnsentChanges { false }; // journaled since the domain server was last sent the tree
+    quint64 _journalReplayTimeUSecs { 0 };
+    int _journalReplayedRecords { 0 };
+    qint64 _journalReplayedBytes { 0 };
+
+    QString _snapshotFilename;
+    bool _loadFromSnapshot { false };
+    bool _loadedFromSnapshot { false };
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -0,0 +1,130 @@
+//
+//  OctreeSnapshot.cpp
+//  libraries/octree/src
+//
+//  Created on 2019-11-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSnapshot.h"
+
+#include "OctreeLogging.h"
+
+static const quint32 SNAPSHOT_MAGIC = 0x4f534e50; // "OSNP"
+static const quint16 SNAPSHOT_FORMAT_VERSION = 1;
+
+// items are framed by their size, a zero size ends them and is followed by the item count
+static const quint32 END_OF_ITEMS = 0;
+static const quint32 MAX_ITEM_SIZE = 256 * 1024 * 1024;
+
+static bool readHeaderFromStream(QDataStream& stream, OctreeSnapshotHeader& header) {
+    quint32 magic = 0;
+    quint16 formatVersion = 0;
+    quint8 itemVersion = 0;
+    qint64 dataVersion = -1;
+    stream >> magic >> formatVersion;
+    if (stream.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || formatVersion != SNAPSHOT_FORMAT_VERSION) {
+        return false;
+    }
+    stream >> itemVersion >> header.id >> dataVersion >> header.sourceTag >> header.metadata;
+    header.itemVersion = (PacketVersion)itemVersion;
+    header.dataVersion = dataVersion;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool OctreeSnapshotWriter::open(const QString& filename, const OctreeSnapshotHeader& header) {
+    _file.setFileName(filename);
+    if (!_file.open(QIODevice::WriteOnly)) {
+        qCWarning(octree) << "Failed to open snapshot" << filename << _file.errorString();
+        return false;
+    }
+    _stream.setDevice(&_file);
+    _stream << SNAPSHOT_MAGIC << SNAPSHOT_FORMAT_VERSION << (quint8)header.itemVersion << header.id
+        << (qint64)header.dataVersion << header.sourceTag << header.metadata;
+    _numItems = 0;
+    return _stream.status() == QDataStream::Ok;
+}
+
+bool OctreeSnapshotWriter::append(const QByteArray& item) {
+    if (item.isEmpty() || (quint32)item.size() > MAX_ITEM_SIZE) {
+        qCWarning(octree) << "Can't add an item of" << item.size() << "bytes to snapshot" << _file.fileName();
+        return false;
+    }
+    _stream << (quint32)item.size();
+    _stream.writeRawData(item.constData(), item.size());
+    _numItems++;
+    return _stream.status() == QDataStream::Ok;
+}
+
+bool OctreeSnapshotWriter::commit() {
+    _stream << END_OF_ITEMS << (quint32)_numItems;
+    if (_stream.status() != QDataStream::Ok) {
+        _file.cancelWriting();
+    }
+    bool success = _file.commit();
+    if (!success) {
+        qCWarning(octree) << "Failed to write snapshot" << _file.fileName() << _file.errorString();
+    }
+    return success;
+}
+
+bool OctreeSnapshotReader::open(const QString& filename) {
+    _file.setFileName(filename);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    _stream.setDevice(&_file);
+    _numItemsRead = 0;
+    _atEnd = false;
+    if (!readHeaderFromStream(_stream, _header)) {
+        qCWarning(octree) << "Ignoring unreadable snapshot" << filename;
+        _file.close();
+        return false;
+    }
+    return true;
+}
+
+bool OctreeSnapshotReader::readNext(QByteArray& item) {
+    if (_atEnd || !_file.isOpen()) {
+        return false;
+    }
+
+    quint32 size = 0;
+    _stream >> size;
+    if (_stream.status() != QDataStream::Ok || size > MAX_ITEM_SIZE) {
+        qCWarning(octree) << "Snapshot" << _file.fileName() << "is truncated after" << _numItemsRead << "items";
+        return false;
+    }
+
+    if (size == END_OF_ITEMS) {
+        quint32 numItems = 0;
+        _stream >> numItems;
+        if (_stream.status() != QDataStream::Ok || (int)numItems != _numItemsRead) {
+            qCWarning(octree) << "Snapshot" << _file.fileName() << "should hold" << numItems << "items, read"
+                << _numItemsRead;
+            return false;
+        }
+        _atEnd = true;
+        return false;
+    }
+
+    item.resize(size);
+    if (_stream.readRawData(item.data(), size) != (int)size) {
+        qCWarning(octree) << "Snapshot" << _file.fileName() << "is truncated after" << _numItemsRead << "items";
+        return false;
+    }
+    _numItemsRead++;
+    return true;
+}
+
+bool OctreeSnapshotReader::readHeader(const QString& filename, OctreeSnapshotHeader& header) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    return readHeaderFromStream(stream, header);
+}
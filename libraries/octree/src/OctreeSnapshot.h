@@ -0,0 +1,78 @@
+//
+//  OctreeSnapshot.h
+//  libraries/octree/src
+//
+//  Created on 2019-11-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSnapshot_h
+#define hifi_OctreeSnapshot_h
+
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+#include <QtCore/QVariantMap>
+
+#include <udt/PacketHeaders.h>
+
+// Binary save of an octree, written and read one item at a time so that neither side holds the whole document.
+//
+// The header carries what the JSON save keeps next to its "Entities" array. Each item is opaque to the snapshot,
+// the tree encodes it with its wire format, so a snapshot can only be read by code with the same itemVersion.
+struct OctreeSnapshotHeader {
+    QUuid id;
+    int64_t dataVersion { -1 };
+    PacketVersion itemVersion { 0 };
+    QByteArray sourceTag; // identifies the JSON save this snapshot was written next to, if any
+    QVariantMap metadata; // tree level data, e.g. the named paths
+};
+
+class OctreeSnapshotWriter {
+public:
+    // the file only replaces an existing one on commit()
+    bool open(const QString& filename, const OctreeSnapshotHeader& header);
+    bool append(const QByteArray& item);
+    bool commit();
+
+    int getNumItems() const { return _numItems; }
+
+private:
+    QSaveFile _file;
+    QDataStream _stream;
+    int _numItems { 0 };
+};
+
+class OctreeSnapshotReader {
+public:
+    // opens the file and reads its header
+    bool open(const QString& filename);
+    const OctreeSnapshotHeader& getHeader() const { return _header; }
+
+    // reads the next item into item, reusing its storage. Returns false at the end of the items or on a read error,
+    // atEnd() tells them apart.
+    bool readNext(QByteArray& item);
+    bool atEnd() const { return _atEnd; }
+
+    int getNumItemsRead() const { return _numItemsRead; }
+
+    // reads only the header of a snapshot
+    static bool readHeader(const QString& filename, OctreeSnapshotHeader& header);
+
+private:
+    QFile _file;
+    QDataStream _stream;
+    OctreeSnapshotHeader _header;
+    int _numItemsRead { 0 };
+    bool _atEnd { false };
+};
+
+#endif // hifi_OctreeSnapshot_h
@@ -0,0 +1,177 @@
+//
+//  TimingWheel.h
+//  libraries/shared/src
+//
+//  Created on 2019-11-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimingWheel_h
+#define hifi_TimingWheel_h
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// A hierarchical timing wheel: keys scheduled to expire at a time (in usecs), and handed back by expire() once that
+// time has passed. Scheduling and removing a key are O(1), and expire() costs O(keys expired) plus at most one step per
+// tick elapsed, whatever the number of keys scheduled; stretches of time with nothing due are skipped.
+//
+// Time is cut into ticks. The first level has a slot for each of the next 256 ticks, the next one a slot for each of
+// the next 256 runs of 256 ticks, and so on over LEVELS levels; as time moves on the slots of the higher levels are
+// cascaded down into the lower ones. A key comes out of expire() in the first call made after the end of the tick
+// its expiry falls in (or, for an expiry already past when it was scheduled, of the tick it was scheduled in), so it
+// is never early and at most a tick late, and keys come out in the order of their ticks.
+// Keys further away than the wheel spans are parked in its last slot and go back around when they get there.
+template <typename Key, typename Hash = std::hash<Key>>
+class TimingWheel {
+public:
+    static const int SLOT_BITS = 8;
+    static const int SLOTS_PER_LEVEL = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+    TimingWheel(uint64_t tickUsecs, uint64_t now) : _tickUsecs(tickUsecs), _currentTick(now / tickUsecs) {
+        assert(tickUsecs > 0);
+        _slots.resize(LEVELS * SLOTS_PER_LEVEL);
+    }
+
+    size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+    bool contains(const Key& key) const { return _entries.find(key) != _entries.end(); }
+
+    // schedules key to expire at expiry, or moves it there if it was already scheduled
+    void schedule(const Key& key, uint64_t expiry) {
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            it = _entries.emplace(key, Entry()).first;
+        } else {
+            unlink(it->second);
+        }
+        it->second.tick = expiry / _tickUsecs;
+        link(it->first, it->second);
+    }
+
+    // returns false if key wasn't scheduled
+    bool remove(const Key& key) {
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            return false;
+        }
+        unlink(it->second);
+        _entries.erase(it);
+        return true;
+    }
+
+    void clear() {
+        for (auto& slot : _slots) {
+            slot.clear();
+        }
+        for (auto& count : _levelCounts) {
+            count = 0;
+        }
+        _entries.clear();
+    }
+
+    // moves the wheel to now, and appends the keys that expired before it to expired (in the order of their ticks)
+    // after unscheduling them
+    void expire(uint64_t now, std::vector<Key>& expired) {
+        uint64_t nowTick = now / _tickUsecs;
+        while (_currentTick < nowTick) {
+            // cascade the slots of the higher levels whose run starts with this tick
+            for (int level = 1; level < LEVELS; level++) {
+                if (((_currentTick >> (SLOT_BITS * (level - 1))) & (SLOTS_PER_LEVEL - 1)) != 0) {
+                    break;
+                }
+                std::vector<Key> cascaded;
+                cascaded.swap(_slots[slotIndex(level, _currentTick)]);
+                _levelCounts[level] -= cascaded.size();
+                for (const auto& key : cascaded) {
+                    link(key, _entries[key]);
+                }
+            }
+
+            std::vector<Key> due;
+            due.swap(_slots[slotIndex(0, _currentTick)]);
+            _levelCounts[0] -= due.size();
+            for (const auto& key : due) {
+                auto it = _entries.find(key);
+                if (it->second.tick > _currentTick) {
+                    // parked beyond the span of the wheel, go around again
+                    link(key, it->second);
+                } else {
+                    expired.push_back(key);
+                    _entries.erase(it);
+                }
+            }
+            _currentTick++;
+
+            // nothing happens before the next run of the first level that isn't empty
+            int level = 0;
+            while (level < LEVELS && _levelCounts[level] == 0) {
+                level++;
+            }
+            if (level == LEVELS) {
+                _currentTick = nowTick;
+            } else if (level > 0) {
+                uint64_t runTicks = (uint64_t)1 << (SLOT_BITS * level);
+                uint64_t nextRun = (_currentTick + runTicks - 1) & ~(runTicks - 1);
+                _currentTick = nextRun < nowTick ? nextRun : nowTick;
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t tick { 0 };
+        uint32_t slot { 0 };
+        uint32_t position { 0 };
+    };
+
+    static uint32_t slotIndex(int level, uint64_t tick) {
+        return (uint32_t)(level * SLOTS_PER_LEVEL + ((tick >> (SLOT_BITS * level)) & (SLOTS_PER_LEVEL - 1)));
+    }
+
+    void link(const Key& key, Entry& entry) {
+        // past ticks are due on the current one
+        uint64_t tick = entry.tick < _currentTick ? _currentTick : entry.tick;
+        uint64_t delta = tick - _currentTick;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= ((uint64_t)1 << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        if (delta >= ((uint64_t)1 << (SLOT_BITS * LEVELS))) {
+            // the last tick of the span
+            tick = _currentTick + ((uint64_t)1 << (SLOT_BITS * LEVELS)) - 1;
+        }
+        entry.slot = slotIndex(level, tick);
+        auto& slot = _slots[entry.slot];
+        entry.position = (uint32_t)slot.size();
+        slot.push_back(key);
+        _levelCounts[level]++;
+    }
+
+    void unlink(const Entry& entry) {
+        // swap the last key of the slot into the place of this one
+        auto& slot = _slots[entry.slot];
+        if (entry.position + 1 < slot.size()) {
+            slot[entry.position] = slot.back();
+            _entries[slot[entry.position]].position = entry.position;
+        }
+        slot.pop_back();
+        _levelCounts[entry.slot / SLOTS_PER_LEVEL]--;
+    }
+
+    uint64_t _tickUsecs;
+    uint64_t _currentTick; // the next tick to expire
+    std::vector<std::vector<Key>> _slots;
+    size_t _levelCounts[LEVELS] {}; // keys in the slots of each level
+    std::unordered_map<Key, Entry, Hash> _entries;
+};
+
+#endif // hifi_TimingWheel_h
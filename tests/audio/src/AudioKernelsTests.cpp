@@ -0,0 +1,342 @@
+//
+//  AudioKernelsTests.cpp
+//  tests/audio/src
+//
+//  Created on 11/12/19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioKernelsTests.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <AudioKernels.h>
+#include <AudioLimiter.h>
+#include <AudioRingBuffer.h>
+#include <CPUDetect.h>
+
+QTEST_MAIN(AudioKernelsTests)
+
+// sizes around the SIMD widths, and the network frame sizes
+static const int BLOCK_SIZES[] = { 0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 240, 241, 480, 960 };
+
+static std::vector<float> randomFloats(int size, float scale, int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-scale, scale);
+    std::vector<float> samples(size);
+    for (auto& sample : samples) {
+        sample = distribution(generator);
+    }
+    return samples;
+}
+
+static std::vector<int16_t> randomInt16s(int size, int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-32768, 32767);
+    std::vector<int16_t> samples(size);
+    for (auto& sample : samples) {
+        sample = (int16_t)distribution(generator);
+    }
+    return samples;
+}
+
+static bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+static bool hasAVX2() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    return cpuSupportsAVX2();
+#else
+    return false;
+#endif
+}
+
+void AudioKernelsTests::silenceTest() {
+    for (int size : BLOCK_SIZES) {
+        std::vector<float> samples(size, 0.0f);
+        QCOMPARE(hasNonZeroSamples(samples.data(), size), false);
+
+        if (size == 0) {
+            continue;
+        }
+
+        // negative zero is silent
+        samples[size - 1] = -0.0f;
+        QCOMPARE(hasNonZeroSamples(samples.data(), size), false);
+
+        // anything else, at any position, is not
+        for (int i : { 0, size / 2, size - 1 }) {
+            for (float value : { 1.0e-30f, -1.0f, NAN }) {
+                samples[i] = value;
+                QCOMPARE(hasNonZeroSamples(samples.data(), size), hasNonZeroSamples_ref(samples.data(), size));
+                QCOMPARE(hasNonZeroSamples(samples.data(), size), true);
+                samples[i] = 0.0f;
+            }
+        }
+    }
+}
+
+void AudioKernelsTests::accumulateTest() {
+    for (int size : BLOCK_SIZES) {
+        auto src = randomFloats(size + 1, 1.0f, 1);
+        auto dst = randomFloats(size + 1, 1.0f, 2);
+        auto expected = dst;
+        accumulateFloat_ref(src.data(), expected.data(), size);
+        accumulateSamples(src.data(), dst.data(), size);
+        QVERIFY(sameBits(dst, expected));
+
+        // wraps around on overflow
+        auto src16 = randomInt16s(size + 1, 3);
+        auto dst16 = randomInt16s(size + 1, 4);
+        auto expected16 = dst16;
+        accumulateInt16_ref(src16.data(), expected16.data(), size);
+        accumulateSamples(src16.data(), dst16.data(), size);
+        QVERIFY(dst16 == expected16);
+    }
+}
+
+void AudioKernelsTests::scaleTest() {
+    for (int size : BLOCK_SIZES) {
+        for (float gain : { 0.0f, 0.3f, -0.77f, 1.0f }) {
+            auto src = randomFloats(size, 1.0f, 5);
+            std::vector<float> dst(size), expected(size);
+            scaleFloat_ref(src.data(), expected.data(), gain, size);
+            scaleSamples(src.data(), dst.data(), gain, size);
+            QVERIFY(sameBits(dst, expected));
+
+            auto src16 = randomInt16s(size, 6);
+            std::vector<int16_t> dst16(size), expected16(size);
+            scaleInt16_ref(src16.data(), expected16.data(), gain, size);
+            scaleSamples(src16.data(), dst16.data(), gain, size);
+            QVERIFY(dst16 == expected16);
+        }
+    }
+}
+
+void AudioKernelsTests::gainfadeTest() {
+    for (int size : BLOCK_SIZES) {
+        auto src = randomInt16s(2 * size, 7);
+        auto win = randomFloats(size, 1.0f, 8);
+        for (auto& frac : win) {
+            frac = fabsf(frac);
+        }
+
+        auto dst = randomFloats(2 * size, 1.0f, 9);
+        auto expected = dst;
+        gainfade_1x2_ref(src.data(), expected.data(), win.data(), 0.3f, 1.7f, size);
+        gainfade_1x2(src.data(), dst.data(), win.data(), 0.3f, 1.7f, size);
+        QVERIFY(sameBits(dst, expected));
+
+        dst = randomFloats(2 * size, 1.0f, 10);
+        expected = dst;
+        gainfade_2x2_ref(src.data(), expected.data(), win.data(), 1.1f, 0.2f, size);
+        gainfade_2x2(src.data(), dst.data(), win.data(), 1.1f, 0.2f, size);
+        QVERIFY(sameBits(dst, expected));
+    }
+}
+
+void AudioKernelsTests::peakTest() {
+    for (int size : BLOCK_SIZES) {
+        for (int numChannels : { 1, 2, 3, 4 }) {
+            auto src = randomFloats(numChannels * size, 4.0f, 11);
+            std::vector<uint32_t> peak(size), expected(size);
+            peakAbsBits_ref(src.data(), expected.data(), size, numChannels);
+            peakAbsBits(src.data(), peak.data(), size, numChannels);
+            QVERIFY(peak == expected);
+        }
+    }
+}
+
+void AudioKernelsTests::gainDitherTest() {
+    for (int size : BLOCK_SIZES) {
+        for (int numChannels : { 1, 2, 3, 4 }) {
+            auto src = randomFloats(numChannels * size, 32768.0f, 12);
+            auto gain = randomFloats(size, 1.0f, 13);
+            for (auto& g : gain) {
+                g = fabsf(g);
+            }
+
+            std::vector<int16_t> dst(numChannels * size), expected(numChannels * size);
+            uint32_t ditherState = 12345;
+            uint32_t expectedDitherState = 12345;
+            gainDitherToInt16_ref(src.data(), gain.data(), expected.data(), size, numChannels, expectedDitherState);
+            gainDitherToInt16(src.data(), gain.data(), dst.data(), size, numChannels, ditherState);
+            QVERIFY(dst == expected);
+            QCOMPARE(ditherState, expectedDitherState);
+        }
+    }
+}
+
+void AudioKernelsTests::limiterBlockTest() {
+    const int SAMPLE_RATE = 48000;
+    const int NUM_FRAMES = SAMPLE_RATE / 2;
+
+    for (int numChannels : { 1, 2, 4 }) {
+        // alternate quiet and loud passages, to go through attack and release
+        std::mt19937 generator(numChannels);
+        std::normal_distribution<float> distribution(0.0f, 10000.0f);
+        std::vector<float> input(numChannels * NUM_FRAMES);
+        for (int n = 0; n < NUM_FRAMES; n++) {
+            float envelope = ((n / 4000) % 2) ? 3.0f : 0.2f;
+            for (int c = 0; c < numChannels; c++) {
+                input[numChannels * n + c] = envelope * distribution(generator);
+            }
+        }
+
+        // single frames never reach the SIMD code, whole network frames do
+        AudioLimiter blockLimiter(SAMPLE_RATE, numChannels);
+        AudioLimiter frameLimiter(SAMPLE_RATE, numChannels);
+        blockLimiter.setThreshold(-6.0f);
+        frameLimiter.setThreshold(-6.0f);
+
+        std::vector<float> blockInput = input;
+        std::vector<float> frameInput = input;
+        std::vector<int16_t> blockOutput(numChannels * NUM_FRAMES);
+        std::vector<int16_t> frameOutput(numChannels * NUM_FRAMES);
+
+        const int BLOCK_FRAMES = 240;
+        for (int n = 0; n < NUM_FRAMES; n += BLOCK_FRAMES) {
+            blockLimiter.render(&blockInput[numChannels * n], &blockOutput[numChannels * n], BLOCK_FRAMES);
+        }
+        for (int n = 0; n < NUM_FRAMES; n++) {
+            frameLimiter.render(&frameInput[numChannels * n], &frameOutput[numChannels * n], 1);
+        }
+
+        QVERIFY(blockOutput == frameOutput);
+    }
+}
+
+void AudioKernelsTests::ringBufferTest() {
+    const int FRAME_SAMPLES = 100;
+    const int NUM_SAMPLES = 250;
+
+    // add path, with the read wrapping around the end of the buffer
+    {
+        AudioMixRingBuffer ringBuffer(FRAME_SAMPLES, 3);
+        auto filler = randomFloats(2 * FRAME_SAMPLES, 1.0f, 14);
+        ringBuffer.writeSamples(filler.data(), (int)filler.size());
+        ringBuffer.skipSamples((int)filler.size());
+
+        auto samples = randomFloats(NUM_SAMPLES, 1.0f, 15);
+        ringBuffer.writeSamples(samples.data(), NUM_SAMPLES);
+
+        auto mix = randomFloats(NUM_SAMPLES, 1.0f, 16);
+        auto expected = mix;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            expected[i] += samples[i];
+        }
+        QCOMPARE(ringBuffer.appendSamples(mix.data(), NUM_SAMPLES), NUM_SAMPLES);
+        QVERIFY(sameBits(mix, expected));
+    }
+
+    // faded write from a ring buffer iterator, with both buffers wrapping around
+    {
+        AudioRingBuffer source(FRAME_SAMPLES, 3);
+        AudioRingBuffer destination(FRAME_SAMPLES, 3);
+        auto filler = randomInt16s(2 * FRAME_SAMPLES + 30, 17);
+        source.writeSamples(filler.data(), 2 * FRAME_SAMPLES);
+        source.skipSamples(2 * FRAME_SAMPLES);
+        destination.writeSamples(filler.data(), (int)filler.size());
+        destination.skipSamples((int)filler.size());
+
+        auto samples = randomInt16s(NUM_SAMPLES, 18);
+        source.writeSamples(samples.data(), NUM_SAMPLES);
+
+        const float FADE = 0.6f;
+        QCOMPARE(destination.writeSamplesWithFade(source.nextOutput(), NUM_SAMPLES, FADE), NUM_SAMPLES);
+        std::vector<int16_t> faded(NUM_SAMPLES);
+        destination.readSamples(faded.data(), NUM_SAMPLES);
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            QCOMPARE(faded[i], (int16_t)((float)samples[i] * FADE));
+        }
+
+        // and the plain copy
+        destination.writeSamples(source.nextOutput(), NUM_SAMPLES);
+        std::vector<int16_t> copied(NUM_SAMPLES);
+        destination.readSamples(copied.data(), NUM_SAMPLES);
+        QVERIFY(copied == samples);
+    }
+}
+
+void AudioKernelsTests::kernelBenchmark() {
+    const int NUM_FRAMES = 240;     // one network frame
+    const int NUM_ITERATIONS = 100000;
+
+    auto stereo = randomFloats(2 * NUM_FRAMES, 32768.0f, 19);
+    auto mix = randomFloats(2 * NUM_FRAMES, 1.0f, 20);
+    auto gain = randomFloats(NUM_FRAMES, 1.0f, 21);
+    for (auto& g : gain) {
+        g = fabsf(g);
+    }
+    auto samples16 = randomInt16s(2 * NUM_FRAMES, 22);
+    std::vector<int16_t> output16(2 * NUM_FRAMES);
+    std::vector<uint32_t> peaks(NUM_FRAMES);
+    std::vector<float> silence(2 * NUM_FRAMES, 0.0f);
+    uint32_t ditherState = 0;
+    volatile bool result = false;
+
+    auto time = [&](const std::function<void()>& kernel) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            kernel();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / NUM_ITERATIONS;
+    };
+
+    struct Kernel {
+        const char* name;
+        std::function<void()> reference;
+        std::function<void()> dispatched;
+    };
+    std::vector<Kernel> kernels = {
+        { "silence detection",
+            [&] { result = hasNonZeroSamples_ref(silence.data(), 2 * NUM_FRAMES); },
+            [&] { result = hasNonZeroSamples(silence.data(), 2 * NUM_FRAMES); } },
+        { "accumulate float",
+            [&] { accumulateFloat_ref(stereo.data(), mix.data(), 2 * NUM_FRAMES); },
+            [&] { accumulateSamples(stereo.data(), mix.data(), 2 * NUM_FRAMES); } },
+        { "accumulate int16",
+            [&] { accumulateInt16_ref(samples16.data(), output16.data(), 2 * NUM_FRAMES); },
+            [&] { accumulateSamples(samples16.data(), output16.data(), 2 * NUM_FRAMES); } },
+        { "scale int16",
+            [&] { scaleInt16_ref(samples16.data(), output16.data(), 0.5f, 2 * NUM_FRAMES); },
+            [&] { scaleSamples(samples16.data(), output16.data(), 0.5f, 2 * NUM_FRAMES); } },
+        { "gainfade stereo",
+            [&] { gainfade_2x2_ref(samples16.data(), mix.data(), gain.data(), 0.5f, 0.7f, NUM_FRAMES); },
+            [&] { gainfade_2x2(samples16.data(), mix.data(), gain.data(), 0.5f, 0.7f, NUM_FRAMES); } },
+        { "peak detection stereo",
+            [&] { peakAbsBits_ref(stereo.data(), peaks.data(), NUM_FRAMES, 2); },
+            [&] { peakAbsBits(stereo.data(), peaks.data(), NUM_FRAMES, 2); } },
+        { "gain, dither and int16 stereo",
+            [&] { gainDitherToInt16_ref(stereo.data(), gain.data(), output16.data(), NUM_FRAMES, 2, ditherState); },
+            [&] { gainDitherToInt16(stereo.data(), gain.data(), output16.data(), NUM_FRAMES, 2, ditherState); } },
+    };
+
+    std::cout << "[" << NUM_FRAMES << " stereo frames, " << (hasAVX2() ? "AVX2" : "reference") << " dispatch]" << std::endl;
+    std::cout << "[kernel, reference nsecs, dispatched nsecs, speedup]" << std::endl;
+    for (auto& kernel : kernels) {
+        double reference = time(kernel.reference);
+        double dispatched = time(kernel.dispatched);
+        std::cout << "    " << kernel.name << ", " << reference << ", " << dispatched << ", "
+            << (dispatched > 0.0 ? reference / dispatched : 0.0) << "x" << std::endl;
+    }
+
+    AudioLimiter limiter(AudioConstants::SAMPLE_RATE, 2);
+    std::vector<float> input(2 * NUM_FRAMES);
+    double limiterNsecs = time([&] {
+        input = stereo;
+        limiter.render(input.data(), output16.data(), NUM_FRAMES);
+    });
+    std::cout << "    limiter stereo, " << limiterNsecs << std::endl;
+}
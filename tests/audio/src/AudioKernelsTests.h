@@ -0,0 +1,38 @@
+//
+//  AudioKernelsTests.h
+//  tests/audio/src
+//
+//  Created on 11/12/19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioKernelsTests_h
+#define hifi_AudioKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the dispatched kernels match the reference code bit for bit, for block sizes around the SIMD widths
+    void silenceTest();
+    void accumulateTest();
+    void scaleTest();
+    void gainfadeTest();
+    void peakTest();
+    void gainDitherTest();
+
+    // Test that the limiter output does not depend on how the input is split into blocks
+    void limiterBlockTest();
+
+    // Test that the ring buffer add and faded write paths match a sample by sample computation
+    void ringBufferTest();
+
+    // Reports the throughput of each kernel, reference and dispatched
+    void kernelBenchmark();
+};
+
+#endif // hifi_AudioKernelsTests_h
@@ -0,0 +1,249 @@
+//
+//  AvatarEncodeTests.cpp
+//  tests/avatars/src
+//
+//  Created on 2019-11-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarEncodeTests.h"
+
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+#include <AvatarEncodeCache.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AvatarEncodeTests)
+
+static const int NUM_JOINTS = 80;
+
+// An avatar as the mixer sees it, with its joints and global position set directly instead of parsed from packets
+class SyntheticAvatar : public AvatarData {
+public:
+    SyntheticAvatar(glm::vec3 position) : _basePosition(position) {
+        setSessionUUID(QUuid::createUuid());
+        animate(0);
+    }
+
+    // moves the avatar and its joints a little, like an animated avatar between two frames
+    void animate(int frame) {
+        float t = (float)frame * 0.05f;
+        _globalPosition = _basePosition + glm::vec3(0.2f * sinf(t), 0.0f, 0.2f * cosf(t));
+        for (int i = 0; i < NUM_JOINTS; ++i) {
+            // the extremities move a lot, the spine barely does
+            float amplitude = (i % 4 == 0) ? 0.001f : 0.3f;
+            glm::vec3 axis = glm::normalize(glm::vec3(1.0f + i % 3, 1.0f + i % 5, 1.0f + i % 7));
+            setJointData(i, glm::angleAxis(amplitude * sinf(t + (float)i), axis), glm::vec3(0.0f, 0.1f, 0.0f));
+        }
+    }
+
+private:
+    glm::vec3 _basePosition;
+};
+
+// the bytes a viewer parses, the UUID is stripped by the receiving avatar hash map
+static QByteArray withoutUUID(const QByteArray& bytes) {
+    return bytes.mid(NUM_BYTES_RFC4122_UUID);
+}
+
+void AvatarEncodeTests::sharedEncodeTest() {
+    SyntheticAvatar avatar(glm::vec3(0.0f));
+    AvatarEncodeCache cache;
+
+    glm::vec3 nearViewer(5.0f, 0.0f, 0.0f);
+    glm::vec3 otherNearViewer(0.0f, 0.0f, -6.0f);
+    glm::vec3 farViewer(300.0f, 0.0f, 0.0f);
+
+    bool encoded = false;
+    const auto& first = cache.get(avatar, 1, nearViewer, false, &encoded);
+    QVERIFY(encoded);
+    QVERIFY(first.isKeyframe());
+    QVERIFY(first.version != 0);
+
+    // the first encode of a level is a full one, identical to what any viewer would get
+    QVector<JointData> noJoints(NUM_JOINTS);
+    AvatarDataPacket::SendStatus sendStatus;
+    sendStatus.sendUUID = true;
+    auto fullBytes = avatar.toByteArray(AvatarData::SendAllData, 0, noJoints, sendStatus, false, true, nearViewer, nullptr);
+    QCOMPARE(first.bytes, fullBytes);
+    uint32_t firstVersion = first.version;
+
+    // anyone in the same level this frame gets the same encode
+    const auto& shared = cache.get(avatar, 1, otherNearViewer, true, &encoded);
+    QVERIFY(!encoded);
+    QCOMPARE(shared.version, firstVersion);
+
+    // other levels have their own
+    const auto& far = cache.get(avatar, 1, farViewer, false, &encoded);
+    QVERIFY(encoded);
+    QVERIFY(far.version != firstVersion);
+
+    // next frame is a delta against the previous one
+    avatar.animate(1);
+    const auto& delta = cache.get(avatar, 2, nearViewer, false, &encoded);
+    QVERIFY(encoded);
+    QVERIFY(!delta.isKeyframe());
+    QCOMPARE(delta.baseVersion, firstVersion);
+    QVERIFY(delta.appliesTo(firstVersion));
+    QVERIFY(!delta.appliesTo(0));
+    QVERIFY(delta.bytes.size() < fullBytes.size());
+    uint32_t deltaVersion = delta.version;
+
+    // and a keyframe applies to everyone
+    avatar.animate(2);
+    const auto& keyframe = cache.get(avatar, 3, nearViewer, true, &encoded);
+    QVERIFY(encoded);
+    QVERIFY(keyframe.isKeyframe());
+    QVERIFY(keyframe.appliesTo(0));
+    QVERIFY(keyframe.version != deltaVersion);
+}
+
+void AvatarEncodeTests::sharedEncodeDecodeTest() {
+    SyntheticAvatar avatar(glm::vec3(0.0f));
+    SyntheticAvatar viewer(glm::vec3(3.0f, 0.0f, 0.0f));
+    glm::vec3 viewerPosition = viewer.getClientGlobalPosition();
+    AvatarEncodeCache cache;
+
+    const int NUM_FRAMES = 20;
+    for (int frame = 1; frame <= NUM_FRAMES; ++frame) {
+        avatar.animate(frame);
+        const auto& encode = cache.get(avatar, frame, viewerPosition, false);
+        QCOMPARE(encode.isKeyframe(), frame == 1);
+        viewer.parseDataFromBuffer(withoutUUID(encode.bytes));
+    }
+
+    // every joint is where the avatar has it, give or take quantization and the culled small changes
+    auto sentJoints = avatar.getJointData();
+    auto receivedJoints = viewer.getJointData();
+    QCOMPARE(receivedJoints.size(), sentJoints.size());
+    for (int i = 0; i < sentJoints.size(); ++i) {
+        float dot = fabsf(glm::dot(sentJoints[i].rotation, receivedJoints[i].rotation));
+        QVERIFY2(dot > 0.999f, qPrintable(QString("joint %1 is off (dot %2)").arg(i).arg(dot)));
+    }
+}
+
+void AvatarEncodeTests::toBufferTest() {
+    SyntheticAvatar avatar(glm::vec3(0.0f));
+    glm::vec3 viewerPosition(2.0f, 0.0f, 0.0f);
+    QVector<JointData> noJoints(NUM_JOINTS);
+
+    // small enough that a full encode spans a few packets
+    const int MAX_DATA_SIZE = 200;
+
+    for (auto detail : { AvatarData::NoData, AvatarData::MinimumData, AvatarData::SendAllData }) {
+        AvatarDataPacket::SendStatus arrayStatus;
+        AvatarDataPacket::SendStatus bufferStatus;
+        arrayStatus.sendUUID = bufferStatus.sendUUID = true;
+        QVector<JointData> arraySentJoints;
+        QVector<JointData> bufferSentJoints;
+
+        do {
+            auto bytes = avatar.toByteArray(detail, 0, noJoints, arrayStatus, false, true, viewerPosition,
+                                            &arraySentJoints, MAX_DATA_SIZE);
+
+            // fill with junk, toBuffer has to write every byte it reports
+            std::vector<unsigned char> buffer(MAX_DATA_SIZE, 0xAB);
+            int numBytes = avatar.toBuffer(buffer.data(), MAX_DATA_SIZE, detail, 0, noJoints, bufferStatus, false, true,
+                                           viewerPosition, &bufferSentJoints);
+
+            QCOMPARE(numBytes, bytes.size());
+            QVERIFY(numBytes <= MAX_DATA_SIZE);
+            QCOMPARE(QByteArray((const char*)buffer.data(), numBytes), bytes);
+            QCOMPARE(bufferStatus.itemFlags, arrayStatus.itemFlags);
+        } while (!arrayStatus);
+
+        QCOMPARE(bufferSentJoints.size(), arraySentJoints.size());
+    }
+}
+
+void AvatarEncodeTests::serializationBenchmark() {
+    const int GRID_SIZE = 10;
+    const float GRID_SPACING = 4.0f;
+    const int NUM_FRAMES = 50;
+    const int NUM_AVATARS = GRID_SIZE * GRID_SIZE;
+
+    std::vector<std::unique_ptr<SyntheticAvatar>> avatars;
+    for (int i = 0; i < NUM_AVATARS; ++i) {
+        glm::vec3 position((float)(i % GRID_SIZE) * GRID_SPACING, 0.0f, (float)(i / GRID_SIZE) * GRID_SPACING);
+        avatars.emplace_back(new SyntheticAvatar(position));
+    }
+
+    // what the mixer keeps per viewer and source
+    struct ViewerState {
+        QVector<JointData> lastSentJoints;
+        quint64 lastEncodeTime { 0 };
+        uint32_t encodeVersion { 0 };
+    };
+
+    std::cout << "[" << NUM_AVATARS << " avatars seeing each other, " << NUM_FRAMES << " frames]" << std::endl;
+    std::cout << "[encoding, usecs/frame, encodes/frame, bytes/frame]" << std::endl;
+
+    for (bool shared : { false, true }) {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> distribution;
+
+        std::vector<ViewerState> viewerStates(NUM_AVATARS * NUM_AVATARS);
+        std::vector<std::unique_ptr<AvatarEncodeCache>> caches;
+        for (int i = 0; i < NUM_AVATARS; ++i) {
+            caches.emplace_back(new AvatarEncodeCache());
+        }
+
+        quint64 totalUsecs = 0;
+        uint64_t numEncodes = 0;
+        uint64_t numBytes = 0;
+
+        for (int frame = 1; frame <= NUM_FRAMES; ++frame) {
+            for (auto& avatar : avatars) {
+                avatar->animate(frame);
+            }
+
+            auto start = usecTimestampNow();
+            for (int viewer = 0; viewer < NUM_AVATARS; ++viewer) {
+                glm::vec3 viewerPosition = avatars[viewer]->getClientGlobalPosition();
+                for (int source = 0; source < NUM_AVATARS; ++source) {
+                    if (source == viewer) {
+                        continue;
+                    }
+                    auto& state = viewerStates[viewer * NUM_AVATARS + source];
+                    auto& avatar = *avatars[source];
+                    bool sendAll = distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO;
+
+                    if (shared) {
+                        bool encoded = false;
+                        const auto& encode = caches[source]->get(avatar, frame, viewerPosition, sendAll, &encoded);
+                        numEncodes += encoded ? 1 : 0;
+                        if (encode.appliesTo(state.encodeVersion)) {
+                            state.lastSentJoints = encode.sentJoints;
+                            state.encodeVersion = encode.version;
+                            state.lastEncodeTime = usecTimestampNow();
+                            numBytes += encode.bytes.size();
+                            continue;
+                        }
+                        state.encodeVersion = 0;
+                    }
+
+                    AvatarDataPacket::SendStatus sendStatus;
+                    sendStatus.sendUUID = true;
+                    auto bytes = avatar.toByteArray(sendAll ? AvatarData::SendAllData : AvatarData::CullSmallData,
+                                                    state.lastEncodeTime, state.lastSentJoints, sendStatus, false, true,
+                                                    viewerPosition, &state.lastSentJoints);
+                    state.lastEncodeTime = usecTimestampNow();
+                    ++numEncodes;
+                    numBytes += bytes.size();
+                }
+            }
+            totalUsecs += usecTimestampNow() - start;
+        }
+
+        std::cout << "    " << (shared ? "shared" : "per viewer") << ", " << totalUsecs / NUM_FRAMES << ", "
+            << numEncodes / NUM_FRAMES << ", " << numBytes / NUM_FRAMES << std::endl;
+    }
+}
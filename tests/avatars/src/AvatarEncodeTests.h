@@ -0,0 +1,34 @@
+//
+//  AvatarEncodeTests.h
+//  tests/avatars/src
+//
+//  Created on 2019-11-08.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarEncodeTests_h
+#define hifi_AvatarEncodeTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarEncodeTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that encodes are shared within a frame and distance level, and chain from one frame to the next
+    void sharedEncodeTest();
+
+    // Test that a viewer only sent the shared encodes ends up with the avatar's joints
+    void sharedEncodeDecodeTest();
+
+    // Test that encoding straight into a packet's payload gives the bytes toByteArray does, split the same way
+    void toBufferTest();
+
+    // Reports serialization time per frame for a crowd of synthetic avatars that all see each other,
+    // encoding for every viewer the way the avatar mixer used to, and through the shared encodes
+    void serializationBenchmark();
+};
+
+#endif // hifi_AvatarEncodeTests_h
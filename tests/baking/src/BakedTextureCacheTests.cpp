@@ -0,0 +1,186 @@
+//
+//  BakedTextureCacheTests.cpp
+//  tests/baking/src
+//
+//  Created on 2019-12-01.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedTextureCacheTests.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QTemporaryDir>
+
+#include <BakedTextureCache.h>
+#include <ktx/KTX.h>
+
+QTEST_MAIN(BakedTextureCacheTests)
+
+static QByteArray sourceHash(const QByteArray& image) {
+    return QCryptographicHash::hash(image, QCryptographicHash::Sha256);
+}
+
+// an uncompressed size x size RGBA texture with a single mip, the cache only serves whole KTX files
+static QByteArray makeKTX(uint32_t size) {
+    ktx::Header header;
+    header.setUncompressed(ktx::GLType::UNSIGNED_BYTE, 1, ktx::GLFormat::RGBA, ktx::GLInternalFormat::RGBA8,
+                           ktx::GLBaseInternalFormat::RGBA);
+    header.set2D(size, size);
+    header.numberOfMipmapLevels = 1;
+    auto texture = ktx::KTX::createBare(header);
+    const auto& storage = texture->getStorage();
+    return QByteArray(reinterpret_cast<const char*>(storage->data()), (int)storage->size());
+}
+
+void BakedTextureCacheTests::keyTest() {
+    auto hash = sourceHash("image");
+    auto key = BakedTextureCache::makeKey(hash, image::TextureUsage::ALBEDO_TEXTURE, gpu::BackendTarget::GL45, true);
+
+    QCOMPARE(key, BakedTextureCache::makeKey(hash, image::TextureUsage::ALBEDO_TEXTURE, gpu::BackendTarget::GL45, true));
+
+    QSet<BakedTextureCache::Key> keys {
+        key,
+        BakedTextureCache::makeKey(sourceHash("other image"), image::TextureUsage::ALBEDO_TEXTURE, gpu::BackendTarget::GL45, true),
+        BakedTextureCache::makeKey(hash, image::TextureUsage::NORMAL_TEXTURE, gpu::BackendTarget::GL45, true),
+        BakedTextureCache::makeKey(hash, image::TextureUsage::ALBEDO_TEXTURE, gpu::BackendTarget::GLES32, true),
+        BakedTextureCache::makeKey(hash, image::TextureUsage::ALBEDO_TEXTURE, gpu::BackendTarget::GL45, false)
+    };
+    QCOMPARE(keys.size(), 5);
+}
+
+void BakedTextureCacheTests::findTest() {
+    BakedTextureCache cache;
+    auto key = BakedTextureCache::makeKey(sourceHash("image"), image::TextureUsage::ALBEDO_TEXTURE,
+                                          gpu::BackendTarget::GL45, true);
+
+    QVERIFY(cache.find(key).isEmpty());
+
+    QByteArray ktx = makeKTX(16);
+    cache.insert(key, ktx, 5000);
+    QCOMPARE(cache.find(key), ktx);
+    QCOMPARE(cache.find(key), ktx);
+
+    auto stats = cache.getStats();
+    QCOMPARE(stats.hits, (uint64_t)2);
+    QCOMPARE(stats.misses, (uint64_t)1);
+    QCOMPARE(stats.savedUsecs, (uint64_t)10000);
+    QCOMPARE(stats.bakedUsecs, (uint64_t)5000);
+}
+
+void BakedTextureCacheTests::directoryTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto key = BakedTextureCache::makeKey(sourceHash("image"), image::TextureUsage::SKY_TEXTURE,
+                                          gpu::BackendTarget::GL45, false);
+    QByteArray ktx = makeKTX(32);
+
+    {
+        BakedTextureCache cache;
+        cache.setDirectory(dir.path());
+        cache.insert(key, ktx, 7000);
+    }
+
+    BakedTextureCache otherCache;
+    otherCache.setDirectory(dir.path());
+    QCOMPARE(otherCache.find(key), ktx);
+    QCOMPARE(otherCache.getStats().savedUsecs, (uint64_t)7000);
+
+    // entries beyond the budget of the directory are dropped when it's set
+    BakedTextureCache trimmedCache;
+    trimmedCache.setDirectory(dir.path(), ktx.size() / 2);
+    QVERIFY(trimmedCache.find(key).isEmpty());
+}
+
+void BakedTextureCacheTests::trimTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto usedKey = BakedTextureCache::makeKey(sourceHash("used image"), image::TextureUsage::ALBEDO_TEXTURE,
+                                              gpu::BackendTarget::GL45, true);
+    auto unusedKey = BakedTextureCache::makeKey(sourceHash("unused image"), image::TextureUsage::ALBEDO_TEXTURE,
+                                                gpu::BackendTarget::GL45, true);
+    QByteArray ktx = makeKTX(32);
+
+    {
+        BakedTextureCache cache;
+        cache.setDirectory(dir.path());
+        cache.insert(usedKey, ktx, 1000);
+        cache.insert(unusedKey, ktx, 1000);
+    }
+
+    // both were baked an hour ago, in the order that would trim the used one first by write time
+    QDir cacheDir { dir.path() };
+    QDateTime anHourAgo = QDateTime::currentDateTimeUtc().addSecs(-3600);
+    for (const auto& name : cacheDir.entryList(QDir::Files)) {
+        QFile file { cacheDir.absoluteFilePath(name) };
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(anHourAgo.addSecs(name.startsWith(QString(sourceHash("used image").toHex())) ? 0 : 1),
+                                 QFileDevice::FileModificationTime));
+    }
+
+    {
+        BakedTextureCache cache;
+        cache.setDirectory(dir.path());
+        QCOMPARE(cache.find(usedKey), ktx);
+    }
+
+    // room for one entry only
+    BakedTextureCache trimmedCache;
+    trimmedCache.setDirectory(dir.path(), ktx.size() + 1024);
+    QCOMPARE(trimmedCache.find(usedKey), ktx);
+    QVERIFY(trimmedCache.find(unusedKey).isEmpty());
+}
+
+void BakedTextureCacheTests::insertTrimTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QByteArray ktx = makeKTX(32);
+    const qint64 BUDGET = 4 * ktx.size();
+    BakedTextureCache cache;
+    cache.setDirectory(dir.path(), BUDGET);
+    for (int i = 0; i < 32; i++) {
+        auto key = BakedTextureCache::makeKey(sourceHash(QByteArray::number(i)), image::TextureUsage::ALBEDO_TEXTURE,
+                                              gpu::BackendTarget::GL45, true);
+        cache.insert(key, ktx, 1000);
+    }
+
+    qint64 size = 0;
+    for (const auto& file : QDir(dir.path()).entryInfoList(QDir::Files)) {
+        size += file.size();
+    }
+    QVERIFY(size > 0);
+    QVERIFY(size <= BUDGET);
+}
+
+void BakedTextureCacheTests::corruptEntryTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto key = BakedTextureCache::makeKey(sourceHash("image"), image::TextureUsage::ALBEDO_TEXTURE,
+                                          gpu::BackendTarget::GL45, true);
+    QByteArray ktx = makeKTX(32);
+    {
+        BakedTextureCache cache;
+        cache.setDirectory(dir.path());
+        cache.insert(key, ktx, 1000);
+    }
+
+    // cut the entry short, as a full disk or a crash of another tool could
+    QDir cacheDir { dir.path() };
+    auto files = cacheDir.entryList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    QFile file { cacheDir.absoluteFilePath(files.front()) };
+    QVERIFY(file.resize(file.size() / 2));
+
+    BakedTextureCache cache;
+    cache.setDirectory(dir.path());
+    QVERIFY(cache.find(key).isEmpty());
+    QCOMPARE(cache.getStats().misses, (uint64_t)1);
+    QVERIFY(cacheDir.entryList(QDir::Files).isEmpty());
+}
@@ -0,0 +1,39 @@
+//
+//  BakedTextureCacheTests.h
+//  tests/baking/src
+//
+//  Created on 2019-12-01.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakedTextureCacheTests_h
+#define hifi_BakedTextureCacheTests_h
+
+#include <QtTest/QtTest>
+
+class BakedTextureCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that every part of what a texture was baked from makes a different key
+    void keyTest();
+
+    // Test that lookups find what was inserted and count hits, misses and saved time
+    void findTest();
+
+    // Test that entries written to the cache directory are found by another cache, as another process would
+    void directoryTest();
+
+    // Test that the cache directory is trimmed least recently used first
+    void trimTest();
+
+    // Test that inserting keeps the cache directory within its budget
+    void insertTrimTest();
+
+    // Test that a damaged entry in the cache directory is removed instead of being served
+    void corruptEntryTest();
+};
+
+#endif // hifi_BakedTextureCacheTests_h
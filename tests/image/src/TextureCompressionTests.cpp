@@ -0,0 +1,255 @@
+//
+//  TextureCompressionTests.cpp
+//  tests/image/src
+//
+//  Created on 2019-12-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureCompressionTests.h"
+
+#include <iostream>
+#include <thread>
+
+#include <tbb/task_arena.h>
+
+#include <gpu/Texture.h>
+#include <image/Image.h>
+#include <image/TextureProcessing.h>
+
+QTEST_GUILESS_MAIN(TextureCompressionTests)
+
+struct CompressionFormat {
+    const char* name;
+    gpu::Element format;
+    gpu::BackendTarget target;
+    bool hdr;
+};
+
+static const std::vector<CompressionFormat> FORMATS {
+    { "BC1", gpu::Element::COLOR_COMPRESSED_BCX_SRGB, gpu::BackendTarget::GL45, false },
+    { "BC3", gpu::Element::COLOR_COMPRESSED_BCX_SRGBA, gpu::BackendTarget::GL45, false },
+    { "BC4", gpu::Element::COLOR_COMPRESSED_BCX_RED, gpu::BackendTarget::GL45, false },
+    { "BC5", gpu::Element::COLOR_COMPRESSED_BCX_XY, gpu::BackendTarget::GL45, false },
+    { "BC7", gpu::Element::COLOR_COMPRESSED_BCX_SRGBA_HIGH, gpu::BackendTarget::GL45, false },
+    { "BC6", gpu::Element::COLOR_COMPRESSED_BCX_HDR_RGB, gpu::BackendTarget::GL45, true },
+    { "R11G11B10", gpu::Element::COLOR_R11G11B10, gpu::BackendTarget::GL45, true },
+    { "ETC2", gpu::Element::COLOR_COMPRESSED_ETC2_SRGB, gpu::BackendTarget::GLES32, false },
+    { "ETC2 RGBA", gpu::Element::COLOR_COMPRESSED_ETC2_SRGBA, gpu::BackendTarget::GLES32, false },
+};
+
+// a noisy gradient, so that the blocks don't all compress the same way
+static image::Image makeImage(int size, bool hdr, int seed) {
+    image::Image result(size, size, hdr ? image::Image::Format_RGBAF : image::Image::Format_ARGB32);
+    quint32 noise = 1664525u * (quint32)seed + 1013904223u;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            noise = 1664525u * noise + 1013904223u;
+            int r = (x * 255) / size;
+            int g = (y * 255) / size;
+            int b = (noise >> 24) & 0xFF;
+            int a = ((x / 8 + y / 8) % 2) ? 255 : (noise >> 16) & 0xFF;
+            if (hdr) {
+                result.setFloatPixel(x, y, glm::vec4(4.0f * r / 255.0f, g / 255.0f, b / 255.0f, 1.0f));
+            } else {
+                result.setPackedPixel(x, y, qRgba(r, g, b, a));
+            }
+        }
+    }
+    return result;
+}
+
+static gpu::TexturePointer makeTexture(const CompressionFormat& format, int size) {
+    auto texture = gpu::Texture::create2D(format.format, size, size, gpu::Texture::MAX_NUM_MIPS,
+                                          gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR));
+    texture->setStoredMipFormat(format.format);
+    return texture;
+}
+
+// runs the conversion with the task pool restricted to the calling thread
+template <typename F>
+static void runSerial(F function) {
+    tbb::task_arena arena(1);
+    arena.execute(function);
+}
+
+static void compareMips(const gpu::TexturePointer& serial, const gpu::TexturePointer& parallel, int numFaces) {
+    for (uint8_t face = 0; face < numFaces; face++) {
+        for (uint16_t mip = 0; mip < serial->getNumMips(); mip++) {
+            QCOMPARE(parallel->isStoredMipFaceAvailable(mip, face), serial->isStoredMipFaceAvailable(mip, face));
+            if (!serial->isStoredMipFaceAvailable(mip, face)) {
+                continue;
+            }
+            auto serialMip = serial->accessStoredMipFace(mip, face);
+            auto parallelMip = parallel->accessStoredMipFace(mip, face);
+            QCOMPARE(parallelMip->size(), serialMip->size());
+            QVERIFY(memcmp(parallelMip->data(), serialMip->data(), serialMip->size()) == 0);
+        }
+    }
+}
+
+void TextureCompressionTests::parallelMatchesSerialTest() {
+    // not a multiple of the block size below the first few mips, so that the edge blocks are covered
+    const int SIZE = 256 + 64;
+    for (const auto& format : FORMATS) {
+        auto serial = makeTexture(format, SIZE);
+        auto parallel = makeTexture(format, SIZE);
+
+        runSerial([&] {
+            image::convertToTextureWithMips(serial.get(), makeImage(SIZE, format.hdr, 1), format.target);
+        });
+        image::convertToTextureWithMips(parallel.get(), makeImage(SIZE, format.hdr, 1), format.target);
+
+        QVERIFY2(serial->isStoredMipFaceAvailable(0), format.name);
+        QVERIFY2(serial->isStoredMipFaceAvailable(1), format.name);
+        compareMips(serial, parallel, 1);
+    }
+}
+
+void TextureCompressionTests::cubeFacesTest() {
+    const int SIZE = 128;
+    for (const auto& format : FORMATS) {
+        auto makeCube = [&] {
+            auto texture = gpu::Texture::createCube(format.format, SIZE, gpu::Texture::MAX_NUM_MIPS,
+                                                    gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR, gpu::Sampler::WRAP_CLAMP));
+            texture->setStoredMipFormat(format.format);
+            return texture;
+        };
+        auto makeFaces = [&] {
+            std::vector<image::Image> faces;
+            for (int face = 0; face < gpu::Texture::NUM_CUBE_FACES; face++) {
+                faces.push_back(makeImage(SIZE, format.hdr, face));
+            }
+            return faces;
+        };
+
+        auto serial = makeCube();
+        for (int face = 0; face < gpu::Texture::NUM_CUBE_FACES; face++) {
+            runSerial([&] {
+                image::convertToTextureWithMips(serial.get(), makeImage(SIZE, format.hdr, face), format.target, false, face);
+            });
+        }
+        auto parallel = makeCube();
+        image::convertToCubeTextureWithMips(parallel.get(), makeFaces(), format.target);
+
+        compareMips(serial, parallel, gpu::Texture::NUM_CUBE_FACES);
+    }
+}
+
+void TextureCompressionTests::abortTest() {
+    const int SIZE = 256;
+    std::atomic<bool> abortProcessing { true };
+    for (const auto& format : FORMATS) {
+        auto texture = makeTexture(format, SIZE);
+        image::convertToTextureWithMips(texture.get(), makeImage(SIZE, format.hdr, 1), format.target, abortProcessing);
+        for (uint16_t mip = 0; mip < texture->getNumMips(); mip++) {
+            QVERIFY2(!texture->isStoredMipFaceAvailable(mip), format.name);
+        }
+    }
+}
+
+void TextureCompressionTests::abortWhileRunningTest() {
+    const int SIZE = 1024;
+    const std::vector<int> ABORT_DELAYS_MSECS { 1, 5, 20, 50 };
+    for (const auto& format : FORMATS) {
+        auto reference = makeTexture(format, SIZE);
+        image::convertToTextureWithMips(reference.get(), makeImage(SIZE, format.hdr, 1), format.target);
+
+        for (int delay : ABORT_DELAYS_MSECS) {
+            std::atomic<bool> abortProcessing { false };
+            std::thread aborter([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+                abortProcessing = true;
+            });
+            auto texture = makeTexture(format, SIZE);
+            image::convertToTextureWithMips(texture.get(), makeImage(SIZE, format.hdr, 1), format.target, abortProcessing);
+            aborter.join();
+
+            // whichever mips made it in must be complete, a partly compressed one would differ from the reference
+            for (uint16_t mip = 0; mip < texture->getNumMips(); mip++) {
+                if (!texture->isStoredMipFaceAvailable(mip)) {
+                    continue;
+                }
+                QVERIFY2(reference->isStoredMipFaceAvailable(mip), format.name);
+                auto abortedMip = texture->accessStoredMipFace(mip);
+                auto referenceMip = reference->accessStoredMipFace(mip);
+                QCOMPARE(abortedMip->size(), referenceMip->size());
+                QVERIFY2(memcmp(abortedMip->data(), referenceMip->data(), referenceMip->size()) == 0, format.name);
+            }
+        }
+    }
+}
+
+void TextureCompressionTests::ggxConvolveTest() {
+    // a vertical cross of 64x64 faces
+    const int FACE_SIZE = 64;
+    auto makeCross = [&] {
+        image::Image cross(3 * FACE_SIZE, 4 * FACE_SIZE, image::Image::Format_ARGB32);
+        quint32 noise = 1013904223u;
+        for (int y = 0; y < 4 * FACE_SIZE; y++) {
+            for (int x = 0; x < 3 * FACE_SIZE; x++) {
+                noise = 1664525u * noise + 1013904223u;
+                cross.setPackedPixel(x, y, qRgba((x * 255) / (3 * FACE_SIZE), (y * 255) / (4 * FACE_SIZE), (noise >> 24) & 0xFF, 255));
+            }
+        }
+        return cross;
+    };
+    std::atomic<bool> abortProcessing { false };
+    auto convolve = [&] {
+        return image::TextureUsage::processCubeTextureColorFromImage(makeCross(), "cross", true, gpu::BackendTarget::GLES32,
+                                                                     image::TextureUsage::CUBE_GGX_CONVOLVE, abortProcessing);
+    };
+
+    gpu::TexturePointer serial;
+    runSerial([&] {
+        serial = convolve();
+    });
+    auto parallel = convolve();
+
+    QVERIFY(serial);
+    QVERIFY(parallel);
+    for (uint8_t face = 0; face < gpu::Texture::NUM_CUBE_FACES; face++) {
+        for (uint16_t mip = 0; mip < serial->getNumMips(); mip++) {
+            QVERIFY(serial->isStoredMipFaceAvailable(mip, face));
+        }
+    }
+    compareMips(serial, parallel, gpu::Texture::NUM_CUBE_FACES);
+}
+
+void TextureCompressionTests::compressionBenchmark() {
+    const int SIZE = 2048;
+    const int NUM_ITERATIONS = 3;
+    // the megapixels of the whole mip chain
+    const double MEGAPIXELS = (4.0 / 3.0) * SIZE * SIZE / 1.0e6;
+
+    auto time = [&](const CompressionFormat& format, bool serial) {
+        double totalSeconds = 0.0;
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            auto texture = makeTexture(format, SIZE);
+            auto source = makeImage(SIZE, format.hdr, i);
+            QElapsedTimer timer;
+            timer.start();
+            if (serial) {
+                runSerial([&] {
+                    image::convertToTextureWithMips(texture.get(), std::move(source), format.target);
+                });
+            } else {
+                image::convertToTextureWithMips(texture.get(), std::move(source), format.target);
+            }
+            totalSeconds += timer.nsecsElapsed() / 1.0e9;
+        }
+        return (MEGAPIXELS * NUM_ITERATIONS) / totalSeconds;
+    };
+
+    std::cout << "[" << SIZE << "x" << SIZE << " with mips, " << tbb::this_task_arena::max_concurrency() << " pool threads]" << std::endl;
+    std::cout << "[format, serial MP/s, parallel MP/s, speedup]" << std::endl;
+    for (const auto& format : FORMATS) {
+        double serial = time(format, true);
+        double parallel = time(format, false);
+        std::cout << "    " << format.name << ", " << serial << ", " << parallel << ", "
+            << (serial > 0.0 ? parallel / serial : 0.0) << "x" << std::endl;
+    }
+}
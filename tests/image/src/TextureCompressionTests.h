@@ -0,0 +1,39 @@
+//
+//  TextureCompressionTests.h
+//  tests/image/src
+//
+//  Created on 2019-12-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureCompressionTests_h
+#define hifi_TextureCompressionTests_h
+
+#include <QtTest/QtTest>
+
+class TextureCompressionTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that every format compresses to the same mips on the task pool as on a single thread
+    void parallelMatchesSerialTest();
+
+    // Test that the faces of a cube compressed side by side match the ones compressed one at a time
+    void cubeFacesTest();
+
+    // Test that an aborted compression stops without assigning the mips it skipped
+    void abortTest();
+
+    // Test that a compression aborted while it runs only assigns the mips it finished
+    void abortWhileRunningTest();
+
+    // Test that the GGX convolved mips of a GLES cube match the ones compressed one at a time
+    void ggxConvolveTest();
+
+    // Reports the megapixels per second of each format, on a single thread and on the task pool
+    void compressionBenchmark();
+};
+
+#endif // hifi_TextureCompressionTests_h
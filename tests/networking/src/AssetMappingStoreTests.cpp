@@ -0,0 +1,280 @@
+//
+//  AssetMappingStoreTests.cpp
+//  tests/networking/src
+//
+//  Created on 2019-11-29.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingStoreTests.h"
+
+#include <iostream>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTemporaryDir>
+
+#include <AssetMappingStore.h>
+
+QTEST_MAIN(AssetMappingStoreTests)
+
+static AssetUtils::AssetHash testHash(int index) {
+    return AssetUtils::hashData(QByteArray::number(index)).toHex();
+}
+
+static AssetUtils::AssetPath testPath(int index) {
+    return QString("/folder%1/asset%2.fbx").arg(index % 100).arg(index);
+}
+
+void AssetMappingStoreTests::commitTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath("map.json");
+
+    // start from an existing map file
+    {
+        QJsonObject root;
+        root["/existing.png"] = testHash(0);
+        QFile mapFile(mapFilePath);
+        QVERIFY(mapFile.open(QIODevice::WriteOnly));
+        mapFile.write(QJsonDocument(root).toJson());
+    }
+
+    {
+        AssetMappingStore store;
+        QVERIFY(store.load(mapFilePath));
+        QCOMPARE(store.size(), (size_t)1);
+
+        AssetMappingStore::Transaction transaction;
+        transaction.set("/a.fbx", testHash(1));
+        transaction.set("/b.fbx", testHash(2));
+        transaction.set("/c.fbx", testHash(2));
+        QVERIFY(store.commit(transaction));
+
+        AssetMappingStore::Transaction removal;
+        removal.remove("/a.fbx");
+        removal.remove("/c.fbx");
+        removal.remove("/not-mapped.fbx");
+        QVERIFY(store.commit(removal));
+
+        QVERIFY(store.getLogSize() > 0);
+        QVERIFY(!store.isHashMapped(testHash(1)));
+        QVERIFY(store.isHashMapped(testHash(2)));
+    }
+
+    AssetMappingStore reloaded;
+    QVERIFY(reloaded.load(mapFilePath));
+    QCOMPARE(reloaded.size(), (size_t)2);
+    QCOMPARE(reloaded.find("/existing.png")->second, testHash(0));
+    QCOMPARE(reloaded.find("/b.fbx")->second, testHash(2));
+    QVERIFY(reloaded.find("/a.fbx") == reloaded.end());
+    QVERIFY(reloaded.find("/c.fbx") == reloaded.end());
+    QVERIFY(reloaded.isHashMapped(testHash(0)));
+    QVERIFY(reloaded.isHashMapped(testHash(2)));
+    QVERIFY(!reloaded.isHashMapped(testHash(1)));
+}
+
+void AssetMappingStoreTests::tornTransactionTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath("map.json");
+    auto logFilePath = mapFilePath + ".log";
+
+    qint64 firstTransactionSize;
+    {
+        AssetMappingStore store;
+        QVERIFY(store.load(mapFilePath));
+
+        AssetMappingStore::Transaction first;
+        first.set("/first.fbx", testHash(1));
+        QVERIFY(store.commit(first));
+        firstTransactionSize = store.getLogSize();
+
+        AssetMappingStore::Transaction second;
+        for (int i = 0; i < 10; ++i) {
+            second.set(testPath(i), testHash(i));
+        }
+        QVERIFY(store.commit(second));
+    }
+
+    // cut the second transaction short, as if we went down while writing it
+    QVERIFY(QFile::resize(logFilePath, QFileInfo(logFilePath).size() - 8));
+
+    {
+        AssetMappingStore store;
+        QVERIFY(store.load(mapFilePath));
+        QCOMPARE(store.size(), (size_t)1);
+        QVERIFY(store.find("/first.fbx") != store.end());
+        QCOMPARE(store.getLogSize(), firstTransactionSize);
+        QCOMPARE(QFileInfo(logFilePath).size(), firstTransactionSize);
+
+        // new transactions go where the torn one was
+        AssetMappingStore::Transaction third;
+        third.set("/third.fbx", testHash(3));
+        QVERIFY(store.commit(third));
+    }
+
+    // a corrupted byte in the middle of a record is dropped the same way
+    {
+        QFile logFile(logFilePath);
+        QVERIFY(logFile.open(QIODevice::ReadWrite));
+        QVERIFY(logFile.seek(firstTransactionSize + 10));
+        QVERIFY(logFile.write("!", 1) == 1);
+    }
+
+    AssetMappingStore reloaded;
+    QVERIFY(reloaded.load(mapFilePath));
+    QCOMPARE(reloaded.size(), (size_t)1);
+    QVERIFY(reloaded.find("/first.fbx") != reloaded.end());
+}
+
+void AssetMappingStoreTests::compactionTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath("map.json");
+
+    AssetMappingStore store;
+    QVERIFY(store.load(mapFilePath));
+
+    for (int i = 0; i < 100; ++i) {
+        AssetMappingStore::Transaction transaction;
+        transaction.set(testPath(i), testHash(i));
+        if (i % 2) {
+            transaction.remove(testPath(i - 1));
+        }
+        QVERIFY(store.commit(transaction));
+    }
+    QVERIFY(store.getLogSize() > 0);
+    QVERIFY(!QFile::exists(mapFilePath));
+
+    QVERIFY(store.compact());
+    QCOMPARE(store.getLogSize(), (qint64)0);
+    QCOMPARE(QFileInfo(mapFilePath + ".log").size(), (qint64)0);
+
+    // the snapshot is the plain JSON map file
+    QFile mapFile(mapFilePath);
+    QVERIFY(mapFile.open(QIODevice::ReadOnly));
+    auto root = QJsonDocument::fromJson(mapFile.readAll()).object();
+    QCOMPARE(root.size(), 50);
+
+    AssetMappingStore reloaded;
+    QVERIFY(reloaded.load(mapFilePath));
+    QVERIFY(reloaded.getMappings() == store.getMappings());
+
+    // the log is compacted on its own once it outgrows the snapshot
+    AssetMappingStore::Transaction large;
+    for (int i = 0; i < 20000; ++i) {
+        large.set(testPath(i), testHash(i));
+    }
+    QVERIFY(reloaded.commit(large));
+    QCOMPARE(reloaded.getLogSize(), (qint64)0);
+    QCOMPARE(reloaded.size(), (size_t)20000);
+}
+
+void AssetMappingStoreTests::folderTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    AssetMappingStore store;
+    QVERIFY(store.load(dir.filePath("map.json")));
+
+    AssetMappingStore::Transaction transaction;
+    transaction.set("/a/x.fbx", testHash(1));
+    transaction.set("/a/y.fbx", testHash(2));
+    transaction.set("/a/sub/z.fbx", testHash(3));
+    transaction.set("/a.fbx", testHash(4));
+    transaction.set("/ab/w.fbx", testHash(5));
+    transaction.set("/b/v.fbx", testHash(6));
+    QVERIFY(store.commit(transaction));
+
+    auto folder = store.getFolder("/a/");
+    QStringList paths;
+    for (auto it = folder.first; it != folder.second; ++it) {
+        paths << it->first;
+    }
+    QCOMPARE(paths, QStringList({ "/a/sub/z.fbx", "/a/x.fbx", "/a/y.fbx" }));
+
+    folder = store.getFolder("/a/sub/");
+    QCOMPARE(std::distance(folder.first, folder.second), (std::ptrdiff_t)1);
+
+    folder = store.getFolder("/c/");
+    QVERIFY(folder.first == folder.second);
+
+    folder = store.getFolder("/");
+    QCOMPARE(std::distance(folder.first, folder.second), (std::ptrdiff_t)6);
+}
+
+void AssetMappingStoreTests::importBenchmark() {
+    const int NUM_MAPPINGS = 100000;
+    // rewriting the whole map file per mapping is quadratic, time a sample of it
+    const int NUM_REWRITES = 100;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    std::cout << "[import, mappings, ms]" << std::endl;
+
+    {
+        AssetMappingStore store;
+        QVERIFY(store.load(dir.filePath("single.json")));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < NUM_MAPPINGS; ++i) {
+            AssetMappingStore::Transaction transaction;
+            transaction.set(testPath(i), testHash(i));
+            QVERIFY(store.commit(transaction));
+        }
+        std::cout << "    transaction per mapping, " << NUM_MAPPINGS << ", " << timer.elapsed() << std::endl;
+    }
+
+    {
+        AssetMappingStore store;
+        QVERIFY(store.load(dir.filePath("batched.json")));
+
+        QElapsedTimer timer;
+        timer.start();
+        AssetMappingStore::Transaction transaction;
+        for (int i = 0; i < NUM_MAPPINGS; ++i) {
+            transaction.set(testPath(i), testHash(i));
+        }
+        QVERIFY(store.commit(transaction));
+        std::cout << "    single transaction, " << NUM_MAPPINGS << ", " << timer.elapsed() << std::endl;
+
+        QElapsedTimer loadTimer;
+        loadTimer.start();
+        AssetMappingStore reloaded;
+        QVERIFY(reloaded.load(dir.filePath("batched.json")));
+        QCOMPARE(reloaded.size(), (size_t)NUM_MAPPINGS);
+        std::cout << "    (reloaded in " << loadTimer.elapsed() << " ms)" << std::endl;
+    }
+
+    {
+        // what every mapping change used to cost once the server had this many mappings
+        AssetUtils::Mappings mappings;
+        for (int i = 0; i < NUM_MAPPINGS; ++i) {
+            mappings[testPath(i)] = testHash(i);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < NUM_REWRITES; ++i) {
+            QSaveFile mapFile(dir.filePath("rewrite.json"));
+            QVERIFY(mapFile.open(QIODevice::WriteOnly));
+            QJsonObject root;
+            for (const auto& mapping : mappings) {
+                root[mapping.first] = mapping.second;
+            }
+            mapFile.write(QJsonDocument(root).toJson());
+            QVERIFY(mapFile.commit());
+        }
+        std::cout << "    full map file rewrite, " << NUM_REWRITES << ", " << timer.elapsed() << std::endl;
+        std::cout << "    (" << timer.elapsed() / NUM_REWRITES << " ms per mapping at " << NUM_MAPPINGS << " mappings)"
+            << std::endl;
+    }
+}
@@ -0,0 +1,36 @@
+//
+//  AssetMappingStoreTests.h
+//  tests/networking/src
+//
+//  Created on 2019-11-29.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetMappingStoreTests_h
+#define hifi_AssetMappingStoreTests_h
+
+#include <QtTest/QtTest>
+
+class AssetMappingStoreTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that committed transactions are there after a reload, along with the snapshot they started from
+    void commitTest();
+
+    // Test that a transaction only partially written to the log is dropped whole on reload
+    void tornTransactionTest();
+
+    // Test that compaction moves the log into the snapshot without changing the mappings
+    void compactionTest();
+
+    // Test that folder queries return exactly the mappings below the folder
+    void folderTest();
+
+    // Reports the time to import 100k mappings one by one, as a single transaction, and by rewriting the map file
+    void importBenchmark();
+};
+
+#endif // hifi_AssetMappingStoreTests_h
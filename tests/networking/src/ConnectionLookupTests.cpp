@@ -0,0 +1,207 @@
+//
+//  ConnectionLookupTests.cpp
+//  tests/networking/src
+//
+//  Created on 2019-11-07.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ConnectionLookupTests.h"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <SharedUtil.h>
+#include <udt/ConnectionLookupTable.h>
+
+QTEST_MAIN(ConnectionLookupTests)
+
+static const int NUM_SENDERS = 4096;
+static const quint16 FIRST_SENDER_PORT = 20000;
+
+// the table never dereferences what it stores, so the tests hand it addresses inside a plain buffer
+static std::vector<char> fakeConnections(NUM_SENDERS + 1);
+
+static udt::Connection* fakeConnection(int index) {
+    return reinterpret_cast<udt::Connection*>(&fakeConnections[index]);
+}
+
+static std::vector<HifiSockAddr> createSenderSockAddrs() {
+    std::vector<HifiSockAddr> sockAddrs;
+    sockAddrs.reserve(NUM_SENDERS);
+    for (int i = 0; i < NUM_SENDERS; ++i) {
+        // spread the senders over a few addresses and ports, like clients behind a handful of NATs
+        QHostAddress address(QString("10.0.%1.%2").arg(i / 1024).arg(1 + (i % 200)));
+        sockAddrs.emplace_back(address, FIRST_SENDER_PORT + i);
+    }
+    return sockAddrs;
+}
+
+static udt::ConnectionLookupTable::Snapshot createSnapshot(const std::vector<HifiSockAddr>& sockAddrs) {
+    udt::ConnectionLookupTable::Snapshot snapshot;
+    snapshot.reserve(sockAddrs.size());
+    for (size_t i = 0; i < sockAddrs.size(); ++i) {
+        snapshot.emplace(sockAddrs[i], fakeConnection((int)i));
+    }
+    return snapshot;
+}
+
+void ConnectionLookupTests::concurrentPublishTest() {
+    auto sockAddrs = createSenderSockAddrs();
+    HifiSockAddr churnSockAddr(QHostAddress::LocalHost, FIRST_SENDER_PORT - 1);
+
+    udt::ConnectionLookupTable table;
+    table.publish(createSnapshot(sockAddrs));
+
+    const int NUM_READERS = 4;
+    std::atomic<bool> stop { false };
+    std::atomic<int> numMismatches { 0 };
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < NUM_READERS; ++r) {
+        readers.emplace_back([&, r] {
+            int i = r;
+            while (!stop) {
+                i = (i + 7) % NUM_SENDERS;
+                if (table.find(sockAddrs[i]) != fakeConnection(i)) {
+                    ++numMismatches;
+                }
+
+                auto churnConnection = table.find(churnSockAddr);
+                if (churnConnection && churnConnection != fakeConnection(NUM_SENDERS)) {
+                    ++numMismatches;
+                }
+            }
+        });
+    }
+
+    // keep adding and removing one connection while the readers run
+    const int NUM_PUBLISHES = 2000;
+    for (int i = 0; i < NUM_PUBLISHES; ++i) {
+        auto snapshot = createSnapshot(sockAddrs);
+        if (i % 2 == 0) {
+            snapshot.emplace(churnSockAddr, fakeConnection(NUM_SENDERS));
+        }
+        table.publish(std::move(snapshot));
+    }
+
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    QCOMPARE(numMismatches.load(), 0);
+    QCOMPARE(table.getNumPublishes(), (uint64_t)NUM_PUBLISHES + 1);
+    QVERIFY(table.find(churnSockAddr) == nullptr);
+}
+
+void ConnectionLookupTests::readerSlotsTest() {
+    auto sockAddrs = createSenderSockAddrs();
+
+    udt::ConnectionLookupTable first;
+    udt::ConnectionLookupTable second;
+    first.publish(createSnapshot(sockAddrs));
+    second.publish(createSnapshot(sockAddrs));
+
+    const int NUM_READERS = 4;
+    std::vector<std::thread> readers;
+    std::atomic<int> numMismatches { 0 };
+    for (int r = 0; r < NUM_READERS; ++r) {
+        readers.emplace_back([&, r] {
+            for (int i = r; i < NUM_SENDERS; i += NUM_READERS) {
+                // a lookup in the other table and a nested one in the same table while holding a snapshot
+                first.withSnapshot([&](const udt::ConnectionLookupTable::Snapshot& snapshot) {
+                    if (snapshot.at(sockAddrs[i]) != second.find(sockAddrs[i])
+                        || first.find(sockAddrs[i]) != fakeConnection(i)) {
+                        ++numMismatches;
+                    }
+                });
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    QCOMPARE(numMismatches.load(), 0);
+    QCOMPARE(first.getNumReaderSlots(), (size_t)NUM_READERS);
+    QCOMPARE(second.getNumReaderSlots(), (size_t)NUM_READERS);
+
+    // the slots of the threads that are gone are idle, so publishing doesn't wait on them
+    first.publish(createSnapshot(sockAddrs));
+    QCOMPARE(first.find(sockAddrs[0]), fakeConnection(0));
+    QCOMPARE(first.getNumReaderSlots(), (size_t)NUM_READERS + 1);
+}
+
+void ConnectionLookupTests::contentionBenchmark() {
+    const int LOOKUPS_PER_THREAD = 1000000;
+    const int WRITER_INTERVAL_USECS = 1000;
+
+    auto sockAddrs = createSenderSockAddrs();
+
+    std::mutex mapMutex;
+    std::unordered_map<HifiSockAddr, udt::Connection*> lockedMap = createSnapshot(sockAddrs);
+
+    udt::ConnectionLookupTable table;
+    table.publish(createSnapshot(sockAddrs));
+
+    std::cout << "[lookup, reader threads, lookups/s]" << std::endl;
+
+    for (bool lockFree : { false, true }) {
+        for (int numReaders : { 1, 2, 4, 8 }) {
+            std::atomic<bool> readersDone { false };
+            std::atomic<uint64_t> numFound { 0 };
+
+            // a connection comes or goes every so often, like a real socket
+            std::thread writer([&] {
+                while (!readersDone) {
+                    if (lockFree) {
+                        table.publish(createSnapshot(sockAddrs));
+                    } else {
+                        std::lock_guard<std::mutex> lock(mapMutex);
+                        lockedMap = createSnapshot(sockAddrs);
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(WRITER_INTERVAL_USECS));
+                }
+            });
+
+            auto startTime = usecTimestampNow();
+
+            std::vector<std::thread> readers;
+            for (int r = 0; r < numReaders; ++r) {
+                readers.emplace_back([&, r] {
+                    uint64_t found = 0;
+                    int i = r * 131;
+                    for (int lookup = 0; lookup < LOOKUPS_PER_THREAD; ++lookup) {
+                        i = (i + 7) % NUM_SENDERS;
+                        if (lockFree) {
+                            found += table.find(sockAddrs[i]) != nullptr;
+                        } else {
+                            std::lock_guard<std::mutex> lock(mapMutex);
+                            found += lockedMap.find(sockAddrs[i]) != lockedMap.end();
+                        }
+                    }
+                    numFound += found;
+                });
+            }
+            for (auto& reader : readers) {
+                reader.join();
+            }
+
+            auto elapsedUsecs = std::max(usecTimestampNow() - startTime, (quint64)1);
+            readersDone = true;
+            writer.join();
+
+            QCOMPARE(numFound.load(), (uint64_t)numReaders * LOOKUPS_PER_THREAD);
+
+            float lookupsPerSecond = (float)numReaders * LOOKUPS_PER_THREAD * USECS_PER_SECOND / (float)elapsedUsecs;
+            std::cout << "    " << (lockFree ? "lookup table" : "mutex + map") << ", " << numReaders << ", "
+                << lookupsPerSecond << std::endl;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+//
+//  ConnectionLookupTests.h
+//  tests/networking/src
+//
+//  Created on 2019-11-07.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ConnectionLookupTests_h
+#define hifi_ConnectionLookupTests_h
+
+#include <QtTest/QtTest>
+
+class ConnectionLookupTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that readers always find the stable entries while a writer keeps publishing new snapshots
+    void concurrentPublishTest();
+
+    // Test that each reading thread gets one slot per table, and that reads nest and span tables
+    void readerSlotsTest();
+
+    // Reports lookups per second for a mutex guarded map and the lookup table, with several reader threads
+    void contentionBenchmark();
+};
+
+#endif // hifi_ConnectionLookupTests_h
@@ -0,0 +1,195 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Created on 2019-11-13.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <NLPacket.h>
+#include <udt/PacketBufferPool.h>
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+using namespace udt;
+
+void PacketBufferPoolTests::threadPoolingTest() {
+    auto& bufferPool = PacketBufferPool::getInstance();
+    PacketBufferPool::sampleThreadStats();
+
+    // outside of a pooling burst packets come from the heap
+    {
+        auto packet = NLPacket::create(PacketType::BulkAvatarData);
+        QVERIFY(!packet->hasPooledBuffer());
+    }
+    auto stats = PacketBufferPool::sampleThreadStats();
+    QCOMPARE(stats.allocated, (uint64_t)1);
+    QCOMPARE(stats.pooled, (uint64_t)0);
+
+    bufferPool.beginThreadPooling();
+    QVERIFY(bufferPool.isThreadPooling());
+
+    const char* firstBuffer = nullptr;
+    {
+        auto packet = NLPacket::create(PacketType::BulkAvatarData);
+        QVERIFY(packet->hasPooledBuffer());
+        firstBuffer = packet->getData();
+
+        // dirty the whole buffer, the next packet must not see it
+        std::vector<char> junk(packet->getPayloadCapacity(), 'x');
+        packet->write(junk.data(), junk.size());
+    }
+
+    {
+        // the buffer we just gave back is the next one out of the thread's cache
+        auto packet = NLPacket::create(PacketType::MixedAudio);
+        QVERIFY(packet->hasPooledBuffer());
+        QCOMPARE(packet->getData(), firstBuffer);
+        QCOMPARE(packet->getType(), PacketType::MixedAudio);
+        QCOMPARE(packet->getPayloadSize(), (qint64)0);
+
+        const char* payload = packet->getPayload();
+        for (int i = 0; i < packet->getPayloadCapacity(); ++i) {
+            QCOMPARE(payload[i], (char)0);
+        }
+    }
+
+    // packets bigger than a pool buffer still go to the heap
+    {
+        auto packet = BasePacket::create(PacketBufferPool::BUFFER_SIZE + 1);
+        QVERIFY(!packet->hasPooledBuffer());
+    }
+
+    bufferPool.endThreadPooling();
+    QVERIFY(!bufferPool.isThreadPooling());
+
+    stats = PacketBufferPool::sampleThreadStats();
+    QCOMPARE(stats.pooled + stats.allocated, (uint64_t)3);
+    QVERIFY(stats.pooled >= 1);
+
+    // sampling resets the counters
+    stats = PacketBufferPool::sampleThreadStats();
+    QCOMPARE(stats.pooled + stats.allocated, (uint64_t)0);
+}
+
+void PacketBufferPoolTests::crossThreadReleaseTest() {
+    auto& bufferPool = PacketBufferPool::getInstance();
+
+    const int NUM_PACKETS = (int)PacketBufferPool::THREAD_CACHE_SIZE;
+
+    // build packets here, and let another thread destroy them, like a reliable send through the send queue would
+    bufferPool.beginThreadPooling();
+    std::vector<std::unique_ptr<NLPacket>> packets;
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        packets.push_back(NLPacket::create(PacketType::BulkAvatarData));
+    }
+    bufferPool.endThreadPooling();
+
+    std::thread([&] {
+        packets.clear();
+    }).join();
+
+    // they went back to the shared free list, the next burst refills from there
+    QVERIFY(bufferPool.getNumFreeBuffers() >= (size_t)NUM_PACKETS);
+
+    PacketBufferPool::sampleThreadStats();
+    bufferPool.beginThreadPooling();
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        packets.push_back(NLPacket::create(PacketType::BulkAvatarData));
+    }
+    packets.clear();
+    bufferPool.endThreadPooling();
+
+    auto stats = PacketBufferPool::sampleThreadStats();
+    QCOMPARE(stats.pooled, (uint64_t)NUM_PACKETS);
+    QCOMPARE(stats.allocated, (uint64_t)0);
+}
+
+void PacketBufferPoolTests::spillTest() {
+    auto& bufferPool = PacketBufferPool::getInstance();
+
+    const int NUM_PACKETS = (int)PacketBufferPool::THREAD_CACHE_SIZE;
+
+    bufferPool.beginThreadPooling();
+    {
+        std::vector<std::unique_ptr<NLPacket>> packets;
+        for (int i = 0; i < NUM_PACKETS; ++i) {
+            packets.push_back(NLPacket::create(PacketType::BulkAvatarData));
+        }
+        // destroyed while pooling, so they go to this thread's cache
+    }
+    auto numFreeBeforeSpill = bufferPool.getNumFreeBuffers();
+
+    // nested, nothing is spilled until the outermost end
+    bufferPool.beginThreadPooling();
+    bufferPool.endThreadPooling();
+    QCOMPARE(bufferPool.getNumFreeBuffers(), numFreeBeforeSpill);
+
+    bufferPool.endThreadPooling();
+    QCOMPARE(bufferPool.getNumFreeBuffers(), numFreeBeforeSpill + NUM_PACKETS - PacketBufferPool::THREAD_CACHE_REFILL);
+
+    // the next burst starts from what the cache kept
+    PacketBufferPool::sampleThreadStats();
+    bufferPool.beginThreadPooling();
+    auto packet = NLPacket::create(PacketType::BulkAvatarData);
+    QCOMPARE(bufferPool.getNumFreeBuffers(), numFreeBeforeSpill + NUM_PACKETS - PacketBufferPool::THREAD_CACHE_REFILL);
+    packet.reset();
+    bufferPool.endThreadPooling();
+    QCOMPARE(PacketBufferPool::sampleThreadStats().pooled, (uint64_t)1);
+}
+
+void PacketBufferPoolTests::packetFrameBenchmark() {
+    auto& bufferPool = PacketBufferPool::getInstance();
+
+    // about what an avatar mixer slave sends to 100 listeners in a frame
+    const int NUM_PACKETS_PER_FRAME = 300;
+    const int NUM_FRAMES = 1000;
+    const int PAYLOAD_SIZE = 1000;
+    std::vector<char> payload(PAYLOAD_SIZE, 1);
+
+    std::cout << "[" << NUM_PACKETS_PER_FRAME << " packets of " << PAYLOAD_SIZE << " bytes per frame]" << std::endl;
+    std::cout << "[buffers, nsecs/packet, allocations/frame]" << std::endl;
+
+    for (bool pooled : { false, true }) {
+        std::vector<std::unique_ptr<NLPacket>> packets;
+        packets.reserve(NUM_PACKETS_PER_FRAME);
+        PacketBufferPool::sampleThreadStats();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+            if (pooled) {
+                bufferPool.beginThreadPooling();
+            }
+
+            for (int i = 0; i < NUM_PACKETS_PER_FRAME; ++i) {
+                auto packet = NLPacket::create(PacketType::BulkAvatarData);
+                packet->write(payload.data(), payload.size());
+                packets.push_back(std::move(packet));
+            }
+            // "sent"
+            packets.clear();
+
+            if (pooled) {
+                bufferPool.endThreadPooling();
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto stats = PacketBufferPool::sampleThreadStats();
+        auto nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        std::cout << (pooled ? "pooled" : "heap") << ", "
+                  << (double)nsecs / (NUM_FRAMES * NUM_PACKETS_PER_FRAME) << ", "
+                  << (double)stats.allocated / NUM_FRAMES << std::endl;
+    }
+}
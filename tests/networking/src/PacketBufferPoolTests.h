@@ -0,0 +1,33 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Created on 2019-11-13.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#include <QtTest/QtTest>
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that packets built on a pooling thread recycle their buffers, start zeroed, and are counted
+    void threadPoolingTest();
+
+    // Test that buffers given back on another thread make it back to the pooling thread
+    void crossThreadReleaseTest();
+
+    // Test that a burst's buffers beyond one refill are spilled to the shared free list when pooling ends
+    void spillTest();
+
+    // Reports the cost of building and destroying a frame's worth of mixer packets, with and without pooling
+    void packetFrameBenchmark();
+};
+
+#endif // hifi_PacketBufferPoolTests_h
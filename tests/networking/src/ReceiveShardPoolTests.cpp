@@ -0,0 +1,79 @@
+//
+//  ReceiveShardPoolTests.cpp
+//  tests/networking/src
+//
+//  Created on 2019-11-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceiveShardPoolTests.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <udt/Packet.h>
+#include <udt/ReceiveShardPool.h>
+
+QTEST_MAIN(ReceiveShardPoolTests)
+
+void ReceiveShardPoolTests::senderOrderTest() {
+    const int NUM_SHARDS = 4;
+    const int NUM_SENDERS = 16;
+    const int PACKETS_PER_SENDER = 500;
+    const quint16 FIRST_SENDER_PORT = 40000;
+
+    std::mutex processedMutex;
+    std::unordered_map<quint16, std::vector<int>> processedIndices;
+    std::atomic<int> numProcessed { 0 };
+
+    {
+        udt::ReceiveShardPool pool(NUM_SHARDS, [&](std::unique_ptr<udt::Packet> packet) {
+            int index;
+            packet->readPrimitive(&index);
+            {
+                std::lock_guard<std::mutex> lock(processedMutex);
+                processedIndices[packet->getSenderSockAddr().getPort()].push_back(index);
+            }
+            ++numProcessed;
+        });
+        QCOMPARE(pool.numShards(), NUM_SHARDS);
+
+        // interleave the senders the way they would come off the socket
+        for (int i = 0; i < PACKETS_PER_SENDER; ++i) {
+            for (int sender = 0; sender < NUM_SENDERS; ++sender) {
+                auto packet = udt::Packet::create();
+                packet->writePrimitive(i);
+                packet->seek(0);
+                packet->getSenderSockAddr() = HifiSockAddr(QHostAddress::LocalHost, FIRST_SENDER_PORT + sender);
+                pool.queuePacket(std::move(packet));
+            }
+        }
+
+        QTRY_COMPARE_WITH_TIMEOUT(numProcessed.load(), NUM_SENDERS * PACKETS_PER_SENDER, 10000);
+
+        // a shard counts a packet once the handler has returned, so keep sampling until every count is in
+        uint64_t totalProcessed = 0;
+        uint64_t totalDropped = 0;
+        auto sampleProcessed = [&] {
+            for (auto& shardStats : pool.sampleStats()) {
+                totalDropped += shardStats.dropped;
+                totalProcessed += shardStats.processed;
+            }
+            return totalProcessed;
+        };
+        QTRY_COMPARE_WITH_TIMEOUT(sampleProcessed(), (uint64_t)(NUM_SENDERS * PACKETS_PER_SENDER), 10000);
+        QCOMPARE(totalDropped, (uint64_t)0);
+    }
+
+    QCOMPARE((int)processedIndices.size(), NUM_SENDERS);
+    for (auto& senderIndices : processedIndices) {
+        QCOMPARE((int)senderIndices.second.size(), PACKETS_PER_SENDER);
+        for (int i = 0; i < PACKETS_PER_SENDER; ++i) {
+            QCOMPARE(senderIndices.second[i], i);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  ReceiveShardPoolTests.h
+//  tests/networking/src
+//
+//  Created on 2019-11-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceiveShardPoolTests_h
+#define hifi_ReceiveShardPoolTests_h
+
+#include <QtTest/QtTest>
+
+class ReceiveShardPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that every packet is processed once and that packets from one sender are processed in order
+    void senderOrderTest();
+};
+
+#endif // hifi_ReceiveShardPoolTests_h
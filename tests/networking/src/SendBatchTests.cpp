@@ -0,0 +1,156 @@
+//
+//  SendBatchTests.cpp
+//  tests/networking/src
+//
+//  Created on 2019-11-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendBatchTests.h"
+
+#include <iostream>
+
+#include <QtNetwork/QUdpSocket>
+
+#include <SharedUtil.h>
+#include <udt/Packet.h>
+#include <udt/Socket.h>
+
+QTEST_MAIN(SendBatchTests)
+
+static const int TEST_PAYLOAD_SIZE = 1200;
+
+std::unique_ptr<udt::Packet> createTestPacket(int index) {
+    auto packet = udt::Packet::create();
+    packet->writePrimitive(index);
+
+    char filler[TEST_PAYLOAD_SIZE - sizeof(int)];
+    memset(filler, index & 0xFF, sizeof(filler));
+    packet->write(filler, sizeof(filler));
+
+    return packet;
+}
+
+void SendBatchTests::batchedSendTest() {
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 * 1024 * 1024);
+    HifiSockAddr receiverSockAddr(QHostAddress::LocalHost, receiver.localPort());
+
+    udt::Socket socket(nullptr, false);
+    socket.bind(QHostAddress::LocalHost);
+    socket.setBatchedSendEnabled(true);
+
+    // a shorter datagram in the middle of the batch ends a segmented run
+    const int NUM_PACKETS = 200;
+    const int SHORT_PACKET_INDEX = 100;
+
+    socket.beginSendBatch();
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        if (i == SHORT_PACKET_INDEX) {
+            auto packet = udt::Packet::create();
+            packet->writePrimitive(i);
+            socket.writePacket(std::move(packet), receiverSockAddr);
+        } else {
+            socket.writePacket(createTestPacket(i), receiverSockAddr);
+        }
+    }
+    socket.flushSendBatch();
+
+    int numReceived = 0;
+    udt::SequenceNumber lastSequenceNumber;
+    while (numReceived < NUM_PACKETS && (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(1000))) {
+        while (receiver.hasPendingDatagrams()) {
+            auto size = receiver.pendingDatagramSize();
+            auto buffer = std::unique_ptr<char[]>(new char[size]);
+            QCOMPARE(receiver.readDatagram(buffer.get(), size), size);
+
+            auto packet = udt::Packet::fromReceivedPacket(std::move(buffer), size, HifiSockAddr());
+
+            int index;
+            packet->readPrimitive(&index);
+            QCOMPARE(index, numReceived);
+            QCOMPARE(packet->getPayloadSize(), (qint64)(index == SHORT_PACKET_INDEX ? sizeof(int) : TEST_PAYLOAD_SIZE));
+
+            if (numReceived > 0) {
+                auto expectedSequenceNumber = lastSequenceNumber;
+                QVERIFY(packet->getSequenceNumber() == ++expectedSequenceNumber);
+            }
+            lastSequenceNumber = packet->getSequenceNumber();
+
+            ++numReceived;
+        }
+    }
+
+    QCOMPARE(numReceived, NUM_PACKETS);
+}
+
+void SendBatchTests::sendBenchmark() {
+    // mimic a mixer frame: a few packets for each of a number of listeners
+    const int NUM_LISTENERS = 8;
+    const int PACKETS_PER_LISTENER = 8;
+    const int NUM_FRAMES = 500;
+    const int NUM_PACKETS = NUM_FRAMES * NUM_LISTENERS * PACKETS_PER_LISTENER;
+
+    std::vector<std::unique_ptr<QUdpSocket>> listeners;
+    std::vector<HifiSockAddr> listenerSockAddrs;
+    for (int i = 0; i < NUM_LISTENERS; ++i) {
+        listeners.emplace_back(new QUdpSocket());
+        QVERIFY(listeners.back()->bind(QHostAddress::LocalHost, 0));
+        listenerSockAddrs.emplace_back(QHostAddress::LocalHost, listeners.back()->localPort());
+    }
+
+    udt::Socket socket(nullptr, false);
+    socket.bind(QHostAddress::LocalHost);
+
+    std::cout << "[mode, packets/s, syscalls/packet]" << std::endl;
+
+    for (bool batched : { false, true }) {
+        socket.setBatchedSendEnabled(batched);
+        socket.sampleSendBatchStats();
+
+        std::vector<std::unique_ptr<udt::Packet>> packets;
+        packets.reserve(NUM_PACKETS);
+        for (int i = 0; i < NUM_PACKETS; ++i) {
+            packets.push_back(createTestPacket(i));
+        }
+
+        auto packetIt = packets.begin();
+        auto startTime = usecTimestampNow();
+        for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+            socket.beginSendBatch();
+            for (int listener = 0; listener < NUM_LISTENERS; ++listener) {
+                for (int i = 0; i < PACKETS_PER_LISTENER; ++i) {
+                    socket.writePacket(std::move(*packetIt++), listenerSockAddrs[listener]);
+                }
+            }
+            socket.flushSendBatch();
+
+            // keep the listeners from overflowing, this isn't part of what we are measuring
+            if (frame % 16 == 0) {
+                auto pauseTime = usecTimestampNow();
+                for (auto& listener : listeners) {
+                    while (listener->hasPendingDatagrams()) {
+                        listener->readDatagram(nullptr, 0);
+                    }
+                }
+                startTime += usecTimestampNow() - pauseTime;
+            }
+        }
+        auto elapsedUsecs = std::max(usecTimestampNow() - startTime, (quint64)1);
+
+        auto stats = socket.sampleSendBatchStats();
+        float syscallsPerPacket = (batched && stats.datagrams > 0) ? (float)stats.syscalls / (float)stats.datagrams : 1.0f;
+        float packetsPerSecond = (float)NUM_PACKETS * USECS_PER_SECOND / (float)elapsedUsecs;
+
+        std::cout << "    " << (batched ? "batched" : "unbatched") << ", " << packetsPerSecond << ", "
+            << syscallsPerPacket << std::endl;
+        if (batched) {
+            std::cout << "    (" << stats.segmentedDatagrams << " of " << stats.datagrams
+                << " datagrams sent with segmentation offload)" << std::endl;
+        }
+    }
+}
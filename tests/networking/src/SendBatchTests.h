@@ -0,0 +1,27 @@
+//
+//  SendBatchTests.h
+//  tests/networking/src
+//
+//  Created on 2019-11-06.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendBatchTests_h
+#define hifi_SendBatchTests_h
+
+#include <QtTest/QtTest>
+
+class SendBatchTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a flushed batch arrives complete, in order and with consecutive sequence numbers
+    void batchedSendTest();
+
+    // Reports packets per second and syscalls per packet with and without send batching
+    void sendBenchmark();
+};
+
+#endif // hifi_SendBatchTests_h
@@ -0,0 +1,138 @@
+//
+//  EntityEditBatchTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-12-09.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEditBatchTests.h"
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <DependencyManager.h>
+#include <EntityEditFilters.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityEditBatchTests)
+
+static EntityTreePointer createTree() {
+    EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
+    tree->createRootElement();
+    tree->setIsServer(true);
+    return tree;
+}
+
+static SharedNodePointer createSender(bool isAllowedEditor) {
+    SharedNodePointer node(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr()));
+    NodePermissions permissions;
+    permissions.set(NodePermissions::Permission::canRezPermanentEntities);
+    if (isAllowedEditor) {
+        permissions.set(NodePermissions::Permission::canAdjustLocks);
+    }
+    node->setPermissions(permissions);
+    return node;
+}
+
+static EntityItemID addBox(const EntityTreePointer& tree) {
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName("box");
+    properties.setPosition(glm::vec3(1.0f));
+    tree->addEntity(entityID, properties);
+    return entityID;
+}
+
+// one EntityEdit message holding an edit per set of properties
+static OctreeEditBatchMessage makeEditMessage(const SharedNodePointer& sender, const EntityItemID& entityID,
+                                              const std::vector<EntityItemProperties>& edits) {
+    QByteArray data;
+    for (const auto& properties : edits) {
+        QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+        EntityPropertyFlags didntFitProperties;
+        EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, properties, buffer,
+                                                     properties.getChangedProperties(), didntFitProperties);
+        data += buffer;
+    }
+    auto message = QSharedPointer<ReceivedMessage>::create(data, PacketType::EntityEdit,
+                                                           versionForPacketType(PacketType::EntityEdit), HifiSockAddr());
+    return OctreeEditBatchMessage(message, sender);
+}
+
+static EntityItemProperties makeEdit(const QString& name, quint64 lastEdited, const QString& userData = QString()) {
+    EntityItemProperties properties;
+    properties.setName(name);
+    if (!userData.isNull()) {
+        properties.setUserData(userData);
+    }
+    properties.setLastEdited(lastEdited);
+    return properties;
+}
+
+static uint64_t filterEvaluations() {
+    uint64_t evaluations = 0;
+    for (const auto& stats : DependencyManager::get<EntityEditFilters>()->getFilterStats()) {
+        evaluations += stats.evaluations;
+    }
+    return evaluations;
+}
+
+void EntityEditBatchTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void EntityEditBatchTests::coalesceTest() {
+    EntityTreePointer tree = createTree();
+    EntityItemID entityID = addBox(tree);
+    SharedNodePointer editor = createSender(true);
+
+    quint64 now = usecTimestampNow();
+    OctreeEditBatch batch;
+    batch.push_back(makeEditMessage(editor, entityID, { makeEdit("first", now + 1), makeEdit("second", now + 2) }));
+    batch.push_back(makeEditMessage(editor, entityID, { makeEdit("third", now + 3) }));
+    tree->withWriteLock([&] {
+        tree->processEditBatch(batch);
+    });
+
+    QCOMPARE(batch[0].numEdits + batch[1].numEdits, 3);
+    QCOMPARE(batch[0].numCoalescedEdits, 2);
+    QCOMPARE(tree->findEntityByEntityItemID(entityID)->getName(), QString("third"));
+}
+
+void EntityEditBatchTests::filterOncePerEditTest() {
+    EntityTreePointer tree = createTree();
+    EntityItemID entityID = addBox(tree);
+    SharedNodePointer sender = createSender(false);
+
+    DependencyManager::set<EntityEditFilters>(tree);
+    DependencyManager::get<EntityEditFilters>()->addFilterRules(EntityItemID(), "test",
+        "{ \"rules\": [ { \"rejectProperties\": [ \"userData\" ] } ] }");
+
+    // the last edit changes everything the others do, but the filter rejects it
+    quint64 now = usecTimestampNow();
+    OctreeEditBatch batch;
+    batch.push_back(makeEditMessage(sender, entityID, {
+        makeEdit("first", now + 1),
+        makeEdit("second", now + 2),
+        makeEdit("third", now + 3, "{ \"rejected\": true }")
+    }));
+    tree->withWriteLock([&] {
+        tree->processEditBatch(batch);
+    });
+
+    QCOMPARE(batch[0].numEdits, 3);
+    QCOMPARE(batch[0].numCoalescedEdits, 0);
+    QCOMPARE(filterEvaluations(), (uint64_t)3);
+    QCOMPARE(tree->findEntityByEntityItemID(entityID)->getName(), QString("second"));
+
+    DependencyManager::destroy<EntityEditFilters>();
+}
@@ -0,0 +1,29 @@
+//
+//  EntityEditBatchTests.h
+//  tests/octree/src
+//
+//  Created on 2019-12-09.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditBatchTests_h
+#define hifi_EntityEditBatchTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEditBatchTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test that an editor's edits overwritten by a later edit of the batch are coalesced
+    void coalesceTest();
+
+    // Test that the edit filter sees every filtered edit of a batch exactly once, even when a later one is rejected
+    void filterOncePerEditTest();
+};
+
+#endif // hifi_EntityEditBatchTests_h
@@ -0,0 +1,145 @@
+//
+//  EntityEditFilterRulesTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEditFilterRulesTests.h"
+
+#include <EntityEditFilterRules.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(EntityEditFilterRulesTests)
+
+static std::shared_ptr<EntityEditFilterRules> parseRules(const QByteArray& contents) {
+    QString error;
+    auto rules = EntityEditFilterRules::parse(contents, error);
+    if (!rules) {
+        qDebug() << "failed to parse rules:" << error;
+    }
+    return rules;
+}
+
+static bool applyRules(const EntityEditFilterRules& rules, EntityItemProperties& properties, bool& wasChanged,
+                       quint64 now = 0, const QUuid& senderID = QUuid()) {
+    EntityItemPointer noEntity;
+    EntityEditFilterRules::Edit edit(EntityTree::FilterType::Edit, properties, properties, wasChanged, noEntity, noEntity,
+                                     senderID, now);
+    return rules.apply(edit);
+}
+
+void EntityEditFilterRulesTests::parseTest() {
+    QVERIFY(EntityEditFilterRules::isRuleSet("{ \"rules\": [] }"));
+    QVERIFY(!EntityEditFilterRules::isRuleSet("function filter(properties) { return properties; }"));
+    QVERIFY(!EntityEditFilterRules::isRuleSet("{ \"wantsToFilterAdd\": false }"));
+
+    auto rules = parseRules("{ \"wantsToFilterPhysics\": false, \"rules\": [] }");
+    QVERIFY(rules);
+    QVERIFY(rules->wantsToFilter(EntityTree::FilterType::Add));
+    QVERIFY(rules->wantsToFilter(EntityTree::FilterType::Edit));
+    QVERIFY(!rules->wantsToFilter(EntityTree::FilterType::Physics));
+    QVERIFY(!rules->wantsToFilter(EntityTree::FilterType::Delete));
+    QVERIFY(!rules->needsZone());
+
+    QString error;
+    QVERIFY(!EntityEditFilterRules::parse("{ \"rules\": [ { \"frobnicate\": true } ] }", error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!EntityEditFilterRules::parse("{ \"rules\": [ { \"rejectProperties\": [ \"notAProperty\" ] } ] }", error));
+    QVERIFY(!EntityEditFilterRules::parse("{ \"rules\": [ { \"clampPosition\": { \"min\": { \"x\": 0 } } } ] }", error));
+    QVERIFY(!EntityEditFilterRules::parse("{ \"rules\": [ { \"rateLimit\": { \"editsPerSecond\": 0 } } ] }", error));
+
+    rules = parseRules("{ \"rules\": [ { \"clampPosition\": \"zone\" } ] }");
+    QVERIFY(rules);
+    QVERIFY(rules->needsZone());
+}
+
+void EntityEditFilterRulesTests::rejectPropertiesTest() {
+    auto rules = parseRules("{ \"rules\": [ { \"rejectProperties\": [ \"locked\", \"userData\" ] } ] }");
+    QVERIFY(rules);
+
+    bool wasChanged = false;
+    EntityItemProperties rename;
+    rename.setName("renamed");
+    QVERIFY(applyRules(*rules, rename, wasChanged));
+    QVERIFY(!wasChanged);
+
+    EntityItemProperties lock;
+    lock.setName("renamed");
+    lock.setLocked(true);
+    QVERIFY(!applyRules(*rules, lock, wasChanged));
+
+    EntityItemProperties userData;
+    userData.setUserData("{}");
+    QVERIFY(!applyRules(*rules, userData, wasChanged));
+
+    auto rejectAll = parseRules("{ \"rules\": [ { \"reject\": true } ] }");
+    QVERIFY(rejectAll);
+    QVERIFY(!applyRules(*rejectAll, rename, wasChanged));
+}
+
+void EntityEditFilterRulesTests::clampPositionTest() {
+    auto rules = parseRules("{ \"rules\": [ { \"clampPosition\": "
+        "{ \"min\": { \"x\": -10, \"y\": 0, \"z\": -10 }, \"max\": { \"x\": 10, \"y\": 5, \"z\": 10 } } } ] }");
+    QVERIFY(rules);
+
+    bool wasChanged = false;
+    EntityItemProperties inside;
+    inside.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    QVERIFY(applyRules(*rules, inside, wasChanged));
+    QVERIFY(!wasChanged);
+    QCOMPARE(inside.getPosition(), glm::vec3(1.0f, 2.0f, 3.0f));
+
+    EntityItemProperties outside;
+    outside.setPosition(glm::vec3(20.0f, -1.0f, 3.0f));
+    QVERIFY(applyRules(*rules, outside, wasChanged));
+    QVERIFY(wasChanged);
+    QCOMPARE(outside.getPosition(), glm::vec3(10.0f, 0.0f, 3.0f));
+
+    // edits that don't move the entity aren't touched
+    wasChanged = false;
+    EntityItemProperties rename;
+    rename.setName("renamed");
+    QVERIFY(applyRules(*rules, rename, wasChanged));
+    QVERIFY(!wasChanged);
+    QVERIFY(!rename.containsPositionChange());
+}
+
+void EntityEditFilterRulesTests::rateLimitTest() {
+    auto rules = parseRules("{ \"rules\": [ { \"rateLimit\": { \"editsPerSecond\": 10, \"burst\": 2 } } ] }");
+    QVERIFY(rules);
+
+    QUuid sender = QUuid::createUuid();
+    QUuid otherSender = QUuid::createUuid();
+
+    bool wasChanged = false;
+    const quint64 START = 1000 * USECS_PER_SECOND;
+    EntityItemProperties edit;
+    edit.setName("renamed");
+    QVERIFY(applyRules(*rules, edit, wasChanged, START, sender));
+    QVERIFY(applyRules(*rules, edit, wasChanged, START, sender));
+    QVERIFY(!applyRules(*rules, edit, wasChanged, START, sender));
+
+    // the bucket is the sender's, whatever the edit changes or whoever simulates the entity
+    EntityItemProperties ownedEdit;
+    ownedEdit.setSimulationOwner(QUuid::createUuid(), 1);
+    QVERIFY(!applyRules(*rules, ownedEdit, wasChanged, START, sender));
+
+    // other senders have their own bucket, and edits the server makes itself aren't limited
+    QVERIFY(applyRules(*rules, edit, wasChanged, START, otherSender));
+    QVERIFY(applyRules(*rules, edit, wasChanged, START));
+
+    // an eighth of a second buys one more edit
+    QVERIFY(applyRules(*rules, edit, wasChanged, START + USECS_PER_SECOND / 8, sender));
+    QVERIFY(!applyRules(*rules, edit, wasChanged, START + USECS_PER_SECOND / 8, sender));
+
+    // and a long pause refills the burst, but no more
+    const quint64 LATER = START + 10 * USECS_PER_SECOND;
+    QVERIFY(applyRules(*rules, edit, wasChanged, LATER, sender));
+    QVERIFY(applyRules(*rules, edit, wasChanged, LATER, sender));
+    QVERIFY(!applyRules(*rules, edit, wasChanged, LATER, sender));
+}
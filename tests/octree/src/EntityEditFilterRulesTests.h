@@ -0,0 +1,33 @@
+//
+//  EntityEditFilterRulesTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditFilterRulesTests_h
+#define hifi_EntityEditFilterRulesTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEditFilterRulesTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that rule sets are told apart from scripts, and that malformed rule sets don't load
+    void parseTest();
+
+    // Test that edits changing a rejected property are rejected, and others pass
+    void rejectPropertiesTest();
+
+    // Test that positions outside the box are clamped into it and flagged as changed
+    void clampPositionTest();
+
+    // Test that each owner gets its burst, then editsPerSecond
+    void rateLimitTest();
+};
+
+#endif // hifi_EntityEditFilterRulesTests_h
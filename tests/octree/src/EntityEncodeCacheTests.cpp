@@ -0,0 +1,105 @@
+//
+//  EntityEncodeCacheTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCacheTests.h"
+
+#include <EntityEncodeCache.h>
+#include <EntityItem.h>
+#include <EntityItemProperties.h>
+#include <EntityTreeElement.h>
+#include <EntityTypes.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityEncodeCacheTests)
+
+static EntityItemPointer makeEntity() {
+    EntityItemProperties properties;
+    properties.setName("encode cache test");
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    properties.setUserData("{ \"public\": true }");
+    properties.setPrivateUserData("{ \"private\": true }");
+    return EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+}
+
+static QByteArray encodeDirectly(const EntityItem& entity, bool withPrivateUserData) {
+    OctreePacketData packetData(false, EntityEncodeCache::MAX_ENCODE_SIZE);
+    EncodeBitstreamParams params;
+    auto extraEncodeData = std::make_shared<EntityTreeElementExtraEncodeData>();
+    entity.appendEntityData(&packetData, params, extraEncodeData, withPrivateUserData);
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+void EntityEncodeCacheTests::encodeMatchesTest() {
+    EntityEncodeCache cache;
+    EntityItemPointer entity = makeEntity();
+    QVERIFY(entity);
+
+    QByteArray publicEncode = cache.get(*entity, false);
+    QByteArray privateEncode = cache.get(*entity, true);
+    QVERIFY(!publicEncode.isEmpty());
+    QCOMPARE(publicEncode, encodeDirectly(*entity, false));
+    QCOMPARE(privateEncode, encodeDirectly(*entity, true));
+    QVERIFY(privateEncode.size() > publicEncode.size());
+
+    // the second lookups are hits, and give back the same bytes
+    QCOMPARE(cache.get(*entity, false), publicEncode);
+    QCOMPARE(cache.get(*entity, true), privateEncode);
+
+    auto stats = cache.getStats();
+    QCOMPARE(stats.misses, (uint64_t)2);
+    QCOMPARE(stats.hits, (uint64_t)2);
+    QCOMPARE(stats.numEntries, (size_t)1);
+    QCOMPARE(stats.numBytes, (size_t)(publicEncode.size() + privateEncode.size()));
+}
+
+void EntityEncodeCacheTests::invalidationTest() {
+    EntityEncodeCache cache;
+    EntityItemPointer entity = makeEntity();
+
+    QByteArray before = cache.get(*entity, false);
+
+    // an edit moves the last edited time, so the stale encode is not returned
+    entity->setName("edited");
+    entity->setLastEdited(entity->getLastEdited() + 1);
+    QByteArray after = cache.get(*entity, false);
+    QVERIFY(after != before);
+    QCOMPARE(after, encodeDirectly(*entity, false));
+    QCOMPARE(cache.getStats().misses, (uint64_t)2);
+
+    // so does a change made by the server
+    entity->markAsChangedOnServer();
+    cache.get(*entity, false);
+    QCOMPARE(cache.getStats().misses, (uint64_t)3);
+
+    cache.invalidate(entity->getID());
+    auto stats = cache.getStats();
+    QCOMPARE(stats.invalidations, (uint64_t)1);
+    QCOMPARE(stats.numEntries, (size_t)0);
+    QCOMPARE(stats.numBytes, (size_t)0);
+
+    QCOMPARE(cache.get(*entity, false), encodeDirectly(*entity, false));
+    QCOMPARE(cache.getStats().misses, (uint64_t)4);
+}
+
+void EntityEncodeCacheTests::tooBigTest() {
+    EntityEncodeCache cache;
+    EntityItemPointer entity = makeEntity();
+    entity->setUserData(QString(EntityEncodeCache::MAX_ENCODE_SIZE * 2, 'x'));
+
+    QVERIFY(cache.get(*entity, false).isEmpty());
+    QVERIFY(cache.get(*entity, false).isEmpty());
+
+    // the second lookup doesn't encode it again
+    auto stats = cache.getStats();
+    QCOMPARE(stats.misses, (uint64_t)1);
+    QCOMPARE(stats.tooBig, (uint64_t)2);
+    QCOMPARE(stats.numBytes, (size_t)0);
+}
@@ -0,0 +1,30 @@
+//
+//  EntityEncodeCacheTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCacheTests_h
+#define hifi_EntityEncodeCacheTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEncodeCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the cached encode is what appendEntityData writes into an empty packet, with and without private user data
+    void encodeMatchesTest();
+
+    // Test that an edit or an invalidation makes the cache encode the entity again
+    void invalidationTest();
+
+    // Test that entities which don't fit in a packet are left to appendEntityData
+    void tooBigTest();
+};
+
+#endif // hifi_EntityEncodeCacheTests_h
@@ -0,0 +1,317 @@
+//
+//  EntityKinematicDeltaTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-28.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityKinematicDeltaTests.h"
+
+#include <iostream>
+#include <random>
+
+#include <EntityItem.h>
+#include <EntityItemProperties.h>
+#include <EntityKinematicDelta.h>
+#include <EntityTreeElement.h>
+#include <EntityTypes.h>
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityKinematicDeltaTests)
+
+static EntityKinematicState makeState(const glm::vec3& position) {
+    EntityKinematicState state;
+    state.position = position;
+    state.rotation = glm::angleAxis(0.5f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+    state.velocity = glm::vec3(1.0f, -2.0f, 0.5f);
+    state.angularVelocity = glm::vec3(0.0f, 3.0f, 0.0f);
+    state.acceleration = glm::vec3(0.0f, -9.8f, 0.0f);
+    state.queryAACube = AACube(position - glm::vec3(1.0f), 2.0f);
+    return state;
+}
+
+static bool closeTo(const glm::vec3& a, const glm::vec3& b, float precision) {
+    return glm::all(glm::lessThanEqual(glm::abs(a - b), glm::vec3(precision)));
+}
+
+void EntityKinematicDeltaTests::roundTripTest() {
+    EntityKinematicState baseline = makeState(glm::vec3(100.0f, 20.0f, -50.0f));
+    EntityKinematicState state = baseline;
+    state.position += glm::vec3(3.14159f, -0.001f, 12.5f);
+    state.rotation = glm::angleAxis(2.0f, glm::normalize(glm::vec3(-1.0f, 0.5f, 0.25f)));
+    state.velocity += glm::vec3(-4.2f, 9.9f, 0.003f);
+    state.angularVelocity += glm::vec3(1.5f, -0.25f, 7.0f);
+    state.acceleration = glm::vec3(0.0f);
+    state.queryAACube = AACube(state.position - glm::vec3(1.5f), 3.0f);
+
+    const OCTREE_PACKET_SEQUENCE BASELINE_SEQUENCE = 65530;
+    QByteArray delta;
+    QVERIFY(EntityKinematicDelta::encode(BASELINE_SEQUENCE, baseline, state, delta));
+    OCTREE_PACKET_SEQUENCE sequence = 0;
+    QVERIFY(EntityKinematicDelta::readBaselineSequence(delta, sequence));
+    QCOMPARE(sequence, BASELINE_SEQUENCE);
+
+    EntityKinematicState decoded;
+    QVERIFY(EntityKinematicDelta::decode(delta, baseline, decoded));
+    const float POSITION_PRECISION = 1.0f / (1 << EntityKinematicDelta::POSITION_RADIX);
+    const float VELOCITY_PRECISION = 1.0f / (1 << EntityKinematicDelta::VELOCITY_RADIX);
+    QVERIFY(closeTo(decoded.position, state.position, POSITION_PRECISION));
+    QVERIFY(closeTo(decoded.velocity, state.velocity, VELOCITY_PRECISION));
+    QVERIFY(closeTo(decoded.angularVelocity, state.angularVelocity, VELOCITY_PRECISION));
+    QVERIFY(fabsf(glm::dot(decoded.rotation, state.rotation)) > 0.9999f);
+    QCOMPARE(decoded.acceleration, state.acceleration);
+    QVERIFY(closeTo(decoded.queryAACube.getCorner(), state.queryAACube.getCorner(), POSITION_PRECISION));
+    QCOMPARE(decoded.queryAACube.getScale(), state.queryAACube.getScale());
+}
+
+void EntityKinematicDeltaTests::unchangedComponentsTest() {
+    EntityKinematicState baseline = makeState(glm::vec3(1.0f, 2.0f, 3.0f));
+
+    // only the velocity changed: sequence, mask and one fixed point vec3
+    EntityKinematicState state = baseline;
+    state.velocity.x += 1.0f;
+    QByteArray delta;
+    QVERIFY(EntityKinematicDelta::encode(0, baseline, state, delta));
+    QCOMPARE(delta.size(), (int)(sizeof(OCTREE_PACKET_SEQUENCE) + 1 + 3 * sizeof(int16_t)));
+    QCOMPARE((uint8_t)delta[(int)sizeof(OCTREE_PACKET_SEQUENCE)], (uint8_t)EntityKinematicDelta::VELOCITY);
+
+    // a move smaller than the precision of the offsets is no move
+    state = baseline;
+    state.position.y += 0.0001f;
+    QVERIFY(EntityKinematicDelta::encode(0, baseline, state, delta));
+    QCOMPARE(delta.size(), (int)(sizeof(OCTREE_PACKET_SEQUENCE) + 1));
+
+    EntityKinematicState decoded;
+    QVERIFY(EntityKinematicDelta::decode(delta, baseline, decoded));
+    QCOMPARE(decoded.position, baseline.position);
+    QCOMPARE(decoded.rotation, baseline.rotation);
+    QCOMPARE(decoded.queryAACube, baseline.queryAACube);
+}
+
+void EntityKinematicDeltaTests::rejectTest() {
+    EntityKinematicState baseline = makeState(glm::vec3(0.0f));
+    QByteArray delta;
+
+    // at rest
+    EntityKinematicState state = baseline;
+    state.velocity = glm::vec3(0.0f);
+    state.angularVelocity = glm::vec3(0.0f);
+    QVERIFY(!EntityKinematicDelta::encode(0, baseline, state, delta));
+
+    // too far
+    state = baseline;
+    state.position.z += 40.0f;
+    QVERIFY(!EntityKinematicDelta::encode(0, baseline, state, delta));
+    state = baseline;
+    state.velocity.x += 70.0f;
+    QVERIFY(!EntityKinematicDelta::encode(0, baseline, state, delta));
+
+    // malformed
+    state = baseline;
+    state.position.x += 1.0f;
+    state.velocity.x += 1.0f;
+    QVERIFY(EntityKinematicDelta::encode(0, baseline, state, delta));
+    EntityKinematicState decoded;
+    QVERIFY(!EntityKinematicDelta::decode(delta.left(delta.size() - 1), baseline, decoded));
+    QVERIFY(!EntityKinematicDelta::decode(delta + QByteArray(1, 0), baseline, decoded));
+    QVERIFY(!EntityKinematicDelta::decode(delta.left(2), baseline, decoded));
+    OCTREE_PACKET_SEQUENCE sequence;
+    QVERIFY(!EntityKinematicDelta::readBaselineSequence(delta.left(2), sequence));
+}
+
+void EntityKinematicDeltaTests::nonKinematicChangeTest() {
+    EntityItemProperties properties;
+    properties.setName("kinematic delta test");
+    EntityItemPointer entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+    QVERIFY(entity);
+    quint64 lastNonKinematicChange = entity->getLastNonKinematicChange();
+
+    EntityItemProperties kinematicProperties;
+    kinematicProperties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    kinematicProperties.setVelocity(glm::vec3(0.0f, -1.0f, 0.0f));
+    kinematicProperties.setAngularVelocity(glm::vec3(0.0f, 1.0f, 0.0f));
+    kinematicProperties.setLastEditedBy(QUuid::createUuid());
+    QVERIFY(entity->setProperties(kinematicProperties));
+    QCOMPARE(entity->getLastNonKinematicChange(), lastNonKinematicChange);
+
+    EntityItemProperties nameProperties;
+    nameProperties.setName("renamed");
+    QVERIFY(entity->setProperties(nameProperties));
+    QVERIFY(entity->getLastNonKinematicChange() > lastNonKinematicChange);
+}
+
+namespace {
+
+const int NUM_BODIES = 200;
+const int UPDATES_PER_SECOND = 20; // per moving entity, from its simulation owner
+const int STEPS_PER_UPDATE = 3;
+const int NUM_UPDATES = 10 * UPDATES_PER_SECOND;
+const int ACK_UPDATES = 4; // round trip and ack interval
+const int REBASE_AGE_UPDATES = 2 * UPDATES_PER_SECOND;
+const int REBASE_INTERVAL_UPDATES = UPDATES_PER_SECOND;
+const int PACKET_SIZE = 1400;
+const float FLOOR = 0.5f;
+const float GRAVITY = -9.8f;
+
+struct Body {
+    EntityItemPointer entity;
+    EntityKinematicState state;
+    bool moving { true };
+
+    // what the server knows of the agent
+    bool hasAcked { false };
+    int ackedUpdate { 0 };
+    EntityKinematicState acked;
+    bool hasPending { false };
+    int pendingUpdate { 0 };
+    EntityKinematicState pending;
+    int lastFullUpdate { 0 };
+};
+
+// the size the records take once packed into packets and compressed, the way entity data packets go out
+int compressedSize(const QVector<QByteArray>& records) {
+    int size = 0;
+    QByteArray packet;
+    for (const auto& record : records) {
+        if (packet.size() + record.size() > PACKET_SIZE && !packet.isEmpty()) {
+            size += qCompress(packet).size();
+            packet.clear();
+        }
+        packet += record;
+    }
+    if (!packet.isEmpty()) {
+        size += qCompress(packet).size();
+    }
+    return size;
+}
+
+}
+
+void EntityKinematicDeltaTests::bandwidthBenchmark() {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Body> bodies(NUM_BODIES);
+    for (auto& body : bodies) {
+        EntityItemProperties properties;
+        properties.setName("body");
+        properties.setColor(glm::u8vec3(200, 100, 50));
+        properties.setDimensions(glm::vec3(0.5f));
+        properties.setDynamic(true);
+        body.entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+        body.state.position = glm::vec3(20.0f * unit(generator), 7.0f + 5.0f * unit(generator), 20.0f * unit(generator));
+        body.state.rotation = glm::normalize(glm::quat(unit(generator), unit(generator), unit(generator), unit(generator)));
+        body.state.velocity = glm::vec3(3.0f * unit(generator), 2.5f + 2.5f * unit(generator), 3.0f * unit(generator));
+        body.state.angularVelocity = 3.0f * glm::vec3(unit(generator), unit(generator), unit(generator));
+        body.state.acceleration = glm::vec3(0.0f, GRAVITY, 0.0f);
+    }
+
+    EncodeBitstreamParams params;
+    QVector<QByteArray> fullRecords;
+    QVector<QByteArray> deltaRecords;
+    int numDeltas = 0;
+    const float dt = 1.0f / (float)(UPDATES_PER_SECOND * STEPS_PER_UPDATE);
+
+    for (int update = 0; update < NUM_UPDATES; update++) {
+        for (auto& body : bodies) {
+            if (!body.moving) {
+                continue;
+            }
+            EntityKinematicState& state = body.state;
+            for (int step = 0; step < STEPS_PER_UPDATE; step++) {
+                state.velocity += state.acceleration * dt;
+                state.position += state.velocity * dt;
+                float angle = glm::length(state.angularVelocity) * dt;
+                if (angle > 0.0f) {
+                    state.rotation = glm::normalize(glm::angleAxis(angle, glm::normalize(state.angularVelocity)) * state.rotation);
+                }
+                if (state.position.y < FLOOR && state.velocity.y < 0.0f) {
+                    // bounce, losing energy and spin to the floor
+                    state.position.y = FLOOR;
+                    state.velocity.y *= -0.5f;
+                    state.velocity.x *= 0.8f;
+                    state.velocity.z *= 0.8f;
+                    state.angularVelocity *= 0.7f;
+                    if (state.velocity.y < 0.5f) {
+                        state.velocity = glm::vec3(0.0f);
+                        state.angularVelocity = glm::vec3(0.0f);
+                        body.moving = false;
+                        break;
+                    }
+                }
+            }
+            state.queryAACube = AACube(state.position - glm::vec3(0.5f), 1.0f);
+
+            EntityItemProperties properties;
+            properties.setPosition(state.position);
+            properties.setRotation(state.rotation);
+            properties.setVelocity(state.velocity);
+            properties.setAngularVelocity(state.angularVelocity);
+            properties.setAcceleration(state.acceleration);
+            properties.setQueryAACube(state.queryAACube);
+            body.entity->setProperties(properties);
+            EntityKinematicState entityState = body.entity->getKinematicState();
+
+            OctreePacketData fullPacket(false, PACKET_SIZE);
+            auto extraEncodeData = std::make_shared<EntityTreeElementExtraEncodeData>();
+            QCOMPARE(body.entity->appendEntityData(&fullPacket, params, extraEncodeData, false), OctreeElement::COMPLETED);
+            QByteArray fullRecord((const char*)fullPacket.getUncompressedData(), fullPacket.getUncompressedSize());
+            fullRecords.push_back(fullRecord);
+
+            // the agent acks the full updates it gets a round trip later
+            if (body.hasPending && update - body.pendingUpdate >= ACK_UPDATES) {
+                body.hasAcked = true;
+                body.ackedUpdate = body.pendingUpdate;
+                body.acked = body.pending;
+                body.hasPending = false;
+            }
+            bool rebase = update - body.ackedUpdate > REBASE_AGE_UPDATES &&
+                update - body.lastFullUpdate > REBASE_INTERVAL_UPDATES;
+            QByteArray delta;
+            if (body.hasAcked && !rebase &&
+                    EntityKinematicDelta::encode((OCTREE_PACKET_SEQUENCE)body.ackedUpdate, body.acked, entityState, delta)) {
+                OctreePacketData deltaPacket(false, PACKET_SIZE);
+                QVERIFY(body.entity->appendKinematicDelta(&deltaPacket, params, delta));
+                deltaRecords.push_back(QByteArray((const char*)deltaPacket.getUncompressedData(), deltaPacket.getUncompressedSize()));
+                numDeltas++;
+
+                // what the agent makes of it
+                EntityKinematicState decoded;
+                QVERIFY(EntityKinematicDelta::decode(delta, body.acked, decoded));
+                QVERIFY(closeTo(decoded.position, entityState.position, 1.0f / (1 << EntityKinematicDelta::POSITION_RADIX)));
+            } else {
+                deltaRecords.push_back(fullRecord);
+                body.hasPending = true;
+                body.pendingUpdate = update;
+                body.pending = entityState;
+                body.lastFullUpdate = update;
+            }
+        }
+    }
+
+    int fullBytes = 0;
+    for (const auto& record : fullRecords) {
+        fullBytes += record.size();
+    }
+    int deltaBytes = 0;
+    for (const auto& record : deltaRecords) {
+        deltaBytes += record.size();
+    }
+    int fullCompressedBytes = compressedSize(fullRecords);
+    int deltaCompressedBytes = compressedSize(deltaRecords);
+
+    std::cout << NUM_BODIES << " bodies falling, bouncing and spinning for " << NUM_UPDATES / UPDATES_PER_SECOND
+        << " seconds, " << fullRecords.size() << " updates, " << numDeltas << " of them as deltas:" << std::endl;
+    std::cout << "  full updates: " << fullBytes << " bytes, " << fullCompressedBytes << " compressed" << std::endl;
+    std::cout << "        deltas: " << deltaBytes << " bytes, " << deltaCompressedBytes << " compressed" << std::endl;
+    std::cout << "         saved: " << 100 - (100 * deltaCompressedBytes) / fullCompressedBytes << "% on the wire" << std::endl;
+
+    QVERIFY(numDeltas > 0);
+    QVERIFY(deltaBytes < fullBytes);
+    QVERIFY(deltaCompressedBytes < fullCompressedBytes);
+}
@@ -0,0 +1,36 @@
+//
+//  EntityKinematicDeltaTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-28.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityKinematicDeltaTests_h
+#define hifi_EntityKinematicDeltaTests_h
+
+#include <QtTest/QtTest>
+
+class EntityKinematicDeltaTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a decoded delta is the encoded state, to the precision of the quantization
+    void roundTripTest();
+
+    // Test that the components that are the same as in the baseline are left out of the delta
+    void unchangedComponentsTest();
+
+    // Test that states at rest or too far from the baseline are not encoded, and that malformed deltas don't decode
+    void rejectTest();
+
+    // Test that kinematic edits leave the last non-kinematic change of an entity alone, and other edits move it
+    void nonKinematicChangeTest();
+
+    // Compare the bytes of full updates and of kinematic deltas for a scene of falling, bouncing and spinning bodies
+    void bandwidthBenchmark();
+};
+
+#endif // hifi_EntityKinematicDeltaTests_h
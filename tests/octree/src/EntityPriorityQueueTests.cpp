@@ -0,0 +1,198 @@
+//
+//  EntityPriorityQueueTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-21.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityPriorityQueueTests.h"
+
+#include <iostream>
+#include <limits>
+#include <map>
+
+#include <EntityItemProperties.h>
+#include <EntityPriorityQueue.h>
+#include <EntityTypes.h>
+
+QTEST_MAIN(EntityPriorityQueueTests)
+
+static std::vector<EntityItemPointer> makeEntities(int numEntities) {
+    std::vector<EntityItemPointer> entities;
+    entities.reserve(numEntities);
+    EntityItemProperties properties;
+    for (int i = 0; i < numEntities; ++i) {
+        entities.push_back(EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties));
+    }
+    return entities;
+}
+
+// a cheap stand in for View::computePriority, which scores the same entity differently for each view
+static float score(const EntityItem* entity, uint32_t view) {
+    uint32_t hash = (uint32_t)((uintptr_t)entity >> 4) * 2654435761u ^ view * 40503u;
+    return (float)(hash % 100000) / 100.0f;
+}
+
+static void verifyOrder(EntityPriorityQueue& queue, std::map<const EntityItem*, float> expected) {
+    float lastPriority = std::numeric_limits<float>::max();
+    while (!queue.empty()) {
+        const PrioritizedEntity& top = queue.top();
+        QVERIFY(top.getPriority() <= lastPriority);
+        lastPriority = top.getPriority();
+
+        auto it = expected.find(top.getRawEntityPointer());
+        QVERIFY(it != expected.end());
+        QCOMPARE(top.getPriority(), it->second);
+        expected.erase(it);
+        queue.pop();
+    }
+    QVERIFY(expected.empty());
+}
+
+void EntityPriorityQueueTests::orderTest() {
+    auto entities = makeEntities(500);
+    EntityPriorityQueue queue;
+    std::map<const EntityItem*, float> expected;
+    for (const auto& entity : entities) {
+        float priority = score(entity.get(), 1);
+        queue.emplace(entity, priority);
+        expected[entity.get()] = priority;
+    }
+    QCOMPARE(queue.size(), entities.size());
+    QVERIFY(queue.contains(entities[42].get()));
+
+    // the popped ones are gone, and their slots are reused by the next ones
+    for (int i = 0; i < 100; ++i) {
+        const EntityItem* top = queue.top().getRawEntityPointer();
+        expected.erase(top);
+        queue.pop();
+        QVERIFY(!queue.contains(top));
+    }
+    for (const auto& entity : entities) {
+        if (!queue.contains(entity.get())) {
+            float priority = score(entity.get(), 2);
+            queue.emplace(entity, priority);
+            expected[entity.get()] = priority;
+        }
+    }
+    QCOMPARE(queue.size(), entities.size());
+    verifyOrder(queue, expected);
+}
+
+void EntityPriorityQueueTests::updatePriorityTest() {
+    auto entities = makeEntities(200);
+    EntityPriorityQueue queue;
+    std::map<const EntityItem*, float> expected;
+    for (const auto& entity : entities) {
+        float priority = score(entity.get(), 1);
+        queue.emplace(entity, priority);
+        expected[entity.get()] = priority;
+    }
+
+    // up to the top, and then back down
+    QVERIFY(queue.updatePriority(entities[7].get(), 10000.0f));
+    QCOMPARE(queue.top().getRawEntityPointer(), entities[7].get());
+    QVERIFY(queue.updatePriority(entities[7].get(), -1.0f));
+    QVERIFY(queue.top().getRawEntityPointer() != entities[7].get());
+    expected[entities[7].get()] = -1.0f;
+
+    for (size_t i = 0; i < entities.size(); i += 3) {
+        float priority = score(entities[i].get(), 2);
+        QVERIFY(queue.updatePriority(entities[i].get(), priority));
+        expected[entities[i].get()] = priority;
+    }
+
+    auto notQueued = makeEntities(1);
+    QVERIFY(!queue.updatePriority(notQueued[0].get(), 1.0f));
+
+    verifyOrder(queue, expected);
+}
+
+void EntityPriorityQueueTests::reprioritizeTest() {
+    auto entities = makeEntities(300);
+    EntityPriorityQueue queue;
+    for (const auto& entity : entities) {
+        queue.emplace(entity, score(entity.get(), 1), entity == entities[5]);
+    }
+
+    // drop a third of them from the new view, and delete one
+    const EntityItem* deleted = entities[10].get();
+    entities[10].reset();
+    std::map<const EntityItem*, float> expected;
+    queue.reprioritize([&](const PrioritizedEntity& queued) {
+        if (!queued.getEntity()) {
+            return PrioritizedEntity::DO_NOT_SEND;
+        }
+        if (queued.shouldForceRemove()) {
+            expected[queued.getRawEntityPointer()] = PrioritizedEntity::FORCE_REMOVE;
+            return PrioritizedEntity::FORCE_REMOVE;
+        }
+        float priority = score(queued.getRawEntityPointer(), 2);
+        if (priority < 300.0f) {
+            return PrioritizedEntity::DO_NOT_SEND;
+        }
+        expected[queued.getRawEntityPointer()] = priority;
+        return priority;
+    });
+    QVERIFY(!queue.contains(deleted));
+    QCOMPARE(queue.size(), expected.size());
+    QVERIFY(queue.size() < entities.size());
+    verifyOrder(queue, expected);
+}
+
+void EntityPriorityQueueTests::reprioritizeBenchmark() {
+    const int NUM_ENTITIES = 50 * 1000;
+    const uint32_t NUM_VIEWS = 20;
+
+    auto entities = makeEntities(NUM_ENTITIES);
+    auto fillQueue = [&](EntityPriorityQueue& queue) {
+        for (const auto& entity : entities) {
+            queue.emplace(entity, score(entity.get(), 0));
+        }
+    };
+
+    // what EntityTreeSendThread did for a new view: move the queue aside and emplace everything back with its new score
+    EntityPriorityQueue rebuiltQueue;
+    fillQueue(rebuiltQueue);
+    QElapsedTimer timer;
+    timer.start();
+    for (uint32_t view = 1; view <= NUM_VIEWS; ++view) {
+        EntityPriorityQueue prevQueue;
+        prevQueue.swap(rebuiltQueue);
+        while (!prevQueue.empty()) {
+            EntityItemPointer entity = prevQueue.top().getEntity();
+            prevQueue.pop();
+            if (entity) {
+                rebuiltQueue.emplace(entity, score(entity.get(), view));
+            }
+        }
+    }
+    qint64 rebuildNSecs = timer.nsecsElapsed() / NUM_VIEWS;
+
+    EntityPriorityQueue inPlaceQueue;
+    fillQueue(inPlaceQueue);
+    timer.restart();
+    for (uint32_t view = 1; view <= NUM_VIEWS; ++view) {
+        inPlaceQueue.reprioritize([&](const PrioritizedEntity& queued) {
+            EntityItemPointer entity = queued.getEntity();
+            return entity ? score(entity.get(), view) : PrioritizedEntity::DO_NOT_SEND;
+        });
+    }
+    qint64 inPlaceNSecs = timer.nsecsElapsed() / NUM_VIEWS;
+
+    // both end up with the same order
+    QCOMPARE(inPlaceQueue.size(), rebuiltQueue.size());
+    while (!inPlaceQueue.empty()) {
+        QCOMPARE(inPlaceQueue.top().getPriority(), rebuiltQueue.top().getPriority());
+        inPlaceQueue.pop();
+        rebuiltQueue.pop();
+    }
+
+    std::cout << "Re-scoring " << NUM_ENTITIES << " queued entities for a new view:" << std::endl;
+    std::cout << "  full rebuild: " << rebuildNSecs / 1000 << " usecs" << std::endl;
+    std::cout << "      in place: " << inPlaceNSecs / 1000 << " usecs" << std::endl;
+}
@@ -0,0 +1,33 @@
+//
+//  EntityPriorityQueueTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-21.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityPriorityQueueTests_h
+#define hifi_EntityPriorityQueueTests_h
+
+#include <QtTest/QtTest>
+
+class EntityPriorityQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that entities come out highest priority first, and that contains() follows emplace() and pop()
+    void orderTest();
+
+    // Test that changing the priority of a queued entity moves it in the queue
+    void updatePriorityTest();
+
+    // Test that re-scoring the queue keeps the order and drops what is scored DO_NOT_SEND or was deleted
+    void reprioritizeTest();
+
+    // Reports how long a new view takes to re-score 50k queued entities, rebuilding the queue vs in place
+    void reprioritizeBenchmark();
+};
+
+#endif // hifi_EntityPriorityQueueTests_h
@@ -0,0 +1,135 @@
+//
+//  EntitySimulationTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationTests.h"
+
+#include <iostream>
+#include <random>
+
+#include <EntityItemProperties.h>
+#include <EntityTypes.h>
+#include <NumericalConstants.h>
+#include <SimpleEntitySimulation.h>
+
+QTEST_MAIN(EntitySimulationTests)
+
+// exposes the expiry of mortal entities, which updateEntities() runs against the wall clock
+class TestEntitySimulation : public SimpleEntitySimulation {
+public:
+    using EntitySimulation::expireMortalEntities;
+};
+
+static EntityItemPointer makeMortalEntity(quint64 created, float lifetime) {
+    EntityItemProperties properties;
+    auto entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+    entity->setCreated(created);
+    entity->setLifetime(lifetime);
+    return entity;
+}
+
+void EntitySimulationTests::expireMortalEntitiesTest() {
+    const int NUM_ENTITIES = 100000;
+    const float MAX_LIFETIME = 100.0f; // seconds
+    const quint64 STEP = 97 * USECS_PER_MSEC; // not a multiple of the wheel's tick
+
+    TestEntitySimulation simulation;
+    quint64 start = usecTimestampNow();
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> lifetimes(0.001f, MAX_LIFETIME);
+
+    std::vector<EntityItemPointer> entities;
+    std::vector<quint64> expiries;
+    entities.reserve(NUM_ENTITIES);
+    expiries.reserve(NUM_ENTITIES);
+    for (int i = 0; i < NUM_ENTITIES; ++i) {
+        entities.push_back(makeMortalEntity(start, lifetimes(generator)));
+        expiries.push_back(entities.back()->getExpiry());
+        simulation.addEntity(entities.back());
+    }
+
+    quint64 expireTime = 0;
+    quint64 scanTime = 0;
+    int numSteps = 0;
+    quint64 end = start + (quint64)(MAX_LIFETIME * USECS_PER_SECOND) + STEP;
+    for (quint64 now = start + STEP; now < end; now += STEP) {
+        quint64 before = usecTimestampNow();
+        simulation.expireMortalEntities(now);
+        expireTime += usecTimestampNow() - before;
+
+        // what the update used to cost: a look at every mortal entity
+        before = usecTimestampNow();
+        size_t numExpired = 0;
+        for (const auto& entity : entities) {
+            numExpired += entity->getExpiry() < now ? 1 : 0;
+        }
+        scanTime += usecTimestampNow() - before;
+        ++numSteps;
+
+        // never early and at most a tick late, so they die in the order of their expiry give or take a tick
+        size_t numDead = 0;
+        for (int i = 0; i < NUM_ENTITIES; ++i) {
+            if (entities[i]->isDead()) {
+                QVERIFY(expiries[i] < now);
+                ++numDead;
+            } else {
+                QVERIFY(expiries[i] + EXPIRY_WHEEL_TICK > now);
+            }
+        }
+        QVERIFY(numDead <= numExpired);
+    }
+
+    for (const auto& entity : entities) {
+        QVERIFY(entity->isDead());
+        QVERIFY(!entity->isSimulated());
+    }
+
+    std::cout << "Expired " << NUM_ENTITIES << " mortal entities over " << numSteps << " updates: "
+              << (float)expireTime / (float)numSteps << " usecs/update with the timing wheel, "
+              << (float)scanTime / (float)numSteps << " usecs/update scanning all of them" << std::endl;
+}
+
+void EntitySimulationTests::lifetimeChangeTest() {
+    TestEntitySimulation simulation;
+    quint64 start = usecTimestampNow();
+    auto shortened = makeMortalEntity(start, 10.0f);
+    auto lengthened = makeMortalEntity(start, 1.0f);
+    auto immortalized = makeMortalEntity(start, 1.0f);
+    auto immortal = makeMortalEntity(start, ENTITY_ITEM_IMMORTAL_LIFETIME);
+    for (const auto& entity : { shortened, lengthened, immortalized, immortal }) {
+        simulation.addEntity(entity);
+    }
+
+    shortened->setLifetime(0.5f);
+    lengthened->setLifetime(5.0f);
+    immortalized->setLifetime(ENTITY_ITEM_IMMORTAL_LIFETIME);
+    for (const auto& entity : { shortened, lengthened, immortalized }) {
+        simulation.changeEntity(entity);
+    }
+    simulation.processChangedEntities();
+
+    simulation.expireMortalEntities(start + 600 * USECS_PER_MSEC);
+    QVERIFY(shortened->isDead());
+    QVERIFY(!lengthened->isDead());
+    QVERIFY(!immortalized->isDead());
+
+    simulation.expireMortalEntities(start + 2 * USECS_PER_SECOND);
+    QVERIFY(!lengthened->isDead());
+    QVERIFY(!immortalized->isDead());
+
+    // a change the simulation wasn't told about is caught when the old expiry comes up
+    lengthened->setLifetime(3.0f);
+    simulation.expireMortalEntities(start + 6 * USECS_PER_SECOND);
+    QVERIFY(lengthened->isDead());
+
+    simulation.expireMortalEntities(start + 1000 * USECS_PER_SECOND);
+    QVERIFY(!immortalized->isDead());
+    QVERIFY(!immortal->isDead());
+}
@@ -0,0 +1,28 @@
+//
+//  EntitySimulationTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySimulationTests_h
+#define hifi_EntitySimulationTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySimulationTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that 100k mortal entities die in the order of their expiry, never early and at most a tick late, and
+    // reports how long expiring them took against scanning them all on every update
+    void expireMortalEntitiesTest();
+
+    // Test that changing the lifetime of an entity moves its expiry, and that immortal entities never expire
+    void lifetimeChangeTest();
+};
+
+#endif // hifi_EntitySimulationTests_h
@@ -0,0 +1,279 @@
+//
+//  EntitySnapshotTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySnapshotTests.h"
+
+#include <iostream>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <DependencyManager.h>
+#include <EntityTree.h>
+#include <Gzip.h>
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntitySnapshotTests)
+
+static QJsonObject vec3ToJson(float x, float y, float z) {
+    return QJsonObject { { "x", x }, { "y", y }, { "z", z } };
+}
+
+// a save with a mix of entity types, parents and user data, like a built up domain
+static QByteArray generateSave(int numEntities, const QUuid& id, int dataVersion) {
+    QByteArray json = "{\n  \"DataVersion\": " + QByteArray::number(dataVersion) + ",\n  \"Entities\": [";
+    QString parentID;
+    for (int i = 0; i < numEntities; i++) {
+        QJsonObject entity;
+        QString entityID = QUuid::createUuid().toString();
+        entity["id"] = entityID;
+        entity["name"] = QString("entity %1").arg(i);
+        entity["position"] = vec3ToJson((float)(i % 100), (float)((i / 100) % 100), (float)(i / 10000));
+        entity["dimensions"] = vec3ToJson(0.5f, 0.25f + (float)(i % 7) * 0.1f, 1.0f);
+        entity["rotation"] = QJsonObject { { "x", 0.0 }, { "y", 0.7071068 }, { "z", 0.0 }, { "w", 0.7071068 } };
+        entity["userData"] = QString("{\"grabbableKey\":{\"grabbable\":%1},\"index\":%2}").arg(i % 2 ? "true" : "false").arg(i);
+        switch (i % 4) {
+            case 0:
+                entity["type"] = "Box";
+                entity["color"] = QJsonObject { { "red", i % 256 }, { "green", 128 }, { "blue", 64 } };
+                parentID = entityID;
+                break;
+            case 1:
+                entity["type"] = "Text";
+                entity["text"] = QString("label %1").arg(i);
+                entity["lineHeight"] = 0.1;
+                entity["parentID"] = parentID;
+                break;
+            case 2:
+                entity["type"] = "Model";
+                entity["modelURL"] = QString("https://example.com/models/%1.fbx").arg(i % 50);
+                entity["shapeType"] = "box";
+                break;
+            default:
+                entity["type"] = "Light";
+                entity["intensity"] = 2.5;
+                entity["falloffRadius"] = 3.0;
+                break;
+        }
+        json += (i == 0) ? "\n    " : ",\n    ";
+        json += QJsonDocument(entity).toJson(QJsonDocument::Compact);
+    }
+    json += "\n  ],\n  \"Id\": \"" + id.toString().toUtf8() + "\",\n  \"Version\": " +
+        QByteArray::number((int)versionForPacketType(PacketType::EntityData)) + "\n}\n";
+    return json;
+}
+
+static EntityTreePointer createTree() {
+    EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
+    tree->createRootElement();
+    tree->setIsServer(true);
+    return tree;
+}
+
+// the entities of the tree's JSON save by id, without the times that loading resets
+static QMap<QString, QJsonObject> savedEntities(const EntityTreePointer& tree) {
+    QString json;
+    tree->toJSONString(json);
+    QMap<QString, QJsonObject> entities;
+    for (const auto& value : QJsonDocument::fromJson(json.toUtf8()).object()["Entities"].toArray()) {
+        QJsonObject entity = value.toObject();
+        entity.remove("lastEdited");
+        entity.remove("age");
+        entity.remove("ageAsText");
+        entities[entity["id"].toString()] = entity;
+    }
+    return entities;
+}
+
+#ifdef Q_OS_LINUX
+static qint64 readStatusKB(const char* field) {
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    for (const auto& line : status.readAll().split('\n')) {
+        if (line.startsWith(field)) {
+            return line.mid((int)strlen(field)).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+// resets the peak to the current resident size, and returns it
+static qint64 resetPeakMemoryKB() {
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+    return readStatusKB("VmRSS:");
+}
+
+static qint64 peakMemoryKB() {
+    return readStatusKB("VmHWM:");
+}
+#else
+static qint64 resetPeakMemoryKB() {
+    return -1;
+}
+
+static qint64 peakMemoryKB() {
+    return -1;
+}
+#endif
+
+void EntitySnapshotTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void EntitySnapshotTests::roundTripTest() {
+    QTemporaryDir dir;
+    QString snapshotFilename = dir.filePath("models.json.gz.snapshot");
+    QUuid id = QUuid::createUuid();
+    QByteArray save = generateSave(200, id, 12);
+
+    EntityTreePointer jsonTree = createTree();
+    bool success = false;
+    jsonTree->withWriteLock([&] {
+        QDataStream jsonStream(save);
+        success = jsonTree->readFromStream(save.size(), jsonStream);
+    });
+    QVERIFY(success);
+    QCOMPARE(jsonTree->getPersistID(), id);
+    QCOMPARE(jsonTree->getPersistDataVersion(), 12);
+    QVERIFY(jsonTree->writeToSnapshotFile(snapshotFilename, "tag"));
+
+    OctreeSnapshotHeader header;
+    QVERIFY(OctreeSnapshotReader::readHeader(snapshotFilename, header));
+    QCOMPARE(header.id, id);
+    QCOMPARE(header.dataVersion, (int64_t)12);
+    QCOMPARE(header.sourceTag, QByteArray("tag"));
+
+    EntityTreePointer snapshotTree = createTree();
+    success = false;
+    snapshotTree->withWriteLock([&] {
+        success = snapshotTree->readFromSnapshotFile(snapshotFilename);
+    });
+    QVERIFY(success);
+    QCOMPARE(snapshotTree->getPersistID(), id);
+    QCOMPARE(snapshotTree->getPersistDataVersion(), 12);
+
+    auto expected = savedEntities(jsonTree);
+    auto actual = savedEntities(snapshotTree);
+    QCOMPARE(expected.size(), 200);
+    QCOMPARE(actual.size(), expected.size());
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter) {
+        QCOMPARE(actual.value(iter.key()), iter.value());
+    }
+}
+
+void EntitySnapshotTests::badSnapshotTest() {
+    QTemporaryDir dir;
+    QString snapshotFilename = dir.filePath("models.json.gz.snapshot");
+    QByteArray save = generateSave(20, QUuid::createUuid(), 1);
+
+    EntityTreePointer jsonTree = createTree();
+    bool success = false;
+    jsonTree->withWriteLock([&] {
+        QDataStream jsonStream(save);
+        success = jsonTree->readFromStream(save.size(), jsonStream);
+    });
+    QVERIFY(success);
+    QVERIFY(jsonTree->writeToSnapshotFile(snapshotFilename));
+
+    QFile file(snapshotFilename);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray snapshot = file.readAll();
+
+    // cut inside the last item
+    QVERIFY(file.resize(snapshot.size() - 20));
+    file.close();
+    success = true;
+    EntityTreePointer truncatedTree = createTree();
+    truncatedTree->withWriteLock([&] {
+        success = truncatedTree->readFromSnapshotFile(snapshotFilename);
+    });
+    QVERIFY(!success);
+
+    // the item version follows the magic and the format version
+    const int ITEM_VERSION_OFFSET = 6;
+    snapshot[ITEM_VERSION_OFFSET] = (char)(snapshot[ITEM_VERSION_OFFSET] + 1);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(snapshot);
+    file.close();
+    EntityTreePointer otherVersionTree = createTree();
+    otherVersionTree->withWriteLock([&] {
+        success = otherVersionTree->readFromSnapshotFile(snapshotFilename);
+    });
+    QVERIFY(!success);
+    QVERIFY(savedEntities(otherVersionTree).isEmpty());
+}
+
+void EntitySnapshotTests::loadBenchmark() {
+    const int NUM_ENTITIES = 100 * 1000;
+
+    QTemporaryDir dir;
+    QString saveFilename = dir.filePath("models.json.gz");
+    QString snapshotFilename = saveFilename + ".snapshot";
+    QUuid id = QUuid::createUuid();
+    {
+        QByteArray gzippedSave;
+        QVERIFY(gzip(generateSave(NUM_ENTITIES, id, 1), gzippedSave));
+        QFile file(saveFilename);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(gzippedSave);
+    }
+
+    QElapsedTimer timer;
+    qint64 baselineKB = resetPeakMemoryKB();
+    timer.start();
+    EntityTreePointer jsonTree = createTree();
+    bool success = false;
+    jsonTree->withWriteLock([&] {
+        success = jsonTree->readFromFile(saveFilename.toLocal8Bit().constData());
+    });
+    qint64 jsonLoadMSecs = timer.elapsed();
+    qint64 jsonPeakKB = peakMemoryKB() - baselineKB;
+    QVERIFY(success);
+
+    timer.restart();
+    QVERIFY(jsonTree->writeToSnapshotFile(snapshotFilename));
+    qint64 snapshotWriteMSecs = timer.elapsed();
+    jsonTree->withWriteLock([&] {
+        jsonTree->eraseAllOctreeElements(false);
+    });
+    jsonTree.reset();
+
+    baselineKB = resetPeakMemoryKB();
+    timer.restart();
+    EntityTreePointer snapshotTree = createTree();
+    success = false;
+    snapshotTree->withWriteLock([&] {
+        success = snapshotTree->readFromSnapshotFile(snapshotFilename);
+    });
+    qint64 snapshotLoadMSecs = timer.elapsed();
+    qint64 snapshotPeakKB = peakMemoryKB() - baselineKB;
+    QVERIFY(success);
+    QCOMPARE(snapshotTree->getPersistID(), id);
+
+    std::cout << NUM_ENTITIES << " entities, " << QFileInfo(saveFilename).size() << " bytes of gzipped JSON, "
+        << QFileInfo(snapshotFilename).size() << " bytes of snapshot (written in " << snapshotWriteMSecs << " msecs)"
+        << std::endl;
+    std::cout << "JSON load: " << jsonLoadMSecs << " msecs, peak memory +" << jsonPeakKB << " KB" << std::endl;
+    std::cout << "Snapshot load: " << snapshotLoadMSecs << " msecs, peak memory +" << snapshotPeakKB << " KB" << std::endl;
+}
@@ -0,0 +1,32 @@
+//
+//  EntitySnapshotTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySnapshotTests_h
+#define hifi_EntitySnapshotTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySnapshotTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test that JSON -> tree -> snapshot -> tree gives back the same JSON, header data included
+    void roundTripTest();
+
+    // Test that a truncated snapshot or one with another item version fails to load
+    void badSnapshotTest();
+
+    // Reports the load time and peak memory of a generated 100k entity save, as JSON and as a snapshot
+    void loadBenchmark();
+};
+
+#endif // hifi_EntitySnapshotTests_h
@@ -0,0 +1,122 @@
+//
+//  OctreeJournalTests.cpp
+//  tests/octree/src
+//
+//  Created on 2019-11-15.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournalTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <OctreeJournal.h>
+
+QTEST_MAIN(OctreeJournalTests)
+
+static OctreeJournal::Record makeRecord(OctreeJournal::RecordType type, const QUuid& id, const QByteArray& data = QByteArray()) {
+    OctreeJournal::Record record;
+    record.type = type;
+    record.id = id;
+    record.data = data;
+    return record;
+}
+
+void OctreeJournalTests::replayTest() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.journal");
+    QUuid snapshotID = QUuid::createUuid();
+    QUuid a = QUuid::createUuid();
+    QUuid b = QUuid::createUuid();
+    QUuid c = QUuid::createUuid();
+
+    {
+        OctreeJournal journal;
+        journal.setFilename(filename);
+        QVERIFY(journal.reset(snapshotID, 7));
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Upsert, a, "a1"), makeRecord(OctreeJournal::Upsert, b, "b1") }));
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Upsert, a, "a2"), makeRecord(OctreeJournal::Upsert, c, "c1") }));
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Delete, b) }));
+        QCOMPARE(journal.getNumRecords(), 5);
+    }
+
+    OctreeJournal journal;
+    journal.setFilename(filename);
+    std::vector<OctreeJournal::Record> records;
+    QVERIFY(journal.replay(snapshotID, 7, records));
+    QCOMPARE(journal.getNumRecords(), 5);
+    QCOMPARE((int)records.size(), 3);
+    QCOMPARE(records[0].id, a);
+    QCOMPARE(records[0].data, QByteArray("a2"));
+    QCOMPARE(records[1].id, c);
+    QCOMPARE(records[2].id, b);
+    QCOMPARE(records[2].type, OctreeJournal::Delete);
+}
+
+void OctreeJournalTests::snapshotMismatchTest() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.journal");
+    QUuid snapshotID = QUuid::createUuid();
+
+    {
+        OctreeJournal journal;
+        journal.setFilename(filename);
+        QVERIFY(journal.reset(snapshotID, 7));
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Upsert, QUuid::createUuid(), "x") }));
+    }
+
+    OctreeJournal journal;
+    journal.setFilename(filename);
+    std::vector<OctreeJournal::Record> records;
+    QVERIFY(!journal.replay(snapshotID, 8, records));
+    QVERIFY(records.empty());
+
+    // the stale journal was replaced by an empty one for the loaded save
+    QVERIFY(journal.replay(snapshotID, 8, records));
+    QVERIFY(records.empty());
+}
+
+void OctreeJournalTests::tornRecordTest() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.journal");
+    QUuid snapshotID = QUuid::createUuid();
+    QUuid a = QUuid::createUuid();
+    QUuid b = QUuid::createUuid();
+
+    qint64 goodSize = 0;
+    {
+        OctreeJournal journal;
+        journal.setFilename(filename);
+        QVERIFY(journal.reset(snapshotID, 1));
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Upsert, a, "a1") }));
+        goodSize = journal.getSize();
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Upsert, b, QByteArray(100, 'b')) }));
+    }
+
+    // cut the last record short, as a crash in the middle of a write would
+    {
+        QFile file(filename);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(goodSize + 20));
+    }
+
+    std::vector<OctreeJournal::Record> records;
+    {
+        OctreeJournal journal;
+        journal.setFilename(filename);
+        QVERIFY(journal.replay(snapshotID, 1, records));
+        QCOMPARE((int)records.size(), 1);
+        QCOMPARE(records[0].id, a);
+        QCOMPARE(journal.getSize(), goodSize);
+        QVERIFY(journal.append({ makeRecord(OctreeJournal::Delete, a) }));
+    }
+
+    OctreeJournal journal;
+    journal.setFilename(filename);
+    QVERIFY(journal.replay(snapshotID, 1, records));
+    QCOMPARE((int)records.size(), 1);
+    QCOMPARE(records[0].type, OctreeJournal::Delete);
+}
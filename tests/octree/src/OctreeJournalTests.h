@@ -0,0 +1,30 @@
+//
+//  OctreeJournalTests.h
+//  tests/octree/src
+//
+//  Created on 2019-11-15.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournalTests_h
+#define hifi_OctreeJournalTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeJournalTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that replay keeps the last record of each item, in the order they were last written
+    void replayTest();
+
+    // Test that a journal written for another save is not replayed
+    void snapshotMismatchTest();
+
+    // Test that a torn record at the end is dropped, and that appending carries on after the last good one
+    void tornRecordTest();
+};
+
+#endif // hifi_OctreeJournalTests_h
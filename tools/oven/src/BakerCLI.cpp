@@ -91,7 +91,8 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
             auto it = STRING_TO_TEXTURE_USAGE_TYPE_MAP.find(type);
             if (it == STRING_TO_TEXTURE_USAGE_TYPE_MAP.end()) {
                 qCDebug(model_baking) << "Unknown texture usage type:" << type;
-                QCoreApplication::exit(OVEN_STATUS_CODE_FAIL);
+                finish(OVEN_STATUS_CODE_FAIL);
+                return;
             }
             _baker = std::unique_ptr<Baker> { new TextureBaker(inputUrl, it->second, outputPath) };
             _baker->moveToThread(Oven::instance().getNextWorkerThread());
@@ -100,7 +101,7 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
 
     if (!_baker) {
         qCDebug(model_baking) << "Failed to determine baker type for file" << inputUrl;
-        QCoreApplication::exit(OVEN_STATUS_CODE_FAIL);
+        finish(OVEN_STATUS_CODE_FAIL);
         return;
     }
 
@@ -125,5 +126,13 @@ void BakerCLI::handleFinishedBaker() {
             errorFile.close();
         }
     }
-    QCoreApplication::exit(exitCode);
+    finish(exitCode);
+}
+
+void BakerCLI::finish(int statusCode) {
+    if (_baker) {
+        // the baker lives on one of the oven's worker threads, let it go away there
+        _baker.release()->deleteLater();
+    }
+    emit bakeFinished(statusCode);
 }
@@ -36,10 +36,16 @@ public:
 public slots:
     void bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type = QString::null);
 
+signals:
+    // emitted with one of the OVEN_STATUS_CODE values once the bake started by bakeFile is over
+    void bakeFinished(int statusCode);
+
 private slots:
     void handleFinishedBaker();  
 
 private:
+    void finish(int statusCode);
+
     QDir _outputPath;
     std::unique_ptr<Baker> _baker;
 };
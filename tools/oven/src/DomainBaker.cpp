@@ -17,6 +17,8 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonObject>
 
+#include <NumericalConstants.h>
+
 #include "Gzip.h"
 #include "Oven.h"
 #include "baking/BakerLibrary.h"
@@ -38,6 +40,8 @@ DomainBaker::DomainBaker(const QUrl& localModelFileURL, const QString& domainNam
 }
 
 void DomainBaker::bake() {
+    _textureCacheStatsAtStart = BakedTextureCache::getInstance().getStats();
+
     setupOutputFolder();
 
     if (hasErrors()) {
@@ -746,6 +750,17 @@ void DomainBaker::checkIfRewritingComplete() {
             return;
         }
 
+        auto textureCacheStats = BakedTextureCache::getInstance().getStats();
+        auto hits = textureCacheStats.hits - _textureCacheStatsAtStart.hits;
+        auto lookups = hits + textureCacheStats.misses - _textureCacheStatsAtStart.misses;
+        if (lookups > 0) {
+            auto savedUsecs = textureCacheStats.savedUsecs - _textureCacheStatsAtStart.savedUsecs;
+            auto bakedUsecs = textureCacheStats.bakedUsecs - _textureCacheStatsAtStart.bakedUsecs;
+            qDebug() << "Found" << hits << "of" << lookups << "baked textures in the baked texture cache ("
+                << (100.0 * hits / lookups) << "% deduplicated), saving" << (float)savedUsecs / USECS_PER_SECOND
+                << "s of texture processing on top of the" << (float)bakedUsecs / USECS_PER_SECOND << "s spent";
+        }
+
         // we've now written out our new models file - time to say that we are finished up
         emit finished();
     }
@@ -76,6 +76,9 @@ private:
 
     bool _shouldRebakeOriginals { false };
 
+    // to report what the baked texture cache saved this bake
+    BakedTextureCache::Stats _textureCacheStatsAtStart;
+
     void addModelBaker(const QString& property, const QString& url, const QJsonValueRef& jsonRef);
     void addTextureBaker(const QString& property, const QString& url, image::TextureUsage::Type type, const QJsonValueRef& jsonRef);
     void addScriptBaker(const QString& property, const QString& url, const QJsonValueRef& jsonRef);
@@ -26,7 +26,9 @@
 #include <hfm/ModelFormatRegistry.h>
 #include <FBXSerializer.h>
 #include <OBJSerializer.h>
+#include <PathUtils.h>
 
+#include "BakedTextureCache.h"
 #include "MaterialBaker.h"
 
 Oven* Oven::_staticInstance { nullptr };
@@ -45,6 +47,9 @@ Oven::Oven() {
     DependencyManager::set<TextureCache>();
     DependencyManager::set<MaterialCache>();
 
+    // share the textures we bake with the other oven processes, and the bakes after this one
+    BakedTextureCache::getInstance().setDirectory(PathUtils::getAppLocalDataFilePath("baked-texture-cache"));
+
     MaterialBaker::setNextOvenWorkerThreadOperator([] {
         return Oven::instance().getNextWorkerThread();
     });
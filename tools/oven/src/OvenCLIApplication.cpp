@@ -20,20 +20,31 @@
 #include <TextureBaker.h>
 
 #include "BakerCLI.h"
+#include "OvenWorker.h"
 
 static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
 static const QString CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER = "disable-texture-compression";
+static const QString CLI_WORKER_PARAMETER = "worker";
 
 QUrl OvenCLIApplication::_inputUrlParameter;
 QUrl OvenCLIApplication::_outputUrlParameter;
 QString OvenCLIApplication::_typeParameter;
+bool OvenCLIApplication::_workerParameter { false };
 
 OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
 {
     BakerCLI* cli = new BakerCLI(this);
+
+    if (_workerParameter) {
+        // keep baking whatever we are sent until our input is closed
+        new OvenWorker(cli);
+        return;
+    }
+
+    connect(cli, &BakerCLI::bakeFinished, this, &QCoreApplication::exit);
     QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, _inputUrlParameter),
                               Q_ARG(QString, _outputUrlParameter.toString()), Q_ARG(QString, _typeParameter));
 }
@@ -47,7 +58,8 @@ void OvenCLIApplication::parseCommandLine(int argc, char* argv[]) {
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
         { CLI_TYPE_PARAMETER, "Type of asset. [model|material]"/*|js]"*/, "type" },
-        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." }
+        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." },
+        { CLI_WORKER_PARAMETER, "Bake the jobs written to stdin, one per line, until it is closed." }
     });
 
     auto versionOption = parser.addVersionOption();
@@ -75,6 +87,16 @@ void OvenCLIApplication::parseCommandLine(int argc, char* argv[]) {
         Q_UNREACHABLE();
     }
 
+    if (parser.isSet(CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER)) {
+        qDebug() << "Disabling texture compression";
+        TextureBaker::setCompressionEnabled(false);
+    }
+
+    if (parser.isSet(CLI_WORKER_PARAMETER)) {
+        _workerParameter = true;
+        return;
+    }
+
     if (!parser.isSet(CLI_INPUT_PARAMETER) || !parser.isSet(CLI_OUTPUT_PARAMETER)) {
         std::cout << "Error: Input and Output not set" << std::endl; // Avoid Qt log spam
         QCoreApplication mockApp(argc, argv); // required for call to showHelp()
@@ -86,9 +108,4 @@ void OvenCLIApplication::parseCommandLine(int argc, char* argv[]) {
     _outputUrlParameter = QDir::fromNativeSeparators(parser.value(CLI_OUTPUT_PARAMETER));
 
     _typeParameter = parser.isSet(CLI_TYPE_PARAMETER) ? parser.value(CLI_TYPE_PARAMETER) : QString::null;
-
-    if (parser.isSet(CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER)) {
-        qDebug() << "Disabling texture compression";
-        TextureBaker::setCompressionEnabled(false);
-    }
 }
@@ -29,6 +29,7 @@ private:
     static QUrl _inputUrlParameter;
     static QUrl _outputUrlParameter;
     static QString _typeParameter;
+    static bool _workerParameter;
 };
 
 #endif // hifi_OvenCLIApplication_h
@@ -0,0 +1,120 @@
+//
+//  OvenWorker.cpp
+//  tools/oven/src
+//
+//  Created on 2019-11-30.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OvenWorker.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+
+#include "ModelBakingLoggingCategory.h"
+
+OvenWorker::OvenWorker(BakerCLI* cli) :
+    QObject(cli),
+    _cli(cli)
+{
+    connect(_cli, &BakerCLI::bakeFinished, this, &OvenWorker::handleBakeFinished);
+
+    // there is no portable way to be notified of input on stdin, so block on it in a thread of its own; it goes away
+    // with the process once the input is closed and we quit
+    std::thread([this] {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            QMetaObject::invokeMethod(this, "queueJob", Qt::QueuedConnection,
+                                      Q_ARG(QByteArray, QByteArray::fromStdString(line)));
+        }
+        QMetaObject::invokeMethod(this, "handleEndOfInput", Qt::QueuedConnection);
+    }).detach();
+}
+
+void OvenWorker::queueJob(QByteArray job) {
+    if (job.trimmed().isEmpty()) {
+        return;
+    }
+    _jobs.enqueue(job);
+    if (!_isBaking) {
+        startNextJob();
+    }
+}
+
+void OvenWorker::handleEndOfInput() {
+    _isInputClosed = true;
+    if (!_isBaking && _jobs.isEmpty()) {
+        QCoreApplication::exit(OVEN_STATUS_CODE_SUCCESS);
+    }
+}
+
+void OvenWorker::startNextJob() {
+    while (!_jobs.isEmpty() && !_isBaking) {
+        auto job = QJsonDocument::fromJson(_jobs.dequeue()).object();
+
+        _textureCacheStatsAtStart = BakedTextureCache::getInstance().getStats();
+        _currentAssetHash = job["hash"].toString();
+        _currentOutputPath = job["output"].toString();
+        auto inputPath = job["input"].toString();
+        auto name = job["name"].toString();
+        auto type = job["type"].toString();
+
+        if (_currentAssetHash.isEmpty() || _currentOutputPath.isEmpty() || inputPath.isEmpty() || name.isEmpty()) {
+            qCWarning(model_baking) << "Ignoring malformed bake job";
+            continue;
+        }
+
+        // copy the file to bake to the output directory, to give it a name the bakers can work with
+        auto bakeInputPath = QDir(_currentOutputPath).absoluteFilePath(name);
+        if (!QFile::copy(inputPath, bakeInputPath)) {
+            QFile errorFile { QDir(_currentOutputPath).absoluteFilePath(OVEN_ERROR_FILENAME) };
+            if (errorFile.open(QFile::WriteOnly)) {
+                errorFile.write("Couldn't copy file to bake to temporary directory");
+            }
+            reportResult(OVEN_STATUS_CODE_FAIL);
+            continue;
+        }
+
+        qCDebug(model_baking) << "Baking" << name << "for" << _currentAssetHash;
+        _isBaking = true;
+        _cli->bakeFile(QUrl::fromLocalFile(bakeInputPath), _currentOutputPath, type);
+        return;
+    }
+
+    if (!_isBaking && _isInputClosed) {
+        QCoreApplication::exit(OVEN_STATUS_CODE_SUCCESS);
+    }
+}
+
+void OvenWorker::handleBakeFinished(int statusCode) {
+    _isBaking = false;
+    reportResult(statusCode);
+
+    // let bakeFile return before starting the next one, it may have finished without getting to the baker
+    QTimer::singleShot(0, this, [this] {
+        startNextJob();
+    });
+}
+
+void OvenWorker::reportResult(int statusCode) {
+    auto textureCacheStats = BakedTextureCache::getInstance().getStats();
+
+    // the log goes to stdout as well, a whole line at a time, so this stays a line of its own
+    fprintf(stdout, "%s %s %d %llu %llu %llu\n", OVEN_JOB_RESULT_PREFIX, qPrintable(_currentAssetHash), statusCode,
+            (unsigned long long)(textureCacheStats.hits - _textureCacheStatsAtStart.hits),
+            (unsigned long long)(textureCacheStats.misses - _textureCacheStatsAtStart.misses),
+            (unsigned long long)(textureCacheStats.savedUsecs - _textureCacheStatsAtStart.savedUsecs));
+    fflush(stdout);
+}
@@ -0,0 +1,57 @@
+//
+//  OvenWorker.h
+//  tools/oven/src
+//
+//  Created on 2019-11-30.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OvenWorker_h
+#define hifi_OvenWorker_h
+
+#include <QtCore/QObject>
+#include <QtCore/QQueue>
+
+#include <BakedTextureCache.h>
+
+#include "BakerCLI.h"
+
+// Written to stdout once a job is over, followed by the asset hash, the OVEN_STATUS_CODE, and the number of baked texture
+// cache hits and misses and usecs of texture processing the hits saved during the job
+static const char* const OVEN_JOB_RESULT_PREFIX = "OVEN_JOB_RESULT";
+
+// Bakes the jobs the asset server writes to our stdin, one after the other, so that a single oven process pays for
+// its startup once rather than once per asset. A job is a line of JSON:
+//
+//  { "hash": asset hash, "input": path to the asset file, "name": file name to bake it under,
+//    "output": directory to bake into, "type": asset type, as for -t }
+//
+// and the result is reported the same way as the exit code and errors.txt of a single file bake.
+class OvenWorker : public QObject {
+    Q_OBJECT
+
+public:
+    OvenWorker(BakerCLI* cli);
+
+private slots:
+    void queueJob(QByteArray job);
+    void handleEndOfInput();
+    void handleBakeFinished(int statusCode);
+
+private:
+    void startNextJob();
+    void reportResult(int statusCode);
+
+    BakerCLI* _cli;
+    QQueue<QByteArray> _jobs;
+    QString _currentAssetHash;
+    QString _currentOutputPath;
+    BakedTextureCache::Stats _textureCacheStatsAtStart;
+    bool _isBaking { false };
+    bool _isInputClosed { false };
+};
+
+#endif // hifi_OvenWorker_h